@@ -7,9 +7,11 @@ set(mlas_common_srcs
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/sgemm.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/convolve.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/pooling.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/snchwc.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/activate.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/logistic.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/tanh.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/softmax.cpp
 )
 
 if (MSVC)
@@ -65,8 +67,23 @@ if (MSVC)
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/cvtfp16a.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/LogisticKernelFma3.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/TanhKernelFma3.asm
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/snchwc_avx.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/snchwc_fma3.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/snchwc_avx512f.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/softmax_fma3.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/softmax_avx512f.cpp
     )
 
+    # The NCHWc and softmax kernels for each instruction set extension are
+    # written with intrinsics, so build each source for the extension that it
+    # targets.
+
+    set_source_files_properties(${ONNXRUNTIME_ROOT}/core/mlas/lib/snchwc_avx.cpp PROPERTIES COMPILE_FLAGS "/arch:AVX")
+    set_source_files_properties(${ONNXRUNTIME_ROOT}/core/mlas/lib/snchwc_fma3.cpp PROPERTIES COMPILE_FLAGS "/arch:AVX2")
+    set_source_files_properties(${ONNXRUNTIME_ROOT}/core/mlas/lib/snchwc_avx512f.cpp PROPERTIES COMPILE_FLAGS "/arch:AVX512")
+    set_source_files_properties(${ONNXRUNTIME_ROOT}/core/mlas/lib/softmax_fma3.cpp PROPERTIES COMPILE_FLAGS "/arch:AVX2")
+    set_source_files_properties(${ONNXRUNTIME_ROOT}/core/mlas/lib/softmax_avx512f.cpp PROPERTIES COMPILE_FLAGS "/arch:AVX512")
+
   endif()
 
 else()
@@ -113,6 +130,7 @@ else()
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SgemmKernelM1Avx.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SgemmKernelM1TransposeBAvx.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SgemmTransposePackB16x4Avx.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/snchwc_avx.cpp
     )
     set_source_files_properties(${mlas_platform_srcs_avx} PROPERTIES COMPILE_FLAGS "-mavx")
 
@@ -120,11 +138,15 @@ else()
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SgemmKernelFma3.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/LogisticKernelFma3.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/TanhKernelFma3.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/snchwc_fma3.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/softmax_fma3.cpp
     )
     set_source_files_properties(${mlas_platform_srcs_avx2} PROPERTIES COMPILE_FLAGS "-mavx2 -mfma")
 
     set(mlas_platform_srcs_avx512f
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SgemmKernelAvx512F.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/snchwc_avx512f.cpp
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/softmax_avx512f.cpp
     )
     set_source_files_properties(${mlas_platform_srcs_avx512f} PROPERTIES COMPILE_FLAGS "-mavx512f")
 
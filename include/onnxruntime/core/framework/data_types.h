@@ -7,7 +7,9 @@
 #include <stdint.h>
 #include <type_traits>
 #include <map>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "core/common/common.h"
 #include "core/common/exceptions.h"
@@ -35,6 +37,18 @@ using VectorDouble = std::vector<double>;
 using VectorMapStringToFloat = std::vector<MapStringToFloat>;
 using VectorMapInt64ToFloat = std::vector<MapInt64ToFloat>;
 
+//a batch of maps with the same keys, which the com.microsoft SharedKeyZipMap op outputs in place of a
+//sequence of maps. the keys are shared with the kernel and the values of all the maps are in one buffer.
+template <typename K>
+struct SharedKeyMaps {
+  std::shared_ptr<const std::vector<K>> keys;
+  //[number of maps, number of keys], the values of each map in the order of the keys
+  std::vector<float> values;
+};
+
+using SharedKeyMapsString = SharedKeyMaps<std::string>;
+using SharedKeyMapsInt64 = SharedKeyMaps<int64_t>;
+
 class DataTypeImpl;
 class TensorTypeBase;
 
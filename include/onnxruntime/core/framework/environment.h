@@ -9,6 +9,8 @@
 #include "core/common/status.h"
 
 namespace onnxruntime {
+class SharedInitializerCache;
+
 /**
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -30,6 +32,14 @@ class Environment {
   */
   static bool IsInitialized() { return is_initialized_; }
 
+  /**
+     Cache of the initializers shared by the sessions created in this environment that set
+     SessionOptions::shared_initializer_cache to it.
+  */
+  const std::shared_ptr<SharedInitializerCache>& GetSharedInitializerCache() const {
+    return shared_initializer_cache_;
+  }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Environment);
 
@@ -37,5 +47,7 @@ class Environment {
   Status Initialize();
 
   static std::atomic<bool> is_initialized_;
+
+  std::shared_ptr<SharedInitializerCache> shared_initializer_cache_;
 };
 }  // namespace onnxruntime
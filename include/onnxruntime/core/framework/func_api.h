@@ -36,6 +36,11 @@ using FunctionState = void*;
 // take the ComputeContext, and create a function state.
 using CreateFunctionStateC = int (*)(ComputeContext*, FunctionState*);
 // pass in the function state and input/output tensors, perform compute and return status code, 0 - succeed.
+// outputs:
+// if an output's data is set on entry, the runtime allocated it from the output's inferred shape, which is in
+// ndim/shape/dtype. the function should write the result there and leave data/shape as they are.
+// otherwise the function allocates the output: the data with the allocate_func in the ComputeContext, the shape with
+// new[]. the runtime takes ownership of both, and uses the data as the output without copying it where it can.
 using ComputeFuncC = int (*)(FunctionState, ONNXRunTimeTensor*, size_t, ONNXRunTimeTensor*, size_t);
 // release the function state.
 using DestroyFunctionStateC = void (*)(FunctionState);
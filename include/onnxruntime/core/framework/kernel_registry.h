@@ -28,6 +28,7 @@ class KernelRegistry {
                       const std::unordered_map<int, MLValue>& initialized_tensors,
                       const MLValueNameIdxMap& mlvalue_name_idx_map,
                       const FuncManager& funcs_mgr,
+                      WorkStealingThreadPool* intra_op_thread_pool,
                       std::unique_ptr<OpKernel>& op_kernel) const;
 
   // Check if an execution provider can create kernel for a node and return
@@ -46,6 +46,20 @@ class OpKernel {
     ORT_NOT_IMPLEMENTED(__FUNCTION__, " is not implemented");
   }
 
+  /**
+  Called once when the session is initialized for each input of the node that's a constant initializer, so the
+  kernel can transform it, e.g. pack a weight matrix into the layout its computation uses, rather than do so in
+  every Compute call.
+  @param tensor The value of the initializer.
+  @param input_idx The index of the node input the initializer is used as.
+  @param is_packed Set to true if the kernel keeps what it needs from the tensor and won't read the input in Compute.
+  The session releases an initializer once all the kernels that use it have packed it.
+  */
+  virtual Status PrePack(const Tensor& /*tensor*/, int /*input_idx*/, bool& is_packed) {
+    is_packed = false;
+    return Status::OK();
+  }
+
   const OrtAllocatorInfo& Allocator(int id, OrtMemType mem_type) const {
     return op_kernel_info_.GetAllocatorInfo(id, mem_type);
   }
@@ -115,6 +129,14 @@ class OpKernelContext {
     return static_cast<int>(kernel_->Node().OutputDefs().size());
   }
 
+  /**
+   * Thread pool shared by the session's kernels to parallelize work within a node.
+   * nullptr if the session is single threaded.
+   */
+  WorkStealingThreadPool* GetIntraOpThreadPool() const {
+    return kernel_->Info().GetIntraOpThreadPool();
+  }
+
   /**
    * return an allocator on device 0, with memtype of OrtMemTypeDefault
    *
@@ -153,6 +175,9 @@ class OpKernelContext {
   const MLValue* GetImplicitInputMLValue(int index) const;
   MLValue* GetOutputMLValue(int index);
 
+  // use tensor as the output at index if the execution frame doesn't need to provide the buffer. see ExecutionFrame.
+  bool TrySetOutputTensor(int index, std::unique_ptr<Tensor>& tensor);
+
  private:
   Status GetOrCreateOutputMLValue(int index, MLValue*& value);
 
@@ -15,6 +15,7 @@ namespace onnxruntime {
 
 class MLValueNameIdxMap;
 class FuncManager;
+class WorkStealingThreadPool;
     /**
    A very light-weight class, which works as an aggregated
    view of all data needed for constructing a Kernel instance.
@@ -27,7 +28,8 @@ class OpKernelInfo : public OpNodeProtoHelper<ProtoHelperNodeContext> {
                         const IExecutionProvider& execution_provider,
                         const std::unordered_map<int, MLValue>& initialized_tensors,
                         const MLValueNameIdxMap& mlvalue_name_idx_map,
-                        const FuncManager& funcs_mgr);
+                        const FuncManager& funcs_mgr,
+                        WorkStealingThreadPool* intra_op_thread_pool = nullptr);
 
   OpKernelInfo(const OpKernelInfo& other);
 
@@ -45,6 +47,9 @@ class OpKernelInfo : public OpNodeProtoHelper<ProtoHelperNodeContext> {
 
   common::Status GetFusedFuncs(ComputeFunc* compute, CreateFunctionStateFunc* create, DestroyFunctionStateFunc* release) const;
 
+  /** Thread pool shared by the session's kernels to parallelize work within a node. nullptr if single threaded. */
+  WorkStealingThreadPool* GetIntraOpThreadPool() const noexcept;
+
  private:
   ORT_DISALLOW_MOVE(OpKernelInfo);
   ORT_DISALLOW_ASSIGNMENT(OpKernelInfo);
@@ -57,6 +62,7 @@ class OpKernelInfo : public OpNodeProtoHelper<ProtoHelperNodeContext> {
   const std::unordered_map<int, MLValue>& initialized_tensors_;
   const MLValueNameIdxMap& mlvalue_name_idx_map_;
   const FuncManager& funcs_mgr_;
+  WorkStealingThreadPool* intra_op_thread_pool_;
   ProtoHelperNodeContext proto_helper_context_;
 };
 
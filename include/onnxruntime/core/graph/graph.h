@@ -486,6 +486,20 @@ class Graph {
   /** Removes all initializer tensors from this Graph and releases the memory they were using. */
   void CleanAllInitializedTensors() noexcept;
 
+  /** Records where the raw_data of initializers is in the model file the Graph was loaded from, when that file is
+  mapped into memory. The Graph keeps the mapping alive.
+  @param mapped_file The mapping of the model file.
+  @param locations Initializer name to the address and length of its raw_data in the mapping.
+  */
+  void SetMappedInitializerData(std::shared_ptr<void> mapped_file,
+                                std::unordered_map<std::string, std::pair<const void*, size_t>> locations);
+
+  /** Gets the raw_data of an initializer in the mapped model file.
+  @param[out] length Set to the length of the data.
+  @returns The address of the data, or nullptr if the initializer isn't in a mapped file or has been replaced since.
+  */
+  const void* GetMappedInitializerData(const std::string& tensor_name, size_t& length) const;
+
   /** Gets the Graph inputs excluding initializers. 
   These are the required inputs to the Graph as the initializers can be optionally overridden via graph inputs.
   @remarks Contains no nullptr values. */
@@ -498,6 +512,11 @@ class Graph {
     return graph_inputs_including_initializers_;
   }
 
+  /** Returns true if an initializer that is also a Graph input can be overridden by a value fed for that input.
+  From IR version 4 initializers don't need to be Graph inputs, so one that is listed as an input is a default value.
+  Before that every initializer had to be listed as an input, and they are treated as constant. */
+  bool CanOverrideInitializer() const noexcept { return ir_version_ >= 4; }
+
   /** Gets the Graph outputs.
   @remarks Contains no nullptr values.*/
   const std::vector<const NodeArg*>& GetOutputs() const noexcept { return graph_outputs_; }
@@ -572,6 +591,13 @@ class Graph {
     return *(result.first->second);
   }
 
+  /** Replaces the type and shape of a NodeArg in this Graph, e.g. when a transformer replaces the Node that
+  produces a graph output with one that has a different output type.
+  @param arg The NodeArg to change. Must be owned by this Graph.
+  @param type_proto The new type.
+  */
+  void SetNodeArgType(NodeArg& arg, const ONNX_NAMESPACE::TypeProto& type_proto);
+
   /** Generate a unique name.in this Graph for a NodeArg */
   std::string GenerateNodeArgName(const std::string& base_name);
 
@@ -919,6 +945,10 @@ class Graph {
   InitializedTensorSet name_to_initial_tensor_;
   std::vector<int> removed_initializer_indexes_;
 
+  // the model file if it was mapped into memory, and where the raw_data of the initializers loaded from it is
+  std::shared_ptr<void> mapped_file_;
+  std::unordered_map<std::string, std::pair<const void*, size_t>> mapped_initializer_data_;
+
   Type graph_type_ = Type::Main;
 
   IOnnxRuntimeOpSchemaCollectionPtr schema_registry_;
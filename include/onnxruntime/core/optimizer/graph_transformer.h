@@ -38,7 +38,18 @@ class GraphTransformer {
   */
   common::Status Apply(Graph& graph, bool& modified) const;
 
+  /** Gets the number of rewrites, such as fused or folded nodes, made by the last call to Apply. A transformer is
+  applied to one Graph at a time. */
+  int NumRewrites() const noexcept {
+    return num_rewrites_;
+  }
+
  protected:
+  /** Count rewrites made by ApplyImpl, for profiling. */
+  void RecordRewrites(int count = 1) const noexcept {
+    num_rewrites_ += count;
+  }
+
   /** Helper method to call ApplyImpl on any subgraphs in the Node. */
   common::Status Recurse(Node& node, bool& modified, int graph_level) const {
     int subgraph_level = ++graph_level;
@@ -64,6 +75,8 @@ class GraphTransformer {
 
   const std::string name_;
   const std::string desc_;
+
+  mutable int num_rewrites_ = 0;
 };
 
 /**
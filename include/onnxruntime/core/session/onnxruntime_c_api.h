@@ -142,6 +142,7 @@ ORT_RUNTIME_CLASS(RunOptions);
 ORT_RUNTIME_CLASS(TypeInfo);
 ORT_RUNTIME_CLASS(TensorTypeAndShapeInfo);
 ORT_RUNTIME_CLASS(SessionOptions);
+ORT_RUNTIME_CLASS(RunPlan);
 
 // When passing in an allocator to any ORT function, be sure that the allocator object
 // is not destroyed until the last allocated object using it is freed.
@@ -170,6 +171,15 @@ ORT_API_STATUS(OrtCreateEnvWithCustomLogger, OrtLoggingFunction logging_function
                _In_ const char* logid,
                _Out_ OrtEnv** out);
 
+/**
+ * Memory used by the initializers that the sessions created in env with OrtEnableSharedInitializers share.
+ * \param num_tensors, num_bytes The distinct tensors held for those sessions, and their size.
+ * \param num_references, num_referenced_bytes The initializers of those sessions that use them, and the size they
+ * would have if each session held its own copy.
+ */
+ORT_API_STATUS(OrtGetSharedInitializerStats, _In_ OrtEnv* env, _Out_ size_t* num_tensors, _Out_ size_t* num_bytes,
+               _Out_ size_t* num_references, _Out_ size_t* num_referenced_bytes);
+
 // TODO: document the path separator convention? '/' vs '\'
 // TODO: should specify the access characteristics of model_path. Is this read only during the
 // execution of OrtCreateSession, or does the OrtSession retain a handle to the file/directory
@@ -184,6 +194,25 @@ ORT_API_STATUS(OrtRun, _Inout_ OrtSession* sess,
                _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
                _In_ const char* const* output_names, size_t output_names_len, _Out_ OrtValue** output);
 
+/**
+ * Resolve the input and output names once for repeated calls to OrtRunWithPlan with the same inputs and outputs,
+ * so those calls don't need to look up any names.
+ * \param out should be freed by OrtReleaseRunPlan after use, and must not be used after the session is released.
+ * It can be used by multiple threads at once. Running it with a different session fails.
+ */
+ORT_API_STATUS(OrtCreateRunPlan, _In_ OrtSession* sess,
+               _In_ const char* const* input_names, size_t input_len,
+               _In_ const char* const* output_names, size_t output_names_len, _Out_ OrtRunPlan** out);
+
+/**
+ * Same as OrtRun, with the inputs and outputs in the order of the names the run plan was created with.
+ * \param input should have an entry for each input name in the run plan.
+ * \param output should have an entry for each output name in the run plan.
+ */
+ORT_API_STATUS(OrtRunWithPlan, _Inout_ OrtSession* sess,
+               _In_ OrtRunOptions* run_options, _In_ const OrtRunPlan* run_plan,
+               _In_ const OrtValue* const* input, _Out_ OrtValue** output);
+
 /**
  * \return A pointer of the newly created object. The pointer should be freed by OrtReleaseSessionOptions after use
  */
@@ -211,6 +240,56 @@ ORT_API(void, OrtDisableMemPattern, _In_ OrtSessionOptions* options);
 ORT_API(void, OrtEnableCpuMemArena, _In_ OrtSessionOptions* options);
 ORT_API(void, OrtDisableCpuMemArena, _In_ OrtSessionOptions* options);
 
+// Map a model loaded from a file path into memory instead of reading it, so the CPU tensors for its initializers
+// use the file's pages in place. The file must not change while the session exists.
+ORT_API(void, OrtEnableModelFileMapping, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableModelFileMapping, _In_ OrtSessionOptions* options);
+
+// Share the CPU initializers with raw data with the other sessions created in the same OrtEnv that enable this,
+// so sessions of the same model, or of models with initializers in common, hold one copy of each between them.
+ORT_API(void, OrtEnableSharedInitializers, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableSharedInitializers, _In_ OrtSessionOptions* options);
+
+// How an arena sizes the memory it adds when it runs out.
+typedef enum OrtArenaExtendStrategy {
+  OrtArenaExtendNextPowerOfTwo = 0,  // double the size of each addition
+  OrtArenaExtendSameAsRequested = 1  // add exactly what the allocation needs
+} OrtArenaExtendStrategy;
+
+// Limit of the memory the CPU arena allocates. A run that needs more fails. 0 for no limit.
+ORT_API(void, OrtSetCpuMemArenaMaxBytes, _In_ OrtSessionOptions* options, size_t max_bytes);
+
+// \return 0 if success, -1 for an unknown strategy
+ORT_API(int, OrtSetCpuMemArenaExtendStrategy, _In_ OrtSessionOptions* options, enum OrtArenaExtendStrategy strategy);
+
+// Return the memory the arenas aren't using to the system when the session's last run in progress finishes and
+// they have more than the min free bytes free. The execution frames pooled for later runs are kept.
+ORT_API(void, OrtEnableMemArenaShrinkOnIdle, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableMemArenaShrinkOnIdle, _In_ OrtSessionOptions* options);
+
+// The free bytes of the arenas below which shrinking on idle is skipped. 64 MB by default.
+ORT_API(void, OrtSetMemArenaShrinkOnIdleMinFreeBytes, _In_ OrtSessionOptions* options, size_t min_free_bytes);
+
+// The graph transformers applied when the session is initialized. Each level includes the ones below it.
+typedef enum OrtGraphOptimizationLevel {
+  OrtGraphOptimizationNone = 0,      // only the transformers registered by the application
+  OrtGraphOptimizationBasic = 1,     // node eliminations and constant folding into Conv, producing standard ONNX ops
+  OrtGraphOptimizationExtended = 2,  // fusions into larger kernels, some of which only run on CPU
+  OrtGraphOptimizationLayout = 3     // convolutions in the processor specific NCHWc layout, which only run on CPU
+} OrtGraphOptimizationLevel;
+
+// \return 0 if success, -1 for an unknown level
+ORT_API(int, OrtSetSessionGraphOptimizationLevel, _In_ OrtSessionOptions* options, enum OrtGraphOptimizationLevel level);
+
+// Return the output of the ZipMap nodes that are graph outputs as one batch of maps that share their keys, instead of
+// a sequence of maps. Read it with OrtGetSharedKeyMaps.
+ORT_API(void, OrtEnableZipMapSharedKeys, _In_ OrtSessionOptions* options);
+ORT_API(void, OrtDisableZipMapSharedKeys, _In_ OrtSessionOptions* options);
+
+// save the model after the graph transformations and the assignment of nodes to execution providers, so a session
+// that loads it can skip them. that session must use the same execution providers.
+ORT_API(void, OrtSetOptimizedModelFilePath, _In_ OrtSessionOptions* options, _In_ const char* optimized_model_filepath);
+
 // < logger id to use for session output
 ORT_API(void, OrtSetSessionLogId, _In_ OrtSessionOptions* options, const char* logid);
 
@@ -220,6 +299,10 @@ ORT_API(void, OrtSetSessionLogVerbosityLevel, _In_ OrtSessionOptions* options, u
 // How many threads in the session thread pool.
 ORT_API(int, OrtSetSessionThreadPoolSize, _In_ OrtSessionOptions* options, int session_thread_pool_size);
 
+// How many threads, including the calling thread, may be used to execute a single node.
+// The total number of threads used by a session is capped at the number of hardware threads.
+ORT_API(int, OrtSetIntraOpNumThreads, _In_ OrtSessionOptions* options, int intra_op_num_threads);
+
 /**
   * To use additional providers, you must build ORT with the extra providers enabled. Then call one of these
   * functions to enable them in the session:
@@ -233,6 +316,29 @@ ORT_API(int, OrtSetSessionThreadPoolSize, _In_ OrtSessionOptions* options, int s
 
 ORT_API(void, OrtAppendCustomOpLibPath, _In_ OrtSessionOptions* options, const char* lib_path);
 
+/**
+ * Return the memory the session's arenas aren't using to the system.
+ * The execution frames the session pools for later runs are released first. If the CPU arena caches small blocks
+ * per thread, only the blocks cached by the calling thread are returned.
+ * \param released_bytes optional, the number of bytes released
+ */
+ORT_API_STATUS(OrtSessionShrinkMemoryArenas, _Inout_ OrtSession* sess, _Out_opt_ size_t* released_bytes);
+
+typedef struct OrtArenaStats {
+  int64_t bytes_limit;            // 0 if there's no limit
+  int64_t total_allocated_bytes;  // allocated by the arena from the system
+  int64_t bytes_in_use;
+  int64_t max_bytes_in_use;
+  int64_t num_allocs;
+  int64_t num_extensions;  // number of times the arena allocated more memory
+  int64_t num_shrinkages;  // number of times the arena returned memory
+} OrtArenaStats;
+
+/**
+ * Get the statistics of the CPU memory arena. They're all 0 if the arena is disabled.
+ */
+ORT_API_STATUS(OrtSessionGetCpuArenaStats, _In_ const OrtSession* sess, _Out_ OrtArenaStats* out);
+
 ORT_API_STATUS(OrtSessionGetInputCount, _In_ const OrtSession* sess, _Out_ size_t* out);
 ORT_API_STATUS(OrtSessionGetOutputCount, _In_ const OrtSession* sess, _Out_ size_t* out);
 
@@ -367,6 +473,16 @@ ORT_API_STATUS(OrtGetTypeInfo, _In_ const OrtValue* value, OrtTypeInfo** out);
 
 ORT_API(enum ONNXType, OrtGetValueType, _In_ const OrtValue* value);
 
+/**
+ * Read a batch of maps that share their keys, which a ZipMap graph output is when OrtEnableZipMapSharedKeys is set.
+ * Its OrtGetValueType is ONNX_TYPE_OPAQUE.
+ * \param keys A tensor of shape [K], string or int64, of the keys of all the maps.
+ * \param values A float tensor of shape [N, K], with the values of each of the N maps in the order of the keys.
+ * keys and values should be freed by OrtReleaseValue. They don't copy the data, so they're only valid until the
+ * backing OrtValue is freed.
+ */
+ORT_API_STATUS(OrtGetSharedKeyMaps, _In_ const OrtValue* value, _Out_ OrtValue** keys, _Out_ OrtValue** values);
+
 typedef enum OrtAllocatorType {
   OrtDeviceAllocator = 0,
   OrtArenaAllocator = 1
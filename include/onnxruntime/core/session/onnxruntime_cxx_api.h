@@ -87,6 +87,10 @@ class SessionOptionsWrapper {
   ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableMemPattern)
   ORT_REDIRECT_SIMPLE_FUNCTION_CALL(EnableCpuMemArena)
   ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableCpuMemArena)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(EnableSharedInitializers)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableSharedInitializers)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(EnableZipMapSharedKeys)
+  ORT_REDIRECT_SIMPLE_FUNCTION_CALL(DisableZipMapSharedKeys)
   void EnableProfiling(_In_ const char* profile_file_prefix) {
     OrtEnableProfiling(value.get(), profile_file_prefix);
   }
@@ -100,6 +104,9 @@ class SessionOptionsWrapper {
   void SetSessionThreadPoolSize(int session_thread_pool_size) {
     OrtSetSessionThreadPoolSize(value.get(), session_thread_pool_size);
   }
+  void SetIntraOpNumThreads(int intra_op_num_threads) {
+    OrtSetIntraOpNumThreads(value.get(), intra_op_num_threads);
+  }
 
   SessionOptionsWrapper clone() const {
     OrtSessionOptions* p = OrtCloneSessionOptions(value.get());
@@ -3,6 +3,7 @@
 
 #include "bahdanau_attention.h"
 #include "core/providers/cpu/rnn/rnn_helpers.h"
+#include "core/mlas/inc/mlas.h"
 
 #include <stdexcept>
 #include <memory.h>
@@ -79,28 +80,9 @@ void BahdanauAttention<T>::PrepareMemory(
                                keys_.data(), attn_depth_, &CPUMathUtil::Instance());
 }
 
-template <typename T>
-static void SoftmaxInplace(const gsl::span<T>& alignments) {
-  T* x = alignments.data();
-  size_t len = alignments.size();
-
-  double sum = 0.0;
-
-  for (size_t i = 0; i < len; i++) {
-    T e = exp(x[i]);
-    sum += e;
-    x[i] = e;
-  }
-
-  if (sum == 0.0) {
-    for (size_t i = 0; i < len; i++) {
-      x[i] = static_cast<T>(1.0 / len);
-    }
-  } else {
-    for (size_t i = 0; i < len; i++) {
-      x[i] = static_cast<T>(x[i] / sum);
-    }
-  }
+// the max of the alignments is subtracted before the exponentials, so the sum can't be zero
+static void SoftmaxInplace(const gsl::span<float>& alignments) {
+  MlasComputeSoftmax(alignments.data(), alignments.data(), 1, alignments.size(), false);
 }
 
 /**
@@ -142,16 +124,15 @@ void BahdanauAttention<T>::Compute(
     }
 
     SoftmaxInplace(gsl::span<T>{alignments, mem_steps});
-
-    // Calculate the context
-    auto outspan = output.subspan(b * memory_depth_);
-    auto values = values_.subspan(b * max_memory_steps_ * memory_depth_);
-    math::GemmEx<T, CPUMathUtil>(CblasNoTrans, CblasNoTrans,
-                                 1, memory_depth_, max_memory_steps_, T{1.0},
-                                 alignments, max_memory_steps_,
-                                 values.data(), memory_depth_, T{0.0},
-                                 outspan.data(), memory_depth_, &CPUMathUtil::Instance());
   }
+
+  // Calculate the context of each batch entry from its alignments and values
+  math::GemmStridedBatched<T, CPUMathUtil>(CblasNoTrans, CblasNoTrans,
+                                           1, memory_depth_, max_memory_steps_, T{1.0},
+                                           aligns.data(), max_memory_steps_, max_memory_steps_,
+                                           values_.data(), memory_depth_, max_memory_steps_ * memory_depth_, T{0.0},
+                                           output.data(), memory_depth_, memory_depth_,
+                                           batch_size_, &CPUMathUtil::Instance());
 }
 
 template class BahdanauAttention<float>;
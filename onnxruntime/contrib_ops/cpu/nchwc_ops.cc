@@ -0,0 +1,310 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "nchwc_ops.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    ReorderInput,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    ReorderInput);
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    ReorderOutput,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    ReorderOutput);
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    NchwcConv,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcConv);
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    NchwcMaxPool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcPool);
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    NchwcAveragePool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcPool);
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    NchwcGlobalMaxPool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcPool);
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    NchwcGlobalAveragePool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcPool);
+
+static int64_t RoundUpToBlockSize(int64_t channels) {
+  const auto block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  return (channels + block_size - 1) / block_size * block_size;
+}
+
+// A convolution with a single group and fewer input channels than the block size reads the NCHW input, as it
+// would otherwise mostly read padding. The other convolutions read a NCHWc input.
+static bool HasNchwInput(const TensorShape& filter_shape, int64_t group) {
+  return group == 1 && filter_shape[1] < static_cast<int64_t>(MlasNchwcGetBlockSize());
+}
+
+static size_t ReorderedFilterSize(const TensorShape& filter_shape, int64_t group) {
+  const int64_t input_channels = (group == 1 && !HasNchwInput(filter_shape, group))
+                                     ? RoundUpToBlockSize(filter_shape[1])
+                                     : filter_shape[1];
+  return static_cast<size_t>(RoundUpToBlockSize(filter_shape[0]) * input_channels * filter_shape.SizeFromDimension(2));
+}
+
+static void ReorderFilter(const TensorShape& filter_shape, int64_t group, const float* filter, float* reordered) {
+  if (group == 1 && !HasNchwInput(filter_shape, group)) {
+    MlasReorderFilterOIHWBiBo(filter_shape.GetDims().data(), filter, reordered);
+  } else {
+    MlasReorderFilterOIHWBo(filter_shape.GetDims().data(), filter, reordered);
+  }
+}
+
+static void PadBias(int64_t output_channels, const float* bias, float* padded) {
+  const int64_t padded_channels = RoundUpToBlockSize(output_channels);
+  std::copy_n(bias, output_channels, padded);
+  std::fill(padded + output_channels, padded + padded_channels, 0.0f);
+}
+
+Status ReorderInput::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const auto& X_shape = X->Shape();
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4, "ReorderInput expects a 4D input: ", X_shape.ToString());
+
+  std::vector<int64_t> Y_dims(X_shape.GetDims());
+  Y_dims[1] = RoundUpToBlockSize(Y_dims[1]);
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+
+  MlasReorderInput(X_shape.GetDims().data(), X->template Data<float>(), Y->template MutableData<float>());
+  return Status::OK();
+}
+
+Status ReorderOutput::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const auto& X_shape = X->Shape();
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4, "ReorderOutput expects a 4D input: ", X_shape.ToString());
+  ORT_RETURN_IF_NOT(X_shape[1] == RoundUpToBlockSize(channels_),
+                    "ReorderOutput input has ", X_shape[1], " channels, which don't hold ", channels_);
+
+  std::vector<int64_t> Y_dims(X_shape.GetDims());
+  Y_dims[1] = channels_;
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+
+  MlasReorderOutput(Y_dims.data(), X->template Data<float>(), Y->template MutableData<float>());
+  return Status::OK();
+}
+
+Status NchwcConv::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+
+  if (input_idx == 1) {
+    const auto& filter_shape = tensor.Shape();
+    if (filter_shape.NumDimensions() != 4) {
+      return Status::OK();
+    }
+
+    packed_filter_ = BufferUniquePtr(alloc->Alloc(sizeof(float) * ReorderedFilterSize(filter_shape, group_)),
+                                     BufferDeleter(alloc));
+    ReorderFilter(filter_shape, group_, tensor.Data<float>(), static_cast<float*>(packed_filter_.get()));
+    packed_filter_shape_ = filter_shape;
+    is_packed = true;
+  } else if (input_idx == 2) {
+    const int64_t output_channels = tensor.Shape().Size();
+    packed_bias_ = BufferUniquePtr(alloc->Alloc(sizeof(float) * RoundUpToBlockSize(output_channels)),
+                                   BufferDeleter(alloc));
+    PadBias(output_channels, tensor.Data<float>(), static_cast<float*>(packed_bias_.get()));
+    is_packed = true;
+  }
+
+  return Status::OK();
+}
+
+Status NchwcConv::Compute(OpKernelContext* context) const {
+  const size_t num_inputs = OpKernel::Node().InputDefs().size();
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = packed_filter_ ? nullptr : context->Input<Tensor>(1);
+  const Tensor* B = (packed_bias_ || num_inputs != 3) ? nullptr : context->Input<Tensor>(2);
+
+  const auto& X_shape = X->Shape();
+  const auto& filter_shape = W != nullptr ? W->Shape() : packed_filter_shape_;
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4 && filter_shape.NumDimensions() == 4,
+                    "NchwcConv only supports 2D convolutions. X: ", X_shape.ToString(),
+                    " W: ", filter_shape.ToString());
+
+  const int64_t N = X_shape[0];
+  const int64_t M = filter_shape[0];
+  const int64_t C = filter_shape[1] * group_;
+
+  if (group_ > 1) {
+    ORT_RETURN_IF_NOT(filter_shape[1] == 1 && M == group_,
+                      "NchwcConv only supports depthwise grouped convolutions. W: ", filter_shape.ToString(),
+                      " group: ", group_);
+  }
+
+  const int64_t input_channels = HasNchwInput(filter_shape, group_) ? C : RoundUpToBlockSize(C);
+  ORT_RETURN_IF_NOT(X_shape[1] == input_channels, "NchwcConv expects ", input_channels,
+                    " input channels for the filter ", filter_shape.ToString(), " but has ", X_shape[1]);
+
+  std::vector<int64_t> kernel_shape;
+  ORT_RETURN_IF_ERROR(ComputeKernelShape(filter_shape, kernel_shape));
+
+  std::vector<int64_t> pads(pads_);
+  if (pads.empty()) {
+    pads.resize(kernel_shape.size() * 2, 0);
+  }
+  std::vector<int64_t> dilations(dilations_);
+  if (dilations.empty()) {
+    dilations.resize(kernel_shape.size(), 1);
+  }
+  std::vector<int64_t> strides(strides_);
+  if (strides.empty()) {
+    strides.resize(kernel_shape.size(), 1);
+  }
+
+  std::vector<int64_t> Y_dims({N, RoundUpToBlockSize(M)});
+  ORT_RETURN_IF_ERROR(InferOutputShape(X_shape.Slice(2), kernel_shape, strides, dilations, &pads, &Y_dims));
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+  const float* filter_data = static_cast<const float*>(packed_filter_.get());
+  BufferUniquePtr reordered_filter;
+  if (filter_data == nullptr) {
+    reordered_filter = BufferUniquePtr(alloc->Alloc(sizeof(float) * ReorderedFilterSize(filter_shape, group_)),
+                                       BufferDeleter(alloc));
+    ReorderFilter(filter_shape, group_, W->template Data<float>(), static_cast<float*>(reordered_filter.get()));
+    filter_data = static_cast<const float*>(reordered_filter.get());
+  }
+
+  const float* bias_data = static_cast<const float*>(packed_bias_.get());
+  BufferUniquePtr padded_bias;
+  if (B != nullptr) {
+    padded_bias = BufferUniquePtr(alloc->Alloc(sizeof(float) * Y_dims[1]), BufferDeleter(alloc));
+    PadBias(M, B->template Data<float>(), static_cast<float*>(padded_bias.get()));
+    bias_data = static_cast<const float*>(padded_bias.get());
+  }
+
+  MLAS_ACTIVATION Activation;
+  if (activation_.empty()) {
+    Activation.ActivationKind = MlasIdentityActivation;
+  } else if (activation_ == "Relu") {
+    Activation.ActivationKind = MlasReluActivation;
+  } else if (activation_ == "LeakyRelu") {
+    Activation.ActivationKind = MlasLeakyReluActivation;
+    Activation.alpha = alpha_;
+  } else if (activation_ == "Tanh") {
+    Activation.ActivationKind = MlasTanhActivation;
+  } else if (activation_ == "Sigmoid") {
+    Activation.ActivationKind = MlasLogisticActivation;
+  } else {
+    ORT_NOT_IMPLEMENTED("Not implemented fused activation: ", activation_);
+  }
+
+  MlasNchwcConv(X_shape.GetDims().data(),
+                kernel_shape.data(),
+                dilations.data(),
+                pads.data(),
+                strides.data(),
+                Y_dims.data(),
+                static_cast<size_t>(group_),
+                X->template Data<float>(),
+                filter_data,
+                bias_data,
+                Y->template MutableData<float>(),
+                &Activation);
+
+  return Status::OK();
+}
+
+NchwcPool::NchwcPool(const OpKernelInfo& info) : OpKernel(info) {
+  const auto& op_name = info.GetKernelDef().OpName();
+  global_pooling_ = (op_name == "NchwcGlobalMaxPool" || op_name == "NchwcGlobalAveragePool");
+
+  if (op_name == "NchwcMaxPool" || op_name == "NchwcGlobalMaxPool") {
+    kind_ = MlasMaximumPooling;
+  } else if (info.GetAttrOrDefault<int64_t>("count_include_pad", 0) != 0) {
+    kind_ = MlasAveragePoolingIncludePad;
+  } else {
+    kind_ = MlasAveragePoolingExcludePad;
+  }
+
+  if (!global_pooling_) {
+    ORT_ENFORCE(info.GetAttrs<int64_t>("kernel_shape", kernel_shape_).IsOK() && kernel_shape_.size() == 2,
+                "NchwcPool expects a 2D kernel shape.");
+
+    if (!info.GetAttrs<int64_t>("pads", pads_).IsOK() || pads_.empty()) {
+      pads_.resize(4, 0);
+    }
+
+    if (!info.GetAttrs<int64_t>("strides", strides_).IsOK() || strides_.empty()) {
+      strides_.resize(2, 1);
+    }
+
+    ORT_ENFORCE(pads_.size() == 4 && strides_.size() == 2);
+    for (size_t dim = 0; dim < 2; ++dim) {
+      ORT_ENFORCE(kernel_shape_[dim] > 0);
+      ORT_ENFORCE(pads_[dim] < kernel_shape_[dim] && pads_[dim + 2] < kernel_shape_[dim],
+                  "Pad should be smaller than kernel.");
+    }
+  }
+}
+
+Status NchwcPool::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const auto& X_shape = X->Shape();
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4, "NchwcPool expects a 4D input: ", X_shape.ToString());
+
+  std::vector<int64_t> Y_dims({X_shape[0], X_shape[1], 1, 1});
+  if (!global_pooling_) {
+    for (size_t dim = 0; dim < 2; ++dim) {
+      Y_dims[dim + 2] = (X_shape[dim + 2] + pads_[dim] + pads_[dim + 2] - kernel_shape_[dim]) / strides_[dim] + 1;
+      ORT_RETURN_IF_NOT(Y_dims[dim + 2] > 0, "Invalid input shape: ", X_shape.ToString());
+    }
+  }
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+
+  MlasNchwcPool(kind_,
+                X_shape.GetDims().data(),
+                global_pooling_ ? nullptr : kernel_shape_.data(),
+                global_pooling_ ? nullptr : pads_.data(),
+                global_pooling_ ? nullptr : strides_.data(),
+                Y_dims.data(),
+                X->template Data<float>(),
+                Y->template MutableData<float>());
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/nn/conv_base.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+/*
+The Nchwc ops work on tensors in the NCHWc layout used by MLAS: the channels are split into blocks of
+MlasNchwcGetBlockSize() channels, which are stored next to each other for each spatial position. A tensor in this
+layout has the shape {N, C, H, W} of the NCHW tensor it holds, with C padded to a multiple of the block size.
+The NchwcTransformer inserts these ops; the block size depends on the processor.
+*/
+
+class ReorderInput final : public OpKernel {
+ public:
+  explicit ReorderInput(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+class ReorderOutput final : public OpKernel {
+ public:
+  explicit ReorderOutput(const OpKernelInfo& info) : OpKernel(info) {
+    ORT_ENFORCE(info.GetAttr<int64_t>("channels", &channels_).IsOK());
+    ORT_ENFORCE(channels_ > 0, "invalid channel count");
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t channels_;
+};
+
+class NchwcConv final : public OpKernel, public ConvBase {
+ public:
+  explicit NchwcConv(const OpKernelInfo& info) : OpKernel(info), ConvBase(info) {
+    activation_ = info.GetAttrOrDefault<std::string>("activation", "");
+    alpha_ = info.GetAttrOrDefault("alpha", 0.01f);
+  }
+
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // the filter and bias when they're constant, reordered and padded for MlasNchwcConv
+  TensorShape packed_filter_shape_;
+  BufferUniquePtr packed_filter_;
+  BufferUniquePtr packed_bias_;
+};
+
+class NchwcPool final : public OpKernel {
+ public:
+  explicit NchwcPool(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  MLAS_POOLING_KIND kind_;
+  bool global_pooling_;
+  std::vector<int64_t> kernel_shape_;
+  std::vector<int64_t> pads_;
+  std::vector<int64_t> strides_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/shared_key_zip_map.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    SharedKeyZipMap,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", std::vector<MLDataType>{DataTypeImpl::GetType<SharedKeyMapsString>(),
+                                                                   DataTypeImpl::GetType<SharedKeyMapsInt64>()}),
+    SharedKeyZipMap);
+
+SharedKeyZipMap::SharedKeyZipMap(const OpKernelInfo& info) : OpKernel(info) {
+  auto classlabels_strings = info.GetAttrsOrDefault<std::string>("classlabels_strings");
+  auto classlabels_int64s = info.GetAttrsOrDefault<int64_t>("classlabels_int64s");
+  ORT_ENFORCE(classlabels_strings.empty() ^ classlabels_int64s.empty(),
+              "Must provide classlabels_strings or classlabels_int64s but not both.");
+  if (!classlabels_strings.empty()) {
+    classlabels_strings_ = std::make_shared<const std::vector<std::string>>(std::move(classlabels_strings));
+  } else {
+    classlabels_int64s_ = std::make_shared<const std::vector<int64_t>>(std::move(classlabels_int64s));
+  }
+}
+
+template <typename K>
+Status SharedKeyZipMap::ComputeImpl(OpKernelContext& context,
+                                    const std::shared_ptr<const std::vector<K>>& keys) const {
+  const Tensor& X = *context.Input<Tensor>(0);
+  const auto& x_dims = X.Shape().GetDims();
+
+  if (x_dims.empty() || x_dims.size() > 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Zipmap only supports 1D or 2D input tensors");
+  }
+
+  const int64_t features_per_batch = x_dims.back();
+  if (features_per_batch != static_cast<int64_t>(keys->size())) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input features_per_batch[", features_per_batch,
+                           "] != number of classlabels[", keys->size(), "]");
+  }
+
+  auto& Z = *context.Output<SharedKeyMaps<K>>(0);
+  Z.keys = keys;
+  const float* x_data = X.Data<float>();
+  Z.values.assign(x_data, x_data + X.Shape().Size());
+
+  return Status::OK();
+}
+
+Status SharedKeyZipMap::Compute(OpKernelContext* context) const {
+  if (classlabels_strings_ != nullptr) {
+    return ComputeImpl(*context, classlabels_strings_);
+  }
+  return ComputeImpl(*context, classlabels_int64s_);
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+/*
+ZipMap of ai.onnx.ml, writing the maps as a SharedKeyMaps batch. The labels are made once, when the kernel is
+created, and every batch shares them, so a run only copies X.
+*/
+class SharedKeyZipMap final : public OpKernel {
+ public:
+  explicit SharedKeyZipMap(const OpKernelInfo& info);
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  template <typename K>
+  Status ComputeImpl(OpKernelContext& context, const std::shared_ptr<const std::vector<K>>& keys) const;
+
+  std::shared_ptr<const std::vector<std::string>> classlabels_strings_;
+  std::shared_ptr<const std::vector<int64_t>> classlabels_int64s_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
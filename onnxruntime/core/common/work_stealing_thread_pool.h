@@ -0,0 +1,481 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+/*
+Thread pool with one lock-free deque per worker.
+
+A worker pushes and pops tasks at the bottom of its own deque without taking any lock, and
+steals from the top of the other workers' deques when it runs out of work. Tasks scheduled from a
+thread that is not a worker of the pool (e.g. the thread calling InferenceSession::Run) go into a
+small shared injection queue, which is the only place a mutex is taken on the hot path.
+
+This is intended for fine grained inter-op scheduling where every task enqueues its successors,
+so the common case is a worker pushing to and popping from its own deque. The same pool type also
+serves as the session wide intra-op pool via ParallelFor, where the calling thread takes part in the
+loop and helpers are only scheduled for the iterations it can't run itself.
+
+Per worker statistics (tasks run, successful steals, time spent idle) are kept in relaxed atomics
+so callers can report them through the profiler.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class WorkStealingThreadPool;
+
+/**
+ * Makes an intra-op thread pool available to code running on the current thread that has no access to the
+ * OpKernelContext, such as the MLAS threading callbacks. Executors create one around OpKernel::Compute.
+ * A scope with a nullptr pool means work on this thread should run single threaded. Scopes nest, and the
+ * previous scope is restored on destruction.
+ */
+class IntraOpThreadPoolScope {
+ public:
+  explicit IntraOpThreadPoolScope(WorkStealingThreadPool* thread_pool)
+      : thread_pool_(thread_pool), previous_(Current()) {
+    Current() = this;
+  }
+
+  ~IntraOpThreadPoolScope() {
+    Current() = previous_;
+  }
+
+  /** The innermost scope on the current thread, or nullptr if there is none. */
+  static const IntraOpThreadPoolScope* GetCurrent() { return Current(); }
+
+  WorkStealingThreadPool* ThreadPool() const { return thread_pool_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IntraOpThreadPoolScope);
+
+  static IntraOpThreadPoolScope*& Current() {
+    static thread_local IntraOpThreadPoolScope* current = nullptr;
+    return current;
+  }
+
+  WorkStealingThreadPool* const thread_pool_;
+  IntraOpThreadPoolScope* const previous_;
+};
+
+/**
+ * Bounded Chase-Lev deque of task pointers.
+ * Push and Pop may only be called by the owning thread. Steal may be called by any thread.
+ * Push returns false when the deque is full so the caller can fall back to another queue.
+ */
+template <typename T>
+class WorkStealingDeque {
+ public:
+  explicit WorkStealingDeque(size_t capacity_log2 = 10)
+      : mask_((static_cast<size_t>(1) << capacity_log2) - 1),
+        buffer_(new std::atomic<T*>[mask_ + 1]) {
+    for (size_t i = 0; i <= mask_; ++i) {
+      buffer_[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  bool Push(T* item) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_acquire);
+    if (bottom - top > static_cast<int64_t>(mask_)) {
+      return false;
+    }
+
+    buffer_[bottom & mask_].store(item, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  T* Pop() {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+
+    T* item = nullptr;
+    if (top <= bottom) {
+      item = buffer_[bottom & mask_].load(std::memory_order_relaxed);
+      if (top == bottom) {
+        // last item. race against any thieves for it.
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+          item = nullptr;
+        }
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+      }
+    } else {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    return item;
+  }
+
+  T* Steal() {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = bottom_.load(std::memory_order_acquire);
+
+    if (top < bottom) {
+      T* item = buffer_[top & mask_].load(std::memory_order_acquire);
+      if (top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return item;
+      }
+    }
+
+    return nullptr;
+  }
+
+  bool Empty() const {
+    return top_.load(std::memory_order_acquire) >= bottom_.load(std::memory_order_acquire);
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(WorkStealingDeque);
+
+  // top_ is written by thieves and bottom_ by the owner, so keep them on separate cache lines.
+  std::atomic<int64_t> top_{0};
+  char padding0_[64 - sizeof(std::atomic<int64_t>)];
+  std::atomic<int64_t> bottom_{0};
+  char padding1_[64 - sizeof(std::atomic<int64_t>)];
+
+  const size_t mask_;
+  std::unique_ptr<std::atomic<T*>[]> buffer_;
+};
+
+class WorkStealingThreadPool {
+ public:
+  using Task = std::function<void()>;
+
+  struct WorkerStats {
+    uint64_t tasks_run = 0;
+    uint64_t steals = 0;
+    uint64_t idle_microseconds = 0;
+  };
+
+  explicit WorkStealingThreadPool(size_t pool_size) {
+    ORT_ENFORCE(pool_size > 0, "WorkStealingThreadPool requires at least one thread.");
+
+    workers_.reserve(pool_size);
+    for (size_t i = 0; i < pool_size; ++i) {
+      workers_.push_back(std::make_unique<Worker>());
+    }
+
+    // start the threads only once all the deques exist as any worker may steal from any other
+    for (size_t i = 0; i < pool_size; ++i) {
+      workers_[i]->thread = std::thread(&WorkStealingThreadPool::WorkerLoop, this, i);
+    }
+  }
+
+  ~WorkStealingThreadPool() {
+    {
+      std::lock_guard<OrtMutex> lock(sleep_mutex_);
+      done_ = true;
+    }
+    wake_cv_.notify_all();
+
+    try {
+      for (auto& worker : workers_) {
+        worker->thread.join();
+      }
+    } catch (const std::exception& ex) {
+      LOGS_DEFAULT(ERROR) << "Exception joining threads in WorkStealingThreadPool: " << ex.what();
+    }
+
+    // anything left was scheduled after shutdown started. discard it.
+    for (auto* task : injection_queue_) {
+      delete task;
+    }
+  }
+
+  /**
+   * Schedule a task. If called from one of this pool's workers the task is pushed to that worker's deque,
+   * otherwise it is added to the shared injection queue.
+   */
+  void Schedule(Task fn) {
+    Task* task = new Task(std::move(fn));
+
+    const PerThread& per_thread = GetPerThread();
+    if (per_thread.pool != this || !workers_[per_thread.index]->deque.Push(task)) {
+      std::lock_guard<OrtMutex> lock(injection_mutex_);
+      injection_queue_.push_back(task);
+      num_injected_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // pairs with the fence in WaitForWork so either we see the sleeper or it sees the new task
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (num_sleeping_.load(std::memory_order_relaxed) > 0) {
+      std::lock_guard<OrtMutex> lock(sleep_mutex_);
+      wake_cv_.notify_one();
+    }
+  }
+
+  /**
+   * Run fn(i) for i in [0, total) and wait for all iterations to complete.
+   * The calling thread runs iterations as well, so this is safe to call from one of the pool's own workers.
+   * The first exception thrown by fn is rethrown on the calling thread once all started iterations finish.
+   */
+  void ParallelFor(int32_t total, const std::function<void(int32_t)>& fn) {
+    if (total <= 0) {
+      return;
+    }
+
+    if (total == 1) {
+      fn(0);
+      return;
+    }
+
+    // helpers may start after the loop is finished so they share ownership of the loop state
+    auto loop = std::make_shared<ParallelForLoop>(total, fn);
+
+    const int32_t num_helpers = static_cast<int32_t>(std::min(static_cast<size_t>(total - 1), workers_.size()));
+    for (int32_t i = 0; i < num_helpers; ++i) {
+      Schedule([loop]() { loop->Run(); });
+    }
+
+    loop->Run();
+
+    std::unique_lock<OrtMutex> lock(loop->mutex);
+    while (loop->completed != total) {
+      loop->cv.wait(lock);
+    }
+
+    if (loop->exception) {
+      std::rethrow_exception(loop->exception);
+    }
+  }
+
+  /** Run fn(i) for i in [0, total) on thread_pool, or serially on the calling thread if thread_pool is nullptr. */
+  static void TryParallelFor(WorkStealingThreadPool* thread_pool, int32_t total,
+                             const std::function<void(int32_t)>& fn) {
+    if (thread_pool) {
+      thread_pool->ParallelFor(total, fn);
+    } else {
+      for (int32_t i = 0; i < total; ++i) {
+        fn(i);
+      }
+    }
+  }
+
+  size_t NumThreads() const { return workers_.size(); }
+
+  /** Index of the calling worker in this pool, or -1 if the caller is not one of its workers. */
+  int CurrentThreadId() const {
+    const PerThread& per_thread = GetPerThread();
+    return per_thread.pool == this ? static_cast<int>(per_thread.index) : -1;
+  }
+
+  /** Cumulative statistics for each worker since the pool was created. */
+  std::vector<WorkerStats> GetStats() const {
+    std::vector<WorkerStats> stats(workers_.size());
+    for (size_t i = 0; i < workers_.size(); ++i) {
+      stats[i].tasks_run = workers_[i]->tasks_run.load(std::memory_order_relaxed);
+      stats[i].steals = workers_[i]->steals.load(std::memory_order_relaxed);
+      stats[i].idle_microseconds = workers_[i]->idle_microseconds.load(std::memory_order_relaxed);
+    }
+    return stats;
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(WorkStealingThreadPool);
+
+  struct Worker {
+    WorkStealingDeque<Task> deque;
+    std::atomic<uint64_t> tasks_run{0};
+    std::atomic<uint64_t> steals{0};
+    std::atomic<uint64_t> idle_microseconds{0};
+    std::thread thread;
+  };
+
+  struct ParallelForLoop {
+    ParallelForLoop(int32_t total_in, const std::function<void(int32_t)>& fn_in) : total(total_in), fn(fn_in) {}
+
+    // claim and run iterations until there are none left
+    void Run() {
+      int32_t num_run = 0;
+      std::exception_ptr error;
+
+      // the pool is already busy with this loop so anything nested, e.g. MLAS calls, runs single threaded
+      IntraOpThreadPoolScope nested_scope(nullptr);
+
+      for (int32_t i = next.fetch_add(1, std::memory_order_relaxed); i < total;
+           i = next.fetch_add(1, std::memory_order_relaxed)) {
+        try {
+          fn(i);
+        } catch (...) {
+          if (!error) {
+            error = std::current_exception();
+          }
+        }
+        ++num_run;
+      }
+
+      if (num_run > 0) {
+        std::lock_guard<OrtMutex> lock(mutex);
+        if (error && !exception) {
+          exception = error;
+        }
+
+        completed += num_run;
+        if (completed == total) {
+          cv.notify_all();
+        }
+      }
+    }
+
+    const int32_t total;
+    // only called for claimed iterations, which ParallelFor waits for, so a reference is safe
+    const std::function<void(int32_t)>& fn;
+    std::atomic<int32_t> next{0};
+
+    OrtMutex mutex;
+    OrtCondVar cv;
+    int32_t completed = 0;         // guarded by mutex
+    std::exception_ptr exception;  // guarded by mutex
+  };
+
+  struct PerThread {
+    const WorkStealingThreadPool* pool = nullptr;
+    size_t index = 0;
+  };
+
+  static PerThread& GetPerThread() {
+    static thread_local PerThread per_thread;
+    return per_thread;
+  }
+
+  Task* TryGetTask(size_t index) {
+    Worker& self = *workers_[index];
+    Task* task = self.deque.Pop();
+    if (task) {
+      return task;
+    }
+
+    // steal, starting from our neighbour so the workers don't all hit the same victim
+    const size_t num_workers = workers_.size();
+    for (size_t i = 1; i < num_workers; ++i) {
+      task = workers_[(index + i) % num_workers]->deque.Steal();
+      if (task) {
+        self.steals.fetch_add(1, std::memory_order_relaxed);
+        return task;
+      }
+    }
+
+    if (num_injected_.load(std::memory_order_relaxed) > 0) {
+      std::lock_guard<OrtMutex> lock(injection_mutex_);
+      if (!injection_queue_.empty()) {
+        task = injection_queue_.front();
+        injection_queue_.pop_front();
+        num_injected_.fetch_sub(1, std::memory_order_relaxed);
+      }
+    }
+
+    return task;
+  }
+
+  bool HasWork() const {
+    if (num_injected_.load(std::memory_order_relaxed) > 0) {
+      return true;
+    }
+
+    for (const auto& worker : workers_) {
+      if (!worker->deque.Empty()) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // Block until there may be work to do. Returns false if the pool is shutting down and there is nothing left.
+  bool WaitForWork() {
+    std::unique_lock<OrtMutex> lock(sleep_mutex_);
+    num_sleeping_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    while (!done_ && !HasWork()) {
+      wake_cv_.wait(lock);
+    }
+
+    num_sleeping_.fetch_sub(1, std::memory_order_relaxed);
+    return !done_ || HasWork();
+  }
+
+  void WorkerLoop(size_t index) {
+    PerThread& per_thread = GetPerThread();
+    per_thread.pool = this;
+    per_thread.index = index;
+
+    Worker& self = *workers_[index];
+
+    while (true) {
+      Task* task = TryGetTask(index);
+
+      if (!task) {
+        auto idle_start = std::chrono::high_resolution_clock::now();
+
+        // spin briefly as a successor task is usually scheduled very soon after we run out of work
+        for (int i = 0; i < kSpinCount && !task; ++i) {
+          std::this_thread::yield();
+          task = TryGetTask(index);
+        }
+
+        bool keep_running = true;
+        while (!task && keep_running) {
+          keep_running = WaitForWork();
+          task = TryGetTask(index);
+        }
+
+        auto idle = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - idle_start);
+        self.idle_microseconds.fetch_add(idle.count(), std::memory_order_relaxed);
+
+        if (!task) {
+          break;
+        }
+      }
+
+      try {
+        (*task)();
+      } catch (const std::exception& ex) {
+        LOGS_DEFAULT(ERROR) << "Exception running WorkStealingThreadPool task: " << ex.what();
+      } catch (...) {
+        LOGS_DEFAULT(ERROR) << "Unknown exception running WorkStealingThreadPool task.";
+      }
+
+      delete task;
+      self.tasks_run.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    per_thread.pool = nullptr;
+  }
+
+  static constexpr int kSpinCount = 64;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  OrtMutex injection_mutex_;
+  std::deque<Task*> injection_queue_;  // guarded by injection_mutex_
+  std::atomic<size_t> num_injected_{0};
+
+  OrtMutex sleep_mutex_;
+  OrtCondVar wake_cv_;
+  std::atomic<int> num_sleeping_{0};
+  bool done_ = false;  // guarded by sleep_mutex_
+};
+
+}  // namespace onnxruntime
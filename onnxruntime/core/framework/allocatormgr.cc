@@ -3,6 +3,7 @@
 
 #include "core/framework/allocatormgr.h"
 #include "core/framework/bfc_arena.h"
+#include "core/framework/thread_caching_arena.h"
 #include <mutex>
 #include <sstream>
 #include <unordered_map>
@@ -14,9 +15,13 @@ using namespace ::onnxruntime::common;
 
 AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id) {
   auto device_allocator = std::unique_ptr<IDeviceAllocator>(info.factory(device_id));
-  if (device_allocator->AllowsArena())
-    return std::shared_ptr<IArenaAllocator>(
-        std::make_unique<BFCArena>(std::move(device_allocator), info.max_mem));
+  if (device_allocator->AllowsArena()) {
+    auto arena = std::make_unique<BFCArena>(std::move(device_allocator), info.max_mem, info.arena_extend_strategy);
+    if (info.use_thread_cache)
+      return std::shared_ptr<IArenaAllocator>(std::make_unique<ThreadCachingArena>(std::move(arena)));
+
+    return std::shared_ptr<IArenaAllocator>(std::move(arena));
+  }
 
   return device_allocator;
 }
@@ -3,12 +3,70 @@
 
 #pragma once
 
+#include <sstream>
 #include <string>
 
 #include "core/common/common.h"
 #include "core/framework/allocator.h"
 
 namespace onnxruntime {
+// Runtime statistics collected by an allocator.
+struct AllocatorStats {
+  int64_t num_allocs;             // Number of allocations.
+  int64_t bytes_in_use;           // Number of bytes in use.
+  int64_t total_allocated_bytes;  // The total number of allocated bytes by the allocator.
+  int64_t max_bytes_in_use;       // The maximum bytes in use.
+  int64_t max_alloc_size;         // The max single allocation seen.
+                                  // The upper limit what the allocator can allocate, if such a limit
+                                  // is known. Certain allocator may return 0 to indicate the limit is
+                                  // unknown.
+  int64_t bytes_limit;
+  // Number of regions an arena has allocated from its device allocator, and returned to it by Shrink.
+  int64_t num_arena_extensions;
+  int64_t num_arena_shrinkages;
+  // Allocations served from and missing a ThreadCachingArena's per-thread caches. 0 for other allocators.
+  int64_t num_cache_hits;
+  int64_t num_cache_misses;
+
+  AllocatorStats() { Clear(); }
+
+  void Clear() {
+    this->num_allocs = 0;
+    this->bytes_in_use = 0;
+    this->max_bytes_in_use = 0;
+    this->max_alloc_size = 0;
+    this->bytes_limit = 0;
+    this->total_allocated_bytes = 0;
+    this->num_arena_extensions = 0;
+    this->num_arena_shrinkages = 0;
+    this->num_cache_hits = 0;
+    this->num_cache_misses = 0;
+  }
+
+  std::string DebugString() const {
+    std::ostringstream ss;
+    ss << "Limit:           " << this->bytes_limit << "\n"
+       << "InUse:          " << this->bytes_in_use << "\n"
+       << "TotalAllocated: " << this->total_allocated_bytes << "\n"
+       << "MaxInUse:       " << this->max_bytes_in_use << "\n"
+       << "NumAllocs:      " << this->num_allocs << "\n"
+       << "MaxAllocSize:   " << this->max_alloc_size << "\n"
+       << "NumExtensions:  " << this->num_arena_extensions << "\n"
+       << "NumShrinkages:  " << this->num_arena_shrinkages << "\n"
+       << "CacheHits:      " << this->num_cache_hits << "\n"
+       << "CacheMisses:    " << this->num_cache_misses << "\n";
+    return ss.str();
+  }
+};
+
+// How an arena sizes the regions it allocates from its device allocator when it needs more memory.
+enum class ArenaExtendStrategy {
+  // double the size of each new region, up to the memory limit. fewer regions, but the last one may be mostly unused.
+  kNextPowerOfTwo = 0,
+  // allocate exactly the size of the request that didn't fit. regions are only as large as needed.
+  kSameAsRequested = 1,
+};
+
 // The interface for arena which manage memory allocations
 // Arena will hold a pool of pre-allocate memories and manage their lifecycle.
 // Need an underline IResourceAllocator to allocate memories.
@@ -28,6 +86,12 @@ class IArenaAllocator : public IAllocator {
   virtual size_t Max() const = 0;
   const OrtAllocatorInfo& Info() const override = 0;
   // allocate host pinned memory?
+
+  // Return the regions that have no memory in use to the device allocator.
+  // Returns the number of bytes released.
+  virtual size_t Shrink() { return 0; }
+
+  virtual void GetStats(AllocatorStats* stats) { stats->Clear(); }
 };
 
 using ArenaPtr = std::shared_ptr<IArenaAllocator>;
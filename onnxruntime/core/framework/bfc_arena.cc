@@ -5,12 +5,15 @@
 
 namespace onnxruntime {
 BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
-                   size_t total_memory)
-    : device_allocator_(std::move(resource_allocator)),
+                   size_t total_memory,
+                   ArenaExtendStrategy extend_strategy)
+    : extend_strategy_(extend_strategy),
+      device_allocator_(std::move(resource_allocator)),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1),
       info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().id, device_allocator_->Info().mem_type) {
   curr_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, size_t{1048576}));
+  initial_region_allocation_bytes_ = curr_region_allocation_bytes_;
 
   // Allocate the requested amount of memory.
   memory_limit_ = total_memory;
@@ -64,17 +67,21 @@ bool BFCArena::Extend(size_t rounded_bytes) {
     return false;
   }
 
-  // If curr_region_allocation_bytes_ is not enough to satisfy the
-  // allocation, keep multiplying by a power of two until that is
-  // sufficient.
+  size_t bytes = rounded_bytes;
   bool increased_allocation = false;
-  while (rounded_bytes > curr_region_allocation_bytes_) {
-    curr_region_allocation_bytes_ *= 2;
-    increased_allocation = true;
+  if (extend_strategy_ == ArenaExtendStrategy::kNextPowerOfTwo) {
+    // If curr_region_allocation_bytes_ is not enough to satisfy the
+    // allocation, keep multiplying by a power of two until that is
+    // sufficient.
+    while (rounded_bytes > curr_region_allocation_bytes_) {
+      curr_region_allocation_bytes_ *= 2;
+      increased_allocation = true;
+    }
+
+    bytes = std::min(curr_region_allocation_bytes_, available_bytes);
   }
 
   // Try allocating.
-  size_t bytes = std::min(curr_region_allocation_bytes_, available_bytes);
   void* mem_addr = device_allocator_->Alloc(bytes);
   if (mem_addr == nullptr && !started_backpedal_) {
     // Only backpedal once.
@@ -94,7 +101,7 @@ bool BFCArena::Extend(size_t rounded_bytes) {
     return false;
   }
 
-  if (!increased_allocation) {
+  if (extend_strategy_ == ArenaExtendStrategy::kNextPowerOfTwo && !increased_allocation) {
     // Increase the region size of the next required allocation.
     curr_region_allocation_bytes_ *= 2;
   }
@@ -103,6 +110,7 @@ bool BFCArena::Extend(size_t rounded_bytes) {
                      << " bytes.";
 
   stats_.total_allocated_bytes += bytes;
+  ++stats_.num_arena_extensions;
   LOGS_DEFAULT(INFO) << "Total allocated bytes: "
                      << stats_.total_allocated_bytes;
 
@@ -168,7 +176,17 @@ void* BFCArena::Reserve(size_t size) {
     return nullptr;
 
   std::lock_guard<OrtMutex> lock(lock_);
+  if (size > memory_limit_ - static_cast<size_t>(stats_.total_allocated_bytes)) {
+    LOGS_DEFAULT(WARNING) << "BFC Arena can't reserve " << size << " bytes without exceeding its limit of "
+                          << memory_limit_ << " bytes. " << stats_.total_allocated_bytes << " bytes are allocated.";
+    return nullptr;
+  }
+
   void* ptr = device_allocator_->Alloc(size);
+  if (ptr == nullptr) {
+    return nullptr;
+  }
+
   ORT_ENFORCE(reserved_chunks_.find(ptr) == reserved_chunks_.end());
   reserved_chunks_.insert(std::pair<void*, size_t>(ptr, size));
   stats_.bytes_in_use += size;
@@ -235,6 +253,44 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   return nullptr;
 }
 
+size_t BFCArena::Shrink() {
+  std::lock_guard<OrtMutex> lock(lock_);
+
+  // a region with nothing in use has been coalesced back into a single free chunk
+  std::vector<void*> free_regions;
+  for (const auto& region : region_manager_.regions()) {
+    ChunkHandle h = region_manager_.get_handle(region.ptr());
+    const Chunk* c = ChunkFromHandle(h);
+    if (!c->in_use() && c->size == region.memory_size()) {
+      free_regions.push_back(region.ptr());
+    }
+  }
+
+  size_t released_bytes = 0;
+  for (void* ptr : free_regions) {
+    ChunkHandle h = region_manager_.get_handle(ptr);
+    const size_t bytes = ChunkFromHandle(h)->size;
+    RemoveFreeChunkFromBin(h);
+    DeleteChunk(h);
+    region_manager_.RemoveAllocationRegion(ptr);
+    device_allocator_->Free(ptr);
+
+    released_bytes += bytes;
+    stats_.total_allocated_bytes -= bytes;
+    ++stats_.num_arena_shrinkages;
+  }
+
+  if (!free_regions.empty()) {
+    // grow from the initial size again rather than from the size of the released regions
+    curr_region_allocation_bytes_ = initial_region_allocation_bytes_;
+    started_backpedal_ = false;
+    LOGS_DEFAULT(INFO) << "Released " << free_regions.size() << " regions of " << released_bytes << " bytes. "
+                       << "Total allocated bytes: " << stats_.total_allocated_bytes;
+  }
+
+  return released_bytes;
+}
+
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<OrtMutex> lock(lock_);
   *stats = stats_;
@@ -329,6 +385,19 @@ void BFCArena::Free(void* p) {
     return;
   }
   std::lock_guard<OrtMutex> lock(lock_);
+  FreeInternal(p);
+}
+
+void BFCArena::FreeBatch(const std::vector<void*>& ptrs) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (void* p : ptrs) {
+    if (p != nullptr) {
+      FreeInternal(p);
+    }
+  }
+}
+
+void BFCArena::FreeInternal(void* p) {
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
     device_allocator_->Free(it->first);
@@ -460,6 +460,12 @@ ORT_REGISTER_SEQ(VectorDouble);
 ORT_REGISTER_SEQ(VectorMapStringToFloat);
 ORT_REGISTER_SEQ(VectorMapInt64ToFloat);
 
+extern const char kSharedKeyMapsDomain[] = "com.microsoft";
+extern const char kSharedKeyMapsStringName[] = "SharedKeyMapsString";
+extern const char kSharedKeyMapsInt64Name[] = "SharedKeyMapsInt64";
+ORT_REGISTER_OPAQUE_TYPE(SharedKeyMapsString, kSharedKeyMapsDomain, kSharedKeyMapsStringName);
+ORT_REGISTER_OPAQUE_TYPE(SharedKeyMapsInt64, kSharedKeyMapsDomain, kSharedKeyMapsInt64Name);
+
 // Used for Tensor Proto registrations
 #define REGISTER_TENSOR_PROTO(TYPE, reg_fn)                  \
   {                                                          \
@@ -507,6 +513,9 @@ void RegisterAllProtos(const std::function<void(MLDataType)>& reg_fn) {
 
   REGISTER_ONNX_PROTO(VectorMapStringToFloat, reg_fn);
   REGISTER_ONNX_PROTO(VectorMapInt64ToFloat, reg_fn);
+
+  REGISTER_ONNX_PROTO(SharedKeyMapsString, reg_fn);
+  REGISTER_ONNX_PROTO(SharedKeyMapsInt64, reg_fn);
 }
 }  // namespace data_types_internal
 
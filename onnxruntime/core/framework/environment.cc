@@ -3,6 +3,7 @@
 
 #include "core/framework/environment.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/shared_initializer_cache.h"
 #include "core/graph/constants.h"
 #include "core/graph/contrib_ops/contrib_defs.h"
 #include "core/graph/op.h"
@@ -95,6 +96,8 @@ Internal copy node
 Internal copy node
 )DOC");
 
+    shared_initializer_cache_ = std::make_shared<SharedInitializerCache>();
+
     is_initialized_ = true;
   } catch (std::exception& ex) {
     status = Status{ONNXRUNTIME, common::RUNTIME_EXCEPTION, std::string{"Exception caught: "} + ex.what()};
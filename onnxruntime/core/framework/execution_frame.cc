@@ -21,44 +21,138 @@ ExecutionFrame::ExecutionFrame(const std::unordered_map<std::string, MLValue>& f
                                const std::vector<MLValue>& fetches,
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                                const SessionState& session_state)
+    : ExecutionFrame(session_state) {
+  Reset(feeds, output_names, fetches, fetch_allocators);
+}
+
+ExecutionFrame::ExecutionFrame(const SessionState& session_state)
     : node_index_info_(session_state.GetNodeIndexInfo()),
       session_state_(session_state),
       mem_patterns_(nullptr),
       planner_(nullptr) {
+  all_values_.resize(session_state_.GetMLValueNameIdxMap().MaxIdx() + 1);
+}
+
+void ExecutionFrame::Reset(const std::unordered_map<std::string, MLValue>& feeds,
+                           const std::vector<std::string>& output_names,
+                           const std::vector<MLValue>& fetches,
+                           const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
   Init(feeds, output_names, fetches, fetch_allocators);
 
   // If the session enable memory pattern optimization
   // and we have execution plan generated, try to setup
   // memory pattern optimization.
-  if (session_state.GetEnableMemoryPattern() &&
-      session_state.GetExecutionPlan()) {
-    std::vector<TensorShape> input_shapes;
-    bool all_tensors = true;
-    for (const auto& feed : feeds) {
-      if (!(feed.second.IsTensor())) {
-        all_tensors = false;
-        break;
-      }
-      auto& tensor = feed.second.Get<Tensor>();
-      input_shapes.push_back(tensor.Shape());
+  if (session_state_.GetEnableMemoryPattern() &&
+      session_state_.GetExecutionPlan()) {
+    BindMemoryPatterns(feeds);
+  }
+}
+
+void ExecutionFrame::Reset(const FeedsFetchesInfo& feeds_fetches_info,
+                           const std::vector<MLValue>& feeds,
+                           const std::vector<MLValue>& fetches,
+                           const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  Init(feeds_fetches_info, feeds, fetches, fetch_allocators);
+
+  if (session_state_.GetEnableMemoryPattern() &&
+      session_state_.GetExecutionPlan()) {
+    BindMemoryPatterns(feeds);
+  }
+}
+
+void ExecutionFrame::Release() {
+  // assigning an empty MLValue keeps the vector's storage
+  for (auto& value : all_values_) {
+    value = MLValue();
+  }
+
+  custom_allocators_.clear();
+  fetch_mlvalue_idxs_.clear();
+  output_indices_.clear();
+  planner_.reset();
+  status_ = Status::OK();
+}
+
+static const MLValue& FeedValue(const std::pair<const std::string, MLValue>& feed) { return feed.second; }
+static const MLValue& FeedValue(const MLValue& feed) { return feed; }
+
+template <typename TFeeds>
+bool ExecutionFrame::InputShapesMatchBoundPatterns(const TFeeds& feeds) const {
+  if (mem_patterns_ == nullptr || bound_input_shapes_.size() != feeds.size()) {
+    return false;
+  }
+
+  size_t i = 0;
+  for (const auto& feed : feeds) {
+    const MLValue& value = FeedValue(feed);
+    if (!value.IsTensor() || value.Get<Tensor>().Shape() != bound_input_shapes_[i++]) {
+      return false;
     }
-    // if there is some traditional ml value type in inputs
-    // disable the memory pattern optimization.
-    if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(input_shapes);
-      // if no existing patterns, generate one in this executionframe
-      if (!mem_patterns_) {
-        planner_ = std::make_unique<MLValuePatternPlanner>(*session_state.GetExecutionPlan());
-      } else {
-        // pre-allocate the big chunk requested in memory pattern.
-        // all the internal kernel's input/output tensors will be allocated on these buffer.
-        for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
-          ORT_ENFORCE(buffers_.find(mem_patterns_->locations[i]) == buffers_.end());
-          AllocatorPtr alloc = GetAllocator(mem_patterns_->locations[i]);
-          void* buffer = mem_patterns_->patterns[i].PeakSize() > 0 ? alloc->Alloc(mem_patterns_->patterns[i].PeakSize()) : nullptr;
-          buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(buffer, alloc);
-        }
+  }
+
+  return true;
+}
+
+template <typename TFeeds>
+void ExecutionFrame::BindMemoryPatterns(const TFeeds& feeds) {
+  // a pooled frame that ran with the same input shapes last time already has the buffers it needs
+  if (InputShapesMatchBoundPatterns(feeds)) {
+    return;
+  }
+
+  bound_input_shapes_.clear();
+
+  bool all_tensors = true;
+  for (const auto& feed : feeds) {
+    const MLValue& value = FeedValue(feed);
+    if (!(value.IsTensor())) {
+      all_tensors = false;
+      break;
+    }
+    auto& tensor = value.Get<Tensor>();
+    bound_input_shapes_.push_back(tensor.Shape());
+  }
+
+  // if there is some traditional ml value type in inputs
+  // disable the memory pattern optimization.
+  if (!all_tensors) {
+    bound_input_shapes_.clear();
+    mem_patterns_ = nullptr;
+    buffers_.clear();
+    return;
+  }
+
+  auto mem_patterns = session_state_.GetMemoryPatternGroup(bound_input_shapes_);
+
+  // inputs with different shapes in the same dim buckets share a pattern, so the buffers may already be bound.
+  // retry if allocating one of them failed last time.
+  if (mem_patterns && mem_patterns == mem_patterns_ && buffers_.size() == mem_patterns_->locations.size()) {
+    return;
+  }
+
+  mem_patterns_ = std::move(mem_patterns);
+  buffers_.clear();
+
+  // if no existing patterns, generate one in this executionframe
+  if (!mem_patterns_) {
+    planner_ = std::make_unique<MLValuePatternPlanner>(*session_state_.GetExecutionPlan(),
+                                                       session_state_.GetEnableMemoryPatternOfflinePacking());
+  } else {
+    // pre-allocate the big chunk requested in memory pattern.
+    // all the internal kernel's input/output tensors will be allocated on these buffer.
+    for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
+      ORT_ENFORCE(buffers_.find(mem_patterns_->locations[i]) == buffers_.end());
+      AllocatorPtr alloc = GetAllocator(mem_patterns_->locations[i]);
+      const size_t peak_size = mem_patterns_->patterns[i].PeakSize();
+      void* buffer = peak_size > 0 ? alloc->Alloc(peak_size) : nullptr;
+      if (peak_size > 0 && buffer == nullptr) {
+        // e.g. the arena's memory limit was reached. the values in the pattern fall back to their own allocations.
+        LOGS_DEFAULT(WARNING) << "Failed to allocate the " << peak_size << " byte memory pattern buffer for "
+                              << mem_patterns_->locations[i].name;
+        continue;
       }
+
+      buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(buffer, alloc);
     }
   }
 }
@@ -116,15 +210,16 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(int mlvalue_inde
       // if block not found, fall back to default behavior
       if (block) {
         auto it = buffers_.find(location);
-        // if the block is not correct, log message then fall back to default behavior
-        if (it != buffers_.end() && block->size_ == size) {
+        // if the block is not correct, log message then fall back to default behavior.
+        // the block may be larger than needed if the pattern was traced with larger inputs in the same dim buckets.
+        if (it != buffers_.end() && size <= block->size_) {
           void* buffer = it->second.get();
           auto status = AllocateTensorWithPreAllocateBufferHelper(
               p_mlvalue, static_cast<void*>(static_cast<char*>(buffer) + block->offset_),
               element_type, location, shape);
           return status;
         }
-        if (block->size_ != size) {
+        if (block->size_ < size) {
           LOGS_DEFAULT(WARNING) << "For mlvalue with index: " << mlvalue_index << ", block in memory pattern size is: "
                                 << block->size_ << " but the actually size is: " << size << ", fall back to default allocation behavior";
         } else if (it == buffers_.end()) {
@@ -136,6 +231,11 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(int mlvalue_inde
   }
   //no memory pattern, or the pattern is not correct.
   void* buffer = size == 0 ? nullptr : alloc->Alloc(size);
+  if (size > 0 && buffer == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to allocate ", size, " bytes for mlvalue with index: ",
+                           mlvalue_index, " from ", location.name);
+  }
+
   std::unique_ptr<Tensor> p_tensor = std::make_unique<Tensor>(element_type,
                                                               shape,
                                                               buffer,
@@ -296,36 +396,76 @@ void ExecutionFrame::Init(const std::unordered_map<std::string, MLValue>& feeds,
                           const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
   auto& mlvalue_idx_map = session_state_.GetMLValueNameIdxMap();
 
-  // 1. resize the all_value_ vector
-  all_values_.resize(mlvalue_idx_map.MaxIdx() + 1);
+  // 1. all_values_ was sized in the constructor, and emptied by Release if the frame is being reused
+
+  // 2. resolve the output names
+  fetch_mlvalue_idxs_.clear();
+  for (const auto& oname : output_names) {
+    int mlvalue_idx;
+    Status status = mlvalue_idx_map.GetIdx(oname, mlvalue_idx);
+    ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+    fetch_mlvalue_idxs_.push_back(mlvalue_idx);
+  }
 
-  // 2. Handle non-empty output vector
+  // 3. handle the fetches and weights
+  InitFetchesAndInitializers(fetches, fetch_allocators);
+
+  // 4. handle feed in values. these can override initializer values so must be last
+  for (const auto& feed : feeds) {
+    int mlvalue_idx;
+    Status status = mlvalue_idx_map.GetIdx(feed.first, mlvalue_idx);
+    ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
+    // we are sharing the underline tensor/object for MLValue
+    all_values_[mlvalue_idx] = feed.second;
+  }
+}
+
+void ExecutionFrame::Init(const FeedsFetchesInfo& feeds_fetches_info,
+                          const std::vector<MLValue>& feeds,
+                          const std::vector<MLValue>& fetches,
+                          const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  const auto& feeds_mlvalue_idxs = feeds_fetches_info.feeds_mlvalue_idxs;
+  ORT_ENFORCE(feeds.size() == feeds_mlvalue_idxs.size(),
+              "feeds vector size: " + std::to_string(feeds.size()) +
+                  " does not match the number of feed names: " + std::to_string(feeds_mlvalue_idxs.size()));
+
+  // the indices were resolved when feeds_fetches_info was created so there are no names to look up here
+  fetch_mlvalue_idxs_.assign(feeds_fetches_info.fetches_mlvalue_idxs.cbegin(),
+                             feeds_fetches_info.fetches_mlvalue_idxs.cend());
+
+  InitFetchesAndInitializers(fetches, fetch_allocators);
+
+  // feeds can override initializer values so must be last
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    all_values_[feeds_mlvalue_idxs[i]] = feeds[i];
+  }
+}
+
+void ExecutionFrame::InitFetchesAndInitializers(
+    const std::vector<MLValue>& fetches,
+    const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  // Handle non-empty output vector
   if (!fetches.empty()) {
     // should've already verified this much before when Run() starts
-    ORT_ENFORCE(output_names.size() == fetches.size(),
-                "output_names vector size: " + std::to_string(output_names.size()) +
+    ORT_ENFORCE(fetch_mlvalue_idxs_.size() == fetches.size(),
+                "output_names vector size: " + std::to_string(fetch_mlvalue_idxs_.size()) +
                     " does not match that of fetches vector: " + std::to_string(fetches.size()));
 
     // setup output_indices_, we don't want to generate mem plan on output tensors.
-    output_indices_.reserve(output_names.size());
-    auto idx = 0;
-    for (const auto& oname : output_names) {
-      int mlvalue_idx;
-      Status status = mlvalue_idx_map.GetIdx(oname, mlvalue_idx);
-      ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
-      all_values_[mlvalue_idx] = fetches.at(idx);
+    output_indices_.reserve(fetch_mlvalue_idxs_.size());
+    for (size_t idx = 0, end = fetch_mlvalue_idxs_.size(); idx < end; ++idx) {
+      int mlvalue_idx = fetch_mlvalue_idxs_[idx];
+      all_values_[mlvalue_idx] = fetches[idx];
       output_indices_.push_back(mlvalue_idx);
 
       auto custom_alloc_entry = fetch_allocators.find(idx);
       if (custom_alloc_entry != fetch_allocators.cend()) {
         custom_allocators_[mlvalue_idx] = custom_alloc_entry->second;
       }
-
-      ++idx;
     }
   }
 
-  // 3. handle the weights.
+  // Handle the weights.
   // We do this after the fetches to handle an edge case (possibly dubious) where a Constant is an output.
   // The Constant gets lifted to an initializer so there's no Node producing the value as an output during Graph
   // execution (i.e. Graph execution won't write the value to all_values_).
@@ -336,15 +476,23 @@ void ExecutionFrame::Init(const std::unordered_map<std::string, MLValue>& feeds,
     auto mlvalue_index = entry.first;
     all_values_[mlvalue_index] = entry.second;
   }
+}
 
-  // 4. handle feed in values. these can override initializer values so must be last
-  for (const auto& feed : feeds) {
-    int mlvalue_idx;
-    Status status = mlvalue_idx_map.GetIdx(feed.first, mlvalue_idx);
-    ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
-    // we are sharing the underline tensor/object for MLValue
-    all_values_[mlvalue_idx] = feed.second;
+Status ExecutionFrame::GetOutputs(std::vector<MLValue>& fetches) const {
+  if (fetches.empty()) {
+    fetches.resize(fetch_mlvalue_idxs_.size());
+  } else {
+    // this should've been checked before already
+    ORT_ENFORCE(fetch_mlvalue_idxs_.size() == fetches.size(),
+                "output_names vector size: " + std::to_string(fetch_mlvalue_idxs_.size()) +
+                    " does not match that of fetches vector: " + std::to_string(fetches.size()));
+  }
+
+  for (size_t idx = 0, end = fetch_mlvalue_idxs_.size(); idx < end; ++idx) {
+    fetches[idx] = GetMLValue(fetch_mlvalue_idxs_[idx]);
   }
+
+  return Status::OK();
 }
 
 void ExecutionFrame::TraceFree(int mlvalue_idx) {
@@ -379,7 +527,15 @@ Status ExecutionFrame::GeneratePatterns(MemoryPatternGroup* out) const {
     return Status(ONNXRUNTIME, FAIL, "Memory pattern planner is not enabled on this execution framework.");
   }
 
-  return planner_->GeneratePatterns(out);
+  ORT_RETURN_IF_ERROR(planner_->GeneratePatterns(out));
+
+  for (size_t i = 0; i < out->locations.size(); i++) {
+    VLOGS(session_state_.Logger(), 1) << "Memory pattern for " << out->locations[i].ToString() << ": peak size "
+                                      << out->patterns[i].PeakSize() << " bytes, lower bound "
+                                      << out->patterns[i].LowerBound() << " bytes";
+  }
+
+  return Status::OK();
 }
 
 int ExecutionFrame::GetNodeOffset(onnxruntime::NodeIndex node_index) const {
@@ -440,6 +596,38 @@ Status ExecutionFrame::GetOrCreateNodeOutputMLValue(int index,
   return Status::OK();
 }
 
+bool ExecutionFrame::TrySetNodeOutputTensor(int index, std::unique_ptr<Tensor>& tensor) {
+  int mlvalue_idx = node_index_info_.GetMLValueIndex(index);
+  if (mlvalue_idx == NodeIndexInfo::kInvalidEntry) {
+    return false;
+  }
+
+  MLValue& mlvalue = all_values_.at(mlvalue_idx);
+  if (mlvalue.IsAllocated() || custom_allocators_.find(mlvalue_idx) != custom_allocators_.cend()) {
+    return false;
+  }
+
+  const auto& per_alloc_plan = GetAllocationPlan(mlvalue_idx);
+  if (per_alloc_plan.alloc_kind != AllocKind::kAllocate &&
+      per_alloc_plan.alloc_kind != AllocKind::kAllocateOutput &&
+      per_alloc_plan.alloc_kind != AllocKind::kReuse) {
+    return false;
+  }
+
+  auto ml_type = per_alloc_plan.value_type;
+  if (ml_type == nullptr || !ml_type->IsTensorType() || per_alloc_plan.create_fence_if_async ||
+      static_cast<const TensorTypeBase*>(ml_type)->GetElementType() != tensor->DataType() ||
+      !(per_alloc_plan.location == tensor->Location())) {
+    return false;
+  }
+
+  // the buffer isn't traced as it didn't come from the frame, so a memory pattern won't include it
+  mlvalue.Init(tensor.release(),
+               DataTypeImpl::GetType<Tensor>(),
+               DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return true;
+}
+
 Status ExecutionFrame::ReleaseMLValue(int mlvalue_idx) {
   if (mlvalue_idx == NodeIndexInfo::kInvalidEntry || static_cast<size_t>(mlvalue_idx) >= all_values_.size()) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid index ", mlvalue_idx);
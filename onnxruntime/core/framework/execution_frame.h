@@ -8,6 +8,7 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/common/status.h"
+#include "core/framework/feeds_fetches_info.h"
 #include "core/framework/iexecutor.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/sequential_execution_plan.h"
@@ -45,8 +46,37 @@ class ExecutionFrame {
                  const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                  const SessionState& session_state);
 
+  // Create an empty frame that must be Reset before use. Used by SessionState to pool frames across runs.
+  explicit ExecutionFrame(const SessionState& session_state);
+
   ~ExecutionFrame();
 
+  /**
+  Prepare the frame for a new run.
+  The MLValue storage is reused, and if the input shapes match those of the previous run the memory pattern
+  buffers bound then are reused as well, so a steady state run does not allocate in here.
+  */
+  void Reset(const std::unordered_map<std::string, MLValue>& feeds,
+             const std::vector<std::string>& output_names,
+             const std::vector<MLValue>& fetches,
+             const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
+  /**
+  Prepare the frame for a new run using the MLValue indices in feeds_fetches_info instead of looking up names.
+  feeds must be in the order of feeds_fetches_info.feed_names, and fetches, if not empty, in the order of
+  feeds_fetches_info.output_names.
+  */
+  void Reset(const FeedsFetchesInfo& feeds_fetches_info,
+             const std::vector<MLValue>& feeds,
+             const std::vector<MLValue>& fetches,
+             const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
+  /**
+  Drop all the values referenced by the frame at the end of a run, keeping the storage and any memory pattern
+  buffers so the frame can be Reset for another run.
+  */
+  void Release();
+
   // TODO: These two AllocateMLValue... methods are in the API purely for unit test usage.
   // Fix the unit tests so they set an execution plan that results in these methods being called by
   // GetOrCreateNodeOutputMLValue instead
@@ -86,6 +116,14 @@ class ExecutionFrame {
                                       const MLValueAllocationParameters& parameters,
                                       MLValue*& p_mlvalue);
 
+  /**
+  Use tensor, which owns its buffer, as the node output at index instead of allocating a buffer for it.
+  Returns false and leaves tensor untouched if the frame has to provide the buffer: the output is unused, already
+  allocated (e.g. a fetch the caller pre-allocated), has a custom allocator, needs a fence, or is planned in a
+  different location or with a different type.
+  */
+  bool TrySetNodeOutputTensor(int index, std::unique_ptr<Tensor>& tensor);
+
   AllocatorPtr GetAllocator(const OrtAllocatorInfo& info);
 
   Status ReleaseMLValue(int mlvalue_idx);
@@ -96,6 +134,20 @@ class ExecutionFrame {
 
   Status GeneratePatterns(MemoryPatternGroup* out) const;
 
+  /**
+  Copy the requested outputs to fetches, in the order they were requested in when the frame was Reset.
+  fetches is resized if empty.
+  */
+  Status GetOutputs(std::vector<MLValue>& fetches) const;
+
+  /**
+  Shapes of the feeds, in the order the memory pattern for them is keyed on.
+  Only available if HasPlan() is true, i.e. when a memory pattern should be generated for these shapes.
+  */
+  const std::vector<TensorShape>& GetFeedShapes() const {
+    return bound_input_shapes_;
+  }
+
   bool HasPlan() const {
     return planner_ != nullptr;
   }
@@ -108,6 +160,22 @@ class ExecutionFrame {
             const std::vector<MLValue>& fetches,
             const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
 
+  void Init(const FeedsFetchesInfo& feeds_fetches_info,
+            const std::vector<MLValue>& feeds,
+            const std::vector<MLValue>& fetches,
+            const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
+  // set the fetches and initializers once fetch_mlvalue_idxs_ is set. the feeds are set by the caller after this.
+  void InitFetchesAndInitializers(const std::vector<MLValue>& fetches,
+                                  const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
+  // TFeeds is either a name to MLValue map or a vector of MLValue
+  template <typename TFeeds>
+  void BindMemoryPatterns(const TFeeds& feeds);
+
+  template <typename TFeeds>
+  bool InputShapesMatchBoundPatterns(const TFeeds& feeds) const;
+
   common::Status AllocateAsPerAllocationPlan(int mlvalue_index,
                                              const MLValueAllocationParameters& parameters);
 
@@ -148,17 +216,24 @@ class ExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
   std::unique_ptr<MLValuePatternPlanner> planner_;
 
+  // MLValue indices of the requested outputs, in the order they were requested in.
+  std::vector<int> fetch_mlvalue_idxs_;
+
   // Record the ml value indices for output values. we won't include those
   // values' allocation in memory pattern, as they can't be shared.
   std::vector<int> output_indices_;
 
   // Big chunks on different locations that will be used by mem_pattern.
   std::map<OrtAllocatorInfo, BufferUniquePtr> buffers_;
+
+  // Input shapes mem_patterns_ and buffers_ were bound for. Kept across Release so a pooled frame can skip the
+  // pattern lookup and buffer allocation when the next run has the same shapes.
+  std::vector<TensorShape> bound_input_shapes_;
 };
 }  // namespace onnxruntime
@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/feeds_fetches_info.h"
+
+#include "core/framework/mlvalue_name_idx_map.h"
+
+namespace onnxruntime {
+
+Status FeedsFetchesInfo::MapNamesToMLValueIdxs(const std::vector<std::string>& names,
+                                               const MLValueNameIdxMap& mlvalue_name_idx_map,
+                                               std::vector<int>& mlvalue_idxs) {
+  mlvalue_idxs.clear();
+  mlvalue_idxs.reserve(names.size());
+
+  for (const auto& name : names) {
+    int idx;
+    ORT_RETURN_IF_ERROR(mlvalue_name_idx_map.GetIdx(name, idx));
+    mlvalue_idxs.push_back(idx);
+  }
+
+  return Status::OK();
+}
+
+Status FeedsFetchesInfo::SetMLValueIdxs(const MLValueNameIdxMap& mlvalue_name_idx_map) {
+  ORT_RETURN_IF_ERROR(MapNamesToMLValueIdxs(feed_names, mlvalue_name_idx_map, feeds_mlvalue_idxs));
+  ORT_RETURN_IF_ERROR(MapNamesToMLValueIdxs(output_names, mlvalue_name_idx_map, fetches_mlvalue_idxs));
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
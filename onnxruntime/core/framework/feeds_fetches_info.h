@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+
+namespace onnxruntime {
+class MLValueNameIdxMap;
+class SessionState;
+
+/**
+The feed and output names for a Run, resolved once to the MLValue indices used by the ExecutionFrame.
+Running with a FeedsFetchesInfo takes the feeds and fetches as vectors in the order of feed_names and output_names,
+so repeated runs with the same inputs and outputs don't need to build a name to MLValue map or look up any names.
+*/
+struct FeedsFetchesInfo {
+  FeedsFetchesInfo() = default;
+  FeedsFetchesInfo(const std::vector<std::string>& feed_names_in,
+                   const std::vector<std::string>& output_names_in)
+      : feed_names{feed_names_in}, output_names{output_names_in} {}
+
+  /// Look up each of the names in the map and return the index for each in mlvalue_idxs.
+  static Status MapNamesToMLValueIdxs(const std::vector<std::string>& names,
+                                      const MLValueNameIdxMap& mlvalue_name_idx_map,
+                                      std::vector<int>& mlvalue_idxs);
+
+  /// Set feeds_mlvalue_idxs and fetches_mlvalue_idxs from feed_names and output_names.
+  Status SetMLValueIdxs(const MLValueNameIdxMap& mlvalue_name_idx_map);
+
+  std::vector<std::string> feed_names;
+  std::vector<std::string> output_names;
+
+  std::vector<int> feeds_mlvalue_idxs;
+  std::vector<int> fetches_mlvalue_idxs;
+
+  /// The SessionState the indices were resolved against, if it was created by an InferenceSession, which only runs
+  /// with its own.
+  const SessionState* session_state = nullptr;
+};
+}  // namespace onnxruntime
@@ -1,5 +1,6 @@
 #include "core/framework/func_kernel.h"
 #include "core/framework/allocator.h"
+#include "core/framework/op_kernel_context_internal.h"
 namespace onnxruntime {
 void* allocate_helper_func(void* allocator, size_t alignment, size_t size) {
   // Here we only align the size, we expect the underline device allocator will
@@ -26,4 +27,121 @@ DType ORT_type_to_c_type(MLDataType type) {
     ORT_NOT_IMPLEMENTED("Unsupport MLType to c type.");
 }
 
+MLDataType c_type_to_ORT_type(DType type) {
+  switch (type) {
+    case DType::TFloat32:
+      return DataTypeImpl::GetType<float>();
+    case DType::TDouble:
+      return DataTypeImpl::GetType<double>();
+    case DType::TInt32:
+      return DataTypeImpl::GetType<int32_t>();
+    default:
+      ORT_NOT_IMPLEMENTED("Unsupport c type to MLType.");
+  }
+}
+
+bool GetStaticOutputShape(const NodeArg& output_def, std::vector<int64_t>& dims) {
+  dims.clear();
+  const auto* type_proto = output_def.TypeAsProto();
+  const auto* shape = output_def.Shape();
+  if (!output_def.Exists() || type_proto == nullptr || shape == nullptr ||
+      !type_proto->has_tensor_type()) {
+    return false;
+  }
+
+  auto elem_type = type_proto->tensor_type().elem_type();
+  if (elem_type != ONNX_NAMESPACE::TensorProto_DataType_FLOAT &&
+      elem_type != ONNX_NAMESPACE::TensorProto_DataType_DOUBLE &&
+      elem_type != ONNX_NAMESPACE::TensorProto_DataType_INT32) {
+    return false;
+  }
+
+  for (const auto& dim : shape->dim()) {
+    if (!dim.has_dim_value()) {
+      dims.clear();
+      return false;
+    }
+
+    dims.push_back(dim.dim_value());
+  }
+
+  return true;
+}
+
+Status FunctionKernel::Compute(OpKernelContext* context) const {
+  auto* ctx_internal = static_cast<OpKernelContextInternal*>(context);
+
+  std::vector<ONNXRunTimeTensor> input_tensors;
+  for (int i = 0; i < num_inputs_; i++) {
+    const Tensor* input = context->Input<Tensor>(i);
+    auto& shape = input->Shape();
+    auto& dims = shape.GetDims();
+    ONNXRunTimeTensor input_tensor = {
+        const_cast<void*>(input->DataRaw()),
+        shape.NumDimensions(),
+        //hard code to double now
+        ORT_type_to_c_type(input->DataType()),
+        dims.empty() ? nullptr : const_cast<int64_t*>(&dims[0])};
+    input_tensors.push_back(input_tensor);
+  }
+
+  // allocate the outputs with a known shape up front so the function can write to them directly
+  std::vector<ONNXRunTimeTensor> output_tensors(num_outputs_);
+  std::vector<Tensor*> preallocated_outputs(num_outputs_, nullptr);
+  std::vector<int64_t*> static_shapes(num_outputs_, nullptr);
+  for (int i = 0; i < num_outputs_; i++) {
+    if (!has_static_output_shape_[i])
+      continue;
+
+    auto& dims = static_output_dims_[i];
+    Tensor* output = context->Output(i, TensorShape(dims));
+    if (output == nullptr)
+      continue;
+
+    preallocated_outputs[i] = output;
+    static_shapes[i] = dims.empty() ? nullptr : const_cast<int64_t*>(&dims[0]);
+    output_tensors[i] = {output->MutableDataRaw(), dims.size(), ORT_type_to_c_type(output->DataType()),
+                         static_shapes[i]};
+  }
+
+  int ret = func_(func_state_, input_tensors.empty() ? nullptr : &input_tensors[0], input_tensors.size(), &output_tensors[0], output_tensors.size());
+  if (ret != 0)
+    return Status(common::ONNXRUNTIME, common::FAIL, "FuncKernel call failed with error code: " + std::to_string(ret));
+
+  for (int i = 0; i < num_outputs_; i++) {
+    auto& output_tensor = output_tensors[i];
+    Tensor* output = preallocated_outputs[i];
+    std::unique_ptr<int64_t[]> function_shape(output_tensor.shape != static_shapes[i] ? output_tensor.shape : nullptr);
+
+    // the function wrote to the buffer the runtime gave it
+    if (output != nullptr && output_tensor.data == output->MutableDataRaw())
+      continue;
+
+    // the function allocated the output. wrap the buffer in a tensor that frees it with the allocator that
+    // allocated it, and use that as the output unless the execution frame has to provide the buffer, e.g. for a
+    // pre-allocated fetch.
+    ORT_ENFORCE(host_allocator_ != nullptr, "Function allocated output ", i, " without an allocator");
+    TensorShape output_shape(std::vector<int64_t>(output_tensor.shape, output_tensor.shape + output_tensor.ndim));
+    auto function_output = std::make_unique<Tensor>(c_type_to_ORT_type(output_tensor.dtype), output_shape,
+                                                    output_tensor.data, host_allocator_->Info(), host_allocator_);
+    if (output == nullptr && ctx_internal->TrySetOutputTensor(i, function_output))
+      continue;
+
+    if (output == nullptr)
+      output = context->Output(i, output_shape);
+
+    // unused optional output
+    if (output == nullptr)
+      continue;
+
+    //TODO: for string tensors, this copy is not correct.
+    ORT_ENFORCE(output->DataType() != DataTypeImpl::GetType<std::string>());
+    ORT_ENFORCE(output->Shape() == output_shape, "Function output ", i, " has shape ", output_shape,
+                " but the expected shape is ", output->Shape());
+    memcpy(output->MutableDataRaw(), function_output->DataRaw(), output->DataType()->Size() * output_shape.Size());
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -10,6 +10,11 @@ void release_helper_func(void* allocator, void* p);
 
 DType ORT_type_to_c_type(MLDataType type);
 
+MLDataType c_type_to_ORT_type(DType type);
+
+// get the shape of a tensor output if it's fully known from shape inference and has a type the function api supports
+bool GetStaticOutputShape(const NodeArg& output_def, std::vector<int64_t>& dims);
+
 //A kernel that wrapper the ComputeFunction call generated by execution provider when fuse the sub-graph
 class FunctionKernel : public OpKernel {
  public:
@@ -18,6 +23,12 @@ class FunctionKernel : public OpKernel {
   explicit FunctionKernel(const OpKernelInfo& info) : OpKernel(info) {
     num_inputs_ = info.node().InputDefs().size();
     num_outputs_ = info.node().OutputDefs().size();
+    // outputs with a known shape are allocated by the runtime and passed to the function
+    static_output_dims_.resize(num_outputs_);
+    has_static_output_shape_.resize(num_outputs_);
+    for (size_t i = 0; i < num_outputs_; ++i) {
+      has_static_output_shape_[i] = GetStaticOutputShape(*info.node().OutputDefs()[i], static_output_dims_[i]);
+    }
     CreateFunctionStateFunc create_func;
     auto status = info.GetFusedFuncs(&func_, &create_func, &release_func_);
     ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
@@ -36,42 +47,7 @@ class FunctionKernel : public OpKernel {
     }
   }
 
-  virtual Status Compute(OpKernelContext* context) const override {
-    std::vector<ONNXRunTimeTensor> input_tensors;
-    for (int i = 0; i < num_inputs_; i++) {
-      const Tensor* input = context->Input<Tensor>(i);
-      auto& shape = input->Shape();
-      auto& dims = shape.GetDims();
-      ONNXRunTimeTensor input_tensor = {
-          const_cast<void*>(input->DataRaw()),
-          shape.NumDimensions(),
-          //hard code to double now
-          ORT_type_to_c_type(input->DataType()),
-          dims.empty() ? nullptr : const_cast<int64_t*>(&dims[0])};
-      input_tensors.push_back(input_tensor);
-    }
-
-    std::vector<ONNXRunTimeTensor> output_tensors(num_outputs_);
-    int ret = func_(func_state_, input_tensors.empty() ? nullptr : &input_tensors[0], input_tensors.size(), &output_tensors[0], output_tensors.size());
-    if (ret != 0)
-      return Status(common::ONNXRUNTIME, common::FAIL, "FuncKernel call failed with error code: " + std::to_string(ret));
-
-    for (int i = 0; i < num_outputs_; i++) {
-      TensorShape output_shape(std::vector<int64_t>(output_tensors[i].shape, output_tensors[i].shape + output_tensors[i].ndim));
-      Tensor* output = context->Output(i, output_shape);
-      auto data = output->MutableDataRaw();
-      //TODO: for string tensors, this copy is not correct.
-      ORT_ENFORCE(output->DataType() != DataTypeImpl::GetType<std::string>());
-      memcpy(data, output_tensors[i].data, output->DataType()->Size() * output_shape.Size());
-      //Release output tensors (buffer, shape).
-      host_allocator_->Free(output_tensors[i].data);
-      // for shape, becauset the TempSpaceAllocator we use could be a device allocator, if the kernel is assigned to a device like gpu.
-      // so we prefer to directly allocate shape on heap. otherwise we need pass in multile allocator function for host and device.
-      delete[] output_tensors[i].shape;
-    }
-
-    return Status::OK();
-  }
+  virtual Status Compute(OpKernelContext* context) const override;
 
  private:
   ComputeFunc func_;
@@ -80,5 +56,7 @@ class FunctionKernel : public OpKernel {
   size_t num_inputs_;
   size_t num_outputs_;
   AllocatorPtr host_allocator_;
+  std::vector<std::vector<int64_t>> static_output_dims_;
+  std::vector<bool> has_static_output_shape_;
 };
 }  // namespace onnxruntime
@@ -14,6 +14,7 @@ namespace onnxruntime {
 
 class MLValue;
 class SessionState;
+struct FeedsFetchesInfo;
 class TensorShape;
 namespace logging {
 class Logger;
@@ -40,5 +41,18 @@ class IExecutor {
                                  // optional custom allocators. key is index in fetches
                                  const std::unordered_map<size_t, CustomAllocator> fetch_allocators,
                                  const logging::Logger& logger) = 0;
+
+  /**
+  Execute with the feed and output names already resolved to MLValue indices.
+  feeds must be in the order of feeds_fetches_info.feed_names, and fetches, if not empty, in the order of
+  feeds_fetches_info.output_names.
+  */
+  virtual common::Status Execute(const SessionState& session_state,
+                                 const FeedsFetchesInfo& feeds_fetches_info,
+                                 const std::vector<MLValue>& feeds,
+                                 std::vector<MLValue>& fetches,
+                                 // optional custom allocators. key is index in fetches
+                                 const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                                 const logging::Logger& logger) = 0;
 };
 }  // namespace onnxruntime
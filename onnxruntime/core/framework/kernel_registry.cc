@@ -263,6 +263,7 @@ Status KernelRegistry::CreateKernel(const onnxruntime::Node& node,
                                     const std::unordered_map<int, MLValue>& initialized_tensors,
                                     const MLValueNameIdxMap& mlvalue_name_idx_map,
                                     const FuncManager& funcs_mgr,
+                                    WorkStealingThreadPool* intra_op_thread_pool,
                                     /*out*/ std::unique_ptr<OpKernel>& op_kernel) const {
   const KernelCreateInfo* kernel_create_info = TryFindKernel(node, execution_provider.Type());
 
@@ -275,7 +276,8 @@ Status KernelRegistry::CreateKernel(const onnxruntime::Node& node,
                            execution_provider,
                            initialized_tensors,
                            mlvalue_name_idx_map,
-                           funcs_mgr);
+                           funcs_mgr,
+                           intra_op_thread_pool);
   op_kernel.reset(kernel_create_info->kernel_create_func(kernel_info));
   return Status::OK();
 }
@@ -26,6 +26,7 @@ Status KernelRegistryManager::CreateKernel(const onnxruntime::Node& node,
                                     session_state.GetInitializedTensors(),
                                     session_state.GetMLValueNameIdxMap(),
                                     session_state.GetFuncMgr(),
+                                    session_state.GetIntraOpThreadPool(),
                                     op_kernel);
     if (status.IsOK()) {
       return status;
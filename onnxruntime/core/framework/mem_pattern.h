@@ -22,11 +22,13 @@ class MemoryPattern {
 
   MemoryPattern(MemoryPattern&& rhs)
       : patterns_{std::move(rhs.patterns_)},
-        peak_size_{std::move(rhs.peak_size_)} {}
+        peak_size_{std::move(rhs.peak_size_)},
+        lower_bound_{std::move(rhs.lower_bound_)} {}
 
   MemoryPattern& operator=(MemoryPattern&& rhs) {
     patterns_ = std::move(rhs.patterns_);
     peak_size_ = std::move(rhs.peak_size_);
+    lower_bound_ = std::move(rhs.lower_bound_);
     return *this;
   }
 
@@ -34,6 +36,12 @@ class MemoryPattern {
     return peak_size_;
   }
 
+  // The largest total size of the blocks that are in use at the same time, which no pattern can have a smaller peak
+  // size than.
+  size_t LowerBound() const {
+    return lower_bound_;
+  }
+
   const MemoryBlock* GetBlock(int ml_value_idx) const {
     auto it = patterns_.find(ml_value_idx);
     if (it == patterns_.end())
@@ -48,6 +56,7 @@ class MemoryPattern {
 
   std::unordered_map<int, MemoryBlock> patterns_;
   size_t peak_size_{0};
+  size_t lower_bound_{0};
 };
 
 struct MemoryPatternGroup {
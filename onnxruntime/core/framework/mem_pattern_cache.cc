@@ -0,0 +1,159 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace onnxruntime {
+
+// upper limit on the number of shards. there are fewer if the capacity is small so each shard has room for at
+// least one entry.
+static constexpr size_t kMaxShards = 8;
+
+constexpr size_t MemoryPatternCache::kDefaultCapacity;
+
+MemoryPatternCache::MemoryPatternCache() {
+  Configure(kDefaultCapacity, {});
+}
+
+MemoryPatternCache::~MemoryPatternCache() = default;
+
+void MemoryPatternCache::Configure(size_t capacity, std::vector<int64_t> dim_buckets) {
+  std::sort(dim_buckets.begin(), dim_buckets.end());
+  dim_buckets.erase(std::unique(dim_buckets.begin(), dim_buckets.end()), dim_buckets.end());
+
+  capacity_ = capacity;
+  dim_buckets_ = std::move(dim_buckets);
+  num_hits_ = 0;
+  num_misses_ = 0;
+  num_shards_ = capacity == 0 ? kMaxShards : std::min(capacity, kMaxShards);
+  shards_ = std::make_unique<Shard[]>(num_shards_);
+
+  // split the capacity over the shards so the total is exactly capacity
+  if (capacity != 0) {
+    for (size_t i = 0; i < num_shards_; ++i) {
+      shards_[i].capacity = capacity / num_shards_ + (i < capacity % num_shards_ ? 1 : 0);
+    }
+  }
+}
+
+size_t MemoryPatternCache::KeyHash::operator()(const Key& key) const {
+  std::hash<int64_t> hf;
+  size_t hash = 0;
+  for (auto value : key) {
+    hash ^= hf(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+
+  return hash;
+}
+
+MemoryPatternCache::Key MemoryPatternCache::MakeKey(const std::vector<TensorShape>& input_shapes) const {
+  Key key;
+  for (const auto& shape : input_shapes) {
+    const auto& dims = shape.GetDims();
+    // include the rank so shapes that flatten to the same dims get different keys
+    key.push_back(static_cast<int64_t>(dims.size()));
+    for (auto dim : dims) {
+      auto bucket = std::lower_bound(dim_buckets_.cbegin(), dim_buckets_.cend(), dim);
+      key.push_back(bucket != dim_buckets_.cend() ? *bucket : dim);
+    }
+  }
+
+  return key;
+}
+
+MemoryPatternCache::Shard& MemoryPatternCache::GetShard(const Key& key) const {
+  return shards_[KeyHash()(key) % num_shards_];
+}
+
+// check that each of the input shapes is no larger than the traced shape in any dim
+static bool Covers(const std::vector<TensorShape>& traced_shapes, const std::vector<TensorShape>& input_shapes) {
+  if (traced_shapes.size() != input_shapes.size()) {
+    return false;
+  }
+
+  for (size_t i = 0, end = input_shapes.size(); i < end; ++i) {
+    const auto& traced_dims = traced_shapes[i].GetDims();
+    const auto& input_dims = input_shapes[i].GetDims();
+    if (traced_dims.size() != input_dims.size()) {
+      return false;
+    }
+
+    for (size_t j = 0, rank = input_dims.size(); j < rank; ++j) {
+      if (input_dims[j] > traced_dims[j]) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+std::shared_ptr<const MemoryPatternGroup> MemoryPatternCache::Get(const std::vector<TensorShape>& input_shapes) {
+  Key key = MakeKey(input_shapes);
+  Shard& shard = GetShard(key);
+
+  std::lock_guard<OrtMutex> lock(shard.lock);
+  auto it = shard.index.find(key);
+  if (it == shard.index.end() || !Covers(it->second->traced_shapes, input_shapes)) {
+    ++num_misses_;
+    return nullptr;
+  }
+
+  ++num_hits_;
+
+  // move to the front as the most recently used
+  shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+  return it->second->patterns;
+}
+
+void MemoryPatternCache::Add(const std::vector<TensorShape>& input_shapes,
+                             std::unique_ptr<MemoryPatternGroup> patterns) {
+  Key key = MakeKey(input_shapes);
+  Shard& shard = GetShard(key);
+
+  std::lock_guard<OrtMutex> lock(shard.lock);
+  auto it = shard.index.find(key);
+  if (it != shard.index.end()) {
+    auto entry = it->second;
+    shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+
+    // keep the existing pattern if it's already usable for these inputs, e.g. when concurrent runs with the same
+    // shapes both traced one. otherwise the larger inputs need the new pattern.
+    if (!Covers(entry->traced_shapes, input_shapes)) {
+      entry->traced_shapes = input_shapes;
+      entry->patterns = std::move(patterns);
+    }
+
+    return;
+  }
+
+  if (shard.capacity != 0 && shard.entries.size() >= shard.capacity) {
+    // evict the least recently used. frames still using its patterns hold their own reference.
+    shard.index.erase(shard.entries.back().key);
+    shard.entries.pop_back();
+  }
+
+  shard.entries.push_front(Entry{key, input_shapes, std::move(patterns)});
+  shard.index.emplace(std::move(key), shard.entries.begin());
+}
+
+size_t MemoryPatternCache::Size() const {
+  size_t size = 0;
+  for (size_t i = 0; i < num_shards_; ++i) {
+    std::lock_guard<OrtMutex> lock(shards_[i].lock);
+    size += shards_[i].entries.size();
+  }
+
+  return size;
+}
+
+void MemoryPatternCache::GetStats(MemoryPatternCacheStats* stats) const {
+  stats->size = Size();
+  stats->capacity = capacity_;
+  stats->num_hits = num_hits_;
+  stats->num_misses = num_misses_;
+}
+}  // namespace onnxruntime
@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/tensor_shape.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+struct MemoryPatternCacheStats {
+  size_t size = 0;      // number of cached patterns
+  size_t capacity = 0;  // 0 if there's no limit
+  // lookups for a run's input shapes that found a pattern, and that didn't so the run traced one
+  int64_t num_hits = 0;
+  int64_t num_misses = 0;
+};
+
+/**
+Cache of the memory patterns generated by a session, keyed on the input shapes of the run that traced them.
+
+The cache holds at most `capacity` patterns and evicts the least recently used one when it's full. Entries are
+spread over shards with their own lock, so concurrent runs with different input shapes don't contend.
+
+If dim buckets are set, each input dim is rounded up to the smallest bucket that holds it to make the key, so all
+the input shapes in a bucket share one pattern. The pattern kept for a bucket is the one traced with the largest
+inputs seen so far, and it's only returned for inputs no larger than those in any dim as the blocks for smaller
+inputs fit in it. Tracing a run with the upper bound of a bucket pads the blocks to cover the whole bucket.
+*/
+class MemoryPatternCache {
+ public:
+  static constexpr size_t kDefaultCapacity = 128;
+
+  MemoryPatternCache();
+  ~MemoryPatternCache();
+
+  /**
+  Set the cache limits. Drops any cached patterns, so it should be called before the session runs.
+  @param capacity Maximum number of patterns to keep. 0 for no limit.
+  @param dim_buckets Bucket upper bounds to round input dims up to. Dims above the largest bucket are used as is.
+  Empty to key on the exact input shapes.
+  */
+  void Configure(size_t capacity, std::vector<int64_t> dim_buckets);
+
+  /**
+  Get the pattern to use for a run with the given input shapes.
+  @returns The pattern, or nullptr if there isn't one that covers the input shapes.
+  */
+  std::shared_ptr<const MemoryPatternGroup> Get(const std::vector<TensorShape>& input_shapes);
+
+  /**
+  Add the pattern traced by a run with the given input shapes.
+  If the bucket already has a pattern that covers the input shapes, that pattern is kept.
+  */
+  void Add(const std::vector<TensorShape>& input_shapes, std::unique_ptr<MemoryPatternGroup> patterns);
+
+  /** Number of cached patterns. */
+  size_t Size() const;
+
+  size_t Capacity() const { return capacity_; }
+
+  /** Get the size, capacity, and the number of hits and misses of Get since the cache was configured. */
+  void GetStats(MemoryPatternCacheStats* stats) const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternCache);
+
+  using Key = std::vector<int64_t>;
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    Key key;
+    // input shapes of the run that traced the patterns
+    std::vector<TensorShape> traced_shapes;
+    std::shared_ptr<const MemoryPatternGroup> patterns;
+  };
+
+  struct Shard {
+    OrtMutex lock;
+    size_t capacity = 0;
+    // most recently used first
+    std::list<Entry> entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+  };
+
+  Key MakeKey(const std::vector<TensorShape>& input_shapes) const;
+  Shard& GetShard(const Key& key) const;
+
+  size_t capacity_ = kDefaultCapacity;
+  std::atomic<int64_t> num_hits_{0};
+  std::atomic<int64_t> num_misses_{0};
+  std::vector<int64_t> dim_buckets_;
+  size_t num_shards_ = 0;
+  std::unique_ptr<Shard[]> shards_;
+};
+}  // namespace onnxruntime
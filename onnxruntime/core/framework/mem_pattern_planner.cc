@@ -0,0 +1,178 @@
+//Part of the algo is derived from tensorflow.
+
+/* Copyright 2017 The TensorFlow Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_planner.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace onnxruntime {
+
+void MemPatternPlanner::TraceAllocation(int ml_value_idx, size_t size) {
+  const size_t alloc_index = allocs_.size();
+  allocs_.emplace_back(ml_value_idx, MemoryBlock(0, size), step_++);
+  if (size == 0) {
+    return;
+  }
+
+  live_allocs_[ml_value_idx] = alloc_index;
+  live_size_ += size;
+  max_live_size_ = std::max(max_live_size_, live_size_);
+
+  if (offline_packing_) {
+    return;
+  }
+
+  size_t offset = 0;
+  // best fit is the smallest gap at least as large as size, at the lowest offset if there are several
+  auto gap = gaps_.lower_bound({size, 0});
+  if (gap != gaps_.end()) {
+    const size_t gap_size = gap->first;
+    offset = gap->second;
+    gaps_.erase(gap);
+    if (gap_size > size) {
+      gaps_.emplace(gap_size - size, offset + size);
+    }
+  } else if (!blocks_.empty()) {
+    const auto& last_block = allocs_[blocks_.rbegin()->second].block_;
+    offset = last_block.offset_ + last_block.size_;
+  }
+
+  allocs_[alloc_index].block_.offset_ = offset;
+  blocks_.emplace(offset, alloc_index);
+  buffer_size = std::max(buffer_size, offset + size);
+}
+
+void MemPatternPlanner::TraceFree(int ml_value_index) {
+  auto live = live_allocs_.find(ml_value_index);
+  if (live == live_allocs_.end()) {
+    return;
+  }
+
+  auto& alloc = allocs_[live->second];
+  alloc.free_step_ = step_++;
+  live_size_ -= alloc.block_.size_;
+  live_allocs_.erase(live);
+
+  if (offline_packing_) {
+    return;
+  }
+
+  // merge the gaps on either side of the block with the space it frees. if it's the last block the space is past the
+  // end of the live blocks so isn't a gap.
+  const size_t start = alloc.block_.offset_;
+  const size_t end = start + alloc.block_.size_;
+  auto block = blocks_.find(start);
+
+  size_t gap_start = 0;
+  if (block != blocks_.begin()) {
+    const auto& prev_block = allocs_[std::prev(block)->second].block_;
+    gap_start = prev_block.offset_ + prev_block.size_;
+  }
+
+  if (start > gap_start) {
+    gaps_.erase({start - gap_start, gap_start});
+  }
+
+  auto next_block = std::next(block);
+  if (next_block != blocks_.end()) {
+    const size_t next_start = next_block->first;
+    if (next_start > end) {
+      gaps_.erase({next_start - end, end});
+    }
+
+    gaps_.emplace(next_start - gap_start, gap_start);
+  }
+
+  blocks_.erase(block);
+}
+
+void MemPatternPlanner::PackOffline() {
+  std::vector<size_t> order;
+  order.reserve(allocs_.size());
+  for (size_t i = 0; i < allocs_.size(); ++i) {
+    if (allocs_[i].block_.size_ > 0) {
+      order.push_back(i);
+    }
+  }
+
+  std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return allocs_[a].block_.size_ > allocs_[b].block_.size_;
+  });
+
+  // blocks placed so far, ordered by offset. blocks that aren't live at the same time may overlap.
+  std::vector<size_t> placed;
+  placed.reserve(order.size());
+  buffer_size = 0;
+
+  for (size_t i : order) {
+    auto& alloc = allocs_[i];
+    const size_t size = alloc.block_.size_;
+
+    size_t current = 0;
+    size_t waste_bytes = std::numeric_limits<size_t>::max();
+    size_t best_offset = 0;
+    bool found_gap = false;
+
+    for (size_t j : placed) {
+      const auto& other = allocs_[j];
+      if (other.alloc_step_ >= alloc.free_step_ || alloc.alloc_step_ >= other.free_step_) {
+        continue;
+      }
+
+      if (other.block_.offset_ >= current) {
+        auto gap = other.block_.offset_ - current;
+        if (gap >= size && (gap - size) < waste_bytes) {
+          found_gap = true;
+          waste_bytes = gap - size;
+          best_offset = current;
+        }
+      }
+
+      current = std::max(current, other.block_.offset_ + other.block_.size_);
+    }
+
+    if (!found_gap) {
+      best_offset = current;
+    }
+
+    alloc.block_.offset_ = best_offset;
+    buffer_size = std::max(buffer_size, best_offset + size);
+
+    auto insert_at = std::upper_bound(placed.begin(), placed.end(), best_offset, [this](size_t offset, size_t j) {
+      return offset < allocs_[j].block_.offset_;
+    });
+    placed.insert(insert_at, i);
+  }
+}
+
+MemoryPattern MemPatternPlanner::GenerateMemPattern() {
+  if (offline_packing_) {
+    PackOffline();
+  }
+
+  MemoryPattern pattern;
+  pattern.peak_size_ = buffer_size;
+  pattern.lower_bound_ = max_live_size_;
+  for (auto& alloc : allocs_) {
+    pattern.patterns_[alloc.index_] = alloc.block_;
+  }
+
+  return pattern;
+}
+
+}  // namespace onnxruntime
@@ -18,79 +18,62 @@ limitations under the License.
 #pragma once
 #include "core/framework/mem_pattern.h"
 #include "core/framework/allocation_planner.h"
-#include <list>
+#include <limits>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
 
 namespace onnxruntime {
 // MemPatternPlanner is used to trace allocation/free steps
 // in a single iteration, record the pattern and cached for
 // future request if they have the same input shape.
+//
+// By default each allocation is placed when it's traced, in the smallest gap between the live blocks that fits it or
+// else after the last live block. The live blocks and the gaps are kept ordered so tracing an allocation or free
+// is O(log n).
+//
+// With offline packing the allocations are placed when the pattern is generated, using their lifetimes in the
+// traced run. Each one, largest first, goes in the smallest gap between the blocks already placed that are live at
+// the same time. That's O(n^2), but the peak is usually closer to the lower bound of the largest total size of the
+// blocks that are live at once.
 class MemPatternPlanner {
  public:
-  MemPatternPlanner() = default;
+  explicit MemPatternPlanner(bool offline_packing = false) : offline_packing_(offline_packing) {}
 
-  void TraceAllocation(int ml_value_idx, size_t size) {
-    if (size == 0) {
-      allocs_.emplace_back(ml_value_idx, MemoryBlock(0, 0));
-      return;
-    }
+  void TraceAllocation(int ml_value_idx, size_t size);
 
-    size_t current = 0;
-    size_t waste_bytes = std::numeric_limits<size_t>::max();
-    size_t best_offset = 0;
-    if (!blocks_.empty()) {
-      auto last_block = allocs_[*blocks_.rbegin()];
-      best_offset = last_block.block_.offset_ + last_block.block_.size_;
-    }
+  void TraceFree(int ml_value_index);
 
-    std::list<int>::iterator best_fit_it = blocks_.end();
-    for (auto it = blocks_.begin(); it != blocks_.end(); it++) {
-      if (allocs_[*it].block_.offset_ >= current) {
-        auto gap = allocs_[*it].block_.offset_ - current;
-        if (gap >= size && (gap - size) < waste_bytes) {
-          best_fit_it = it;
-          waste_bytes = gap - size;
-          best_offset = current;
-        }
-      }
-      current = allocs_[*it].block_.offset_ + allocs_[*it].block_.size_;
-    }
-
-    allocs_.emplace_back(ml_value_idx, MemoryBlock(best_offset, size));
-    buffer_size = std::max(buffer_size, best_offset + size);
-    blocks_.insert(best_fit_it, (static_cast<int>(allocs_.size()) - 1));
-  }
-
-  void TraceFree(int ml_value_index) {
-    for (auto it = blocks_.begin(); it != blocks_.end(); it++) {
-      if (allocs_[*it].index_ == ml_value_index) {
-        blocks_.erase(it);
-        break;
-      }
-    }
-  }
-
-  MemoryPattern GenerateMemPattern() {
-    MemoryPattern pattern;
-    pattern.peak_size_ = buffer_size;
-    for (auto& alloc : allocs_) {
-      pattern.patterns_[alloc.index_] = alloc.block_;
-    }
-
-    return pattern;
-  }
+  MemoryPattern GenerateMemPattern();
 
  protected:
   struct MLValueAllocationBlock {
     int index_{-1};
     MemoryBlock block_;
+    // position of the allocation and the free in the trace. a block that isn't freed is live until the end.
+    size_t alloc_step_{0};
+    size_t free_step_{std::numeric_limits<size_t>::max()};
 
     MLValueAllocationBlock() = default;
-    MLValueAllocationBlock(int index, MemoryBlock block) : index_(index), block_(block) {}
+    MLValueAllocationBlock(int index, MemoryBlock block, size_t alloc_step)
+        : index_(index), block_(block), alloc_step_(alloc_step) {}
   };
 
+  // place all the allocations using their lifetimes. sets their offsets and buffer_size.
+  void PackOffline();
+
+  bool offline_packing_;
   std::vector<MLValueAllocationBlock> allocs_;
-  // blocks_ the list of currently allocated memory blocks, sorted in order of their offset
-  std::list<int> blocks_;
+  // blocks_ the currently allocated memory blocks with a non-zero size, keyed by offset. value is the index in allocs_.
+  std::map<size_t, size_t> blocks_;
+  // the free gaps before and between the blocks_ as (size, offset) so the best fit is a lower bound lookup
+  std::set<std::pair<size_t, size_t>> gaps_;
+  // index in allocs_ of the live allocation for each MLValue
+  std::unordered_map<int, size_t> live_allocs_;
+  size_t step_{0};
+  size_t live_size_{0};
+  size_t max_live_size_{0};
   size_t buffer_size{0};
 };
 
@@ -15,7 +15,8 @@ struct SequentialExecutionPlan;
 
 class MLValuePatternPlanner {
  public:
-  explicit MLValuePatternPlanner(const SequentialExecutionPlan& execution_plan);
+  // offline_packing selects how the MemPatternPlanner for each location places the blocks
+  explicit MLValuePatternPlanner(const SequentialExecutionPlan& execution_plan, bool offline_packing = false);
 
   common::Status TraceAllocation(int ml_value_idx, size_t size) {
     auto location = execution_planner_.allocation_plan[ml_value_idx].location;
@@ -53,6 +53,10 @@ OrtStatus* OrtTypeInfo::FromDataTypeImpl(const onnxruntime::DataTypeImpl* input,
     *out = new OrtTypeInfo(ONNX_TYPE_SEQUENCE, nullptr);
     return nullptr;
   }
+  if (input == DataTypeImpl::GetType<onnxruntime::SharedKeyMapsString>() || input == DataTypeImpl::GetType<onnxruntime::SharedKeyMapsInt64>()) {
+    *out = new OrtTypeInfo(ONNX_TYPE_OPAQUE, nullptr);
+    return nullptr;
+  }
   return OrtCreateStatus(ORT_NOT_IMPLEMENTED, "not implemented");
 }
 
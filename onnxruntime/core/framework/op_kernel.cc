@@ -102,6 +102,13 @@ Status OpKernelContext::GetOrCreateOutputMLValue(int index, MLValue*& p_value) {
   return Status::OK();
 }
 
+bool OpKernelContext::TrySetOutputTensor(int index, std::unique_ptr<Tensor>& tensor) {
+  if (index < 0 || index >= OutputCount())
+    return false;
+
+  return execution_frame_->TrySetNodeOutputTensor(GetOutputArgIndex(index), tensor);
+}
+
 int OpKernelContext::GetInputArgIndex(int index) const {
   return node_input_start_index_ + index;
 }
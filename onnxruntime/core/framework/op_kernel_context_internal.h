@@ -36,6 +36,10 @@ class OpKernelContextInternal : public OpKernelContext {
     return OpKernelContext::GetOutputMLValue(index);
   }
 
+  bool TrySetOutputTensor(int index, std::unique_ptr<Tensor>& tensor) {
+    return OpKernelContext::TrySetOutputTensor(index, tensor);
+  }
+
   std::unordered_map<std::string, const MLValue*> GetImplicitInputs() const {
     // we need to convert implicit_inputs_ to a name to MLValue map so it can be used in the ExecutionFrame
     // for a subgraph (the index numbers will be different there).
@@ -13,7 +13,8 @@ OpKernelInfo::OpKernelInfo(const onnxruntime::Node& node,
                            const IExecutionProvider& execution_provider,
                            const std::unordered_map<int, MLValue>& initialized_tensors,
                            const MLValueNameIdxMap& mlvalue_name_idx_map,
-                           const FuncManager& funcs_mgr)
+                           const FuncManager& funcs_mgr,
+                           WorkStealingThreadPool* intra_op_thread_pool)
     : OpNodeProtoHelper(&proto_helper_context_),
       node_(node),
       kernel_def_(kernel_def),
@@ -21,6 +22,7 @@ OpKernelInfo::OpKernelInfo(const onnxruntime::Node& node,
       initialized_tensors_(initialized_tensors),
       mlvalue_name_idx_map_(mlvalue_name_idx_map),
       funcs_mgr_(funcs_mgr),
+      intra_op_thread_pool_(intra_op_thread_pool),
       proto_helper_context_(node) {}
 
 OpKernelInfo::OpKernelInfo(const OpKernelInfo& other)
@@ -29,7 +31,8 @@ OpKernelInfo::OpKernelInfo(const OpKernelInfo& other)
                    *other.execution_provider_,
                    other.initialized_tensors_,
                    other.mlvalue_name_idx_map_,
-                   other.funcs_mgr_) {}
+                   other.funcs_mgr_,
+                   other.intra_op_thread_pool_) {}
 
 const OrtAllocatorInfo& OpKernelInfo::GetAllocatorInfo(int device_id, OrtMemType mem_type) const {
   AllocatorPtr alloc = GetAllocator(device_id, mem_type);
@@ -75,6 +78,10 @@ bool OpKernelInfo::TryGetConstantInput(int input_index, const Tensor** constant_
   return true;
 }
 
+WorkStealingThreadPool* OpKernelInfo::GetIntraOpThreadPool() const noexcept {
+  return intra_op_thread_pool_;
+}
+
 common::Status OpKernelInfo::GetFusedFuncs(ComputeFunc* compute, CreateFunctionStateFunc* create, DestroyFunctionStateFunc* release) const {
   return funcs_mgr_.GetFuncs(node_.Name(), compute, create, release);
 }
@@ -3,15 +3,18 @@
 
 #include "core/framework/parallel_executor.h"
 
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <thread>
 #include <vector>
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
+#include "core/platform/ort_mutex.h"
 
-#ifndef USE_EIGEN_THREADPOOL
-#include "core/common/task_thread_pool.h"
+#include "core/common/work_stealing_thread_pool.h"
+#ifdef USE_EIGEN_THREADPOOL
+#include <unsupported/Eigen/CXX11/ThreadPool>
 #endif
 
 #include "core/framework/allocation_planner.h"
@@ -21,14 +24,55 @@
 
 namespace onnxruntime {
 
-ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag)
-    : out_standings_(0), terminate_flag_{terminate_flag} {
-  auto graph_viewer = session_state.GetGraphViewer();
-  node_refs_.resize(graph_viewer->MaxNodeIndex());
-  for (auto& node : graph_viewer->Nodes()) {
-    node_refs_[node.Index()] = node.GetInputEdgesCount();
+struct ParallelExecutor::RunContext {
+  RunContext(const SessionState& session_state_in, ExecutionFrame& frame_in, const bool& terminate_flag_in,
+             const logging::Logger& logger_in)
+      : session_state{session_state_in},
+        frame{frame_in},
+        terminate_flag{terminate_flag_in},
+        logger{logger_in} {
+    // the counts are calculated once when the session is initialized so all we need to do is copy them
+    const auto& dependency_counts = session_state.GetNodeDependencyCounts();
+    node_refs = std::make_unique<std::atomic<int>[]>(dependency_counts.size());
+    for (size_t i = 0, end = dependency_counts.size(); i < end; ++i) {
+      node_refs[i].store(dependency_counts[i], std::memory_order_relaxed);
+    }
+  }
+
+  const SessionState& session_state;
+  ExecutionFrame& frame;
+  const bool& terminate_flag;
+  const logging::Logger& logger;
+
+  // remaining number of inputs each node is waiting on
+  std::unique_ptr<std::atomic<int>[]> node_refs;
+  std::atomic<int> out_standings{0};
+  OrtMutex complete_mutex;
+  OrtCondVar complete_cv;
+  bool run_completed = false;  // protected by complete_mutex
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunContext);
+};
+
+#ifndef USE_EIGEN_THREADPOOL
+// Record how much work each inter-op worker did during the run, how often it had to steal, and how long it
+// was idle. The pool is shared by concurrent Run calls so the values are only exact when runs don't overlap.
+static void RecordWorkerStats(const SessionState& session_state,
+                              const std::vector<WorkStealingThreadPool::WorkerStats>& stats_before,
+                              TimePoint& start_time) {
+  auto stats_after = session_state.GetThreadPool()->GetStats();
+  for (size_t i = 0, end = stats_after.size(); i < end; ++i) {
+    auto& before = stats_before[i];
+    auto& after = stats_after[i];
+    session_state.Profiler().EndTimeAndRecordEvent(
+        profiling::SESSION_EVENT, "inter_op_worker_" + std::to_string(i), start_time,
+        {{"tasks", std::to_string(after.tasks_run - before.tasks_run)},
+         {"steals", std::to_string(after.steals - before.steals)},
+         {"idle_us", std::to_string(after.idle_microseconds - before.idle_microseconds)}});
   }
 }
+#endif
 
 Status ParallelExecutor::Execute(const SessionState& session_state,
                                  const NameMLValMap& feeds,
@@ -36,72 +80,91 @@ Status ParallelExecutor::Execute(const SessionState& session_state,
                                  std::vector<MLValue>& fetches,
                                  const std::unordered_map<size_t, CustomAllocator> fetch_allocators,
                                  const logging::Logger& logger) {
+  // reuse a frame from an earlier run if one is free. it goes back to the pool when this run is done.
+  auto frame = session_state.AcquireExecutionFrame(feeds, output_names, fetches, fetch_allocators);
+  return ExecuteImpl(session_state, *frame, fetches, logger);
+}
+
+Status ParallelExecutor::Execute(const SessionState& session_state,
+                                 const FeedsFetchesInfo& feeds_fetches_info,
+                                 const std::vector<MLValue>& feeds,
+                                 std::vector<MLValue>& fetches,
+                                 const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                                 const logging::Logger& logger) {
+  auto frame = session_state.AcquireExecutionFrame(feeds_fetches_info, feeds, fetches, fetch_allocators);
+  return ExecuteImpl(session_state, *frame, fetches, logger);
+}
+
+Status ParallelExecutor::ExecuteImpl(const SessionState& session_state,
+                                     ExecutionFrame& frame,
+                                     std::vector<MLValue>& fetches,
+                                     const logging::Logger& logger) {
   TimePoint tp;
   bool f_profiler_enabled = session_state.Profiler().FEnabled();
+#ifndef USE_EIGEN_THREADPOOL
+  std::vector<WorkStealingThreadPool::WorkerStats> worker_stats;
+#endif
   if (f_profiler_enabled) {
     tp = session_state.Profiler().StartTime();
+#ifndef USE_EIGEN_THREADPOOL
+    worker_stats = session_state.GetThreadPool()->GetStats();
+#endif
   }
 
-  root_frame_ = std::make_unique<ExecutionFrame>(feeds, output_names, fetches, fetch_allocators, session_state);
-  //std::cout << "start nodes:" << std::endl;
+  RunContext run_context{session_state, frame, terminate_flag_, logger};
+
+  // hold a reference while the root nodes are enqueued so the run can't be seen as complete
+  // if the first root node finishes before we've scheduled the rest.
+  run_context.out_standings.store(1, std::memory_order_relaxed);
   for (auto node_index : session_state.GetGraphViewer()->GetRootNodes()) {
     auto p_op_kernel = session_state.GetKernel(node_index);
     if (!p_op_kernel)
       continue;
 
-    //std::cout << "\t" << p_op_kernel->Node().Name() << std::endl;
-    EnqueueNode(node_index, session_state, logger);
+    EnqueueNode(node_index, run_context);
   }
+  FinishNodeRun(run_context);
 
   // Wait for finish.
   {
-    std::unique_lock<OrtMutex> lock(complete_mutex_);
-    while (out_standings_ > 0) complete_cv_.wait(lock);
+    std::unique_lock<OrtMutex> lock(run_context.complete_mutex);
+    while (!run_context.run_completed) run_context.complete_cv.wait(lock);
   }
 
   VLOGS(logger, 1) << "Fetching output.";
-  ORT_RETURN_IF_ERROR(
-      FetchOutput(session_state.GetMLValueNameIdxMap(), *root_frame_, output_names, fetches, logger));
-
-  if (root_frame_->HasPlan()) {
-    std::vector<TensorShape> input_shapes;
-    bool all_tensors = true;
-    for (const auto& feed : feeds) {
-      if (!(feed.second.IsTensor())) {
-        all_tensors = false;
-        break;
-      }
-      auto& tensor = feed.second.Get<Tensor>();
-      input_shapes.push_back(tensor.Shape());
-    }
+  ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
+  VLOGS(logger, 1) << "Done with execution.";
 
-    if (all_tensors) {
-      auto mem_patterns = std::make_unique<MemoryPatternGroup>();
-      ORT_RETURN_IF_ERROR(root_frame_->GeneratePatterns(mem_patterns.get()));
-      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns)));
-    }
+  // the frame only has a plan if all the feeds are tensors and there's no pattern for their shapes yet
+  if (frame.HasPlan()) {
+    auto mem_patterns = std::make_unique<MemoryPatternGroup>();
+    ORT_RETURN_IF_ERROR(frame.GeneratePatterns(mem_patterns.get()));
+    ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(frame.GetFeedShapes(), std::move(mem_patterns)));
   }
 
   if (f_profiler_enabled) {
+#ifndef USE_EIGEN_THREADPOOL
+    RecordWorkerStats(session_state, worker_stats, tp);
+#endif
     session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "ParallelExecutor::Execute", tp);
   }
   return Status::OK();
 }
 
-void ParallelExecutor::RunNodeAsync(size_t p_node_index,
-                                    const SessionState& session_state,
-                                    const logging::Logger& logger) {
+void ParallelExecutor::RunNodeAsync(size_t p_node_index, RunContext& run_context) {
   try {
-    RunNodeAsyncInternal(p_node_index, session_state, logger);
+    RunNodeAsyncInternal(p_node_index, run_context);
   } catch (...) {
-    FinishNodeRun();
+    FinishNodeRun(run_context);
     throw;
   }
 }
 
-void ParallelExecutor::RunNodeAsyncInternal(size_t p_node_index,
-                                            const SessionState& session_state,
-                                            const logging::Logger& logger) {
+void ParallelExecutor::RunNodeAsyncInternal(size_t p_node_index, RunContext& run_context) {
+  const SessionState& session_state = run_context.session_state;
+  const logging::Logger& logger = run_context.logger;
+  const bool& terminate_flag = run_context.terminate_flag;
+
   LOGS(logger, INFO) << "Begin execution";
 
   size_t node_index = p_node_index;
@@ -114,7 +177,7 @@ void ParallelExecutor::RunNodeAsyncInternal(size_t p_node_index,
   while (keep_running) {
     // TODO: Convert RunNodeAsync return Status.
     // to also handle exception propagation
-    if (terminate_flag_) {
+    if (terminate_flag) {
       LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
       ORT_THROW("Exiting due to terminate flag being set to true.");
     }
@@ -127,9 +190,9 @@ void ParallelExecutor::RunNodeAsyncInternal(size_t p_node_index,
                 graph_viewer->GetNode(node_index)->Name());
     }
 
-    OpKernelContextInternal op_kernel_context(*root_frame_, *p_op_kernel, logger,
+    OpKernelContextInternal op_kernel_context(run_context.frame, *p_op_kernel, logger,
                                               p_op_kernel->Node().ImplicitInputDefs(),
-                                              terminate_flag_);
+                                              terminate_flag);
 
     if (f_profiler_enabled) {
       sync_time_begin = session_state.Profiler().StartTime();
@@ -178,7 +241,8 @@ void ParallelExecutor::RunNodeAsyncInternal(size_t p_node_index,
     // call compute on the kernel
     VLOGS(logger, 1) << "Computing kernel: " << p_op_kernel->Node().Name();
 
-    // Execute the kernel.
+    // Execute the kernel. MLAS picks up the intra-op pool from the current thread.
+    IntraOpThreadPoolScope intra_op_scope(session_state.GetIntraOpThreadPool());
     auto status = p_op_kernel->Compute(&op_kernel_context);
     if (!status.IsOK()) {
       ORT_THROW("Compute failed for node: ", graph_viewer->GetNode(node_index)->Name());
@@ -223,79 +287,55 @@ void ParallelExecutor::RunNodeAsyncInternal(size_t p_node_index,
     keep_running = false;
 
     // Checking which output nodes ready for running.
+    // Keep the first ready node to run on this thread and push the others to this worker's deque where idle
+    // workers can steal them.
     {
       auto begin = p_op_kernel->Node().OutputEdgesBegin();
       auto end = p_op_kernel->Node().OutputEdgesEnd();
 
-      std::lock_guard<OrtMutex> lock(ref_mutex_);
       for (auto it = begin; it != end; it++) {
         auto idx = (*it).GetNode().Index();
-        if ((--node_refs_[idx]) == 0) {
+        if (run_context.node_refs[idx].fetch_sub(1, std::memory_order_acq_rel) == 1) {
           if (!keep_running) {
             node_index = idx;
             keep_running = true;
           } else {
-            EnqueueNode(idx, session_state, logger);
+            EnqueueNode(idx, run_context);
           }
         }
-
-        // std::cout << "handle output, current name: " << p_op_kernel->Node().Name() << ", current index: "
-        // << p_node_index << ", output name: " << (*it)->GetNode().Name() << ", output index: "
-        // << (*it)->GetNode().Index() << ", after -- output ref: " << node_refs_[idx] << std::endl;
       }
     }
   }
 
-  FinishNodeRun();
+  FinishNodeRun(run_context);
 }
 
-void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger) {
-  {
-    std::unique_lock<OrtMutex> lock(complete_mutex_);
-    out_standings_++;
-  }
+void ParallelExecutor::EnqueueNode(size_t p_node_index, RunContext& run_context) {
+  run_context.out_standings.fetch_add(1, std::memory_order_relaxed);
 
 #ifdef USE_EIGEN_THREADPOOL
-  session_state.GetThreadPool()->Schedule([this, p_node_index, &session_state, &logger]() {
+  run_context.session_state.GetThreadPool()->Schedule([p_node_index, &run_context]() {
     try {
-      ParallelExecutor::RunNodeAsync(p_node_index, std::cref(session_state), std::cref(logger));
+      ParallelExecutor::RunNodeAsync(p_node_index, run_context);
     } catch (...) {
       // catch node processing failure exceptions here to prevent app crash.
     }
   });
 #else
-  std::packaged_task<void()> task{std::bind(&ParallelExecutor::RunNodeAsync, this, p_node_index, std::cref(session_state), std::cref(logger))};
-  session_state.GetThreadPool()->RunTask(std::move(task));
+  run_context.session_state.GetThreadPool()->Schedule([p_node_index, &run_context]() {
+    ParallelExecutor::RunNodeAsync(p_node_index, run_context);
+  });
 #endif
 }
 
-Status ParallelExecutor::FetchOutput(const MLValueNameIdxMap& name_idx_map,
-                                     ExecutionFrame& frame,
-                                     const std::vector<std::string>& output_names,
-                                     std::vector<MLValue>& fetches,
-                                     const logging::Logger& logger) {
-  if (fetches.empty()) {
-    fetches.resize(output_names.size());
-  } else {
-    // this should've been checked before already
-    ORT_ENFORCE(output_names.size() == fetches.size(),
-                "output_names vector size: " + std::to_string(output_names.size()) +
-                    " does not match that of fetches vector: " + std::to_string(fetches.size()));
+void ParallelExecutor::FinishNodeRun(RunContext& run_context) {
+  // only the last outstanding node takes the lock. the notify happens while holding it so Execute can't
+  // return and destroy the RunContext between the flag being set and the notification.
+  if (run_context.out_standings.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    std::lock_guard<OrtMutex> lock(run_context.complete_mutex);
+    run_context.run_completed = true;
+    run_context.complete_cv.notify_all();
   }
-
-  auto idx = 0;
-
-  for (const auto& oname : output_names) {
-    VLOGS(logger, 1) << "Attempting to fetch output with name: " << oname;
-    int mlvalue_index;
-    ORT_RETURN_IF_ERROR(name_idx_map.GetIdx(oname, mlvalue_index));
-    const MLValue& output_mlvalue = frame.GetMLValue(mlvalue_index);
-    VLOGS(logger, 1) << "Copying fetched MLValue to output vector";
-    fetches[idx++] = output_mlvalue;
-  }
-
-  VLOGS(logger, 1) << "Done with execution.";
-  return Status::OK();
 }
 
 }  // namespace onnxruntime
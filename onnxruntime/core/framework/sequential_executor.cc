@@ -8,6 +8,7 @@
 #include <vector>
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
+#include "core/common/work_stealing_thread_pool.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/session_state.h"
@@ -15,12 +16,6 @@
 
 namespace onnxruntime {
 
-static Status FetchOutput(const MLValueNameIdxMap& name_idx_map,
-                          ExecutionFrame& frame,
-                          const std::vector<std::string>& output_names,
-                          std::vector<MLValue>& fetches,
-                          const logging::Logger& logger);
-
 static Status ReleaseNodeMLValues(ExecutionFrame& frame,
                                   const SequentialExecutionPlan& seq_exec_plan,
                                   const SequentialExecutionPlan::NodeExecutionPlan& node_exec_plan,
@@ -32,6 +27,25 @@ Status SequentialExecutor::Execute(const SessionState& session_state,
                                    std::vector<MLValue>& fetches,
                                    const std::unordered_map<size_t, CustomAllocator> fetch_allocators,
                                    const logging::Logger& logger) {
+  // reuse a frame from an earlier run if one is free. it goes back to the pool when this run is done.
+  auto frame = session_state.AcquireExecutionFrame(feeds, output_names, fetches, fetch_allocators);
+  return ExecuteImpl(session_state, *frame, fetches, logger);
+}
+
+Status SequentialExecutor::Execute(const SessionState& session_state,
+                                   const FeedsFetchesInfo& feeds_fetches_info,
+                                   const std::vector<MLValue>& feeds,
+                                   std::vector<MLValue>& fetches,
+                                   const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                                   const logging::Logger& logger) {
+  auto frame = session_state.AcquireExecutionFrame(feeds_fetches_info, feeds, fetches, fetch_allocators);
+  return ExecuteImpl(session_state, *frame, fetches, logger);
+}
+
+Status SequentialExecutor::ExecuteImpl(const SessionState& session_state,
+                                       ExecutionFrame& frame,
+                                       std::vector<MLValue>& fetches,
+                                       const logging::Logger& logger) {
   bool f_profiler_enabled = session_state.Profiler().FEnabled();
   TimePoint tp;
   TimePoint sync_time_begin;
@@ -41,8 +55,6 @@ Status SequentialExecutor::Execute(const SessionState& session_state,
     tp = session_state.Profiler().StartTime();
   }
 
-  ExecutionFrame frame{feeds, output_names, fetches, fetch_allocators, session_state};
-
   LOGS(logger, INFO) << "Begin execution";
   const SequentialExecutionPlan& seq_exec_plan = *session_state.GetExecutionPlan();
   const auto& exec_plan_vec = seq_exec_plan.execution_plan;
@@ -51,6 +63,9 @@ Status SequentialExecutor::Execute(const SessionState& session_state,
   // uncomment the line below to dump execution plan
   //std::cout << std::make_pair(p_seq_exec_plan, &session_state) << "\n";
 
+  // make the intra-op pool available to code, such as MLAS, that doesn't have the OpKernelContext
+  IntraOpThreadPoolScope intra_op_scope(session_state.GetIntraOpThreadPool());
+
   for (const auto& node_exec_plan : exec_plan_vec) {
     if (terminate_flag_) {
       LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
@@ -162,25 +177,14 @@ Status SequentialExecutor::Execute(const SessionState& session_state,
   }
 
   VLOGS(logger, 1) << "Fetching output.";
-  ORT_RETURN_IF_ERROR(FetchOutput(session_state.GetMLValueNameIdxMap(), frame, output_names, fetches, logger));
+  ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
+  VLOGS(logger, 1) << "Done with execution.";
 
+  // the frame only has a plan if all the feeds are tensors and there's no pattern for their shapes yet
   if (frame.HasPlan()) {
-    std::vector<TensorShape> input_shapes;
-    bool all_tensors = true;
-    for (const auto& feed : feeds) {
-      if (!(feed.second.IsTensor())) {
-        all_tensors = false;
-        break;
-      }
-      auto& tensor = feed.second.Get<Tensor>();
-      input_shapes.push_back(tensor.Shape());
-    }
-
-    if (all_tensors) {
-      auto mem_patterns = std::make_unique<MemoryPatternGroup>();
-      ORT_RETURN_IF_ERROR(frame.GeneratePatterns(mem_patterns.get()));
-      ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns)));
-    }
+    auto mem_patterns = std::make_unique<MemoryPatternGroup>();
+    ORT_RETURN_IF_ERROR(frame.GeneratePatterns(mem_patterns.get()));
+    ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(frame.GetFeedShapes(), std::move(mem_patterns)));
   }
 
   if (f_profiler_enabled) {
@@ -190,35 +194,6 @@ Status SequentialExecutor::Execute(const SessionState& session_state,
   return Status::OK();
 }
 
-static Status FetchOutput(const MLValueNameIdxMap& name_idx_map,
-                          ExecutionFrame& frame,
-                          const std::vector<std::string>& output_names,
-                          std::vector<MLValue>& fetches,
-                          const logging::Logger& logger) {
-  if (fetches.empty()) {
-    fetches.resize(output_names.size());
-  } else {
-    // this should've been checked before already
-    ORT_ENFORCE(output_names.size() == fetches.size(),
-                "output_names vector size: " + std::to_string(output_names.size()) +
-                    " does not match that of fetches vector: " + std::to_string(fetches.size()));
-  }
-
-  auto idx = 0;
-
-  for (const auto& oname : output_names) {
-    VLOGS(logger, 1) << "Attempting to fetch output with name: " << oname;
-    int mlvalue_index;
-    ORT_RETURN_IF_ERROR(name_idx_map.GetIdx(oname, mlvalue_index));
-    const MLValue& output_mlvalue = frame.GetMLValue(mlvalue_index);
-    VLOGS(logger, 1) << "Copying fetched MLValue to output vector";
-    fetches[idx++] = output_mlvalue;
-  }
-
-  VLOGS(logger, 1) << "Done with execution.";
-  return Status::OK();
-}
-
 static Status ReleaseNodeMLValues(ExecutionFrame& frame,
                                   const SequentialExecutionPlan& seq_exec_plan,
                                   const SequentialExecutionPlan::NodeExecutionPlan& node_exec_plan,
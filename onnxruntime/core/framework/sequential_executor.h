@@ -14,6 +14,8 @@
 #include "core/graph/graph_viewer.h"
 
 namespace onnxruntime {
+class ExecutionFrame;
+
 class SequentialExecutor : public IExecutor {
  public:
   SequentialExecutor(const bool& terminate_flag = false) : terminate_flag_{terminate_flag} {}
@@ -25,8 +27,21 @@ class SequentialExecutor : public IExecutor {
                          const std::unordered_map<size_t, CustomAllocator> fetch_allocators,
                          const logging::Logger& logger) override;
 
+  common::Status Execute(const SessionState& session_state,
+                         const FeedsFetchesInfo& feeds_fetches_info,
+                         const std::vector<MLValue>& feeds,
+                         std::vector<MLValue>& fetches,
+                         const std::unordered_map<size_t, CustomAllocator>& fetch_allocators,
+                         const logging::Logger& logger) override;
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SequentialExecutor);
+
+  // run the graph with a frame that has been set up with the feeds and fetches
+  common::Status ExecuteImpl(const SessionState& session_state,
+                             ExecutionFrame& frame,
+                             std::vector<MLValue>& fetches,
+                             const logging::Logger& logger);
   const bool& terminate_flag_;
 };
 }  // namespace onnxruntime
@@ -6,6 +6,7 @@
 #include <sstream>
 
 #include "core/common/logging/logging.h"
+#include "core/framework/execution_frame.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/utils.h"
@@ -13,9 +14,16 @@
 using namespace ::onnxruntime::common;
 namespace onnxruntime {
 
+SessionState::~SessionState() = default;
+
 void SessionState::SetGraphViewer(std::unique_ptr<onnxruntime::GraphViewer> graph_viewer) {
   ORT_ENFORCE(nullptr != graph_viewer);
   graph_viewer_ = std::move(graph_viewer);
+
+  node_dependency_counts_.assign(graph_viewer_->MaxNodeIndex(), 0);
+  for (auto& node : graph_viewer_->Nodes()) {
+    node_dependency_counts_[node.Index()] = static_cast<int>(node.GetInputEdgesCount());
+  }
 }
 
 const onnxruntime::GraphViewer* SessionState::GetGraphViewer() const {
@@ -52,6 +60,10 @@ const std::unordered_map<int, MLValue>& SessionState::GetInitializedTensors() co
   return initialized_tensors_;
 }
 
+void SessionState::RemoveInitializedTensor(int mlvalue_index) {
+  initialized_tensors_.erase(mlvalue_index);
+}
+
 SessionState& SessionState::SetLogger(const logging::Logger& logger) {
   logger_ = &logger;
   return *this;
@@ -71,42 +83,118 @@ void SessionState::SetProfiler(profiling::Profiler& profiler) {
   return *profiler_;
 }
 
-static int64_t CalculateMemoryPatternsKey(const std::vector<TensorShape>& shapes) {
-  int64_t key = 0;
-  for (auto& shape : shapes) {
-    for (auto dim : shape.GetDims())
-      key ^= dim;
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
+    const std::vector<TensorShape>& input_shapes) const {
+  return mem_patterns_.Get(input_shapes);
+}
+
+Status SessionState::UpdateMemoryPatternGroupCache(const std::vector<TensorShape>& input_shape,
+                                                   std::unique_ptr<MemoryPatternGroup> mem_patterns) const {
+  mem_patterns_.Add(input_shape, std::move(mem_patterns));
+  return Status::OK();
+}
+
+std::unique_ptr<ExecutionFrame> SessionState::TakeExecutionFrame() const {
+  std::unique_ptr<ExecutionFrame> frame;
+  {
+    std::lock_guard<OrtMutex> lock(execution_frame_pool_lock_);
+    if (!execution_frame_pool_.empty()) {
+      frame = std::move(execution_frame_pool_.back());
+      execution_frame_pool_.pop_back();
+    }
+  }
+
+  if (!frame) {
+    frame = std::make_unique<ExecutionFrame>(*this);
   }
-  return key;
+
+  return frame;
 }
 
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(const std::vector<TensorShape>& input_shapes) const {
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end())
-    return nullptr;
+SessionState::PooledExecutionFrame SessionState::AcquireExecutionFrame(
+    const std::unordered_map<std::string, MLValue>& feeds,
+    const std::vector<std::string>& output_names,
+    const std::vector<MLValue>& fetches,
+    const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) const {
+  auto frame = TakeExecutionFrame();
 
-  return it->second.get();
+  // Reset outside of the lock as it may need to allocate the memory pattern buffers
+  frame->Reset(feeds, output_names, fetches, fetch_allocators);
+
+  return PooledExecutionFrame(frame.release(), ExecutionFrameReleaser{this});
 }
 
-Status SessionState::UpdateMemoryPatternGroupCache(const std::vector<TensorShape>& input_shape,
-                                                   std::unique_ptr<MemoryPatternGroup> mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shape);
+SessionState::PooledExecutionFrame SessionState::AcquireExecutionFrame(
+    const FeedsFetchesInfo& feeds_fetches_info,
+    const std::vector<MLValue>& feeds,
+    const std::vector<MLValue>& fetches,
+    const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) const {
+  auto frame = TakeExecutionFrame();
+  frame->Reset(feeds_fetches_info, feeds, fetches, fetch_allocators);
+
+  return PooledExecutionFrame(frame.release(), ExecutionFrameReleaser{this});
+}
 
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
-    mem_patterns_[key] = std::move(mem_patterns);
+void SessionState::ExecutionFrameReleaser::operator()(ExecutionFrame* frame) const {
+  std::unique_ptr<ExecutionFrame> owned_frame(frame);
+
+  // drop the values from the run before taking the lock. any output the caller still holds keeps its own
+  // reference so it's not affected.
+  owned_frame->Release();
+
+  {
+    std::lock_guard<OrtMutex> lock(session_state->execution_frame_pool_lock_);
+    auto& pool = session_state->execution_frame_pool_;
+    if (pool.size() < session_state->execution_frame_pool_capacity_) {
+      pool.push_back(std::move(owned_frame));
+    }
   }
 
-  return Status::OK();
+  // a frame that didn't fit in the pool is destroyed here, outside of the lock
+}
+
+void SessionState::SetExecutionFramePoolCapacity(size_t capacity) {
+  execution_frame_pool_capacity_ = capacity;
+}
+
+size_t SessionState::GetExecutionFramePoolSize() const {
+  std::lock_guard<OrtMutex> lock(execution_frame_pool_lock_);
+  return execution_frame_pool_.size();
+}
+
+void SessionState::ReleaseExecutionFramePool() const {
+  std::vector<std::unique_ptr<ExecutionFrame>> frames;
+  {
+    std::lock_guard<OrtMutex> lock(execution_frame_pool_lock_);
+    frames.swap(execution_frame_pool_);
+  }
+
+  // free the buffers outside of the lock
+  frames.clear();
+
+  for (const auto& node_to_map_pair : subgraph_session_states_) {
+    for (const auto& attr_name_to_subgraph : node_to_map_pair.second) {
+      attr_name_to_subgraph.second->ReleaseExecutionFramePool();
+    }
+  }
 }
 
 void SessionState::SetEnableMemoryPattern(bool flag) {
   enable_mem_pattern_ = flag;
 }
 
+void SessionState::SetEnableMemoryPatternOfflinePacking(bool flag) {
+  enable_mem_pattern_offline_packing_ = flag;
+}
+
+bool SessionState::GetEnableMemoryPatternOfflinePacking() const {
+  return enable_mem_pattern_offline_packing_;
+}
+
+void SessionState::SetMemoryPatternCacheOptions(size_t capacity, const std::vector<int64_t>& dim_buckets) {
+  mem_patterns_.Configure(capacity, dim_buckets);
+}
+
 bool SessionState::GetEnableMemoryPattern() const {
   return enable_mem_pattern_;
 }
@@ -14,8 +14,11 @@
 #include "core/common/profiler.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_providers.h"
+#include "core/framework/feeds_fetches_info.h"
+#include "core/framework/iexecutor.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/mem_pattern_cache.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/mlvalue_name_idx_map.h"
 #include "core/framework/node_index_info.h"
@@ -28,16 +31,16 @@
 
 namespace onnxruntime {
 
+class ExecutionFrame;
 class ExecutionProviders;
 class KernelDef;
 class OpKernel;
 class NodeIndexInfo;
+class SharedInitializerCache;
 struct SequentialExecutionPlan;
 struct MemoryPatternGroup;
 
-#ifndef USE_EIGEN_THREADPOOL
-class TaskThreadPool;
-#endif
+class WorkStealingThreadPool;
 
 // SessionState should be modified by the inference session class only.
 // It is supposed to be passed by const-ref only to all the executors.
@@ -47,10 +50,18 @@ class SessionState {
       : execution_providers_{execution_providers} {
   }
 
+  ~SessionState();
+
   // Graph viewer.
   void SetGraphViewer(std::unique_ptr<onnxruntime::GraphViewer> graph_viewer);
   const onnxruntime::GraphViewer* GetGraphViewer() const;
 
+  /**
+  Get the number of input edges for each node, indexed by NodeIndex.
+  Calculated when the graph viewer is set so the parallel executor doesn't need to walk the graph on every run.
+  */
+  const std::vector<int>& GetNodeDependencyCounts() const { return node_dependency_counts_; }
+
   // kernels
   // Get kernel for specified node.
   // It should called right before graph execution only.
@@ -76,6 +87,12 @@ class SessionState {
   */
   const std::unordered_map<int, MLValue>& GetInitializedTensors() const;
 
+  /**
+  * Removes an initialized tensor that no kernel reads when the graph is executed,
+  * e.g. one every kernel using it has pre-packed.
+  */
+  void RemoveInitializedTensor(int mlvalue_index);
+
   // execution plan
   void SetExecutionPlan(std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan);
   const SequentialExecutionPlan* GetExecutionPlan() const;
@@ -103,9 +120,10 @@ class SessionState {
   profiling::Profiler& Profiler() const;
 
   /**
-  Get cached memory pattern based on input shapes
+  Get cached memory pattern based on input shapes.
+  The returned pointer keeps the pattern alive if the cache evicts it while a frame is using it.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(const std::vector<TensorShape>& input_shapes) const;
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(const std::vector<TensorShape>& input_shapes) const;
 
   /**
   Set generated memory pattern with a given input shapes. 
@@ -114,6 +132,48 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(const std::vector<TensorShape>& input_shape,
                                        std::unique_ptr<MemoryPatternGroup> mem_patterns) const;
 
+  /// Returns a pooled ExecutionFrame to the SessionState it came from once the run using it is done.
+  struct ExecutionFrameReleaser {
+    const SessionState* session_state;
+    void operator()(ExecutionFrame* frame) const;
+  };
+
+  using PooledExecutionFrame = std::unique_ptr<ExecutionFrame, ExecutionFrameReleaser>;
+
+  /**
+  Get an ExecutionFrame set up for a run with the given feeds and fetches.
+  Frames are pooled, one per concurrent run up to the pool capacity. A frame released by an earlier run is reused along with the memory
+  pattern buffers it bound for that run's input shapes, so a steady state run doesn't allocate a frame.
+  Const as it's an internal cache update only.
+  */
+  PooledExecutionFrame AcquireExecutionFrame(const std::unordered_map<std::string, MLValue>& feeds,
+                                             const std::vector<std::string>& output_names,
+                                             const std::vector<MLValue>& fetches,
+                                             const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) const;
+
+  /**
+  Get an ExecutionFrame set up for a run with feeds and fetches in the order of the names in feeds_fetches_info.
+  */
+  PooledExecutionFrame AcquireExecutionFrame(const FeedsFetchesInfo& feeds_fetches_info,
+                                             const std::vector<MLValue>& feeds,
+                                             const std::vector<MLValue>& fetches,
+                                             const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) const;
+
+  /**
+  Set how many ExecutionFrames released by finished runs are kept for reuse. A frame released while the pool is full
+  is destroyed, so only that many concurrent runs skip setting up a frame.
+  */
+  void SetExecutionFramePoolCapacity(size_t capacity);
+
+  /// The number of ExecutionFrames currently pooled for reuse.
+  size_t GetExecutionFramePoolSize() const;
+
+  /**
+  Destroy the pooled ExecutionFrames of this and the subgraph SessionStates, so the memory pattern buffers they hold
+  go back to the arenas. Frames in use by runs in progress are pooled again when the runs finish.
+  */
+  void ReleaseExecutionFramePool() const;
+
   /**
   Set enable memory pattern flag
   */
@@ -124,6 +184,22 @@ class SessionState {
   */
   bool GetEnableMemoryPattern() const;
 
+  /**
+  Set whether memory patterns are packed offline using the lifetimes of all the traced allocations.
+  See MemPatternPlanner for details.
+  */
+  void SetEnableMemoryPatternOfflinePacking(bool flag);
+
+  bool GetEnableMemoryPatternOfflinePacking() const;
+
+  /**
+  Set the maximum number of cached memory patterns, and the buckets to round input dims up to when looking them up.
+  See MemoryPatternCache for details. Drops any cached patterns.
+  */
+  void SetMemoryPatternCacheOptions(size_t capacity, const std::vector<int64_t>& dim_buckets);
+
+  const MemoryPatternCache& GetMemoryPatternCache() const { return mem_patterns_; }
+
   struct NodeInfo {
     NodeInfo(size_t index0, const onnxruntime::Node* p_node0, const KernelCreateInfo* kci0)
         : index(index0),
@@ -161,10 +237,14 @@ class SessionState {
   Eigen::NonBlockingThreadPool* GetThreadPool() const { return thread_pool_; }
   void SetThreadPool(Eigen::NonBlockingThreadPool* p_pool) { thread_pool_ = p_pool; }
 #else
-  TaskThreadPool* GetThreadPool() const { return thread_pool_; }
-  void SetThreadPool(TaskThreadPool* p_pool) { thread_pool_ = p_pool; }
+  WorkStealingThreadPool* GetThreadPool() const { return thread_pool_; }
+  void SetThreadPool(WorkStealingThreadPool* p_pool) { thread_pool_ = p_pool; }
 #endif
 
+  /// Thread pool shared by the kernels to parallelize work within a node. nullptr if single threaded.
+  WorkStealingThreadPool* GetIntraOpThreadPool() const { return intra_op_thread_pool_; }
+  void SetIntraOpThreadPool(WorkStealingThreadPool* p_pool) { intra_op_thread_pool_ = p_pool; }
+
   bool ExportDll() const { return export_fused_dll_; }
   void SetExportDllFlag(bool flag) { export_fused_dll_ = flag; }
 
@@ -173,16 +253,27 @@ class SessionState {
 
   std::map<OrtAllocatorInfo, BufferUniquePtr>& GetMutableWeightsBuffers() { return weights_buffers_; }
 
+  /// Cache to take the initializers that other sessions may share from. nullptr if they aren't shared.
+  SharedInitializerCache* GetSharedInitializerCache() const { return shared_initializer_cache_; }
+  void SetSharedInitializerCache(SharedInitializerCache* cache) { shared_initializer_cache_ = cache; }
+
+  /// Buffers of the initializers taken from the shared initializer cache, held for the life of the session.
+  std::vector<std::shared_ptr<void>>& GetMutableSharedWeightsBuffers() { return shared_weights_buffers_; }
+
   void CalculateNodeIndexInfo();
   const NodeIndexInfo& GetNodeIndexInfo() const;
 
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SessionState);
 
+  // take a frame from execution_frame_pool_, or create one if they're all in use
+  std::unique_ptr<ExecutionFrame> TakeExecutionFrame() const;
+
   // cache of the constructed kernels to avoid spending construction
   // time per executor
   std::unordered_map<onnxruntime::NodeIndex, std::unique_ptr<OpKernel>> session_kernels_;
   std::unique_ptr<onnxruntime::GraphViewer> graph_viewer_;
+  std::vector<int> node_dependency_counts_;
 
   const ExecutionProviders& execution_providers_;  // owned by InferenceSession
   MLValueNameIdxMap mlvalue_name_idx_map_;
@@ -190,6 +281,8 @@ class SessionState {
   // initialized tensorset
   std::unordered_map<int, MLValue> initialized_tensors_;  // key is mlvalue_index
   std::map<OrtAllocatorInfo, BufferUniquePtr> weights_buffers_;
+  std::vector<std::shared_ptr<void>> shared_weights_buffers_;
+  SharedInitializerCache* shared_initializer_cache_ = nullptr;
   std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan_ = nullptr;
 
   const logging::Logger* logger_ = nullptr;
@@ -197,10 +290,9 @@ class SessionState {
 
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_ = true;
-  // lock for the mem_patterns_
-  mutable OrtMutex mem_patterns_lock_;
+  bool enable_mem_pattern_offline_packing_ = false;
   // cache for the generated mem_patterns. key is calculated based on input shapes.
-  mutable std::map<int64_t, std::unique_ptr<MemoryPatternGroup>> mem_patterns_;
+  mutable MemoryPatternCache mem_patterns_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -214,12 +306,20 @@ class SessionState {
 #ifdef USE_EIGEN_THREADPOOL
   Eigen::NonBlockingThreadPool* thread_pool_ = nullptr;
 #else
-  TaskThreadPool* thread_pool_ = nullptr;
+  WorkStealingThreadPool* thread_pool_ = nullptr;
 #endif
 
+  WorkStealingThreadPool* intra_op_thread_pool_ = nullptr;
+
   bool export_fused_dll_ = false;
   FuncManager fused_funcs_mgr_;
 
   std::unique_ptr<NodeIndexInfo> node_index_info_;
+
+  // frames released by completed runs, ready to be reused. declared last so they're destroyed before the state
+  // they reference.
+  size_t execution_frame_pool_capacity_ = 1;
+  mutable OrtMutex execution_frame_pool_lock_;
+  mutable std::vector<std::unique_ptr<ExecutionFrame>> execution_frame_pool_;
 };
 }  // namespace onnxruntime
@@ -5,10 +5,13 @@
 
 #include <functional>
 #include <limits>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 
+#include "core/graph/graph_utils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/graph_partitioner.h"
 #include "core/framework/ml_value.h"
@@ -16,6 +19,7 @@
 #include "core/framework/mlvalue_name_idx_map.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializer_cache.h"
 #include "core/framework/tensorutils.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
@@ -34,10 +38,13 @@ static common::Status SaveInitializedTensors(const onnxruntime::Graph& graph,
                                              const ExecutionProviders& exec_providers,
                                              const MLValueNameIdxMap& mlvalue_name_idx_map,
                                              std::map<OrtAllocatorInfo, BufferUniquePtr>& weights_buffers,
+                                             SharedInitializerCache* shared_initializer_cache,
+                                             std::vector<std::shared_ptr<void>>& shared_weights_buffers,
                                              const SaveTensorFunc& save_tensor_func,
                                              const logging::Logger& logger);
 
-static common::Status SaveKernels(const ExecutionProviders& execution_providers,
+static common::Status SaveKernels(const onnxruntime::Graph& graph,
+                                  const ExecutionProviders& execution_providers,
                                   SessionState& session_state,
                                   const KernelRegistryManager& custom_registry_manager,
                                   const logging::Logger& logger);
@@ -114,11 +121,13 @@ common::Status SessionStateInitializer::InitializeAndSave(bool enable_memory_pat
 
   ORT_RETURN_IF_ERROR(SaveInitializedTensors(graph_, enable_memory_pattern, exec_plan, execution_providers_,
                                              mlvalue_name_idx_map, session_state_.GetMutableWeightsBuffers(),
+                                             session_state_.GetSharedInitializerCache(),
+                                             session_state_.GetMutableSharedWeightsBuffers(),
                                              add_initialized_tensor, logger_));
 
   graph_.CleanAllInitializedTensors();  // remove weights from the graph now to save memory
 
-  ORT_RETURN_IF_ERROR(SaveKernels(execution_providers_, session_state_, kernel_registry_manager_, logger_));
+  ORT_RETURN_IF_ERROR(SaveKernels(graph_, execution_providers_, session_state_, kernel_registry_manager_, logger_));
   ORT_RETURN_IF_ERROR(SaveInputOutputNamesToNodeMapping(graph_, kernel_registry_manager_, session_state_,
                                                         implicit_inputs));
 
@@ -227,6 +236,54 @@ common::Status DeserializeTensorProto(const ONNX_NAMESPACE::TensorProto& tensor_
   return common::Status::OK();
 }
 
+// Create the CPU tensor for an initializer over its raw_data in the model file if the file is mapped into memory.
+// Returns false if it isn't, or if the data can't be used in place, e.g. because it isn't aligned for its type.
+static bool TryUseMappedData(const Graph& graph, const std::string& name, const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                             const OrtAllocatorInfo& location, MLValue& mlvalue, const logging::Logger& logger) {
+  if (strcmp(location.name, CPU) != 0) {
+    return false;
+  }
+
+  size_t length = 0;
+  const void* data = graph.GetMappedInitializerData(name, length);
+  if (data == nullptr) {
+    return false;
+  }
+
+  std::unique_ptr<Tensor> p_tensor;
+  Status status = utils::GetTensorOverRawData(tensor_proto, data, length, location, &p_tensor);
+  if (!status.IsOK()) {
+    VLOGS(logger, 1) << "Copying initializer " << name << " from the mapped model file. " << status.ErrorMessage();
+    return false;
+  }
+
+  mlvalue.Init(p_tensor.release(),
+               DataTypeImpl::GetType<Tensor>(),
+               DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return true;
+}
+
+// Take the tensor for an initializer from the cache shared with other sessions, adding it if they don't use it yet.
+// Returns false if there's no cache or the initializer can't be shared.
+static bool TryUseSharedInitializer(SharedInitializerCache* cache, const std::string& name,
+                                    const ONNX_NAMESPACE::TensorProto& tensor_proto, const OrtAllocatorInfo& location,
+                                    std::vector<std::shared_ptr<void>>& shared_weights_buffers, MLValue& mlvalue,
+                                    const logging::Logger& logger) {
+  if (cache == nullptr || !SharedInitializerCache::CanShare(tensor_proto, location)) {
+    return false;
+  }
+
+  std::shared_ptr<void> buffer;
+  Status status = cache->GetOrAdd(tensor_proto, location, buffer, mlvalue);
+  if (!status.IsOK()) {
+    VLOGS(logger, 1) << "Not sharing initializer " << name << ". " << status.ErrorMessage();
+    return false;
+  }
+
+  shared_weights_buffers.push_back(std::move(buffer));
+  return true;
+}
+
 static common::Status PlanTensor(MLValuePatternPlanner& planner, const MLValueNameIdxMap& mlvalue_name_idx_map, const std::string& name, const ONNX_NAMESPACE::TensorProto& tensor_proto) {
   int mlvalue_index;
   ORT_RETURN_IF_ERROR(mlvalue_name_idx_map.GetIdx(name, mlvalue_index));
@@ -242,6 +299,8 @@ common::Status SaveInitializedTensorsWithMemPattern(const Graph& graph,
                                                     const ExecutionProviders& exec_providers,
                                                     const MLValueNameIdxMap& mlvalue_name_idx_map,
                                                     std::map<OrtAllocatorInfo, BufferUniquePtr>& weights_buffers,
+                                                    SharedInitializerCache* shared_initializer_cache,
+                                                    std::vector<std::shared_ptr<void>>& shared_weights_buffers,
                                                     const SaveTensorFunc& save_tensor_func,
                                                     const logging::Logger& logger) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
@@ -250,9 +309,35 @@ common::Status SaveInitializedTensorsWithMemPattern(const Graph& graph,
 
   MLValuePatternPlanner planner(execution_plan);
 
-  //1. first plan the memory
+  //0. initializers used in place in a mapped model file, or shared with other sessions, need no buffer
   const onnxruntime::InitializedTensorSet& initialized_tensor_set = graph.GetAllInitializedTensors();
+  std::unordered_set<std::string> unplanned_tensors;
   for (const auto& entry : initialized_tensor_set) {
+    const std::string& name = entry.first;
+    int mlvalue_index;
+    ORT_RETURN_IF_ERROR(mlvalue_name_idx_map.GetIdx(name, mlvalue_index));
+    const auto& location = execution_plan.allocation_plan[mlvalue_index].location;
+
+    MLValue mlvalue;
+    if (TryUseMappedData(graph, name, *entry.second, location, mlvalue, logger)) {
+      VLOGS(logger, 1) << "Added weight with name : " << name << " from the mapped model file";
+    } else if (TryUseSharedInitializer(shared_initializer_cache, name, *entry.second, location,
+                                       shared_weights_buffers, mlvalue, logger)) {
+      VLOGS(logger, 1) << "Added weight with name : " << name << " from the shared initializer cache";
+    } else {
+      continue;
+    }
+
+    save_tensor_func(mlvalue_index, mlvalue);
+    unplanned_tensors.insert(name);
+  }
+
+  //1. first plan the memory
+  for (const auto& entry : initialized_tensor_set) {
+    if (unplanned_tensors.count(entry.first) != 0) {
+      continue;
+    }
+
     //string/complex64/complex128 tensors will be skipped
     ORT_RETURN_IF_ERROR(PlanTensor(planner, mlvalue_name_idx_map, entry.first, *entry.second));
   }
@@ -277,6 +362,10 @@ common::Status SaveInitializedTensorsWithMemPattern(const Graph& graph,
   //3. create weight tensors based on weights buffer
   for (const auto& entry : initialized_tensor_set) {
     const std::string& name = entry.first;
+    if (unplanned_tensors.count(name) != 0) {
+      continue;
+    }
+
     int mlvalue_index;
     ORT_RETURN_IF_ERROR(mlvalue_name_idx_map.GetIdx(name, mlvalue_index));
     const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
@@ -324,6 +413,8 @@ common::Status SaveInitializedTensorsWithSeperateBuffer(const onnxruntime::Graph
                                                         const SequentialExecutionPlan& execution_plan,
                                                         const ExecutionProviders& exec_providers,
                                                         const MLValueNameIdxMap& mlvalue_name_idx_map,
+                                                        SharedInitializerCache* shared_initializer_cache,
+                                                        std::vector<std::shared_ptr<void>>& shared_weights_buffers,
                                                         const SaveTensorFunc& save_tensor_func,
                                                         const logging::Logger& logger) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
@@ -338,7 +429,12 @@ common::Status SaveInitializedTensorsWithSeperateBuffer(const onnxruntime::Graph
     VLOGS(logger, 1) << "About to add weight with name: " << name << " and index: " << mlvalue_index;
     auto& location = execution_plan.allocation_plan[mlvalue_index].location;
     MLValue mlvalue;
-    ORT_RETURN_IF_ERROR(DeserializeTensorProto(*(entry.second), location, exec_providers, mlvalue, nullptr, 0));
+    if (!TryUseMappedData(graph, name, *(entry.second), location, mlvalue, logger) &&
+        !TryUseSharedInitializer(shared_initializer_cache, name, *(entry.second), location, shared_weights_buffers,
+                                 mlvalue, logger)) {
+      ORT_RETURN_IF_ERROR(DeserializeTensorProto(*(entry.second), location, exec_providers, mlvalue, nullptr, 0));
+    }
+
     save_tensor_func(mlvalue_index, mlvalue);
     VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << mlvalue_index;
   }
@@ -353,6 +449,8 @@ common::Status SaveInitializedTensors(const onnxruntime::Graph& graph,
                                       const ExecutionProviders& exec_providers,
                                       const MLValueNameIdxMap& mlvalue_name_idx_map,
                                       std::map<OrtAllocatorInfo, BufferUniquePtr>& weights_buffers,
+                                      SharedInitializerCache* shared_initializer_cache,
+                                      std::vector<std::shared_ptr<void>>& shared_weights_buffers,
                                       const SaveTensorFunc& save_tensor_func,
                                       const logging::Logger& logger) {
   // if we enable the memory pattern and already have the execution plan
@@ -360,10 +458,12 @@ common::Status SaveInitializedTensors(const onnxruntime::Graph& graph,
   // the weights.
   if (enable_memory_pattern) {
     return SaveInitializedTensorsWithMemPattern(graph, execution_plan, exec_providers,
-                                                mlvalue_name_idx_map, weights_buffers, save_tensor_func, logger);
+                                                mlvalue_name_idx_map, weights_buffers, shared_initializer_cache,
+                                                shared_weights_buffers, save_tensor_func, logger);
   }
   return SaveInitializedTensorsWithSeperateBuffer(graph, execution_plan, exec_providers,
-                                                  mlvalue_name_idx_map, save_tensor_func, logger);
+                                                  mlvalue_name_idx_map, shared_initializer_cache,
+                                                  shared_weights_buffers, save_tensor_func, logger);
 }
 
 static common::Status CreateOpKernelInternal(const onnxruntime::Node& node,
@@ -403,19 +503,97 @@ static common::Status CreateOpKernel(const onnxruntime::Node& node,
   return status;
 }
 
-common::Status SaveKernels(const ExecutionProviders& execution_providers,
+// the indices of the initialized tensors that the kernels may pre-pack. an initializer that can be overridden by a
+// graph input or that's a graph output must be read at execution time.
+static std::unordered_set<int> GetConstantInitializedTensors(const onnxruntime::Graph& graph,
+                                                             const SessionState& session_state) {
+  const auto& mlvalue_name_idx_map = session_state.GetMLValueNameIdxMap();
+  const auto& initialized_tensors = session_state.GetInitializedTensors();
+
+  std::unordered_set<int> constant_initialized_tensors;
+  for (const auto& entry : initialized_tensors) {
+    constant_initialized_tensors.insert(entry.first);
+  }
+
+  auto exclude = [&](const NodeArg& def) {
+    int idx;
+    if (mlvalue_name_idx_map.GetIdx(def.Name(), idx).IsOK()) {
+      constant_initialized_tensors.erase(idx);
+    }
+  };
+
+  // an initializer that is constant but listed as a graph input can't be fed, see InferenceSession::ValidateInputNames
+  for (const auto* input_def : graph.GetInputsIncludingInitializers()) {
+    if (!utils::IsConstantInitializer(graph, input_def->Name())) {
+      exclude(*input_def);
+    }
+  }
+
+  for (const auto* output_def : graph.GetOutputs()) {
+    exclude(*output_def);
+  }
+
+  return constant_initialized_tensors;
+}
+
+common::Status SaveKernels(const onnxruntime::Graph& graph,
+                           const ExecutionProviders& execution_providers,
                            SessionState& session_state,
                            const KernelRegistryManager& custom_registry_manager,
                            const logging::Logger& logger) {
   LOGS(logger, INFO) << "Saving kernels.";
 
+  const auto& mlvalue_name_idx_map = session_state.GetMLValueNameIdxMap();
+  const auto& initialized_tensors = session_state.GetInitializedTensors();
+  const auto constant_initialized_tensors = GetConstantInitializedTensors(graph, session_state);
+
+  // number of uses of each constant initialized tensor, and how many of them the kernels have pre-packed
+  std::unordered_map<int, std::pair<int, int>> prepacked_counts;
+
   for (auto& node : session_state.GetGraphViewer()->Nodes()) {
     // construct and save the kernels
     std::unique_ptr<OpKernel> op_kernel;
     ORT_RETURN_IF_ERROR(CreateOpKernel(node, execution_providers, session_state, custom_registry_manager, op_kernel, logger));
+
+    const auto& input_defs = node.InputDefs();
+    for (int input_idx = 0; input_idx < static_cast<int>(input_defs.size()); ++input_idx) {
+      int mlvalue_idx;
+      if (!input_defs[input_idx]->Exists() ||
+          !mlvalue_name_idx_map.GetIdx(input_defs[input_idx]->Name(), mlvalue_idx).IsOK() ||
+          constant_initialized_tensors.count(mlvalue_idx) == 0) {
+        continue;
+      }
+
+      const MLValue& mlvalue = initialized_tensors.at(mlvalue_idx);
+      bool is_packed = false;
+      if (mlvalue.IsTensor()) {
+        ORT_RETURN_IF_ERROR(op_kernel->PrePack(mlvalue.Get<Tensor>(), input_idx, is_packed));
+      }
+
+      auto& counts = prepacked_counts[mlvalue_idx];
+      ++counts.first;
+      counts.second += is_packed ? 1 : 0;
+    }
+
+    // a subgraph reads the values it uses from the outer scope itself
+    for (const auto* implicit_input_def : node.ImplicitInputDefs()) {
+      int mlvalue_idx;
+      if (mlvalue_name_idx_map.GetIdx(implicit_input_def->Name(), mlvalue_idx).IsOK() &&
+          constant_initialized_tensors.count(mlvalue_idx) != 0) {
+        ++prepacked_counts[mlvalue_idx].first;
+      }
+    }
+
     session_state.AddKernel(node.Index(), std::move(op_kernel));
   }
 
+  // release the initializers that no kernel reads any more
+  for (const auto& entry : prepacked_counts) {
+    if (entry.second.second == entry.second.first) {
+      session_state.RemoveInitializedTensor(entry.first);
+    }
+  }
+
   LOGS(logger, INFO) << "Done saving kernels.";
 
   return Status::OK();
@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializer_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include "core/framework/tensorprotoutils.h"
+
+namespace onnxruntime {
+
+static size_t Hash(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  std::hash<int64_t> hf;
+  size_t hash = std::hash<std::string>()(tensor_proto.raw_data());
+  hash ^= hf(tensor_proto.data_type()) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  for (auto dim : tensor_proto.dims()) {
+    hash ^= hf(dim) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+
+  return hash;
+}
+
+static constexpr size_t kMinRemoveExpiredSize = 64;
+
+SharedInitializerCache::SharedInitializerCache()
+    : allocator_(std::make_shared<CPUAllocator>()), remove_expired_size_(kMinRemoveExpiredSize) {
+}
+
+bool SharedInitializerCache::CanShare(const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                      const OrtAllocatorInfo& location) {
+  return strcmp(location.name, CPU) == 0 && !tensor_proto.raw_data().empty();
+}
+
+bool SharedInitializerCache::Matches(const Entry& entry, const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                     const OrtAllocatorInfo& location, const void* buffer) const {
+  if (entry.location_name != location.name || entry.location_id != location.id ||
+      entry.location_mem_type != location.mem_type || entry.data_type != tensor_proto.data_type()) {
+    return false;
+  }
+
+  const auto& dims = tensor_proto.dims();
+  if (!std::equal(dims.cbegin(), dims.cend(), entry.dims.cbegin(), entry.dims.cend())) {
+    return false;
+  }
+
+  const std::string& raw_data = tensor_proto.raw_data();
+  return entry.size == raw_data.size() && memcmp(buffer, raw_data.data(), raw_data.size()) == 0;
+}
+
+void SharedInitializerCache::RemoveExpiredEntries() const {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.buffer.expired()) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+Status SharedInitializerCache::GetOrAdd(const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                        const OrtAllocatorInfo& location,
+                                        std::shared_ptr<void>& buffer, MLValue& mlvalue) {
+  ORT_ENFORCE(CanShare(tensor_proto, location), "Initializer ", tensor_proto.name(), " can't be shared.");
+
+  const std::string& raw_data = tensor_proto.raw_data();
+  const size_t hash = Hash(tensor_proto);
+
+  std::lock_guard<OrtMutex> lock(lock_);
+
+  buffer.reset();
+  auto range = entries_.equal_range(hash);
+  for (auto it = range.first; it != range.second;) {
+    auto existing = it->second.buffer.lock();
+    if (!existing) {
+      // the sessions using it have all gone
+      it = entries_.erase(it);
+      continue;
+    }
+
+    if (Matches(it->second, tensor_proto, location, existing.get())) {
+      buffer = std::move(existing);
+      break;
+    }
+
+    ++it;
+  }
+
+  bool added = false;
+  if (!buffer) {
+    auto allocator = allocator_;
+    void* data = allocator->Alloc(raw_data.size());
+    buffer = std::shared_ptr<void>(data, [allocator](void* p) { allocator->Free(p); });
+    memcpy(data, raw_data.data(), raw_data.size());
+    added = true;
+  }
+
+  std::unique_ptr<Tensor> p_tensor;
+  ORT_RETURN_IF_ERROR(utils::GetTensorOverRawData(tensor_proto, buffer.get(), raw_data.size(), location, &p_tensor));
+
+  if (added) {
+    Entry entry;
+    entry.location_name = location.name;
+    entry.location_id = location.id;
+    entry.location_mem_type = location.mem_type;
+    entry.data_type = tensor_proto.data_type();
+    entry.dims.assign(tensor_proto.dims().cbegin(), tensor_proto.dims().cend());
+    entry.buffer = buffer;
+    entry.size = raw_data.size();
+    entries_.emplace(hash, std::move(entry));
+
+    // the cost of the walk is spread over the entries added since the last one
+    if (entries_.size() >= remove_expired_size_) {
+      RemoveExpiredEntries();
+      remove_expired_size_ = std::max(kMinRemoveExpiredSize, 2 * entries_.size());
+    }
+  }
+
+  mlvalue.Init(p_tensor.release(),
+               DataTypeImpl::GetType<Tensor>(),
+               DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+
+  return Status::OK();
+}
+
+SharedInitializerCache::Stats SharedInitializerCache::GetStats() const {
+  std::lock_guard<OrtMutex> lock(lock_);
+
+  RemoveExpiredEntries();
+
+  Stats stats;
+  for (const auto& entry : entries_) {
+    // each session holds a reference to the buffer for every initializer that uses it. a buffer may be released by
+    // another thread while the stats are gathered, as the lock doesn't cover the sessions.
+    const size_t num_references = static_cast<size_t>(entry.second.buffer.use_count());
+    if (num_references == 0) {
+      continue;
+    }
+
+    ++stats.num_tensors;
+    stats.num_bytes += entry.second.size;
+    stats.num_references += num_references;
+    stats.num_referenced_bytes += num_references * entry.second.size;
+  }
+
+  return stats;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ml_value.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+Cache of the initializer tensors used by the sessions of a process, so sessions of the same model, or of models
+that have some initializers in common, hold one read-only copy of each between them.
+
+Tensors are keyed on their content, type and shape along with the location they're placed at. Lookups compare the
+content of a candidate with the TensorProto, so a hash collision never returns the wrong data. Only CPU tensors
+with raw_data are shared, as the content of tensors elsewhere can't be compared cheaply, and initializers small
+enough to be held in the typed fields aren't worth it.
+
+The buffer of a tensor is released when the last session using it goes away. The cache doesn't keep it alive, and
+the entries of released buffers are removed by GetStats and as the cache grows.
+*/
+class SharedInitializerCache {
+ public:
+  /** Memory held in the cache, and the memory the sessions using it would hold without it. */
+  struct Stats {
+    // distinct tensors in use
+    size_t num_tensors = 0;
+    size_t num_bytes = 0;
+    // initializers of all the sessions that use those tensors
+    size_t num_references = 0;
+    size_t num_referenced_bytes = 0;
+  };
+
+  SharedInitializerCache();
+
+  /** Whether tensor_proto can be shared if it's placed at location. */
+  static bool CanShare(const ONNX_NAMESPACE::TensorProto& tensor_proto, const OrtAllocatorInfo& location);
+
+  /**
+  Get the tensor for tensor_proto placed at location, creating it if no session uses it yet.
+  @param buffer Set to the buffer of the tensor. The caller holds it for as long as it uses mlvalue.
+  @param mlvalue Set to a tensor that doesn't own its data.
+  */
+  Status GetOrAdd(const ONNX_NAMESPACE::TensorProto& tensor_proto, const OrtAllocatorInfo& location,
+                  std::shared_ptr<void>& buffer, MLValue& mlvalue);
+
+  /** Get the stats of the tensors in use, removing the entries of those that aren't. */
+  Stats GetStats() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedInitializerCache);
+
+  struct Entry {
+    // the allocator info name may be owned by an execution provider that goes away before the entry
+    std::string location_name;
+    int location_id;
+    OrtMemType location_mem_type;
+    int32_t data_type;
+    std::vector<int64_t> dims;
+    std::weak_ptr<void> buffer;
+    size_t size;
+  };
+
+  bool Matches(const Entry& entry, const ONNX_NAMESPACE::TensorProto& tensor_proto,
+               const OrtAllocatorInfo& location, const void* buffer) const;
+
+  // remove the entries whose buffer was released. lock_ must be held.
+  void RemoveExpiredEntries() const;
+
+  // the buffers outlive the sessions that created them, so they can't come from a session's allocator
+  AllocatorPtr allocator_;
+
+  mutable OrtMutex lock_;
+  // key is the hash of the raw data, type and shape
+  mutable std::unordered_multimap<size_t, Entry> entries_;
+  // GetOrAdd removes the expired entries once there are this many, so the entries of tensors that are never looked
+  // up again don't accumulate
+  size_t remove_expired_size_;
+};
+}  // namespace onnxruntime
@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/subgraph_executor.h"
+
+#include "core/framework/session_state.h"
+#include "core/framework/utils.h"
+
+namespace onnxruntime {
+
+SubgraphExecutor::SubgraphExecutor(const SessionState& session_state,
+                                   const std::vector<std::string>& feed_names,
+                                   const std::vector<std::string>& output_names,
+                                   const bool& terminate_flag,
+                                   const logging::Logger& logger)
+    : session_state_{session_state},
+      feeds_fetches_info_{feed_names, output_names},
+      terminate_flag_{terminate_flag},
+      logger_{logger} {
+}
+
+common::Status SubgraphExecutor::Initialize() {
+  ORT_RETURN_IF_ERROR(feeds_fetches_info_.SetMLValueIdxs(session_state_.GetMLValueNameIdxMap()));
+
+  feeds_.resize(feeds_fetches_info_.feed_names.size());
+  fetches_.resize(feeds_fetches_info_.output_names.size());
+
+  return Status::OK();
+}
+
+common::Status SubgraphExecutor::Execute(
+    const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  // subgraphs always run sequentially
+  return utils::ExecuteGraph(session_state_, feeds_fetches_info_, feeds_, fetches_, fetch_allocators,
+                             /*sequential_execution*/ true, terminate_flag_, logger_, &device_copy_check_);
+}
+}  // namespace onnxruntime
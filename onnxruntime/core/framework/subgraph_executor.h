@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/feeds_fetches_info.h"
+#include "core/framework/iexecutor.h"
+#include "core/framework/ml_value.h"
+#include "core/framework/utils.h"
+
+namespace onnxruntime {
+class SessionState;
+namespace logging {
+class Logger;
+}
+
+/**
+Runs a subgraph, e.g. the body of a Scan or Loop node, many times with the same feed and output names.
+
+The names are resolved to MLValue indices once when the executor is created for a node's Compute call.
+Between runs the caller updates the feeds and fetches that change, by index, in the vectors returned by Feeds() and
+Fetches(). Feeds that are the same for every run, such as implicit inputs, are set once. This saves building a
+name to MLValue map and looking up every name on each iteration.
+*/
+class SubgraphExecutor {
+ public:
+  SubgraphExecutor(const SessionState& session_state,
+                   const std::vector<std::string>& feed_names,
+                   const std::vector<std::string>& output_names,
+                   const bool& terminate_flag,
+                   const logging::Logger& logger);
+
+  /// Resolve the feed and output names to MLValue indices. Must be called before Execute.
+  common::Status Initialize();
+
+  /// The feeds, in the order of the feed names.
+  std::vector<MLValue>& Feeds() { return feeds_; }
+
+  /**
+  The fetches, in the order of the output names. An allocated entry is used as the buffer for that output. After
+  Execute the entries hold the outputs of the run.
+  */
+  std::vector<MLValue>& Fetches() { return fetches_; }
+
+  /// Run the subgraph with the current feeds and fetches.
+  common::Status Execute(const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators = {});
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SubgraphExecutor);
+
+  const SessionState& session_state_;
+  FeedsFetchesInfo feeds_fetches_info_;
+  const bool& terminate_flag_;
+  const logging::Logger& logger_;
+
+  std::vector<MLValue> feeds_;
+  std::vector<MLValue> fetches_;
+
+  // set by the first run. later runs skip the checks for device copies if it needed none.
+  utils::DeviceCopyCheck device_copy_check_ = utils::DeviceCopyCheck::Unknown;
+};
+}  // namespace onnxruntime
@@ -248,5 +248,55 @@ TensorProto::DataType GetTensorProtoType(const Tensor& tensor) {
   return dtype;
 }
 
+#define CASE_TYPE(X, Y)                                               \
+  case ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_##X: \
+    type = DataTypeImpl::GetType<Y>();                                 \
+    break;
+
+Status GetTensorOverRawData(const TensorProto& tensor_proto, const void* data, size_t length,
+                            const OrtAllocatorInfo& alloc_info, std::unique_ptr<Tensor>* p_tensor) {
+  MLDataType type = nullptr;
+  switch (tensor_proto.data_type()) {
+    CASE_TYPE(FLOAT, float);
+    CASE_TYPE(DOUBLE, double);
+    CASE_TYPE(BOOL, bool);
+    CASE_TYPE(INT8, int8_t);
+    CASE_TYPE(INT16, int16_t);
+    CASE_TYPE(INT32, int32_t);
+    CASE_TYPE(INT64, int64_t);
+    CASE_TYPE(UINT8, uint8_t);
+    CASE_TYPE(UINT16, uint16_t);
+    CASE_TYPE(UINT32, uint32_t);
+    CASE_TYPE(UINT64, uint64_t);
+    CASE_TYPE(FLOAT16, MLFloat16);
+    CASE_TYPE(BFLOAT16, BFloat16);
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Tensor ", tensor_proto.name(), " has type ",
+                             tensor_proto.data_type(), ", which has no fixed size.");
+  }
+
+  // raw_data is little-endian
+  static const int one = 1;
+  if (*reinterpret_cast<const char*>(&one) != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "raw_data can only be used in place on little-endian machines");
+  }
+
+  TensorShape tensor_shape{GetTensorShapeFromTensorProto(tensor_proto)};
+  const size_t element_size = type->Size();
+  if (tensor_shape.Size() < 0 || static_cast<size_t>(tensor_shape.Size()) * element_size != length) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Tensor ", tensor_proto.name(), " has ", length,
+                           " bytes of data for shape ", tensor_shape);
+  }
+
+  if (reinterpret_cast<uintptr_t>(data) % element_size != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The data of tensor ", tensor_proto.name(),
+                           " isn't aligned for its type.");
+  }
+
+  // the tensor has no deleter so it doesn't free the data
+  *p_tensor = std::make_unique<Tensor>(type, tensor_shape, const_cast<void*>(data), alloc_info);
+  return Status::OK();
+}
+
 }  // namespace utils
 }  // namespace onnxruntime
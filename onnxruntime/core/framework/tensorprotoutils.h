@@ -25,5 +25,11 @@ std::vector<int64_t> GetTensorShapeFromTensorShapeProto(const ONNX_NAMESPACE::Te
 common::Status TensorProtoToMLValue(const ONNX_NAMESPACE::TensorProto& input, AllocatorPtr allocator, void* preallocated,
                                     size_t preallocated_size, MLValue& value);
 ONNX_NAMESPACE::TensorProto::DataType GetTensorProtoType(const Tensor& tensor);
+
+// Create a tensor that uses data, the raw_data of tensor_proto held elsewhere such as in a model file mapped into
+// memory, instead of a copy of it. The tensor doesn't own the data. Fails if the type has no fixed size, if data
+// isn't the size of the tensor or isn't aligned for its type, or if the machine isn't little-endian.
+common::Status GetTensorOverRawData(const ONNX_NAMESPACE::TensorProto& tensor_proto, const void* data, size_t length,
+                                    const OrtAllocatorInfo& alloc_info, std::unique_ptr<Tensor>* p_tensor);
 }  // namespace utils
 }  // namespace onnxruntime
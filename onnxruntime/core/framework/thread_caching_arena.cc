@@ -0,0 +1,327 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/thread_caching_arena.h"
+
+#include <limits>
+#include <unordered_map>
+
+namespace onnxruntime {
+
+constexpr size_t ThreadCachingArena::kDefaultMaxCachedSize;
+constexpr size_t ThreadCachingArena::kDefaultMaxCachedBytesPerThread;
+
+namespace {
+// the header in front of each block. its size keeps the returned pointer 64 byte aligned like the BFCArena's.
+constexpr size_t kHeaderSize = 64;
+constexpr int kNotCached = -1;
+
+constexpr size_t kMinClassSize = 256;
+constexpr int kClassesPerDoubling = 4;
+
+// how many allocations a thread counts before adding its cache hits and misses to the shared totals
+constexpr int64_t kStatsPublishInterval = 256;
+
+struct BlockHeader {
+  int size_class;
+};
+
+BlockHeader* Header(void* block) {
+  return static_cast<BlockHeader*>(block);
+}
+
+int FloorLog2(size_t n) {
+  int r = 0;
+  while (n >>= 1) {
+    ++r;
+  }
+
+  return r;
+}
+
+size_t ClassSize(int size_class) {
+  size_t base = kMinClassSize << (size_class / kClassesPerDoubling);
+  return base + (size_class % kClassesPerDoubling) * (base / kClassesPerDoubling);
+}
+
+// smallest size class that holds bytes
+int SizeClass(size_t bytes) {
+  if (bytes <= kMinClassSize) {
+    return 0;
+  }
+
+  // base < bytes <= 2 * base
+  int log2 = FloorLog2(bytes - 1);
+  size_t base = static_cast<size_t>(1) << log2;
+  size_t step = base / kClassesPerDoubling;
+  auto steps = static_cast<int>((bytes - base + step - 1) / step);
+  return (log2 - FloorLog2(kMinClassSize)) * kClassesPerDoubling + steps;
+}
+
+std::atomic<uint64_t> next_arena_id{1};
+
+// set once the thread's caches are destroyed at thread exit. an arena used after that, e.g. by a static that's
+// destroyed after the main thread's thread_locals, goes straight to the BFCArena.
+thread_local bool thread_caches_destroyed = false;
+}  // namespace
+
+struct ThreadCachingArena::ThreadCache {
+  ThreadCache(std::weak_ptr<Shared> shared_in, int num_size_classes)
+      : shared(std::move(shared_in)), free_blocks(num_size_classes) {}
+
+  // return the blocks to the arena if it's still alive. if not they were freed along with the BFCArena.
+  ~ThreadCache() {
+    auto arena_shared = shared.lock();
+    if (!arena_shared) {
+      return;
+    }
+
+    arena_shared->num_cache_hits += num_hits;
+    arena_shared->num_cache_misses += num_misses;
+
+    std::vector<void*> blocks;
+    for (auto& class_blocks : free_blocks) {
+      blocks.insert(blocks.end(), class_blocks.cbegin(), class_blocks.cend());
+    }
+
+    arena_shared->arena->FreeBatch(blocks);
+  }
+
+  std::weak_ptr<Shared> shared;
+  // free blocks by size class
+  std::vector<std::vector<void*>> free_blocks;
+  size_t cached_bytes = 0;
+
+  // counts not yet added to the shared totals
+  int64_t num_hits = 0;
+  int64_t num_misses = 0;
+};
+
+struct ThreadCachingArena::ThreadCaches {
+  // the last cache used, to skip the map lookup when a thread uses one arena
+  uint64_t last_id = 0;
+  ThreadCache* last = nullptr;
+
+  std::unordered_map<uint64_t, std::unique_ptr<ThreadCache>> by_arena_id;
+
+  ~ThreadCaches() {
+    thread_caches_destroyed = true;
+  }
+};
+
+ThreadCachingArena::ThreadCachingArena(std::unique_ptr<BFCArena> arena,
+                                       size_t max_cached_size,
+                                       size_t max_cached_bytes_per_thread)
+    : shared_(std::make_shared<Shared>(std::move(arena))),
+      id_(next_arena_id++),
+      max_cached_size_(max_cached_size),
+      max_cached_bytes_per_thread_(max_cached_bytes_per_thread),
+      num_size_classes_(SizeClass(max_cached_size + kHeaderSize) + 1) {
+}
+
+ThreadCachingArena::~ThreadCachingArena() {
+  // the calling thread's blocks go back to the BFCArena now. other threads' caches for this arena are dropped when
+  // the thread exits or next creates a cache.
+  FlushThreadCache();
+}
+
+ThreadCachingArena::ThreadCaches& ThreadCachingArena::GetThreadCaches() {
+  static thread_local ThreadCaches caches;
+  return caches;
+}
+
+ThreadCachingArena::ThreadCache* ThreadCachingArena::GetThreadCache() {
+  if (thread_caches_destroyed) {
+    return nullptr;
+  }
+
+  ThreadCaches& caches = GetThreadCaches();
+  if (caches.last_id == id_) {
+    return caches.last;
+  }
+
+  auto it = caches.by_arena_id.find(id_);
+  if (it == caches.by_arena_id.end()) {
+    // drop the caches of arenas that have been destroyed
+    for (auto cur = caches.by_arena_id.begin(); cur != caches.by_arena_id.end();) {
+      if (cur->second->shared.expired()) {
+        if (caches.last == cur->second.get()) {
+          caches.last_id = 0;
+          caches.last = nullptr;
+        }
+
+        cur = caches.by_arena_id.erase(cur);
+      } else {
+        ++cur;
+      }
+    }
+
+    it = caches.by_arena_id.emplace(id_, std::make_unique<ThreadCache>(shared_, num_size_classes_)).first;
+  }
+
+  caches.last_id = id_;
+  caches.last = it->second.get();
+  return caches.last;
+}
+
+void ThreadCachingArena::FlushThreadCache() {
+  if (thread_caches_destroyed) {
+    return;
+  }
+
+  ThreadCaches& caches = GetThreadCaches();
+  auto it = caches.by_arena_id.find(id_);
+  if (it == caches.by_arena_id.end()) {
+    return;
+  }
+
+  if (caches.last_id == id_) {
+    caches.last_id = 0;
+    caches.last = nullptr;
+  }
+
+  // the destructor returns the blocks
+  caches.by_arena_id.erase(it);
+}
+
+void ThreadCachingArena::Flush(ThreadCache& cache, size_t target_bytes) {
+  std::vector<void*> blocks;
+
+  // largest first so the fewest blocks are returned
+  for (int size_class = num_size_classes_ - 1; size_class >= 0 && cache.cached_bytes > target_bytes; --size_class) {
+    auto& class_blocks = cache.free_blocks[size_class];
+    while (!class_blocks.empty() && cache.cached_bytes > target_bytes) {
+      blocks.push_back(class_blocks.back());
+      class_blocks.pop_back();
+      cache.cached_bytes -= ClassSize(size_class);
+    }
+  }
+
+  shared_->arena->FreeBatch(blocks);
+}
+
+void ThreadCachingArena::PublishStats(ThreadCache& cache) {
+  shared_->num_cache_hits += cache.num_hits;
+  shared_->num_cache_misses += cache.num_misses;
+  cache.num_hits = 0;
+  cache.num_misses = 0;
+}
+
+void* ThreadCachingArena::Alloc(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  void* block = nullptr;
+
+  if (size <= max_cached_size_) {
+    int size_class = SizeClass(size + kHeaderSize);
+    ThreadCache* cache = GetThreadCache();
+
+    if (cache != nullptr && !cache->free_blocks[size_class].empty()) {
+      auto& class_blocks = cache->free_blocks[size_class];
+      block = class_blocks.back();
+      class_blocks.pop_back();
+      cache->cached_bytes -= ClassSize(size_class);
+      ++cache->num_hits;
+    } else {
+      block = shared_->arena->Alloc(ClassSize(size_class));
+      if (block == nullptr) {
+        return nullptr;
+      }
+
+      Header(block)->size_class = size_class;
+      if (cache != nullptr) {
+        ++cache->num_misses;
+      }
+    }
+
+    if (cache != nullptr && cache->num_hits + cache->num_misses >= kStatsPublishInterval) {
+      PublishStats(*cache);
+    }
+  } else {
+    if (size > std::numeric_limits<size_t>::max() - kHeaderSize) {
+      return nullptr;
+    }
+
+    block = shared_->arena->Alloc(size + kHeaderSize);
+    if (block == nullptr) {
+      return nullptr;
+    }
+
+    Header(block)->size_class = kNotCached;
+  }
+
+  return static_cast<char*>(block) + kHeaderSize;
+}
+
+void ThreadCachingArena::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  void* block = static_cast<char*>(p) - kHeaderSize;
+  int size_class = Header(block)->size_class;
+  ThreadCache* cache = size_class == kNotCached ? nullptr : GetThreadCache();
+  if (cache == nullptr) {
+    shared_->arena->Free(block);
+    return;
+  }
+
+  cache->free_blocks[size_class].push_back(block);
+  cache->cached_bytes += ClassSize(size_class);
+
+  if (cache->cached_bytes > max_cached_bytes_per_thread_) {
+    Flush(*cache, max_cached_bytes_per_thread_ / 2);
+  }
+}
+
+void* ThreadCachingArena::Reserve(size_t size) {
+  if (size == 0 || size > std::numeric_limits<size_t>::max() - kHeaderSize) {
+    return nullptr;
+  }
+
+  void* block = shared_->arena->Reserve(size + kHeaderSize);
+  if (block == nullptr) {
+    return nullptr;
+  }
+
+  Header(block)->size_class = kNotCached;
+  return static_cast<char*>(block) + kHeaderSize;
+}
+
+size_t ThreadCachingArena::Used() const {
+  return shared_->arena->Used();
+}
+
+size_t ThreadCachingArena::Max() const {
+  return shared_->arena->Max();
+}
+
+const OrtAllocatorInfo& ThreadCachingArena::Info() const {
+  return shared_->arena->Info();
+}
+
+FencePtr ThreadCachingArena::CreateFence(const SessionState* session_state) {
+  return shared_->arena->CreateFence(session_state);
+}
+
+size_t ThreadCachingArena::Shrink() {
+  FlushThreadCache();
+  return shared_->arena->Shrink();
+}
+
+void ThreadCachingArena::GetStats(AllocatorStats* stats) {
+  if (!thread_caches_destroyed) {
+    auto& caches = GetThreadCaches();
+    auto it = caches.by_arena_id.find(id_);
+    if (it != caches.by_arena_id.end()) {
+      PublishStats(*it->second);
+    }
+  }
+
+  shared_->arena->GetStats(stats);
+  stats->num_cache_hits = shared_->num_cache_hits;
+  stats->num_cache_misses = shared_->num_cache_misses;
+}
+}  // namespace onnxruntime
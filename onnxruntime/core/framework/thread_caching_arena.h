@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/arena.h"
+#include "core/framework/bfc_arena.h"
+
+namespace onnxruntime {
+
+// An arena that keeps a cache of freed small blocks for each thread in front of a BFCArena, so most small
+// allocations, e.g. kernel temp buffers, don't take the BFCArena lock.
+//
+// Sizes up to max_cached_size are rounded up to one of four size classes per power of two. A thread that frees
+// such a block keeps it for its own next allocation of that class. Once a thread has more than
+// max_cached_bytes_per_thread cached, half of it is returned to the BFCArena in a single batch. A thread's cache is
+// also returned when the thread exits.
+//
+// Each block has a small header recording its size class, which is how Free tells cached sizes from others.
+// Blocks held in thread caches count as in use in the BFCArena stats.
+class ThreadCachingArena : public IArenaAllocator {
+ public:
+  static constexpr size_t kDefaultMaxCachedSize = 256 * 1024;
+  static constexpr size_t kDefaultMaxCachedBytesPerThread = 4 * 1024 * 1024;
+
+  explicit ThreadCachingArena(std::unique_ptr<BFCArena> arena,
+                              size_t max_cached_size = kDefaultMaxCachedSize,
+                              size_t max_cached_bytes_per_thread = kDefaultMaxCachedBytesPerThread);
+
+  ~ThreadCachingArena() override;
+
+  void* Alloc(size_t size) override;
+
+  void Free(void* p) override;
+
+  void* Reserve(size_t size) override;
+
+  size_t Used() const override;
+
+  size_t Max() const override;
+
+  const OrtAllocatorInfo& Info() const override;
+
+  FencePtr CreateFence(const SessionState* session_state) override;
+
+  // Return the calling thread's cached blocks, then the free regions of the BFCArena. Blocks cached by other threads
+  // keep their regions in use until those threads exceed max_cached_bytes_per_thread or exit, as a thread's cache
+  // is only touched by that thread.
+  size_t Shrink() override;
+
+  // Get the BFCArena stats, with the cache hits and misses of all the threads.
+  void GetStats(AllocatorStats* stats) override;
+
+  // Return the blocks cached by the calling thread to the BFCArena.
+  void FlushThreadCache();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadCachingArena);
+
+  // state shared with the thread caches, which may outlive the arena until their thread next allocates or exits
+  struct Shared {
+    explicit Shared(std::unique_ptr<BFCArena> arena_in) : arena(std::move(arena_in)) {}
+
+    std::unique_ptr<BFCArena> arena;
+    std::atomic<int64_t> num_cache_hits{0};
+    std::atomic<int64_t> num_cache_misses{0};
+  };
+
+  struct ThreadCache;
+  struct ThreadCaches;
+
+  // the calling thread's caches, one per arena it has used
+  static ThreadCaches& GetThreadCaches();
+
+  // nullptr once the thread's caches have been destroyed at thread exit
+  ThreadCache* GetThreadCache();
+  // return blocks from cache to the BFCArena until it holds at most target_bytes
+  void Flush(ThreadCache& cache, size_t target_bytes);
+  void PublishStats(ThreadCache& cache);
+
+  std::shared_ptr<Shared> shared_;
+  // unique for the process lifetime, so a thread never uses a cache left over from a destroyed arena at the same
+  // address
+  const uint64_t id_;
+  const size_t max_cached_size_;
+  const size_t max_cached_bytes_per_thread_;
+  const int num_size_classes_;
+};
+}  // namespace onnxruntime
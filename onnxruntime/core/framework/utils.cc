@@ -182,6 +182,18 @@ common::Status CopyInputsAcrossDevices(const SessionState& session_state,
   return Status::OK();
 }
 
+common::Status CopyInputsAcrossDevices(const SessionState& session_state,
+                                       const std::vector<std::string>& feed_names,
+                                       const std::vector<MLValue>& orig_feeds,
+                                       std::vector<MLValue>& new_feeds) {
+  new_feeds.resize(orig_feeds.size());
+  for (size_t idx = 0, end = orig_feeds.size(); idx < end; ++idx) {
+    ORT_RETURN_IF_ERROR(CopyOneInputAcrossDevices(session_state, feed_names[idx], orig_feeds[idx], new_feeds[idx]));
+  }
+
+  return Status::OK();
+}
+
 static std::pair<bool, size_t> Contains(const std::vector<std::string>& output_names,
                                         const std::string& name) {
   auto it = std::find(std::begin(output_names), std::end(output_names), name);
@@ -331,21 +343,15 @@ common::Status ExecuteGraph(const SessionState& session_state,
                             bool sequential_execution,
                             const bool& terminate_flag,
                             const logging::Logger& logger) {
-  std::unique_ptr<IExecutor> p_exec;
-
-  if (sequential_execution) {
-    p_exec = std::unique_ptr<IExecutor>(new SequentialExecutor(terminate_flag));
-  } else {
-    p_exec = std::unique_ptr<IExecutor>(new ParallelExecutor(session_state, terminate_flag));
-  }
+  // the executors hold no per-run state beyond the terminate flag, and everything they need from the graph has been
+  // pre-computed in session_state, so they're cheap enough to create on the stack for each call.
+  SequentialExecutor sequential_executor{terminate_flag};
+  ParallelExecutor parallel_executor{terminate_flag};
+  IExecutor* p_exec = sequential_execution ? static_cast<IExecutor*>(&sequential_executor)
+                                           : static_cast<IExecutor*>(&parallel_executor);
 
   // If we only have one provider it's the CPU provider as that is always automatically registered. If that's the
   // case, assume no copy to/from other devices is required.
-
-  // TODO: Next step: If there is more than one provider we could add an in/out param to track whether any
-  // copy to/from devices was needed, and set that on the first execution. That way when a subgraph is repeatedly
-  // executed in a Scan or Loop node we can skip unnecessary checks for copies.
-
   if (session_state.GetExecutionProviders().NumProviders() == 1) {
     // no device copies are needed so simple execute
     ORT_RETURN_IF_ERROR(p_exec->Execute(session_state, feeds, output_names, fetches, fetch_allocators, logger));
@@ -364,5 +370,66 @@ common::Status ExecuteGraph(const SessionState& session_state,
   return Status::OK();
 }
 
+// whether the executor was given the caller's tensor rather than a copy on another device. only tensors are copied.
+static bool IsSameTensor(const MLValue& value, const MLValue& device_value) {
+  if (!value.IsTensor() || !device_value.IsTensor()) {
+    return true;
+  }
+
+  return &value.Get<Tensor>() == &device_value.Get<Tensor>();
+}
+
+common::Status ExecuteGraph(const SessionState& session_state,
+                            const FeedsFetchesInfo& feeds_fetches_info,
+                            const std::vector<MLValue>& feeds,
+                            std::vector<MLValue>& fetches,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                            bool sequential_execution,
+                            const bool& terminate_flag,
+                            const logging::Logger& logger,
+                            DeviceCopyCheck* device_copy_check) {
+  SequentialExecutor sequential_executor{terminate_flag};
+  ParallelExecutor parallel_executor{terminate_flag};
+  IExecutor* p_exec = sequential_execution ? static_cast<IExecutor*>(&sequential_executor)
+                                           : static_cast<IExecutor*>(&parallel_executor);
+
+  // a graph executed repeatedly, e.g. by SubgraphExecutor, also skips the checks for copies once its first execution
+  // found none were needed
+  if (session_state.GetExecutionProviders().NumProviders() == 1 ||
+      (device_copy_check != nullptr && *device_copy_check == DeviceCopyCheck::NoCopy)) {
+    // no device copies are needed so simple execute
+    ORT_RETURN_IF_ERROR(p_exec->Execute(session_state, feeds_fetches_info, feeds, fetches, fetch_allocators,
+                                        logger));
+  } else {
+    std::vector<MLValue> device_feeds;
+    ORT_RETURN_IF_ERROR(utils::CopyInputsAcrossDevices(session_state, feeds_fetches_info.feed_names, feeds,
+                                                       device_feeds));
+
+    std::vector<MLValue> device_fetches;
+    ORT_RETURN_IF_ERROR(utils::MatchOutputsWithProviders(session_state, feeds_fetches_info.output_names, fetches,
+                                                         device_fetches));
+
+    ORT_RETURN_IF_ERROR(p_exec->Execute(session_state, feeds_fetches_info, device_feeds, device_fetches,
+                                        fetch_allocators, logger));
+
+    ORT_RETURN_IF_ERROR(utils::CopyOutputsAcrossDevices(session_state, device_fetches, fetches));
+
+    if (device_copy_check != nullptr && *device_copy_check == DeviceCopyCheck::Unknown) {
+      bool copied = false;
+      for (size_t i = 0, end = feeds.size(); i < end && !copied; ++i) {
+        copied = !IsSameTensor(feeds[i], device_feeds[i]);
+      }
+
+      for (size_t i = 0, end = fetches.size(); i < end && !copied; ++i) {
+        copied = !IsSameTensor(fetches[i], device_fetches[i]);
+      }
+
+      *device_copy_check = copied ? DeviceCopyCheck::Copy : DeviceCopyCheck::NoCopy;
+    }
+  }
+
+  return Status::OK();
+}
+
 }  // namespace utils
 }  // namespace onnxruntime
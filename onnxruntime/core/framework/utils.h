@@ -6,6 +6,7 @@
 #include "core/graph/basic_types.h"
 #include "core/framework/allocator.h"
 #include "core/framework/data_types.h"
+#include "core/framework/feeds_fetches_info.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/iexecutor.h"
 #include "core/framework/session_state.h"
@@ -48,6 +49,11 @@ common::Status CopyInputsAcrossDevices(const SessionState& session_state,
                                        const NameMLValMap& orig_feeds,
                                        NameMLValMap& new_feeds);
 
+common::Status CopyInputsAcrossDevices(const SessionState& session_state,
+                                       const std::vector<std::string>& feed_names,
+                                       const std::vector<MLValue>& orig_feeds,
+                                       std::vector<MLValue>& new_feeds);
+
 common::Status MatchOutputsWithProviders(const SessionState& session_state,
                                          const std::vector<std::string>& output_names,
                                          std::vector<MLValue>& fetches,
@@ -66,6 +72,27 @@ common::Status ExecuteGraph(const SessionState& session_state,
                             const bool& terminate_flag,
                             const logging::Logger& logger);
 
+// Whether the feeds and fetches of a graph that's executed repeatedly, e.g. a Scan or Loop subgraph, need copying
+// across devices. Found by the first execution.
+enum class DeviceCopyCheck {
+  Unknown,
+  NoCopy,
+  Copy
+};
+
+// Execute the graph with feeds and fetches in the order of the names in feeds_fetches_info.
+// If device_copy_check is given and Unknown, it's set by this execution. If it's NoCopy the checks for copies are
+// skipped, so it must only be reused while the feeds and fetches stay on the same devices.
+common::Status ExecuteGraph(const SessionState& session_state,
+                            const FeedsFetchesInfo& feeds_fetches_info,
+                            const std::vector<MLValue>& feeds,
+                            std::vector<MLValue>& fetches,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                            bool sequential_execution,
+                            const bool& terminate_flag,
+                            const logging::Logger& logger,
+                            DeviceCopyCheck* device_copy_check = nullptr);
+
 #define DispatchOnTensorType(tensor_type, function, ...)      \
   if (tensor_type == DataTypeImpl::GetType<float>())          \
     function<float>(__VA_ARGS__);                             \
@@ -426,6 +426,115 @@ activation and leaky_relu_alpha.)DOC")
         }
       });
 
+  // The Nchwc ops hold 4D tensors in the NCHWc layout: the channels are split into blocks, which are stored next
+  // to each other for each spatial position. The channel count is padded to a multiple of the block size, which
+  // depends on the processor, so the ops only infer the types and the dimensions the layout keeps.
+  ONNX_CONTRIB_OPERATOR_SCHEMA(ReorderInput)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(Reorder a NCHW tensor to the NCHWc layout.)DOC")
+      .Input(0, "X", "4D input tensor in the NCHW layout.", "T")
+      .Output(0, "Y", "Output tensor in the NCHWc layout.", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 1)) {
+          return;
+        }
+        auto& input_shape = getInputShape(ctx, 0);
+        if (input_shape.dim_size() != 4) {
+          fail_shape_inference("Input must be 4D");
+        }
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        *output_shape->add_dim() = input_shape.dim(0);
+        output_shape->add_dim();
+        *output_shape->add_dim() = input_shape.dim(2);
+        *output_shape->add_dim() = input_shape.dim(3);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(ReorderOutput)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(Reorder a tensor in the NCHWc layout to the NCHW layout, dropping the padding channels.)DOC")
+      .Attr("channels", "The number of channels of the NCHW tensor.", AttributeProto::INT)
+      .Input(0, "X", "4D input tensor in the NCHWc layout.", "T")
+      .Output(0, "Y", "Output tensor in the NCHW layout.", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 1)) {
+          return;
+        }
+        auto& input_shape = getInputShape(ctx, 0);
+        if (input_shape.dim_size() != 4) {
+          fail_shape_inference("Input must be 4D");
+        }
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        *output_shape->add_dim() = input_shape.dim(0);
+        output_shape->add_dim()->set_dim_value(getAttribute(ctx, "channels", 0));
+        *output_shape->add_dim() = input_shape.dim(2);
+        *output_shape->add_dim() = input_shape.dim(3);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NchwcConv)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+The convolution operator schema is the same as FusedConv, with the input and output in the NCHWc layout. The
+filter and bias are in the layout of Conv. The input is in the NCHW layout if there's a single group and fewer
+input channels than the block size. Grouped convolutions must be depthwise.)DOC")
+      .Attr("auto_pad", "", AttributeProto::STRING, std::string("NOTSET"))
+      .Attr("kernel_shape", "", AttributeProto::INTS, OPTIONAL)
+      .Attr("dilations", "", AttributeProto::INTS, OPTIONAL)
+      .Attr("strides", "", AttributeProto::INTS, OPTIONAL)
+      .Attr("pads", "", AttributeProto::INTS, OPTIONAL)
+      .Attr("group", "", AttributeProto::INT, static_cast<int64_t>(1))
+      .Attr("activation", "", AttributeProto::STRING, OPTIONAL)
+      .Attr("alpha", "", AttributeProto::FLOAT, OPTIONAL)
+      .Input(0, "X", "", "T")
+      .Input(1, "W", "", "T")
+      .Input(2, "B", "", "T", OpSchema::Optional)
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+      });
+
+  auto nchwc_pool_schema = [](bool global_pooling) {
+    return [=](OpSchema& schema) {
+      schema.SetDomain(kMSDomain)
+          .SinceVersion(1)
+          .Input(0, "X", "Input tensor in the NCHWc layout.", "T")
+          .Output(0, "Y", "Output tensor in the NCHWc layout.", "T")
+          .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+          .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+            propagateElemTypeFromInputToOutput(ctx, 0, 0);
+          });
+      if (!global_pooling) {
+        schema.Attr("kernel_shape", "", AttributeProto::INTS)
+            .Attr("pads", "", AttributeProto::INTS, OPTIONAL)
+            .Attr("strides", "", AttributeProto::INTS, OPTIONAL);
+      }
+    };
+  };
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NchwcMaxPool)
+      .SetDoc(R"DOC(MaxPool with explicit padding on a tensor in the NCHWc layout.)DOC")
+      .FillUsing(nchwc_pool_schema(false));
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NchwcAveragePool)
+      .SetDoc(R"DOC(AveragePool with explicit padding on a tensor in the NCHWc layout.)DOC")
+      .Attr("count_include_pad", "", AttributeProto::INT, static_cast<int64_t>(0))
+      .FillUsing(nchwc_pool_schema(false));
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NchwcGlobalMaxPool)
+      .SetDoc(R"DOC(GlobalMaxPool on a tensor in the NCHWc layout.)DOC")
+      .FillUsing(nchwc_pool_schema(true));
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(NchwcGlobalAveragePool)
+      .SetDoc(R"DOC(GlobalAveragePool on a tensor in the NCHWc layout.)DOC")
+      .FillUsing(nchwc_pool_schema(true));
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(ExpandDims)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -1200,6 +1309,28 @@ Example 4:
   the value of the sampled locations are computed directly
   through bilinear interpolation.)DOC");
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(SharedKeyZipMap)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(ZipMap of ai.onnx.ml, with the maps in one SharedKeyMaps batch instead of a sequence of maps.
+The keys, given by the attributes, are shared by all the maps and the values are X, with a row for each map.
+The session transforms ZipMap nodes whose output is a graph output to this op if enable_zipmap_shared_keys is set.)DOC")
+      .Input(0, "X", "The values of the maps, of shape [N, C] or [C].", "tensor(float)")
+      .Output(0, "Z", "The maps.", "T")
+      .TypeConstraint(
+          "T",
+          {"opaque(com.microsoft,SharedKeyMapsString)", "opaque(com.microsoft,SharedKeyMapsInt64)"},
+          "The batch of maps with string keys, or int64 keys.")
+      .Attr("classlabels_strings", "The keys if using string keys.", AttributeProto::STRINGS, OPTIONAL)
+      .Attr("classlabels_int64s", "The keys if using int64 keys.", AttributeProto::INTS, OPTIONAL)
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        const auto* classlabels_strings = ctx.getAttribute("classlabels_strings");
+        const bool using_strings = classlabels_strings != nullptr && classlabels_strings->strings_size() > 0;
+        auto* opaque_type = ctx.getOutputType(0)->mutable_opaque_type();
+        opaque_type->set_domain(kMSDomain);
+        opaque_type->set_name(using_strings ? "SharedKeyMapsString" : "SharedKeyMapsInt64");
+      });
+
 #ifdef MICROSOFT_INTERNAL
   // register internal ops
   RegisterInternalSchemas();
@@ -1907,6 +1907,7 @@ void Graph::RemoveInitializedTensor(const std::string& tensor_name) {
   auto iter = name_to_initial_tensor_.find(tensor_name);
   if (name_to_initial_tensor_.end() != iter) {
     name_to_initial_tensor_.erase(tensor_name);
+    mapped_initializer_data_.erase(tensor_name);
     SetGraphProtoSyncNeeded();
     SetGraphResolveNeeded();
   }
@@ -1922,6 +1923,23 @@ bool Graph::GetInitializedTensor(const std::string& tensor_name, const TensorPro
   return true;
 }
 
+void Graph::SetMappedInitializerData(std::shared_ptr<void> mapped_file,
+                                     std::unordered_map<std::string, std::pair<const void*, size_t>> locations) {
+  mapped_file_ = std::move(mapped_file);
+  mapped_initializer_data_ = std::move(locations);
+}
+
+const void* Graph::GetMappedInitializerData(const std::string& tensor_name, size_t& length) const {
+  auto iter = mapped_initializer_data_.find(tensor_name);
+  if (mapped_initializer_data_.end() == iter) {
+    length = 0;
+    return nullptr;
+  }
+
+  length = iter->second.second;
+  return iter->second.first;
+}
+
 void Graph::CleanAllInitializedTensors() noexcept {
   name_to_initial_tensor_.clear();
   removed_initializer_indexes_.clear();
@@ -2029,6 +2047,13 @@ std::string Graph::GenerateNodeName(const std::string& base_name) {
   return new_name;
 }
 
+void Graph::SetNodeArgType(NodeArg& arg, const ONNX_NAMESPACE::TypeProto& type_proto) {
+  ORT_ENFORCE(GetNodeArg(arg.Name()) == &arg, "NodeArg ", arg.Name(), " is not owned by this graph.");
+  arg.SetType(type_proto);
+  SetGraphResolveNeeded();
+  SetGraphProtoSyncNeeded();
+}
+
 Node& Graph::AddNode(const std::string& name,
                      const std::string& op_type,
                      const std::string& description,
@@ -2093,7 +2118,16 @@ bool Graph::AddControlEdge(NodeIndex src_node_index, NodeIndex dst_node_index) {
 }
 
 const GraphProto& Graph::ToGraphProto() {
-  if (!GraphProtoSyncNeeded()) {
+  // a subgraph's GraphProto is the attribute of its node, so update it before the node is written
+  bool subgraph_changed = false;
+  for (auto& node : Nodes()) {
+    for (auto& entry : node.GetAttributeNameToMutableSubgraphMap()) {
+      subgraph_changed = subgraph_changed || entry.second->GraphProtoSyncNeeded();
+      entry.second->ToGraphProto();
+    }
+  }
+
+  if (!GraphProtoSyncNeeded() && !subgraph_changed) {
     return *graph_proto_;
   }
 
@@ -1,6 +1,8 @@
 
 #include "core/graph/graph_utils.h"
 
+#include <algorithm>
+
 namespace onnxruntime {
 
 namespace utils {
@@ -80,8 +82,48 @@ const onnx::AttributeProto* GetNodeAttribute(
   return iter == attrs.end() ? nullptr : &iter->second;
 }
 
+bool IsConstantInitializer(const Graph& graph, const std::string& name) {
+  const ONNX_NAMESPACE::TensorProto* initializer = nullptr;
+  if (!graph.GetInitializedTensor(name, initializer)) {
+    return false;
+  }
+
+  if (graph.CanOverrideInitializer()) {
+    const auto& inputs = graph.GetInputsIncludingInitializers();
+    if (std::any_of(inputs.cbegin(), inputs.cend(), [&name](const NodeArg* input) { return input->Name() == name; })) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+NodeArgConsumerCounts CountNodeArgConsumers(const Graph& graph) {
+  NodeArgConsumerCounts consumer_counts;
+  std::vector<const NodeArg*> node_inputs;
+  for (auto& node : graph.Nodes()) {
+    // a node that uses a NodeArg more than once is still one consumer
+    node_inputs.assign(node.InputDefs().cbegin(), node.InputDefs().cend());
+    node_inputs.insert(node_inputs.end(), node.ImplicitInputDefs().cbegin(), node.ImplicitInputDefs().cend());
+    std::sort(node_inputs.begin(), node_inputs.end());
+    node_inputs.erase(std::unique(node_inputs.begin(), node_inputs.end()), node_inputs.end());
+
+    for (const auto* def : node_inputs) {
+      ++consumer_counts[def];
+    }
+  }
+
+  return consumer_counts;
+}
+
+bool IsOnlyConsumer(const NodeArgConsumerCounts& consumer_counts, const NodeArg& input_def) {
+  auto it = consumer_counts.find(&input_def);
+  return it == consumer_counts.cend() || it->second <= 1;
+}
+
 bool RemoveSingleInSingleOutNode(Graph& graph, Node& node) {
-  if (!IsSingleInSingleOutNode(node)) {
+  // the output of a node that produces a graph output can't be replaced by its input
+  if (!IsSingleInSingleOutNode(node) || graph.IsNodeOutputsInGraphOutputs(node)) {
     return false;
   }
   // Get input/output edges, nodes, and node args.
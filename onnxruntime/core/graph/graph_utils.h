@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <unordered_map>
+
 #include "core/graph/onnx_protobuf.h"
 #include "core/graph/graph.h"
 
@@ -37,6 +39,22 @@ bool GetRepeatedNodeAttributeValues(const Node& node,
   }
 }
 
+/** Returns true if the initializer with the given name can't be overridden by a value fed for it, so its value is
+known when the Graph is transformed. From IR version 4 an initializer that is also a Graph input is a default value. */
+bool IsConstantInitializer(const Graph& graph, const std::string& name);
+
+/** The number of Nodes of a Graph that use each NodeArg, as an explicit input or as an implicit input of a
+subgraph. */
+using NodeArgConsumerCounts = std::unordered_map<const NodeArg*, int>;
+
+/** Count the consumers of every NodeArg in one walk over the Graph. A transformer builds the counts once per pass and
+checks each candidate with IsOnlyConsumer, rather than searching the whole Graph for each one. */
+NodeArgConsumerCounts CountNodeArgConsumers(const Graph& graph);
+
+/** Returns true if no Node other than the one consuming input_def uses it. Nodes removed since the counts were built
+only make this more conservative, but a caller that adds a consumer of an existing NodeArg must update the counts. */
+bool IsOnlyConsumer(const NodeArgConsumerCounts& consumer_counts, const NodeArg& input_def);
+
 /** Remove the given single-input-single-output Node from the Graph. */
 bool RemoveSingleInSingleOutNode(Graph& graph, Node& node);
 
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/graph/model.h"
+#include <functional>
 #include <memory>
 
 #ifdef _MSC_VER
@@ -14,6 +15,7 @@
 #pragma warning(pop)
 #endif
 #include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/wire_format_lite.h>
 
 #include "gsl/pointers"
 #include "gsl/gsl_util"
@@ -371,6 +373,116 @@ Status Model::Load(int fd, std::shared_ptr<Model>& p_model, const IOnnxRuntimeOp
   return Status::OK();
 }
 
+// find where the raw_data of each initializer of the main graph is in a serialized ModelProto
+static bool FindInitializerRawData(const uint8_t* data, int length,
+                                   std::unordered_map<std::string, std::pair<const void*, size_t>>& locations) {
+  using google::protobuf::internal::WireFormatLite;
+  // ModelProto.graph, GraphProto.initializer, TensorProto.name and TensorProto.raw_data
+  const uint32_t graph_tag = WireFormatLite::MakeTag(7, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  const uint32_t initializer_tag = WireFormatLite::MakeTag(5, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  const uint32_t name_tag = WireFormatLite::MakeTag(8, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  const uint32_t raw_data_tag = WireFormatLite::MakeTag(9, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+
+  CodedInputStream input(data, length);
+  input.SetTotalBytesLimit(INT_MAX, INT_MAX);
+
+  // read a length delimited field, calling read_field for each field inside it
+  auto read_message = [&input](const std::function<bool(uint32_t)>& read_field) {
+    uint32_t message_length;
+    if (!input.ReadVarint32(&message_length)) {
+      return false;
+    }
+
+    auto limit = input.PushLimit(static_cast<int>(message_length));
+    for (uint32_t tag = input.ReadTag(); tag != 0; tag = input.ReadTag()) {
+      if (!read_field(tag)) {
+        return false;
+      }
+    }
+
+    input.PopLimit(limit);
+    return true;
+  };
+
+  auto read_initializer = [&]() {
+    std::string name;
+    const void* raw_data = nullptr;
+    uint32_t raw_data_length = 0;
+    bool ok = read_message([&](uint32_t tag) {
+      if (tag == name_tag) {
+        return WireFormatLite::ReadString(&input, &name);
+      }
+
+      if (tag == raw_data_tag) {
+        if (!input.ReadVarint32(&raw_data_length)) {
+          return false;
+        }
+
+        raw_data = data + input.CurrentPosition();
+        return input.Skip(static_cast<int>(raw_data_length));
+      }
+
+      return WireFormatLite::SkipField(&input, tag);
+    });
+
+    if (ok && raw_data != nullptr && !name.empty()) {
+      locations[name] = {raw_data, raw_data_length};
+    }
+
+    return ok;
+  };
+
+  for (uint32_t tag = input.ReadTag(); tag != 0; tag = input.ReadTag()) {
+    bool ok;
+    if (tag == graph_tag) {
+      ok = read_message([&](uint32_t graph_field_tag) {
+        return graph_field_tag == initializer_tag ? read_initializer()
+                                                  : WireFormatLite::SkipField(&input, graph_field_tag);
+      });
+    } else {
+      ok = WireFormatLite::SkipField(&input, tag);
+    }
+
+    if (!ok) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Status Model::LoadMapped(const std::string& file_path, std::shared_ptr<Model>& p_model,
+                         const IOnnxRuntimeOpSchemaRegistryList* local_registries) {
+  std::shared_ptr<void> mapped_file;
+  size_t length = 0;
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(file_path, mapped_file, length));
+  if (length > static_cast<size_t>(INT_MAX)) {
+    return Status(ONNXRUNTIME, INVALID_ARGUMENT, "Model file " + file_path + " is too large for protobuf to parse.");
+  }
+
+  const auto* data = static_cast<const uint8_t*>(mapped_file.get());
+  std::unique_ptr<ModelProto> model_proto = std::make_unique<ModelProto>();
+  {
+    CodedInputStream coded_input(data, static_cast<int>(length));
+    coded_input.SetTotalBytesLimit(INT_MAX, INT_MAX);
+    if (!model_proto->ParseFromCodedStream(&coded_input)) {
+      return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed.");
+    }
+  }
+
+  std::unordered_map<std::string, std::pair<const void*, size_t>> locations;
+  if (!FindInitializerRawData(data, static_cast<int>(length), locations)) {
+    return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Failed to find the initializer data in " + file_path);
+  }
+
+  p_model = std::make_shared<Model>(std::move(model_proto), local_registries);
+  p_model->MainGraph().SetMappedInitializerData(std::move(mapped_file), std::move(locations));
+
+  ORT_RETURN_IF_ERROR(p_model->MainGraph().Resolve(true));
+
+  return Status::OK();
+}
+
 Status Model::Save(Model& model, int p_fd) {
   if (p_fd < 0) {
     return Status(ONNXRUNTIME, INVALID_ARGUMENT, "<p_fd> is less than 0.");
@@ -106,6 +106,12 @@ class Model {
   static common::Status Load(int fd, /*out*/ std::shared_ptr<Model>& p_model,
                              const IOnnxRuntimeOpSchemaRegistryList* local_registries = nullptr);
 
+  // Load from a model file that is mapped into memory rather than read. The raw_data of the main graph's
+  // initializers stays in the mapping, so the CPU tensors for them can use it in place. See
+  // Graph::GetMappedInitializerData.
+  static common::Status LoadMapped(const std::string& file_path, /*out*/ std::shared_ptr<Model>& p_model,
+                                   const IOnnxRuntimeOpSchemaRegistryList* local_registries = nullptr);
+
   // 'int' rather than 'size_t' because of a protobuf design choice; let callers handle type checks
   static common::Status LoadFromBytes(int count, void* pBytes, /*out*/ std::shared_ptr<Model>& p_model,
                                       const IOnnxRuntimeOpSchemaRegistryList* local_registries = nullptr);
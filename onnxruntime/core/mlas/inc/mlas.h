@@ -94,6 +94,67 @@ MlasSgemm(
     size_t ldc
     );
 
+void
+MLASCALL
+MlasSgemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    size_t StrideA,
+    const float* B,
+    size_t ldb,
+    size_t StrideB,
+    float beta,
+    float* C,
+    size_t ldc,
+    size_t StrideC,
+    size_t BatchCount
+    );
+
+//
+// Single precision matrix/matrix multiply routines with a matrix B packed
+// once by MlasSgemmPackB, for a matrix B that is used by many calls.
+//
+
+size_t
+MLASCALL
+MlasSgemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasSgemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc
+    );
+
 //
 // Convolution routines.
 //
@@ -102,6 +163,7 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmDepthwise,
 };
 
 struct MLAS_CONV_PARAMETERS {
@@ -186,6 +248,83 @@ MlasPool(
     float* Output
     );
 
+//
+// NCHWc (channel blocked) routines.
+//
+// The NCHWc format stores the channels in blocks of MlasNchwcGetBlockSize()
+// channels, with the channels of a block stored next to each other for each
+// spatial position. The channel count is padded with zeros to a multiple of
+// the block size.
+//
+
+size_t
+MLASCALL
+MlasNchwcGetBlockSize(
+    void
+    );
+
+void
+MLASCALL
+MlasNchwcConv(
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    size_t GroupCount,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    const MLAS_ACTIVATION* Activation
+    );
+
+void
+MLASCALL
+MlasNchwcPool(
+    MLAS_POOLING_KIND PoolingKind,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    float* Output
+    );
+
+void
+MLASCALL
+MlasReorderInput(
+    const int64_t* InputShape,
+    const float* S,
+    float* D
+    );
+
+void
+MLASCALL
+MlasReorderOutput(
+    const int64_t* OutputShape,
+    const float* S,
+    float* D
+    );
+
+void
+MLASCALL
+MlasReorderFilterOIHWBiBo(
+    const int64_t* FilterShape,
+    const float* S,
+    float* D
+    );
+
+void
+MLASCALL
+MlasReorderFilterOIHWBo(
+    const int64_t* FilterShape,
+    const float* S,
+    float* D
+    );
+
 //
 // Miscellaneous compute routines.
 //
@@ -206,6 +345,44 @@ MlasComputeTanh(
     size_t N
     );
 
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    );
+
+//
+// Threading routines.
+//
+// By default, MLAS distributes work using the Windows thread pool or OpenMP.
+// A host application can instead supply callbacks that execute the work on
+// its own thread pool. The callbacks are invoked on the thread that called
+// into MLAS. If GetMaximumThreadCount returns zero, the default threading
+// support is used for that call.
+//
+
+typedef
+void
+(MLAS_THREADED_WORK_ROUTINE)(
+    void* Context,
+    int32_t Index
+    );
+
+struct MLAS_THREADING_CALLBACKS {
+    int32_t (MLASCALL* GetMaximumThreadCount)(void);
+    void (MLASCALL* ExecuteThreaded)(MLAS_THREADED_WORK_ROUTINE* WorkRoutine, void* Context, int32_t Iterations);
+};
+
+void
+MLASCALL
+MlasSetThreadingCallbacks(
+    const MLAS_THREADING_CALLBACKS* Callbacks
+    );
+
 //
 // Half-precision floating-point routines.
 //
@@ -642,6 +642,57 @@ Return Value:
         Segment->CountN);
 }
 
+inline
+void
+MlasConvPartitionBatchGroups(
+    const MLAS_CONV_WORK_BLOCK* WorkBlock,
+    int32_t Index,
+    size_t* BatchGroupStart,
+    size_t* BatchGroupEnd
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the range of batches and groups of a convolution
+    operation to execute on the current worker thread.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the common convolution
+        parameters.
+
+    Index - Supplies the current index of the threaded operation.
+
+    BatchGroupStart - Receives the first batch and group index to execute.
+
+    BatchGroupEnd - Receives the index after the last batch and group index to
+        execute.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t BatchGroupCount = Parameters->BatchCount * Parameters->GroupCount;
+
+    const size_t TargetThreadCount = WorkBlock->TargetThreadCount;
+
+    const size_t BatchGroupCountPerThread = BatchGroupCount / TargetThreadCount;
+    const size_t BatchGroupCountExtra = BatchGroupCount % TargetThreadCount;
+
+    if (uint32_t(Index) < BatchGroupCountExtra) {
+        *BatchGroupStart = (BatchGroupCountPerThread + 1) * Index;
+        *BatchGroupEnd = *BatchGroupStart + BatchGroupCountPerThread + 1;
+    } else {
+        *BatchGroupStart = BatchGroupCountPerThread * Index + BatchGroupCountExtra;
+        *BatchGroupEnd = *BatchGroupStart + BatchGroupCountPerThread;
+    }
+}
+
 void
 MlasConvGemmDirectThreaded(
     void* Context,
@@ -670,28 +721,12 @@ Return Value:
 
     const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
 
-    //
-    // Compute the range of indices to use for this thread.
-    //
-
     const size_t GroupCount = Parameters->GroupCount;
-    const size_t BatchGroupCount = Parameters->BatchCount * GroupCount;
-
-    const size_t TargetThreadCount = WorkBlock->TargetThreadCount;
-
-    const size_t BatchGroupCountPerThread = BatchGroupCount / TargetThreadCount;
-    const size_t BatchGroupCountExtra = BatchGroupCount % TargetThreadCount;
 
     size_t BatchGroupStart;
     size_t BatchGroupEnd;
 
-    if (uint32_t(Index) < BatchGroupCountExtra) {
-        BatchGroupStart = (BatchGroupCountPerThread + 1) * Index;
-        BatchGroupEnd = BatchGroupStart + BatchGroupCountPerThread + 1;
-    } else {
-        BatchGroupStart = BatchGroupCountPerThread * Index + BatchGroupCountExtra;
-        BatchGroupEnd = BatchGroupStart + BatchGroupCountPerThread;
-    }
+    MlasConvPartitionBatchGroups(WorkBlock, Index, &BatchGroupStart, &BatchGroupEnd);
 
     //
     // Iterate over the batch and groups allocated to this thread.
@@ -736,6 +771,316 @@ Return Value:
     }
 }
 
+template<size_t KernelSize, size_t StrideSize>
+void
+MlasConvDepthwiseKernel(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    float Bias,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine computes one output channel of a depthwise convolution with
+    a square kernel of KernelSize elements and a stride of StrideSize in both
+    dimensions. The bias and the activation are applied to each output row
+    while the row is still in the cache.
+
+    The output columns where the kernel reads only the input tensor are
+    computed without bounds checks. When the stride is one, these columns are
+    computed four at a time.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input channel.
+
+    Filter - Supplies the filter for the output channel.
+
+    Bias - Supplies the bias for the output channel.
+
+    Output - Supplies the output channel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+
+    //
+    // Compute the range of output columns where the kernel does not read any
+    // of the padding.
+    //
+
+    size_t OutputWidthStart = (PaddingLeft + StrideSize - 1) / StrideSize;
+    size_t OutputWidthEnd = 0;
+
+    if (InputWidth + PaddingLeft >= KernelSize) {
+        OutputWidthEnd = (InputWidth + PaddingLeft - KernelSize) / StrideSize + 1;
+    }
+
+    OutputWidthStart = (std::min)(OutputWidthStart, OutputWidth);
+    OutputWidthEnd = (std::max)((std::min)(OutputWidthEnd, OutputWidth), OutputWidthStart);
+
+    MLAS_FLOAT32X4 FilterVector[KernelSize * KernelSize];
+
+    for (size_t k = 0; k < KernelSize * KernelSize; k++) {
+        FilterVector[k] = MlasBroadcastFloat32x4(Filter[k]);
+    }
+
+    const MLAS_FLOAT32X4 BiasVector = MlasBroadcastFloat32x4(Bias);
+
+    for (size_t oh = 0; oh < OutputHeight; oh++) {
+
+        //
+        // Compute the range of kernel rows that read the input tensor. The
+        // input row for kernel row kh is (ih + kh - PaddingTop).
+        //
+
+        const size_t ih = oh * StrideSize;
+
+        size_t KernelRowStart = (ih < PaddingTop) ? PaddingTop - ih : 0;
+        size_t KernelRowEnd = 0;
+
+        if (InputHeight + PaddingTop > ih) {
+            KernelRowEnd = (std::min)(KernelSize, InputHeight + PaddingTop - ih);
+        }
+
+        KernelRowStart = (std::min)(KernelRowStart, KernelRowEnd);
+
+        const float* InputBase = Input + (ptrdiff_t(ih) - ptrdiff_t(PaddingTop)) * ptrdiff_t(InputWidth) -
+            ptrdiff_t(PaddingLeft);
+        float* OutputRow = Output + oh * OutputWidth;
+
+        size_t ow = 0;
+
+        //
+        // Compute the output columns that read the left padding.
+        //
+
+        for (; ow < OutputWidthStart; ow++) {
+
+            float Accumulator = Bias;
+
+            for (size_t kh = KernelRowStart; kh < KernelRowEnd; kh++) {
+                for (size_t kw = 0; kw < KernelSize; kw++) {
+                    size_t iw = ow * StrideSize + kw;
+                    if (iw >= PaddingLeft && iw - PaddingLeft < InputWidth) {
+                        Accumulator += InputBase[kh * InputWidth + iw] * Filter[kh * KernelSize + kw];
+                    }
+                }
+            }
+
+            OutputRow[ow] = Accumulator;
+        }
+
+        //
+        // Compute the output columns that read only the input tensor.
+        //
+
+        if (StrideSize == 1) {
+
+            for (; ow + 4 <= OutputWidthEnd; ow += 4) {
+
+                MLAS_FLOAT32X4 Accumulator = BiasVector;
+
+                for (size_t kh = KernelRowStart; kh < KernelRowEnd; kh++) {
+                    const float* InputRow = InputBase + kh * InputWidth + ow;
+                    for (size_t kw = 0; kw < KernelSize; kw++) {
+                        Accumulator = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(InputRow + kw),
+                            FilterVector[kh * KernelSize + kw], Accumulator);
+                    }
+                }
+
+                MlasStoreFloat32x4(OutputRow + ow, Accumulator);
+            }
+        }
+
+        for (; ow < OutputWidthEnd; ow++) {
+
+            float Accumulator = Bias;
+
+            for (size_t kh = KernelRowStart; kh < KernelRowEnd; kh++) {
+                const float* InputRow = InputBase + kh * InputWidth + ow * StrideSize;
+                for (size_t kw = 0; kw < KernelSize; kw++) {
+                    Accumulator += InputRow[kw] * Filter[kh * KernelSize + kw];
+                }
+            }
+
+            OutputRow[ow] = Accumulator;
+        }
+
+        //
+        // Compute the output columns that read the right padding.
+        //
+
+        for (; ow < OutputWidth; ow++) {
+
+            float Accumulator = Bias;
+
+            for (size_t kh = KernelRowStart; kh < KernelRowEnd; kh++) {
+                for (size_t kw = 0; kw < KernelSize; kw++) {
+                    size_t iw = ow * StrideSize + kw;
+                    if (iw >= PaddingLeft && iw - PaddingLeft < InputWidth) {
+                        Accumulator += InputBase[kh * InputWidth + iw] * Filter[kh * KernelSize + kw];
+                    }
+                }
+            }
+
+            OutputRow[ow] = Accumulator;
+        }
+
+        //
+        // Apply the activation to the output row.
+        //
+
+        if (Parameters->Activation->ActivationKind != MlasIdentityActivation) {
+            MlasActivation(Parameters->Activation, OutputRow, nullptr, 1, OutputRow,
+                OutputWidth, OutputWidth);
+        }
+    }
+}
+
+void
+MlasConvDepthwise(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the output channels of one group of a depthwise
+    convolution, where each group has a single input channel.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input channel of the group.
+
+    Filter - Supplies the filters of the group.
+
+    Bias - Optionally supplies the bias vector of the group.
+
+    Output - Supplies the output channels of the group.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    typedef
+    void
+    (MLAS_CONV_DEPTHWISE_KERNEL)(
+        const MLAS_CONV_PARAMETERS* Parameters,
+        const float* Input,
+        const float* Filter,
+        float Bias,
+        float* Output
+        );
+
+    MLAS_CONV_DEPTHWISE_KERNEL* Kernel;
+
+    if (Parameters->KernelShape[0] == 3) {
+        Kernel = (Parameters->StrideShape[0] == 1) ?
+            MlasConvDepthwiseKernel<3, 1> : MlasConvDepthwiseKernel<3, 2>;
+    } else {
+        Kernel = (Parameters->StrideShape[0] == 1) ?
+            MlasConvDepthwiseKernel<5, 1> : MlasConvDepthwiseKernel<5, 2>;
+    }
+
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        Kernel(Parameters, Input, Filter, (Bias != nullptr) ? Bias[f] : 0.0f, Output);
+
+        Filter += K;
+        Output += OutputSize;
+    }
+}
+
+void
+MlasConvDepthwiseThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    depthwise convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t GroupCount = Parameters->GroupCount;
+
+    size_t BatchGroupStart;
+    size_t BatchGroupEnd;
+
+    MlasConvPartitionBatchGroups(WorkBlock, Index, &BatchGroupStart, &BatchGroupEnd);
+
+    //
+    // Iterate over the batch and groups allocated to this thread.
+    //
+
+    const size_t FilterCount = Parameters->FilterCount;
+
+    const size_t InputGroupSize = Parameters->InputSize;
+    const size_t OutputGroupSize = FilterCount * Parameters->OutputSize;
+    const size_t FilterGroupSize = FilterCount * Parameters->K;
+
+    for (size_t bg = BatchGroupStart; bg < BatchGroupEnd; bg++) {
+
+        size_t group = bg % GroupCount;
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += group * FilterCount;
+        }
+
+        MlasConvDepthwise(Parameters, WorkBlock->Input + bg * InputGroupSize,
+            WorkBlock->Filter + group * FilterGroupSize, bias,
+            WorkBlock->Output + bg * OutputGroupSize);
+    }
+}
+
 inline
 bool
 MlasConvTryMultithread(
@@ -900,7 +1245,8 @@ Return Value:
     // Schedule batches of GEMMs across multiple threads.
     //
 
-    if (Algorithm == MlasConvAlgorithmGemmDirect && ((BatchCount > 1) || (GroupCount > 1))) {
+    if ((Algorithm == MlasConvAlgorithmGemmDirect && ((BatchCount > 1) || (GroupCount > 1))) ||
+        Algorithm == MlasConvAlgorithmDepthwise) {
 
         const size_t BatchGroupCount = BatchCount * GroupCount;
 
@@ -920,7 +1266,10 @@ Return Value:
         WorkBlock.Output = Output;
         WorkBlock.TargetThreadCount = TargetThreadCount;
 
-        MlasExecuteThreaded(MlasConvGemmDirectThreaded, &WorkBlock, TargetThreadCount);
+        PMLAS_THREADED_ROUTINE ThreadedRoutine = (Algorithm == MlasConvAlgorithmDepthwise) ?
+            MlasConvDepthwiseThreaded : MlasConvGemmDirectThreaded;
+
+        MlasExecuteThreaded(ThreadedRoutine, &WorkBlock, TargetThreadCount);
 
         return;
     }
@@ -990,6 +1339,17 @@ Return Value:
                     break;
                 }
 
+                case MlasConvAlgorithmDepthwise:
+                {
+                    //
+                    // Invoke the depthwise kernel directly with the input tensor.
+                    //
+
+                    MlasConvDepthwise(Parameters, Input, filter, bias, Output);
+
+                    break;
+                }
+
                 case MlasConvAlgorithmExpandThenGemmSegmented:
                 {
                     //
@@ -1136,6 +1496,23 @@ Return Value:
 
     *WorkingBufferSize = 0;
 
+    //
+    // Detect a depthwise convolution with a kernel that has a specialized
+    // implementation. These would otherwise be computed as a GEMM with a
+    // single row per group.
+    //
+
+    if (Dimensions == 2 && InputChannels == 1 && GroupCount > 1 && AllDilationsAreOne &&
+        Parameters->KernelShape[0] == Parameters->KernelShape[1] &&
+        (Parameters->KernelShape[0] == 3 || Parameters->KernelShape[0] == 5) &&
+        Parameters->StrideShape[0] == Parameters->StrideShape[1] &&
+        (Parameters->StrideShape[0] == 1 || Parameters->StrideShape[0] == 2)) {
+
+        Parameters->Algorithm = MlasConvAlgorithmDepthwise;
+
+        return;
+    }
+
     if (AllStridesAreOne && AllPaddingIsZero) {
 
         //
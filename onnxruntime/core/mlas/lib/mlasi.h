@@ -21,6 +21,7 @@ Abstract:
 #include <mlas.h>
 #include <memory.h>
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
 #if defined(_WIN32)
@@ -176,6 +177,18 @@ void
 
 typedef MLAS_TANH_KERNEL_ROUTINE* PMLAS_TANH_KERNEL_ROUTINE;
 
+typedef
+void
+(MLASCALL MLAS_SOFTMAX_KERNEL_ROUTINE)(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    );
+
+typedef MLAS_SOFTMAX_KERNEL_ROUTINE* PMLAS_SOFTMAX_KERNEL_ROUTINE;
+
 extern "C" {
 
     MLAS_SGEMM_KERNEL_ROUTINE MlasSgemmKernelZero;
@@ -210,6 +223,12 @@ extern "C" {
     MLAS_TANH_KERNEL_ROUTINE MlasTanhKernelFma3;
 #endif
 
+    MLAS_SOFTMAX_KERNEL_ROUTINE MlasSoftmaxKernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_SOFTMAX_KERNEL_ROUTINE MlasSoftmaxKernelFma3;
+    MLAS_SOFTMAX_KERNEL_ROUTINE MlasSoftmaxKernelAvx512F;
+#endif
+
 }
 
 //
@@ -231,6 +250,13 @@ extern "C" {
 #endif
 #endif
 
+//
+// Define the target number of per-thread elements for a softmax operation
+// before using another thread to perform additional work.
+//
+
+#define MLAS_SOFTMAX_THREAD_COMPLEXITY              (64 * 1024)
+
 //
 // Single-threaded single precision matrix/matrix multiply operation.
 //
@@ -252,14 +278,62 @@ MlasSgemmOperation(
     size_t ldc
     );
 
+//
+// Define the NCHWc convolution and pooling routines of an instruction set.
+// Each computes a range of the output rows of an operation on a worker
+// thread, see snchwc.h.
+//
+
+struct MLAS_NCHWC_ROUTINES {
+    MLAS_THREADED_WORK_ROUTINE* ConvNchwcRoutine;
+    MLAS_THREADED_WORK_ROUTINE* ConvNchwRoutine;
+    MLAS_THREADED_WORK_ROUTINE* ConvDepthwiseRoutine;
+    MLAS_THREADED_WORK_ROUTINE* PoolRoutine;
+};
+
+extern const MLAS_NCHWC_ROUTINES MlasNchwcRoutines;
+#if defined(MLAS_TARGET_AMD64)
+extern const MLAS_NCHWC_ROUTINES MlasNchwcRoutinesAvx;
+extern const MLAS_NCHWC_ROUTINES MlasNchwcRoutinesFma3;
+extern const MLAS_NCHWC_ROUTINES MlasNchwcRoutinesAvx512F;
+#endif
+
 //
 // Environment information class.
 //
 
+//
+// Threading callbacks supplied by the host application.
+//
+
+extern MLAS_THREADING_CALLBACKS MlasThreadingCallbacks;
+
+inline
+int32_t
+MlasGetCallbackThreadCount(
+    void
+    )
+{
+    if (MlasThreadingCallbacks.GetMaximumThreadCount == nullptr) {
+        return 0;
+    }
+
+    int32_t ThreadCount = MlasThreadingCallbacks.GetMaximumThreadCount();
+
+    //
+    // Bound the count by the size of the per-thread work arrays.
+    //
+
+    return (ThreadCount > MLAS_MAXIMUM_THREAD_COUNT) ? MLAS_MAXIMUM_THREAD_COUNT : ThreadCount;
+}
+
 struct MLAS_PLATFORM {
 
     MLAS_PLATFORM(void);
 
+    size_t NchwcBlockSize;
+    const MLAS_NCHWC_ROUTINES* NchwcRoutines;
+
 #if defined(MLAS_TARGET_AMD64_IX86)
     PMLAS_SGEMM_KERNEL_ROUTINE KernelZeroRoutine;
     PMLAS_SGEMM_KERNEL_ROUTINE KernelAddRoutine;
@@ -271,6 +345,7 @@ struct MLAS_PLATFORM {
     PMLAS_SGEMM_TRANSPOSE_PACKB_BLOCK_ROUTINE TransposePackB16x4Routine;
     PMLAS_LOGISTIC_KERNEL_ROUTINE LogisticKernelRoutine;
     PMLAS_TANH_KERNEL_ROUTINE TanhKernelRoutine;
+    PMLAS_SOFTMAX_KERNEL_ROUTINE SoftmaxKernelRoutine;
 #endif
 
 #if defined(MLAS_USE_WIN32_THREADPOOL)
@@ -282,6 +357,16 @@ struct MLAS_PLATFORM {
         void
         )
     {
+        //
+        // Prefer the thread pool supplied by the host application.
+        //
+
+        int32_t CallbackThreadCount = MlasGetCallbackThreadCount();
+
+        if (CallbackThreadCount > 0) {
+            return CallbackThreadCount;
+        }
+
 #if defined(MLAS_USE_OPENMP)
         return (omp_get_num_threads() == 1) ? omp_get_max_threads() : 1;
 #elif defined(MLAS_USE_WIN32_THREADPOOL)
@@ -298,12 +383,7 @@ extern MLAS_PLATFORM MlasPlatform;
 // Threading support.
 //
 
-typedef
-void
-(MLAS_THREADED_ROUTINE)(
-    void* Context,
-    int32_t Index
-    );
+typedef MLAS_THREADED_WORK_ROUTINE MLAS_THREADED_ROUTINE;
 
 typedef MLAS_THREADED_ROUTINE* PMLAS_THREADED_ROUTINE;
 
@@ -354,8 +434,10 @@ MlasExecuteThreaded(
 
 #if defined(MLAS_NEON_INTRINSICS)
 typedef float32x4_t MLAS_FLOAT32X4;
+typedef int32x4_t MLAS_INT32X4;
 #elif defined(MLAS_SSE2_INTRINSICS)
 typedef __m128 MLAS_FLOAT32X4;
+typedef __m128i MLAS_INT32X4;
 #endif
 
 inline
@@ -566,6 +648,98 @@ MlasMinimumFloat32x4(MLAS_FLOAT32X4 Vector1, MLAS_FLOAT32X4 Vector2)
 #endif
 }
 
+inline
+float
+MlasReduceAddFloat32x4(MLAS_FLOAT32X4 Vector)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    float32x2_t VectorLow = vget_low_f32(Vector);
+    float32x2_t VectorHigh = vget_high_f32(Vector);
+    VectorLow = vpadd_f32(VectorLow, VectorHigh);
+    VectorLow = vpadd_f32(VectorLow, VectorLow);
+    return vget_lane_f32(VectorLow, 0);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    Vector = _mm_add_ps(Vector, _mm_shuffle_ps(Vector, Vector, _MM_SHUFFLE(3, 2, 3, 2)));
+    Vector = _mm_add_ps(Vector, _mm_shuffle_ps(Vector, Vector, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(Vector);
+#endif
+}
+
+inline
+float
+MlasReduceMaximumFloat32x4(MLAS_FLOAT32X4 Vector)
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+    return vmaxvq_f32(Vector);
+#elif defined(MLAS_NEON32_INTRINSICS)
+    float32x2_t VectorLow = vget_low_f32(Vector);
+    float32x2_t VectorHigh = vget_high_f32(Vector);
+    VectorLow = vpmax_f32(VectorLow, VectorHigh);
+    VectorLow = vpmax_f32(VectorLow, VectorLow);
+    return vget_lane_f32(VectorLow, 0);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    Vector = _mm_max_ps(Vector, _mm_shuffle_ps(Vector, Vector, _MM_SHUFFLE(3, 2, 3, 2)));
+    Vector = _mm_max_ps(Vector, _mm_shuffle_ps(Vector, Vector, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(Vector);
+#endif
+}
+
+inline
+MLAS_INT32X4
+MlasBroadcastInt32x4(int32_t Value)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vdupq_n_s32(Value);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_set1_epi32(Value);
+#endif
+}
+
+inline
+MLAS_INT32X4
+MlasAddInt32x4(MLAS_INT32X4 Vector1, MLAS_INT32X4 Vector2)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vaddq_s32(Vector1, Vector2);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_add_epi32(Vector1, Vector2);
+#endif
+}
+
+template<unsigned ShiftCount>
+inline
+MLAS_INT32X4
+MlasShiftLeftInt32x4(MLAS_INT32X4 Vector)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vshlq_n_s32(Vector, ShiftCount);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_slli_epi32(Vector, ShiftCount);
+#endif
+}
+
+inline
+MLAS_INT32X4
+MlasReinterpretAsInt32x4(MLAS_FLOAT32X4 Vector)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vreinterpretq_s32_f32(Vector);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_castps_si128(Vector);
+#endif
+}
+
+inline
+MLAS_FLOAT32X4
+MlasReinterpretAsFloat32x4(MLAS_INT32X4 Vector)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vreinterpretq_f32_s32(Vector);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_castsi128_ps(Vector);
+#endif
+}
+
 //
 // Reads a platform specific time stamp counter.
 //
@@ -43,6 +43,14 @@ Return Value:
 --*/
 {
 
+    //
+    // Default to the portable NCHWc kernels with the block size that fills two
+    // 128-bit vectors.
+    //
+
+    this->NchwcBlockSize = 8;
+    this->NchwcRoutines = &MlasNchwcRoutines;
+
 #if defined(MLAS_TARGET_AMD64_IX86)
 
     //
@@ -55,6 +63,7 @@ Return Value:
     this->TransposePackB16x4Routine = MlasSgemmTransposePackB16x4Sse;
     this->LogisticKernelRoutine = MlasLogisticKernel;
     this->TanhKernelRoutine = MlasTanhKernel;
+    this->SoftmaxKernelRoutine = MlasSoftmaxKernel;
 #endif
 
     //
@@ -106,9 +115,14 @@ Return Value:
                 if (((Cpuid7[1] & 0x10000) != 0) && ((xcr0 & 0xE0) == 0xE0)) {
                     this->KernelZeroRoutine = MlasSgemmKernelZeroAvx512F;
                     this->KernelAddRoutine = MlasSgemmKernelAddAvx512F;
+                    this->NchwcBlockSize = 16;
+                    this->NchwcRoutines = &MlasNchwcRoutinesAvx512F;
+                    this->SoftmaxKernelRoutine = MlasSoftmaxKernelAvx512F;
                 } else {
                     this->KernelZeroRoutine = MlasSgemmKernelZeroFma3;
                     this->KernelAddRoutine = MlasSgemmKernelAddFma3;
+                    this->NchwcRoutines = &MlasNchwcRoutinesFma3;
+                    this->SoftmaxKernelRoutine = MlasSoftmaxKernelFma3;
                 }
 
                 this->LogisticKernelRoutine = MlasLogisticKernelFma3;
@@ -118,6 +132,7 @@ Return Value:
 
                 this->KernelZeroRoutine = MlasSgemmKernelZeroAvx;
                 this->KernelAddRoutine = MlasSgemmKernelAddAvx;
+                this->NchwcRoutines = &MlasNchwcRoutinesAvx;
             }
 
             this->KernelM1Routine = MlasSgemmKernelM1Avx;
@@ -1171,6 +1171,74 @@ static const PMLAS_POOL_KERNEL_ROUTINE MlasPoolVectorKernels[][2] =
     },
 };
 
+//
+// Define the parameters to execute slices of the channels of a pooling
+// operation on worker threads.
+//
+
+struct MLAS_POOL_THREADED_WORK_BLOCK {
+    const MLAS_WORK_BLOCK* WorkBlock;
+    PMLAS_POOL_KERNEL_ROUTINE PoolKernelRoutine;
+    size_t TotalChannelCount;
+    size_t InputSize;
+    size_t OutputSize;
+    const float* Input;
+    float* Output;
+    int32_t TargetThreadCount;
+};
+
+void
+MlasPoolThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a slice of the
+    channels of a pooling operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the parameters for the operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_POOL_THREADED_WORK_BLOCK* ThreadedWorkBlock = (MLAS_POOL_THREADED_WORK_BLOCK*)Context;
+
+    //
+    // Compute the range of channels to use for this thread.
+    //
+
+    const size_t TotalChannelCount = ThreadedWorkBlock->TotalChannelCount;
+    const size_t TargetThreadCount = size_t(ThreadedWorkBlock->TargetThreadCount);
+
+    const size_t ChannelCountPerThread = TotalChannelCount / TargetThreadCount;
+    const size_t ChannelCountExtra = TotalChannelCount % TargetThreadCount;
+
+    size_t ChannelStart;
+    size_t ChannelCount;
+
+    if (size_t(Index) < ChannelCountExtra) {
+        ChannelStart = (ChannelCountPerThread + 1) * size_t(Index);
+        ChannelCount = ChannelCountPerThread + 1;
+    } else {
+        ChannelStart = ChannelCountPerThread * size_t(Index) + ChannelCountExtra;
+        ChannelCount = ChannelCountPerThread;
+    }
+
+    ThreadedWorkBlock->PoolKernelRoutine(ThreadedWorkBlock->WorkBlock, ChannelCount,
+        ThreadedWorkBlock->Input + ChannelStart * ThreadedWorkBlock->InputSize,
+        ThreadedWorkBlock->Output + ChannelStart * ThreadedWorkBlock->OutputSize);
+}
+
 void
 MLASCALL
 MlasPool(
@@ -1318,18 +1386,50 @@ Return Value:
     //
     // Execute the pooling kernel routine.
     //
+    // Slice the channels across the host application's thread pool if one is
+    // available to this thread.
+    //
+
+    int32_t TargetThreadCount = MlasGetCallbackThreadCount();
+
+    if (TargetThreadCount == 0) {
 
 #if defined(MLAS_USE_OPENMP)
 
-    #pragma omp parallel for
-    for (int64_t c = 0; c < int64_t(TotalChannelCount); c++) {
-        PoolKernelRoutine(&WorkBlock, 1, Input + c * InputSize, Output + c * OutputSize);
-    }
+        #pragma omp parallel for
+        for (int64_t c = 0; c < int64_t(TotalChannelCount); c++) {
+            PoolKernelRoutine(&WorkBlock, 1, Input + c * InputSize, Output + c * OutputSize);
+        }
 
 #else
 
-    PoolKernelRoutine(&WorkBlock, TotalChannelCount, Input, Output);
+        PoolKernelRoutine(&WorkBlock, TotalChannelCount, Input, Output);
 
 #endif
 
+        return;
+    }
+
+    if (size_t(TargetThreadCount) > TotalChannelCount) {
+        TargetThreadCount = int32_t(TotalChannelCount);
+    }
+
+    if (TargetThreadCount <= 1) {
+        PoolKernelRoutine(&WorkBlock, TotalChannelCount, Input, Output);
+        return;
+    }
+
+    MLAS_POOL_THREADED_WORK_BLOCK ThreadedWorkBlock;
+
+    ThreadedWorkBlock.WorkBlock = &WorkBlock;
+    ThreadedWorkBlock.PoolKernelRoutine = PoolKernelRoutine;
+    ThreadedWorkBlock.TotalChannelCount = TotalChannelCount;
+    ThreadedWorkBlock.InputSize = InputSize;
+    ThreadedWorkBlock.OutputSize = OutputSize;
+    ThreadedWorkBlock.Input = Input;
+    ThreadedWorkBlock.Output = Output;
+    ThreadedWorkBlock.TargetThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasPoolThreaded, &ThreadedWorkBlock, TargetThreadCount);
+
 }
@@ -49,6 +49,32 @@ struct MLAS_SGEMM_WORK_BLOCK {
     } Segments[MLAS_MAXIMUM_THREAD_COUNT];
 };
 
+//
+// Define the parameters to execute ranges of a batched SGEMM operation on
+// worker threads.
+//
+
+struct MLAS_SGEMM_BATCH_WORK_BLOCK {
+    CBLAS_TRANSPOSE TransA;
+    CBLAS_TRANSPOSE TransB;
+    size_t M;
+    size_t N;
+    size_t K;
+    float alpha;
+    const float* A;
+    size_t lda;
+    size_t StrideA;
+    const float* B;
+    size_t ldb;
+    size_t StrideB;
+    float beta;
+    float* C;
+    size_t ldc;
+    size_t StrideC;
+    size_t BatchCount;
+    int32_t ThreadCount;
+};
+
 #if defined(MLAS_TARGET_AMD64_IX86)
 
 //
@@ -772,6 +798,154 @@ Return Value:
     }
 }
 
+void
+MlasSgemmMultiplyPanel(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PanelB,
+    float* C,
+    size_t ldc,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies the rows of matrix A with a panel of matrix B
+    packed by MlasSgemmCopyPackB or MlasSgemmTransposePackB, and stores or
+    accumulates the result to matrix C.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    CountN - Supplies the number of columns of the panel and matrix C.
+
+    CountK - Supplies the number of rows of the panel and the number of
+        columns of matrix A.
+
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the slice of matrix A for the panel.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PanelB - Supplies the address of the packed panel of matrix B.
+
+    C - Supplies the address of the slice of matrix C for the panel.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output is stored to matrix C, else false
+        if the output is added to matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+    PMLAS_SGEMM_KERNEL_ROUTINE SgemmKernelRoutine =
+        ZeroMode ? MlasPlatform.KernelZeroRoutine : MlasPlatform.KernelAddRoutine;
+#endif
+
+    //
+    // Step through each slice of matrix A along the M dimension.
+    //
+
+    float* c = C;
+
+    size_t RowsRemaining = M;
+    size_t RowsHandled;
+
+    if (TransA == CblasNoTrans) {
+
+        const float* a = A;
+
+        //
+        // Step through the rows of matrix A.
+        //
+
+        do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+            RowsHandled = SgemmKernelRoutine(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+#else
+            if (ZeroMode) {
+                RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            } else {
+                RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            }
+#endif
+
+            c += ldc * RowsHandled;
+            a += lda * RowsHandled;
+
+            RowsRemaining -= RowsHandled;
+
+        } while (RowsRemaining > 0);
+
+    } else {
+
+        const float* a = A;
+
+        do {
+
+            //
+            // Transpose elements from matrix A into a local buffer.
+            //
+
+            size_t RowsTransposed = RowsRemaining;
+
+            if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
+                RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
+            }
+
+            RowsRemaining -= RowsTransposed;
+
+            MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+
+            a += RowsTransposed;
+
+            //
+            // Step through the rows of the local buffer.
+            //
+
+            const float* pa = PanelA;
+
+            do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+                RowsHandled = SgemmKernelRoutine(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+#else
+                if (ZeroMode) {
+                    RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                } else {
+                    RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                }
+#endif
+
+                c += ldc * RowsHandled;
+                pa += CountK * RowsHandled;
+
+                RowsTransposed -= RowsHandled;
+
+            } while (RowsTransposed > 0);
+
+        } while (RowsRemaining > 0);
+    }
+}
+
 void
 MlasSgemmOperation(
     CBLAS_TRANSPOSE TransA,
@@ -830,7 +1004,6 @@ Return Value:
 
 --*/
 {
-    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
     MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
 
     //
@@ -932,101 +1105,12 @@ Return Value:
             }
 
             //
-            // Select the kernel routine to use for this panel.
-            //
-
-            bool UseKernelZeroRoutine = (k == 0 && beta == 0.0f);
-
-#if defined(MLAS_TARGET_AMD64_IX86)
-            PMLAS_SGEMM_KERNEL_ROUTINE SgemmKernelRoutine =
-                UseKernelZeroRoutine ? MlasPlatform.KernelZeroRoutine : MlasPlatform.KernelAddRoutine;
-#endif
-
-            //
-            // Step through each slice of matrix A along the M dimension.
+            // Multiply the rows of matrix A with the packed panel.
             //
 
-            float* c = C + n;
-
-            size_t RowsRemaining = M;
-            size_t RowsHandled;
-
-            if (TransA == CblasNoTrans) {
-
-                const float* a = A + k;
-
-                //
-                // Step through the rows of matrix A.
-                //
-
-                do {
-
-#if defined(MLAS_TARGET_AMD64_IX86)
-                    RowsHandled = SgemmKernelRoutine(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-#else
-                    if (UseKernelZeroRoutine) {
-                        RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    } else {
-                        RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    }
-#endif
-
-                    c += ldc * RowsHandled;
-                    a += lda * RowsHandled;
-
-                    RowsRemaining -= RowsHandled;
-
-                } while (RowsRemaining > 0);
-
-            } else {
-
-                const float* a = A + k * lda;
-
-                do {
-
-                    //
-                    // Transpose elements from matrix A into a local buffer.
-                    //
-
-                    size_t RowsTransposed = RowsRemaining;
-
-                    if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
-                        RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
-                    }
-
-                    RowsRemaining -= RowsTransposed;
-
-                    MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
-
-                    a += RowsTransposed;
-
-                    //
-                    // Step through the rows of the local buffer.
-                    //
-
-                    const float* pa = PanelA;
-
-                    do {
-
-#if defined(MLAS_TARGET_AMD64_IX86)
-                        RowsHandled = SgemmKernelRoutine(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-#else
-                        if (UseKernelZeroRoutine) {
-                            RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        } else {
-                            RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        }
-#endif
-
-                        c += ldc * RowsHandled;
-                        pa += CountK * RowsHandled;
-
-                        RowsTransposed -= RowsHandled;
-
-                    } while (RowsTransposed > 0);
-
-                } while (RowsRemaining > 0);
-            }
+            MlasSgemmMultiplyPanel(TransA, M, CountN, CountK, alpha,
+                (TransA == CblasNoTrans) ? A + k : A + k * lda, lda, PanelB,
+                C + n, ldc, k == 0 && beta == 0.0f);
         }
     }
 }
@@ -1329,3 +1413,653 @@ Return Value:
         MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
     }
 }
+
+void
+MlasSgemmBatchOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of the
+    matrix multiplies of a batched SGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_BATCH_WORK_BLOCK* WorkBlock = (MLAS_SGEMM_BATCH_WORK_BLOCK*)Context;
+
+    //
+    // Partition the batch evenly across the threads, with the first threads
+    // taking one extra matrix multiply if the count doesn't divide evenly.
+    //
+
+    const size_t ThreadCount = size_t(WorkBlock->ThreadCount);
+    const size_t BatchPerThread = WorkBlock->BatchCount / ThreadCount;
+    const size_t BatchExtra = WorkBlock->BatchCount % ThreadCount;
+    const size_t ThreadIndex = size_t(Index);
+
+    size_t BatchStart = ThreadIndex * BatchPerThread;
+    size_t BatchEnd = BatchStart + BatchPerThread;
+
+    if (ThreadIndex < BatchExtra) {
+        BatchStart += ThreadIndex;
+        BatchEnd += ThreadIndex + 1;
+    } else {
+        BatchStart += BatchExtra;
+        BatchEnd += BatchExtra;
+    }
+
+    for (size_t b = BatchStart; b < BatchEnd; b++) {
+
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, WorkBlock->M,
+            WorkBlock->N, WorkBlock->K, WorkBlock->alpha,
+            WorkBlock->A + b * WorkBlock->StrideA, WorkBlock->lda,
+            WorkBlock->B + b * WorkBlock->StrideB, WorkBlock->ldb,
+            WorkBlock->beta, WorkBlock->C + b * WorkBlock->StrideC,
+            WorkBlock->ldc);
+    }
+}
+
+void
+MLASCALL
+MlasSgemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    size_t StrideA,
+    const float* B,
+    size_t ldb,
+    size_t StrideB,
+    float beta,
+    float* C,
+    size_t ldc,
+    size_t StrideC,
+    size_t BatchCount
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a batch of single precision matrix/matrix
+    multiply operations (SGEMM) where the matrices of each batch entry are
+    at a fixed stride from those of the previous entry.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the first matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    StrideA - Supplies the number of elements between consecutive matrices
+        A. A stride of zero uses the same matrix A for the whole batch.
+
+    B - Supplies the address of the first matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    StrideB - Supplies the number of elements between consecutive matrices
+        B. A stride of zero uses the same matrix B for the whole batch.
+
+    beta - Supplies the scaler beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of the first matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    StrideC - Supplies the number of elements between consecutive matrices
+        C.
+
+    BatchCount - Supplies the number of matrix multiplies in the batch.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (BatchCount == 0) {
+        return;
+    }
+
+    //
+    // A matrix B shared by the whole batch with contiguous rows of matrices A
+    // and C is a single SGEMM with taller A and C matrices. Each panel of
+    // matrix B is then packed once for the whole batch instead of once per
+    // batch entry.
+    //
+
+    if (BatchCount == 1 || (StrideB == 0 && TransA == CblasNoTrans &&
+        StrideA == M * lda && StrideC == M * ldc)) {
+        MlasSgemm(TransA, TransB, M * BatchCount, N, K, alpha, A, lda, B, ldb,
+            beta, C, ldc);
+        return;
+    }
+
+#if defined(MLAS_HAS_THREADING_SUPPORT)
+
+    //
+    // Compute the number of target threads given the complexity of the whole
+    // batch. If the batch has at least that many matrix multiplies, each
+    // thread runs a range of them on its own. Otherwise, the matrix multiplies
+    // are run one at a time and each one is split across the threads.
+    //
+
+    double Complexity = double(M) * double(N) * double(K) * double(BatchCount);
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount > 1 && BatchCount >= size_t(TargetThreadCount)) {
+
+        MLAS_SGEMM_BATCH_WORK_BLOCK WorkBlock;
+
+        WorkBlock.TransA = TransA;
+        WorkBlock.TransB = TransB;
+        WorkBlock.M = M;
+        WorkBlock.N = N;
+        WorkBlock.K = K;
+        WorkBlock.alpha = alpha;
+        WorkBlock.A = A;
+        WorkBlock.lda = lda;
+        WorkBlock.StrideA = StrideA;
+        WorkBlock.B = B;
+        WorkBlock.ldb = ldb;
+        WorkBlock.StrideB = StrideB;
+        WorkBlock.beta = beta;
+        WorkBlock.C = C;
+        WorkBlock.ldc = ldc;
+        WorkBlock.StrideC = StrideC;
+        WorkBlock.BatchCount = BatchCount;
+        WorkBlock.ThreadCount = TargetThreadCount;
+
+        MlasExecuteThreaded(MlasSgemmBatchOperationThreaded, &WorkBlock, TargetThreadCount);
+
+        return;
+    }
+
+#endif
+
+    for (size_t b = 0; b < BatchCount; b++) {
+        MlasSgemm(TransA, TransB, M, N, K, alpha, A + b * StrideA, lda,
+            B + b * StrideB, ldb, beta, C + b * StrideC, ldc);
+    }
+}
+
+size_t
+MLASCALL
+MlasSgemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of bytes needed to pack matrix B with
+    MlasSgemmPackB.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the size of the packed buffer in bytes.
+
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+
+    return AlignedN * K * sizeof(float);
+}
+
+void
+MLASCALL
+MlasSgemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs matrix B for repeated use by MlasSgemm.
+
+    Matrix B is split into slices of MLAS_SGEMM_STRIDEK rows. Each slice is
+    stored as the packed panel MlasSgemmCopyPackB or MlasSgemmTransposePackB
+    would build for all N columns, so a panel for any range of columns that
+    starts at a multiple of 16 is found in place.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of the packed buffer, which must be
+        MlasSgemmPackBSize bytes and aligned to 64 bytes.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+
+    float* D = (float*)PackedB;
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = MLAS_SGEMM_STRIDEK;
+
+        if (CountK > (K - k)) {
+            CountK = K - k;
+        }
+
+        if (TransB == CblasNoTrans) {
+            MlasSgemmCopyPackB(D, B + k * ldb, ldb, N, CountK);
+        } else {
+            MlasSgemmTransposePackB(D, B + k, ldb, N, CountK);
+        }
+
+        D += AlignedN * CountK;
+    }
+}
+
+void
+MlasSgemmPackedOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PackedB,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) for a range of the columns of matrix B packed by
+    MlasSgemmPackB.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    RangeStartN - Supplies the first column of matrix B and matrix C to
+        compute, which must be a multiple of 16.
+
+    RangeCountN - Supplies the number of columns of matrix B and matrix C to
+        compute.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    beta - Supplies the scaler beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+
+    //
+    // Expand the N stride if K is small. The K stride is fixed by the packed
+    // layout.
+    //
+
+    size_t StrideN = MLAS_SGEMM_STRIDEN;
+    size_t StrideK = MLAS_SGEMM_STRIDEK;
+
+    while (StrideK / 2 >= K) {
+        StrideN *= 2;
+        StrideK /= 2;
+    }
+
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+
+    size_t CountN;
+    size_t CountK;
+
+    for (size_t n = RangeStartN; n < RangeStartN + RangeCountN; n += CountN) {
+
+        CountN = StrideN;
+
+        if (CountN > (RangeStartN + RangeCountN - n)) {
+            CountN = RangeStartN + RangeCountN - n;
+        }
+
+        //
+        // Multiply the output matrix by beta as needed.
+        //
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension. The
+        // panel for the columns starts n packed columns into the slice.
+        //
+
+        const float* PackedSliceB = PackedB;
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = MLAS_SGEMM_STRIDEK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
+            }
+
+            MlasSgemmMultiplyPanel(TransA, M, CountN, CountK, alpha,
+                (TransA == CblasNoTrans) ? A + k : A + k * lda, lda,
+                PackedSliceB + n * CountK, C + n, ldc, k == 0 && beta == 0.0f);
+
+            PackedSliceB += AlignedN * CountK;
+        }
+    }
+}
+
+//
+// Define the parameters to execute segments of a SGEMM operation with a
+// packed matrix B on worker threads.
+//
+
+struct MLAS_SGEMM_PACKED_WORK_BLOCK {
+    CBLAS_TRANSPOSE TransA;
+    size_t N;
+    size_t K;
+    size_t lda;
+    size_t ldc;
+    float alpha;
+    float beta;
+    const float* PackedB;
+    struct SEGMENT {
+        size_t M;
+        size_t RangeStartN;
+        size_t RangeCountN;
+        const float* A;
+        float* C;
+    } Segments[MLAS_MAXIMUM_THREAD_COUNT];
+};
+
+void
+MlasSgemmPackedOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    SGEMM operation with a packed matrix B.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_PACKED_WORK_BLOCK* WorkBlock = (MLAS_SGEMM_PACKED_WORK_BLOCK*)Context;
+
+    MLAS_SGEMM_PACKED_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+
+    MlasSgemmPackedOperation(WorkBlock->TransA, Segment->M,
+        Segment->RangeStartN, Segment->RangeCountN, WorkBlock->N,
+        WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+        WorkBlock->PackedB, WorkBlock->beta, Segment->C, WorkBlock->ldc);
+}
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with a matrix B packed by MlasSgemmPackB, so the panels
+    of matrix B are not copied or transposed on every call.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scaler alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed matrix B.
+
+    beta - Supplies the scaler beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_HAS_THREADING_SUPPORT)
+
+    //
+    // Compute the number of target threads given the complexity of the SGEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    double Complexity = double(M) * double(N) * double(K);
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount > 1) {
+
+        MLAS_SGEMM_PACKED_WORK_BLOCK WorkBlock;
+
+        WorkBlock.TransA = TransA;
+        WorkBlock.N = N;
+        WorkBlock.K = K;
+        WorkBlock.lda = lda;
+        WorkBlock.ldc = ldc;
+        WorkBlock.alpha = alpha;
+        WorkBlock.beta = beta;
+        WorkBlock.PackedB = (const float*)PackedB;
+
+        //
+        // Segment the operation across multiple threads. Ranges of columns
+        // start at a multiple of 16 to line up with the packed layout.
+        //
+
+        int32_t Index = 0;
+
+        if (N > M) {
+
+            size_t StrideN = N / TargetThreadCount;
+
+            if ((StrideN * TargetThreadCount) != N) {
+                StrideN++;
+            }
+
+            StrideN =
+                (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+            for (size_t CountN, n = 0; n < N; n += CountN) {
+
+                CountN = StrideN;
+
+                if (CountN > (N - n)) {
+                    CountN = N - n;
+                }
+
+                WorkBlock.Segments[Index].M = M;
+                WorkBlock.Segments[Index].RangeStartN = n;
+                WorkBlock.Segments[Index].RangeCountN = CountN;
+                WorkBlock.Segments[Index].A = A;
+                WorkBlock.Segments[Index].C = C;
+
+                Index++;
+            }
+
+        } else {
+
+            size_t StrideM = M / TargetThreadCount;
+
+            if ((StrideM * TargetThreadCount) != M) {
+                StrideM++;
+            }
+
+            size_t plda = (TransA == CblasNoTrans) ? lda : 1;
+
+            for (size_t CountM, m = 0; m < M; m += CountM) {
+
+                CountM = StrideM;
+
+                if (CountM > (M - m)) {
+                    CountM = M - m;
+                }
+
+                WorkBlock.Segments[Index].M = CountM;
+                WorkBlock.Segments[Index].RangeStartN = 0;
+                WorkBlock.Segments[Index].RangeCountN = N;
+                WorkBlock.Segments[Index].A = A + m * plda;
+                WorkBlock.Segments[Index].C = C + m * ldc;
+
+                Index++;
+            }
+        }
+
+        MlasExecuteThreaded(MlasSgemmPackedOperationThreaded, &WorkBlock, Index);
+
+        return;
+    }
+
+#endif
+
+    MlasSgemmPackedOperation(TransA, M, 0, N, N, K, alpha, A, lda,
+        (const float*)PackedB, beta, C, ldc);
+}
@@ -0,0 +1,642 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    snchwc.cpp
+
+Abstract:
+
+    This module implements the single precision operations using the NCHWc
+    blocking format.
+
+    The NCHWc format stores the channels of a tensor in blocks of BlockSize
+    channels, with the channels of a block stored next to each other for each
+    spatial position: [N][C/BlockSize][H][W][BlockSize]. The channel count is
+    padded with zeros to a multiple of the block size. The kernels then
+    compute a whole block of output channels with vector operations, without
+    the im2col buffer of the NCHW convolution.
+
+--*/
+
+#include "snchwc.h"
+
+//
+// Define the vector traits of the portable kernels, which are used with the
+// default block size when the processor has no kernels of its own.
+//
+
+struct MLAS_NCHWC_FLOAT32X4_TRAITS
+{
+    typedef MLAS_FLOAT32X4 Vector;
+
+    static constexpr size_t VectorSize = 4;
+
+    static Vector Zero(void) { return MlasZeroFloat32x4(); }
+
+    static Vector Load(const float* Buffer) { return MlasLoadFloat32x4(Buffer); }
+
+    static void Store(float* Buffer, Vector Value) { MlasStoreFloat32x4(Buffer, Value); }
+
+    static Vector Broadcast(float Value) { return MlasBroadcastFloat32x4(Value); }
+
+    static Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3) { return MlasMultiplyAddFloat32x4(Vector1, Vector2, Vector3); }
+
+    static Vector Add(Vector Vector1, Vector Vector2) { return MlasAddFloat32x4(Vector1, Vector2); }
+
+    static Vector Maximum(Vector Vector1, Vector Vector2) { return MlasMaximumFloat32x4(Vector1, Vector2); }
+
+    static Vector Divide(Vector Vector1, Vector Vector2) { return MlasDivideFloat32x4(Vector1, Vector2); }
+};
+
+const MLAS_NCHWC_ROUTINES MlasNchwcRoutines = MlasNchwcMakeRoutines<MLAS_NCHWC_FLOAT32X4_TRAITS, 8>();
+
+size_t
+MLASCALL
+MlasNchwcGetBlockSize(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the NCHWc block size for the platform.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns the number of channels in a block.
+
+--*/
+{
+    return MlasPlatform.NchwcBlockSize;
+}
+
+void
+MlasNchwcPrepareWorkBlock(
+    MLAS_NCHWC_WORK_BLOCK* WorkBlock,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape
+    )
+/*++
+
+Routine Description:
+
+    This routine prepares the parameters shared by the NCHWc operations.
+
+Arguments:
+
+    WorkBlock - Supplies the structure to receive the parameters.
+
+    InputShape - Supplies the shape of the input tensor in NCHW order.
+
+    KernelShape - Supplies the optional shape of the kernel. If not
+        supplied, the kernel covers the whole input.
+
+    DilationShape - Supplies the optional shape of the dilation.
+
+    Padding - Supplies the optional number of padding elements at the edges of
+        the input tensor.
+
+    StrideShape - Supplies the optional shape of the stride.
+
+    OutputShape - Supplies the shape of the output tensor in NCHW order.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    WorkBlock->BatchCount = size_t(InputShape[0]);
+    WorkBlock->InputChannels = size_t(InputShape[1]);
+    WorkBlock->OutputChannels = size_t(OutputShape[1]);
+
+    for (size_t dim = 0; dim < 2; dim++) {
+
+        WorkBlock->InputShape[dim] = size_t(InputShape[dim + 2]);
+        WorkBlock->OutputShape[dim] = size_t(OutputShape[dim + 2]);
+        WorkBlock->KernelShape[dim] = (KernelShape != nullptr) ? size_t(KernelShape[dim]) : WorkBlock->InputShape[dim];
+        WorkBlock->DilationShape[dim] = (DilationShape != nullptr) ? size_t(DilationShape[dim]) : 1;
+        WorkBlock->Padding[dim] = (Padding != nullptr) ? size_t(Padding[dim]) : 0;
+        WorkBlock->Padding[dim + 2] = (Padding != nullptr) ? size_t(Padding[dim + 2]) : 0;
+        WorkBlock->StrideShape[dim] = (StrideShape != nullptr) ? size_t(StrideShape[dim]) : 1;
+    }
+
+    WorkBlock->InputSize = WorkBlock->InputShape[0] * WorkBlock->InputShape[1];
+    WorkBlock->OutputSize = WorkBlock->OutputShape[0] * WorkBlock->OutputShape[1];
+}
+
+void
+MlasNchwcPartitionWork(
+    const MLAS_NCHWC_WORK_BLOCK* WorkBlock,
+    int32_t Index,
+    size_t TotalWork,
+    size_t* WorkIndex,
+    size_t* WorkRemaining
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the range of work items for a worker thread.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the target thread count.
+
+    Index - Supplies the index of the worker thread.
+
+    TotalWork - Supplies the total number of work items.
+
+    WorkIndex - Receives the index of the first work item for the thread.
+
+    WorkRemaining - Receives the number of work items for the thread.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t TargetThreadCount = size_t(WorkBlock->TargetThreadCount);
+
+    const size_t WorkPerThread = TotalWork / TargetThreadCount;
+    const size_t WorkPerThreadExtra = TotalWork % TargetThreadCount;
+
+    if (size_t(Index) < WorkPerThreadExtra) {
+        *WorkIndex = (WorkPerThread + 1) * size_t(Index);
+        *WorkRemaining = WorkPerThread + 1;
+    } else {
+        *WorkIndex = WorkPerThread * size_t(Index) + WorkPerThreadExtra;
+        *WorkRemaining = WorkPerThread;
+    }
+}
+
+void
+MlasNchwcExecute(
+    MLAS_NCHWC_WORK_BLOCK* WorkBlock,
+    PMLAS_THREADED_ROUTINE ThreadedRoutine,
+    size_t TotalWork
+    )
+/*++
+
+Routine Description:
+
+    This routine executes a NCHWc operation, splitting its work items across
+    the available threads.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the operation parameters.
+
+    ThreadedRoutine - Supplies the routine to execute a range of work items.
+
+    TotalWork - Supplies the total number of work items.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    int32_t TargetThreadCount = MlasPlatform.GetMaximumThreadCount();
+
+    if (size_t(TargetThreadCount) > TotalWork) {
+        TargetThreadCount = int32_t(TotalWork);
+    }
+
+    if (TargetThreadCount <= 1) {
+        WorkBlock->TargetThreadCount = 1;
+        ThreadedRoutine(WorkBlock, 0);
+        return;
+    }
+
+    WorkBlock->TargetThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(ThreadedRoutine, WorkBlock, TargetThreadCount);
+}
+
+void
+MLASCALL
+MlasNchwcConv(
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    size_t GroupCount,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    const MLAS_ACTIVATION* Activation
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the 2D convolution operation using the NCHWc
+    blocking format.
+
+    The layouts of the input and the filter depend on the convolution:
+
+    A convolution with one group and fewer input channels than the block size,
+    such as the first convolution of an image model, reads a NCHW input. The
+    filter is reordered by MlasReorderFilterOIHWBo.
+
+    A depthwise convolution, with a group per input channel, reads a NCHWc
+    input. The filter is reordered by MlasReorderFilterOIHWBo.
+
+    Otherwise, the convolution has one group and reads a NCHWc input. The
+    filter is reordered by MlasReorderFilterOIHWBiBo.
+
+    The output is always in NCHWc format.
+
+Arguments:
+
+    InputShape - Supplies the shape of the input tensor in NCHW order. For a
+        NCHWc input, the channel count is a multiple of the block size.
+
+    KernelShape - Supplies the shape of the kernel.
+
+    DilationShape - Supplies the shape of the dilation.
+
+    Padding - Supplies the number of padding elements at the edges of the input
+        tensor, in the order top, left, bottom, right.
+
+    StrideShape - Supplies the shape of the stride.
+
+    OutputShape - Supplies the shape of the output tensor in NCHW order. The
+        channel count is a multiple of the block size.
+
+    GroupCount - Supplies the number of channel groups, either one or the
+        number of input channels.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the reordered filter tensor.
+
+    Bias - Supplies the optional bias vector, with an element per output
+        channel including the padding.
+
+    Output - Supplies the output tensor.
+
+    Activation - Supplies the parameters for the activation to apply to the
+        output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_NCHWC_CONV_WORK_BLOCK WorkBlock;
+
+    MlasNchwcPrepareWorkBlock(&WorkBlock, InputShape, KernelShape, DilationShape, Padding, StrideShape, OutputShape);
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    if (GroupCount > 1) {
+        WorkBlock.ConvKind = MlasNchwcConvDepthwise;
+    } else if (WorkBlock.InputChannels < BlockSize) {
+        WorkBlock.ConvKind = MlasNchwcConvNchw;
+    } else {
+        WorkBlock.ConvKind = MlasNchwcConvNchwc;
+    }
+
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Activation = Activation;
+    WorkBlock.Output = Output;
+
+    const MLAS_NCHWC_ROUTINES* Routines = MlasPlatform.NchwcRoutines;
+    PMLAS_THREADED_ROUTINE ThreadedRoutine;
+
+    switch (WorkBlock.ConvKind) {
+
+        case MlasNchwcConvNchwc:
+            ThreadedRoutine = Routines->ConvNchwcRoutine;
+            break;
+
+        case MlasNchwcConvNchw:
+            ThreadedRoutine = Routines->ConvNchwRoutine;
+            break;
+
+        case MlasNchwcConvDepthwise:
+        default:
+            ThreadedRoutine = Routines->ConvDepthwiseRoutine;
+            break;
+    }
+
+    const size_t TotalWork = WorkBlock.BatchCount * (WorkBlock.OutputChannels / BlockSize) * WorkBlock.OutputShape[0];
+
+    MlasNchwcExecute(&WorkBlock, ThreadedRoutine, TotalWork);
+}
+
+void
+MLASCALL
+MlasNchwcPool(
+    MLAS_POOLING_KIND PoolingKind,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the 2D pooling operation using the NCHWc blocking
+    format.
+
+Arguments:
+
+    PoolingKind - Supplies the kind of pooling operation to perform.
+
+    InputShape - Supplies the shape of the input tensor in NCHW order. The
+        channel count is a multiple of the block size.
+
+    KernelShape - Supplies the optional shape of the kernel. If not supplied,
+        the pooling is global.
+
+    Padding - Supplies the optional number of padding elements at the edges of
+        the input tensor, in the order top, left, bottom, right.
+
+    StrideShape - Supplies the optional shape of the stride.
+
+    OutputShape - Supplies the shape of the output tensor in NCHW order.
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_NCHWC_POOL_WORK_BLOCK WorkBlock;
+
+    MlasNchwcPrepareWorkBlock(&WorkBlock, InputShape, KernelShape, nullptr, Padding, StrideShape, OutputShape);
+
+    WorkBlock.PoolingKind = PoolingKind;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    PMLAS_THREADED_ROUTINE ThreadedRoutine = MlasPlatform.NchwcRoutines->PoolRoutine;
+
+    const size_t TotalWork = WorkBlock.BatchCount * (WorkBlock.InputChannels / BlockSize) * WorkBlock.OutputShape[0];
+
+    MlasNchwcExecute(&WorkBlock, ThreadedRoutine, TotalWork);
+}
+
+//
+// Reorder routines.
+//
+
+void
+MLASCALL
+MlasReorderInput(
+    const int64_t* InputShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders a NCHW tensor to the NCHWc format, padding the
+    channels with zeros to a multiple of the block size.
+
+Arguments:
+
+    InputShape - Supplies the shape of the NCHW tensor.
+
+    S - Supplies the NCHW tensor.
+
+    D - Supplies the buffer to receive the NCHWc tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    const size_t BatchCount = size_t(InputShape[0]);
+    const size_t Channels = size_t(InputShape[1]);
+    const size_t SpatialSize = size_t(InputShape[2]) * size_t(InputShape[3]);
+
+    for (size_t n = 0; n < BatchCount; n++) {
+
+        for (size_t c = 0; c < Channels; c += BlockSize) {
+
+            const size_t BlockChannels = (std::min)(BlockSize, Channels - c);
+
+            for (size_t s = 0; s < SpatialSize; s++) {
+
+                size_t bc = 0;
+
+                for (; bc < BlockChannels; bc++) {
+                    D[bc] = S[bc * SpatialSize + s];
+                }
+
+                for (; bc < BlockSize; bc++) {
+                    D[bc] = 0.0f;
+                }
+
+                D += BlockSize;
+            }
+
+            S += BlockChannels * SpatialSize;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasReorderOutput(
+    const int64_t* OutputShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders a NCHWc tensor to the NCHW format, dropping the
+    padding channels.
+
+Arguments:
+
+    OutputShape - Supplies the shape of the NCHW tensor.
+
+    S - Supplies the NCHWc tensor.
+
+    D - Supplies the buffer to receive the NCHW tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    const size_t BatchCount = size_t(OutputShape[0]);
+    const size_t Channels = size_t(OutputShape[1]);
+    const size_t SpatialSize = size_t(OutputShape[2]) * size_t(OutputShape[3]);
+
+    for (size_t n = 0; n < BatchCount; n++) {
+
+        for (size_t c = 0; c < Channels; c += BlockSize) {
+
+            const size_t BlockChannels = (std::min)(BlockSize, Channels - c);
+
+            for (size_t s = 0; s < SpatialSize; s++) {
+
+                for (size_t bc = 0; bc < BlockChannels; bc++) {
+                    D[bc * SpatialSize + s] = S[bc];
+                }
+
+                S += BlockSize;
+            }
+
+            D += BlockChannels * SpatialSize;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasReorderFilterOIHWBiBo(
+    const int64_t* FilterShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders a OIHW filter for a convolution of a NCHWc input.
+
+    The output and input channels are padded with zeros to a multiple of the
+    block size. The result is stored as [O/Bo][I/Bi][H][W][Bi][Bo].
+
+Arguments:
+
+    FilterShape - Supplies the shape of the OIHW filter.
+
+    S - Supplies the OIHW filter.
+
+    D - Supplies the buffer to receive the reordered filter.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    const size_t OutputChannels = size_t(FilterShape[0]);
+    const size_t InputChannels = size_t(FilterShape[1]);
+    const size_t KernelSize = size_t(FilterShape[2]) * size_t(FilterShape[3]);
+
+    for (size_t o = 0; o < OutputChannels; o += BlockSize) {
+
+        for (size_t i = 0; i < InputChannels; i += BlockSize) {
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                for (size_t bi = 0; bi < BlockSize; bi++) {
+
+                    for (size_t bo = 0; bo < BlockSize; bo++) {
+
+                        if (o + bo < OutputChannels && i + bi < InputChannels) {
+                            *D++ = S[((o + bo) * InputChannels + (i + bi)) * KernelSize + k];
+                        } else {
+                            *D++ = 0.0f;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasReorderFilterOIHWBo(
+    const int64_t* FilterShape,
+    const float* S,
+    float* D
+    )
+/*++
+
+Routine Description:
+
+    This routine reorders a OIHW filter for a convolution of a NCHW input or a
+    depthwise convolution.
+
+    The output channels are padded with zeros to a multiple of the block size.
+    The result is stored as [O/Bo][I][H][W][Bo].
+
+Arguments:
+
+    FilterShape - Supplies the shape of the OIHW filter.
+
+    S - Supplies the OIHW filter.
+
+    D - Supplies the buffer to receive the reordered filter.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    const size_t OutputChannels = size_t(FilterShape[0]);
+    const size_t InputChannels = size_t(FilterShape[1]);
+    const size_t KernelSize = size_t(FilterShape[2]) * size_t(FilterShape[3]);
+
+    for (size_t o = 0; o < OutputChannels; o += BlockSize) {
+
+        for (size_t i = 0; i < InputChannels; i++) {
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                for (size_t bo = 0; bo < BlockSize; bo++) {
+
+                    if (o + bo < OutputChannels) {
+                        *D++ = S[((o + bo) * InputChannels + i) * KernelSize + k];
+                    } else {
+                        *D++ = 0.0f;
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,681 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    snchwc.h
+
+Abstract:
+
+    This module contains the private data structures and kernel templates of
+    the single precision operations using the NCHWc blocking format.
+
+    The kernels are templates over a vector traits type, so each instruction
+    set builds its own copy with its native vector width in a source file
+    compiled for it. MLAS_PLATFORM selects the copy for the processor.
+
+    A vector traits type supplies:
+
+        Vector - the vector type.
+
+        VectorSize - the number of floats in a vector.
+
+        Zero, Load, Store, Broadcast, MultiplyAdd, Add, Maximum, Divide - the
+        vector operations. MultiplyAdd(a, b, c) returns a * b + c.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+//
+// Define the parameters to execute segments of a NCHWc operation on worker
+// threads.
+//
+
+struct MLAS_NCHWC_WORK_BLOCK {
+    size_t BatchCount;
+    size_t InputChannels;
+    size_t InputShape[2];
+    size_t InputSize;
+    size_t OutputChannels;
+    size_t OutputShape[2];
+    size_t OutputSize;
+    size_t KernelShape[2];
+    size_t DilationShape[2];
+    size_t Padding[4];
+    size_t StrideShape[2];
+    int32_t TargetThreadCount;
+};
+
+//
+// Define the kinds of NCHWc convolutions.
+//
+
+enum MLAS_NCHWC_CONV_KIND {
+    // NCHWc input and output, filter in OIHWBiBo format.
+    MlasNchwcConvNchwc,
+    // NCHW input with fewer channels than the block size and NCHWc output,
+    // filter in OIHWBo format.
+    MlasNchwcConvNchw,
+    // depthwise convolution of a NCHWc input, filter in OIHWBo format.
+    MlasNchwcConvDepthwise,
+};
+
+struct MLAS_NCHWC_CONV_WORK_BLOCK : MLAS_NCHWC_WORK_BLOCK {
+    MLAS_NCHWC_CONV_KIND ConvKind;
+    const float* Input;
+    const float* Filter;
+    const float* Bias;
+    const MLAS_ACTIVATION* Activation;
+    float* Output;
+};
+
+struct MLAS_NCHWC_POOL_WORK_BLOCK : MLAS_NCHWC_WORK_BLOCK {
+    MLAS_POOLING_KIND PoolingKind;
+    const float* Input;
+    float* Output;
+};
+
+//
+// Define the number of output positions computed at once by the convolution
+// kernels, so that the filter vectors loaded for an input channel are used
+// for several outputs.
+//
+
+#define MLAS_NCHWC_CONV_OUTPUT_COUNT 4
+
+//
+// Support routines shared by the NCHWc operations, see snchwc.cpp.
+//
+
+void
+MlasNchwcPartitionWork(
+    const MLAS_NCHWC_WORK_BLOCK* WorkBlock,
+    int32_t Index,
+    size_t TotalWork,
+    size_t* WorkIndex,
+    size_t* WorkRemaining
+    );
+
+//
+// Convolution kernels.
+//
+// Each kernel computes OutputCount consecutive output positions of a row for
+// one block of output channels. CheckBounds is false when the kernel is known
+// to read inside the input row for every output position.
+//
+
+template<typename Traits, size_t BlockSize>
+struct MLAS_NCHWC_CONV_NCHWC_KERNEL
+{
+    template<size_t OutputCount, bool CheckBounds>
+    static
+    void
+    Compute(
+        const MLAS_NCHWC_CONV_WORK_BLOCK* WorkBlock,
+        size_t n,
+        size_t ob,
+        size_t oh,
+        size_t ow,
+        typename Traits::Vector Accumulators[OutputCount][BlockSize / Traits::VectorSize]
+        )
+    {
+        constexpr size_t VectorCount = BlockSize / Traits::VectorSize;
+
+        const size_t InputHeight = WorkBlock->InputShape[0];
+        const size_t InputWidth = WorkBlock->InputShape[1];
+        const size_t KernelHeight = WorkBlock->KernelShape[0];
+        const size_t KernelWidth = WorkBlock->KernelShape[1];
+        const size_t InputBlockCount = WorkBlock->InputChannels / BlockSize;
+
+        const float* Input = WorkBlock->Input + n * WorkBlock->InputChannels * WorkBlock->InputSize;
+        const float* Filter = WorkBlock->Filter + ob * InputBlockCount * KernelHeight * KernelWidth * BlockSize * BlockSize;
+
+        for (size_t ib = 0; ib < InputBlockCount; ib++) {
+
+            for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+                const size_t ih = oh * WorkBlock->StrideShape[0] + kh * WorkBlock->DilationShape[0] - WorkBlock->Padding[0];
+
+                if (ih >= InputHeight) {
+                    continue;
+                }
+
+                for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                    const float* InputPositions[OutputCount];
+
+                    for (size_t o = 0; o < OutputCount; o++) {
+
+                        const size_t iw = (ow + o) * WorkBlock->StrideShape[1] + kw * WorkBlock->DilationShape[1] - WorkBlock->Padding[1];
+
+                        InputPositions[o] = (!CheckBounds || iw < InputWidth) ?
+                            Input + (ih * InputWidth + iw) * BlockSize : nullptr;
+                    }
+
+                    const float* FilterBlock = Filter + (kh * KernelWidth + kw) * BlockSize * BlockSize;
+
+                    for (size_t bi = 0; bi < BlockSize; bi++) {
+
+                        typename Traits::Vector FilterVectors[VectorCount];
+
+                        for (size_t v = 0; v < VectorCount; v++) {
+                            FilterVectors[v] = Traits::Load(FilterBlock + bi * BlockSize + v * Traits::VectorSize);
+                        }
+
+                        for (size_t o = 0; o < OutputCount; o++) {
+
+                            if (CheckBounds && InputPositions[o] == nullptr) {
+                                continue;
+                            }
+
+                            typename Traits::Vector InputValue = Traits::Broadcast(InputPositions[o][bi]);
+
+                            for (size_t v = 0; v < VectorCount; v++) {
+                                Accumulators[o][v] = Traits::MultiplyAdd(InputValue, FilterVectors[v], Accumulators[o][v]);
+                            }
+                        }
+                    }
+                }
+            }
+
+            Input += WorkBlock->InputSize * BlockSize;
+            Filter += KernelHeight * KernelWidth * BlockSize * BlockSize;
+        }
+    }
+};
+
+template<typename Traits, size_t BlockSize>
+struct MLAS_NCHWC_CONV_NCHW_KERNEL
+{
+    template<size_t OutputCount, bool CheckBounds>
+    static
+    void
+    Compute(
+        const MLAS_NCHWC_CONV_WORK_BLOCK* WorkBlock,
+        size_t n,
+        size_t ob,
+        size_t oh,
+        size_t ow,
+        typename Traits::Vector Accumulators[OutputCount][BlockSize / Traits::VectorSize]
+        )
+    {
+        constexpr size_t VectorCount = BlockSize / Traits::VectorSize;
+
+        const size_t InputHeight = WorkBlock->InputShape[0];
+        const size_t InputWidth = WorkBlock->InputShape[1];
+        const size_t KernelHeight = WorkBlock->KernelShape[0];
+        const size_t KernelWidth = WorkBlock->KernelShape[1];
+        const size_t InputChannels = WorkBlock->InputChannels;
+
+        const float* Input = WorkBlock->Input + n * InputChannels * WorkBlock->InputSize;
+        const float* Filter = WorkBlock->Filter + ob * InputChannels * KernelHeight * KernelWidth * BlockSize;
+
+        for (size_t ic = 0; ic < InputChannels; ic++) {
+
+            for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+                const size_t ih = oh * WorkBlock->StrideShape[0] + kh * WorkBlock->DilationShape[0] - WorkBlock->Padding[0];
+
+                if (ih >= InputHeight) {
+                    continue;
+                }
+
+                for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                    const float* FilterBlock = Filter + (kh * KernelWidth + kw) * BlockSize;
+
+                    typename Traits::Vector FilterVectors[VectorCount];
+
+                    for (size_t v = 0; v < VectorCount; v++) {
+                        FilterVectors[v] = Traits::Load(FilterBlock + v * Traits::VectorSize);
+                    }
+
+                    for (size_t o = 0; o < OutputCount; o++) {
+
+                        const size_t iw = (ow + o) * WorkBlock->StrideShape[1] + kw * WorkBlock->DilationShape[1] - WorkBlock->Padding[1];
+
+                        if (CheckBounds && iw >= InputWidth) {
+                            continue;
+                        }
+
+                        typename Traits::Vector InputValue = Traits::Broadcast(Input[ih * InputWidth + iw]);
+
+                        for (size_t v = 0; v < VectorCount; v++) {
+                            Accumulators[o][v] = Traits::MultiplyAdd(InputValue, FilterVectors[v], Accumulators[o][v]);
+                        }
+                    }
+                }
+            }
+
+            Input += WorkBlock->InputSize;
+            Filter += KernelHeight * KernelWidth * BlockSize;
+        }
+    }
+};
+
+template<typename Traits, size_t BlockSize>
+struct MLAS_NCHWC_CONV_DEPTHWISE_KERNEL
+{
+    template<size_t OutputCount, bool CheckBounds>
+    static
+    void
+    Compute(
+        const MLAS_NCHWC_CONV_WORK_BLOCK* WorkBlock,
+        size_t n,
+        size_t ob,
+        size_t oh,
+        size_t ow,
+        typename Traits::Vector Accumulators[OutputCount][BlockSize / Traits::VectorSize]
+        )
+    {
+        constexpr size_t VectorCount = BlockSize / Traits::VectorSize;
+
+        const size_t InputHeight = WorkBlock->InputShape[0];
+        const size_t InputWidth = WorkBlock->InputShape[1];
+        const size_t KernelHeight = WorkBlock->KernelShape[0];
+        const size_t KernelWidth = WorkBlock->KernelShape[1];
+
+        const float* Input = WorkBlock->Input + (n * WorkBlock->InputChannels + ob * BlockSize) * WorkBlock->InputSize;
+        const float* Filter = WorkBlock->Filter + ob * KernelHeight * KernelWidth * BlockSize;
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            const size_t ih = oh * WorkBlock->StrideShape[0] + kh * WorkBlock->DilationShape[0] - WorkBlock->Padding[0];
+
+            if (ih >= InputHeight) {
+                continue;
+            }
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                const float* FilterBlock = Filter + (kh * KernelWidth + kw) * BlockSize;
+
+                typename Traits::Vector FilterVectors[VectorCount];
+
+                for (size_t v = 0; v < VectorCount; v++) {
+                    FilterVectors[v] = Traits::Load(FilterBlock + v * Traits::VectorSize);
+                }
+
+                for (size_t o = 0; o < OutputCount; o++) {
+
+                    const size_t iw = (ow + o) * WorkBlock->StrideShape[1] + kw * WorkBlock->DilationShape[1] - WorkBlock->Padding[1];
+
+                    if (CheckBounds && iw >= InputWidth) {
+                        continue;
+                    }
+
+                    const float* InputBlock = Input + (ih * InputWidth + iw) * BlockSize;
+
+                    for (size_t v = 0; v < VectorCount; v++) {
+                        Accumulators[o][v] = Traits::MultiplyAdd(Traits::Load(InputBlock + v * Traits::VectorSize), FilterVectors[v], Accumulators[o][v]);
+                    }
+                }
+            }
+        }
+    }
+};
+
+template<typename Traits, typename KernelType, size_t BlockSize, size_t OutputCount, bool CheckBounds>
+inline
+void
+MlasNchwcConvOutputs(
+    const MLAS_NCHWC_CONV_WORK_BLOCK* WorkBlock,
+    size_t n,
+    size_t ob,
+    size_t oh,
+    size_t ow,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine computes OutputCount consecutive output positions of a block
+    of output channels, starting with the bias of the block.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the convolution
+        parameters.
+
+    n - Supplies the batch index.
+
+    ob - Supplies the output channel block index.
+
+    oh - Supplies the output row.
+
+    ow - Supplies the first output column.
+
+    Output - Supplies the output buffer for the output column.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t VectorCount = BlockSize / Traits::VectorSize;
+
+    typename Traits::Vector Accumulators[OutputCount][VectorCount];
+
+    for (size_t v = 0; v < VectorCount; v++) {
+
+        typename Traits::Vector BiasVector = (WorkBlock->Bias != nullptr) ?
+            Traits::Load(WorkBlock->Bias + ob * BlockSize + v * Traits::VectorSize) : Traits::Zero();
+
+        for (size_t o = 0; o < OutputCount; o++) {
+            Accumulators[o][v] = BiasVector;
+        }
+    }
+
+    KernelType::template Compute<OutputCount, CheckBounds>(WorkBlock, n, ob, oh, ow, Accumulators);
+
+    for (size_t o = 0; o < OutputCount; o++) {
+        for (size_t v = 0; v < VectorCount; v++) {
+            Traits::Store(Output + o * BlockSize + v * Traits::VectorSize, Accumulators[o][v]);
+        }
+    }
+}
+
+template<typename Traits, typename KernelType, size_t BlockSize>
+void
+MlasNchwcConvRow(
+    const MLAS_NCHWC_CONV_WORK_BLOCK* WorkBlock,
+    size_t n,
+    size_t ob,
+    size_t oh,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a row of a block of output channels.
+
+    The output columns that read the padding at the left or right edges of the
+    input are computed with bounds checks, and the columns in between are
+    computed several at a time without.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the convolution
+        parameters.
+
+    n - Supplies the batch index.
+
+    ob - Supplies the output channel block index.
+
+    oh - Supplies the output row.
+
+    Output - Supplies the output buffer for the row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const int64_t InputWidth = int64_t(WorkBlock->InputShape[1]);
+    const int64_t OutputWidth = int64_t(WorkBlock->OutputShape[1]);
+    const int64_t StrideWidth = int64_t(WorkBlock->StrideShape[1]);
+    const int64_t PaddingLeftWidth = int64_t(WorkBlock->Padding[1]);
+    const int64_t KernelExtent = (int64_t(WorkBlock->KernelShape[1]) - 1) * int64_t(WorkBlock->DilationShape[1]);
+
+    //
+    // Compute the range of output columns where every kernel column is inside
+    // the input row.
+    //
+
+    int64_t InteriorBegin = (PaddingLeftWidth + StrideWidth - 1) / StrideWidth;
+    int64_t InteriorEnd = 0;
+
+    if (InputWidth - 1 + PaddingLeftWidth - KernelExtent >= 0) {
+        InteriorEnd = (InputWidth - 1 + PaddingLeftWidth - KernelExtent) / StrideWidth + 1;
+    }
+
+    InteriorEnd = (std::min)(InteriorEnd, OutputWidth);
+    InteriorBegin = (std::min)(InteriorBegin, InteriorEnd);
+
+    size_t ow = 0;
+
+    for (; ow < size_t(InteriorBegin); ow++) {
+        MlasNchwcConvOutputs<Traits, KernelType, BlockSize, 1, true>(WorkBlock, n, ob, oh, ow, Output + ow * BlockSize);
+    }
+
+    for (; ow + MLAS_NCHWC_CONV_OUTPUT_COUNT <= size_t(InteriorEnd); ow += MLAS_NCHWC_CONV_OUTPUT_COUNT) {
+        MlasNchwcConvOutputs<Traits, KernelType, BlockSize, MLAS_NCHWC_CONV_OUTPUT_COUNT, false>(WorkBlock, n, ob, oh, ow, Output + ow * BlockSize);
+    }
+
+    for (; ow < size_t(InteriorEnd); ow++) {
+        MlasNchwcConvOutputs<Traits, KernelType, BlockSize, 1, false>(WorkBlock, n, ob, oh, ow, Output + ow * BlockSize);
+    }
+
+    for (; ow < size_t(OutputWidth); ow++) {
+        MlasNchwcConvOutputs<Traits, KernelType, BlockSize, 1, true>(WorkBlock, n, ob, oh, ow, Output + ow * BlockSize);
+    }
+}
+
+template<typename Traits, typename KernelType, size_t BlockSize>
+void
+MlasNchwcConvThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of the
+    output rows of a NCHWc convolution.
+
+Arguments:
+
+    Context - Supplies the pointer to the parameters for the operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_NCHWC_CONV_WORK_BLOCK* WorkBlock = (MLAS_NCHWC_CONV_WORK_BLOCK*)Context;
+
+    const size_t OutputBlockCount = WorkBlock->OutputChannels / BlockSize;
+    const size_t OutputHeight = WorkBlock->OutputShape[0];
+    const size_t OutputRowSize = WorkBlock->OutputShape[1] * BlockSize;
+
+    const size_t TotalWork = WorkBlock->BatchCount * OutputBlockCount * OutputHeight;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasNchwcPartitionWork(WorkBlock, Index, TotalWork, &WorkIndex, &WorkRemaining);
+
+    size_t oh = WorkIndex % OutputHeight;
+    size_t ob = (WorkIndex / OutputHeight) % OutputBlockCount;
+    size_t n = WorkIndex / OutputHeight / OutputBlockCount;
+
+    float* Output = WorkBlock->Output + WorkIndex * OutputRowSize;
+
+    while (WorkRemaining-- > 0) {
+
+        MlasNchwcConvRow<Traits, KernelType, BlockSize>(WorkBlock, n, ob, oh, Output);
+
+        if (WorkBlock->Activation->ActivationKind != MlasIdentityActivation) {
+            MlasActivation(WorkBlock->Activation, Output, nullptr, 1, Output, OutputRowSize, OutputRowSize);
+        }
+
+        Output += OutputRowSize;
+
+        if (++oh == OutputHeight) {
+            oh = 0;
+            if (++ob == OutputBlockCount) {
+                ob = 0;
+                n++;
+            }
+        }
+    }
+}
+
+//
+// Pooling kernels.
+//
+
+template<typename Traits, size_t BlockSize>
+void
+MlasNchwcPoolThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of the
+    output rows of a NCHWc pooling operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the parameters for the operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t VectorCount = BlockSize / Traits::VectorSize;
+
+    const MLAS_NCHWC_POOL_WORK_BLOCK* WorkBlock = (MLAS_NCHWC_POOL_WORK_BLOCK*)Context;
+
+    const MLAS_POOLING_KIND PoolingKind = WorkBlock->PoolingKind;
+
+    const size_t InputHeight = WorkBlock->InputShape[0];
+    const size_t InputWidth = WorkBlock->InputShape[1];
+    const size_t OutputHeight = WorkBlock->OutputShape[0];
+    const size_t OutputWidth = WorkBlock->OutputShape[1];
+
+    const int64_t KernelHeight = int64_t(WorkBlock->KernelShape[0]);
+    const int64_t KernelWidth = int64_t(WorkBlock->KernelShape[1]);
+    const int64_t PaddingLeftHeight = int64_t(WorkBlock->Padding[0]);
+    const int64_t PaddingLeftWidth = int64_t(WorkBlock->Padding[1]);
+    const int64_t StrideHeight = int64_t(WorkBlock->StrideShape[0]);
+    const int64_t StrideWidth = int64_t(WorkBlock->StrideShape[1]);
+
+    const size_t TotalWork = WorkBlock->BatchCount * (WorkBlock->InputChannels / BlockSize) * OutputHeight;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasNchwcPartitionWork(WorkBlock, Index, TotalWork, &WorkIndex, &WorkRemaining);
+
+    size_t ph = WorkIndex % OutputHeight;
+    size_t cb = WorkIndex / OutputHeight;
+
+    float* Output = WorkBlock->Output + WorkIndex * OutputWidth * BlockSize;
+
+    const typename Traits::Vector InitialValue = (PoolingKind == MlasMaximumPooling) ?
+        Traits::Broadcast(std::numeric_limits<float>::lowest()) : Traits::Zero();
+
+    while (WorkRemaining-- > 0) {
+
+        const float* Input = WorkBlock->Input + cb * WorkBlock->InputSize * BlockSize;
+
+        const int64_t ihStart64 = int64_t(ph) * StrideHeight - PaddingLeftHeight;
+        const int64_t ihEnd64 = ihStart64 + KernelHeight;
+
+        const size_t ihStart = size_t((std::max)(ihStart64, int64_t(0)));
+        const size_t ihEnd = size_t((std::min)(ihEnd64, int64_t(InputHeight)));
+
+        for (size_t pw = 0; pw < OutputWidth; pw++) {
+
+            const int64_t iwStart64 = int64_t(pw) * StrideWidth - PaddingLeftWidth;
+            const int64_t iwEnd64 = iwStart64 + KernelWidth;
+
+            const size_t iwStart = size_t((std::max)(iwStart64, int64_t(0)));
+            const size_t iwEnd = size_t((std::min)(iwEnd64, int64_t(InputWidth)));
+
+            typename Traits::Vector Accumulators[VectorCount];
+
+            for (size_t v = 0; v < VectorCount; v++) {
+                Accumulators[v] = InitialValue;
+            }
+
+            for (size_t ih = ihStart; ih < ihEnd; ih++) {
+
+                const float* InputRow = Input + ih * InputWidth * BlockSize;
+
+                for (size_t iw = iwStart; iw < iwEnd; iw++) {
+
+                    for (size_t v = 0; v < VectorCount; v++) {
+
+                        typename Traits::Vector InputVector = Traits::Load(InputRow + iw * BlockSize + v * Traits::VectorSize);
+
+                        if (PoolingKind == MlasMaximumPooling) {
+                            Accumulators[v] = Traits::Maximum(Accumulators[v], InputVector);
+                        } else {
+                            Accumulators[v] = Traits::Add(Accumulators[v], InputVector);
+                        }
+                    }
+                }
+            }
+
+            if (PoolingKind != MlasMaximumPooling) {
+
+                size_t Divisor;
+
+                if (PoolingKind == MlasAveragePoolingExcludePad) {
+                    Divisor = (ihEnd - ihStart) * (iwEnd - iwStart);
+                } else {
+                    Divisor = size_t(KernelHeight * KernelWidth);
+                }
+
+                typename Traits::Vector DivisorVector = Traits::Broadcast(float(Divisor));
+
+                for (size_t v = 0; v < VectorCount; v++) {
+                    Accumulators[v] = Traits::Divide(Accumulators[v], DivisorVector);
+                }
+            }
+
+            for (size_t v = 0; v < VectorCount; v++) {
+                Traits::Store(Output + v * Traits::VectorSize, Accumulators[v]);
+            }
+
+            Output += BlockSize;
+        }
+
+        if (++ph == OutputHeight) {
+            ph = 0;
+            cb++;
+        }
+    }
+}
+
+//
+// Build the routines of an instruction set for MLAS_PLATFORM.
+//
+
+template<typename Traits, size_t BlockSize>
+constexpr
+MLAS_NCHWC_ROUTINES
+MlasNchwcMakeRoutines(
+    void
+    )
+{
+    return {
+        MlasNchwcConvThreaded<Traits, MLAS_NCHWC_CONV_NCHWC_KERNEL<Traits, BlockSize>, BlockSize>,
+        MlasNchwcConvThreaded<Traits, MLAS_NCHWC_CONV_NCHW_KERNEL<Traits, BlockSize>, BlockSize>,
+        MlasNchwcConvThreaded<Traits, MLAS_NCHWC_CONV_DEPTHWISE_KERNEL<Traits, BlockSize>, BlockSize>,
+        MlasNchwcPoolThreaded<Traits, BlockSize>,
+    };
+}
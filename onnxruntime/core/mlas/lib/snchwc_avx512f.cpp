@@ -0,0 +1,61 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    snchwc_avx512f.cpp
+
+Abstract:
+
+    This module implements the single precision operations using the NCHWc
+    blocking format with AVX512F instructions.
+
+    This module is compiled with the compiler flags for AVX512F, and its
+    routines are only used if the processor supports it.
+
+--*/
+
+//
+// GCC reports the undefined vectors that the AVX512F intrinsics use for their
+// masked forms as uninitialized once the intrinsics are inlined.
+//
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include "snchwc.h"
+
+struct MLAS_NCHWC_AVX512F_TRAITS
+{
+    typedef __m512 Vector;
+
+    static constexpr size_t VectorSize = 16;
+
+    static Vector Zero(void) { return _mm512_setzero_ps(); }
+
+    static Vector Load(const float* Buffer) { return _mm512_loadu_ps(Buffer); }
+
+    static void Store(float* Buffer, Vector Value) { _mm512_storeu_ps(Buffer, Value); }
+
+    static Vector Broadcast(float Value) { return _mm512_set1_ps(Value); }
+
+    static Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3) { return _mm512_fmadd_ps(Vector1, Vector2, Vector3); }
+
+    static Vector Add(Vector Vector1, Vector Vector2) { return _mm512_add_ps(Vector1, Vector2); }
+
+    static Vector Maximum(Vector Vector1, Vector Vector2) { return _mm512_max_ps(Vector1, Vector2); }
+
+    static Vector Divide(Vector Vector1, Vector Vector2) { return _mm512_div_ps(Vector1, Vector2); }
+};
+
+//
+// A block of 16 channels fills one 512-bit vector. MLAS_PLATFORM sets the
+// block size to match.
+//
+
+const MLAS_NCHWC_ROUTINES MlasNchwcRoutinesAvx512F = MlasNchwcMakeRoutines<MLAS_NCHWC_AVX512F_TRAITS, 16>();
@@ -0,0 +1,50 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    snchwc_fma3.cpp
+
+Abstract:
+
+    This module implements the single precision operations using the NCHWc
+    blocking format with FMA3 instructions.
+
+    This module is compiled with the compiler flags for FMA3, and its
+    routines are only used if the processor supports it.
+
+--*/
+
+#include "snchwc.h"
+
+struct MLAS_NCHWC_FMA3_TRAITS
+{
+    typedef __m256 Vector;
+
+    static constexpr size_t VectorSize = 8;
+
+    static Vector Zero(void) { return _mm256_setzero_ps(); }
+
+    static Vector Load(const float* Buffer) { return _mm256_loadu_ps(Buffer); }
+
+    static void Store(float* Buffer, Vector Value) { _mm256_storeu_ps(Buffer, Value); }
+
+    static Vector Broadcast(float Value) { return _mm256_set1_ps(Value); }
+
+    static Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3) { return _mm256_fmadd_ps(Vector1, Vector2, Vector3); }
+
+    static Vector Add(Vector Vector1, Vector Vector2) { return _mm256_add_ps(Vector1, Vector2); }
+
+    static Vector Maximum(Vector Vector1, Vector Vector2) { return _mm256_max_ps(Vector1, Vector2); }
+
+    static Vector Divide(Vector Vector1, Vector Vector2) { return _mm256_div_ps(Vector1, Vector2); }
+};
+
+//
+// A block of 8 channels fills one 256-bit vector.
+//
+
+const MLAS_NCHWC_ROUTINES MlasNchwcRoutinesFma3 = MlasNchwcMakeRoutines<MLAS_NCHWC_FMA3_TRAITS, 8>();
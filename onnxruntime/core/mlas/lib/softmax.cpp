@@ -0,0 +1,265 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    softmax.cpp
+
+Abstract:
+
+    This module implements routines to compute the softmax and log softmax
+    functions.
+
+    The kernels are in softmax.h. This module builds the portable copy that
+    is used when the processor has no copy of its own.
+
+--*/
+
+#include "softmax.h"
+
+const MLAS_EXP_CONSTANTS MlasExpConstants = {
+    -126.0f * 0.6931471805599453f,
+    12582912.0f,
+    1.44269504088896341f,
+    -6.93145752e-1f,
+    -1.42860677e-6f,
+    1.37805939e-3f,
+    8.37312452e-3f,
+    4.16695364e-2f,
+    1.66664720e-1f,
+    4.99999851e-1f,
+    1.0f,
+    0x3F800000,
+};
+
+//
+// Define the vector traits of the portable kernels.
+//
+
+struct MLAS_SOFTMAX_FLOAT32X4_TRAITS
+{
+    typedef MLAS_FLOAT32X4 Vector;
+
+    static constexpr size_t VectorSize = 4;
+
+    static Vector Zero(void) { return MlasZeroFloat32x4(); }
+
+    static Vector Load(const float* Buffer) { return MlasLoadFloat32x4(Buffer); }
+
+    static void Store(float* Buffer, Vector Value) { MlasStoreFloat32x4(Buffer, Value); }
+
+    static Vector Broadcast(float Value) { return MlasBroadcastFloat32x4(Value); }
+
+    static Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3) { return MlasMultiplyAddFloat32x4(Vector1, Vector2, Vector3); }
+
+    static Vector Add(Vector Vector1, Vector Vector2) { return MlasAddFloat32x4(Vector1, Vector2); }
+
+    static Vector Subtract(Vector Vector1, Vector Vector2) { return MlasSubtractFloat32x4(Vector1, Vector2); }
+
+    static Vector Multiply(Vector Vector1, Vector Vector2) { return MlasMultiplyFloat32x4(Vector1, Vector2); }
+
+    static Vector Maximum(Vector Vector1, Vector Vector2) { return MlasMaximumFloat32x4(Vector1, Vector2); }
+
+    static Vector PowerOfTwo(Vector Biased, int32_t ExponentBias)
+    {
+        MLAS_INT32X4 Exponent = MlasShiftLeftInt32x4<23>(MlasReinterpretAsInt32x4(Biased));
+        Exponent = MlasAddInt32x4(Exponent, MlasBroadcastInt32x4(ExponentBias));
+        return MlasReinterpretAsFloat32x4(Exponent);
+    }
+
+    static float ReduceAdd(Vector Value) { return MlasReduceAddFloat32x4(Value); }
+
+    static float ReduceMaximum(Vector Value) { return MlasReduceMaximumFloat32x4(Value); }
+};
+
+void
+MLASCALL
+MlasSoftmaxKernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function along each row
+    of a range of rows with the portable kernels.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeSoftmaxRows<MLAS_SOFTMAX_FLOAT32X4_TRAITS>(Input, Output, N, D, LogSoftmax);
+}
+
+//
+// Structure to encapsulate the parameters of a threaded softmax operation.
+//
+
+struct MLAS_SOFTMAX_WORK_BLOCK {
+    const float* Input;
+    float* Output;
+    size_t N;
+    size_t D;
+    bool LogSoftmax;
+    int32_t TargetThreadCount;
+};
+
+void
+MlasComputeSoftmaxThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    softmax or log softmax operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SOFTMAX_WORK_BLOCK*)Context;
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    const size_t N = WorkBlock->N;
+    const size_t D = WorkBlock->D;
+    const size_t TargetThreadCount = size_t(WorkBlock->TargetThreadCount);
+
+    const size_t WorkPerThread = N / TargetThreadCount;
+    const size_t WorkPerThreadExtra = N % TargetThreadCount;
+
+    size_t n;
+    size_t CountN;
+
+    if (size_t(Index) < WorkPerThreadExtra) {
+        n = (WorkPerThread + 1) * size_t(Index);
+        CountN = WorkPerThread + 1;
+    } else {
+        n = WorkPerThread * size_t(Index) + WorkPerThreadExtra;
+        CountN = WorkPerThread;
+    }
+
+    const float* Input = WorkBlock->Input + n * D;
+    float* Output = WorkBlock->Output + n * D;
+
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.SoftmaxKernelRoutine(Input, Output, CountN, D, WorkBlock->LogSoftmax);
+#else
+    MlasSoftmaxKernel(Input, Output, CountN, D, WorkBlock->LogSoftmax);
+#endif
+}
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function along each row
+    of the input buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer. The output buffer may be the same as
+        the input buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SOFTMAX_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+    WorkBlock.LogSoftmax = LogSoftmax;
+
+    //
+    // Compute the number of target threads given the complexity of the softmax
+    // operation. Limit the number of threads to the number of rows and try to
+    // keep each thread processing a minimum number of elements before using
+    // another thread.
+    //
+
+    const double Complexity = double(N) * double(D);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SOFTMAX_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SOFTMAX_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasPlatform.GetMaximumThreadCount();
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (N < size_t(TargetThreadCount)) {
+        TargetThreadCount = int32_t(N);
+    }
+
+    if (TargetThreadCount < 1) {
+        return;
+    }
+
+    WorkBlock.TargetThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasComputeSoftmaxThreaded, &WorkBlock, TargetThreadCount);
+}
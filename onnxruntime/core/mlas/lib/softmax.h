@@ -0,0 +1,525 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    softmax.h
+
+Abstract:
+
+    This module contains the kernel templates to compute the softmax and log
+    softmax functions.
+
+    Each row is processed in two passes over the input: the first finds the
+    maximum value of the row and the second computes the exponentials of the
+    input minus the maximum and accumulates their sum. A final pass over the
+    output then normalizes the row.
+
+    The exponential function is computed by reducing the input to a value in
+    the range [-ln(2)/2, ln(2)/2], evaluating a polynomial approximation over
+    that range, and scaling the result by a power of two built directly from
+    the exponent bits.
+
+    The kernels are templates over a vector traits type, so each instruction
+    set builds its own copy with its native vector width in a source file
+    compiled for it. MLAS_PLATFORM selects the copy for the processor.
+
+    A vector traits type supplies:
+
+        Vector - the vector type.
+
+        VectorSize - the number of floats in a vector.
+
+        Zero, Load, Store, Broadcast, MultiplyAdd, Add, Subtract, Multiply,
+        Maximum - the vector operations. MultiplyAdd(a, b, c) returns
+        a * b + c.
+
+        PowerOfTwo - shifts the integer bits of a vector into the exponent
+        field and adds the exponent bias.
+
+        ReduceAdd, ReduceMaximum - the horizontal reductions of a vector.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+//
+// Bundles the floating point constants for the exponential function.
+//
+
+struct MLAS_EXP_CONSTANTS {
+    float LowerRange;
+    float RoundingBias;
+    float Log2Reciprocal;
+    float Log2High;
+    float Log2Low;
+    float poly_0;
+    float poly_1;
+    float poly_2;
+    float poly_3;
+    float poly_4;
+    float poly_56;
+    int32_t ExponentBias;
+};
+
+extern const MLAS_EXP_CONSTANTS MlasExpConstants;
+
+template<typename Traits>
+inline
+typename Traits::Vector
+MlasComputeExpVector(
+    typename Traits::Vector Vector
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for a vector of values
+    that are less than or equal to zero.
+
+    Values below the lower range are clamped so that the power of two used to
+    scale the result stays a normal floating point number.
+
+Arguments:
+
+    Vector - Supplies the input vector.
+
+Return Value:
+
+    Returns the exponential of each element of the input vector.
+
+--*/
+{
+    typedef typename Traits::Vector Vector_t;
+
+    Vector = Traits::Maximum(Traits::Broadcast(MlasExpConstants.LowerRange), Vector);
+
+    //
+    // Compute the integer power of two (biased into the low bits of the
+    // mantissa) and the remainder of the input.
+    //
+
+    Vector_t RoundingBias = Traits::Broadcast(MlasExpConstants.RoundingBias);
+    Vector_t Biased = Traits::MultiplyAdd(Vector,
+        Traits::Broadcast(MlasExpConstants.Log2Reciprocal), RoundingBias);
+    Vector_t m = Traits::Subtract(Biased, RoundingBias);
+
+    Vector = Traits::MultiplyAdd(m, Traits::Broadcast(MlasExpConstants.Log2High), Vector);
+    Vector = Traits::MultiplyAdd(m, Traits::Broadcast(MlasExpConstants.Log2Low), Vector);
+
+    Vector_t Scale = Traits::PowerOfTwo(Biased, MlasExpConstants.ExponentBias);
+
+    Vector_t p;
+    p = Traits::MultiplyAdd(Vector, Traits::Broadcast(MlasExpConstants.poly_0),
+        Traits::Broadcast(MlasExpConstants.poly_1));
+    p = Traits::MultiplyAdd(p, Vector, Traits::Broadcast(MlasExpConstants.poly_2));
+    p = Traits::MultiplyAdd(p, Vector, Traits::Broadcast(MlasExpConstants.poly_3));
+    p = Traits::MultiplyAdd(p, Vector, Traits::Broadcast(MlasExpConstants.poly_4));
+    p = Traits::MultiplyAdd(p, Vector, Traits::Broadcast(MlasExpConstants.poly_56));
+    p = Traits::MultiplyAdd(p, Vector, Traits::Broadcast(MlasExpConstants.poly_56));
+
+    return Traits::Multiply(p, Scale);
+}
+
+template<typename Traits>
+float
+MlasReduceMaximumKernel(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine finds the maximum value of the input buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the maximum value.
+
+--*/
+{
+    typedef typename Traits::Vector Vector_t;
+    constexpr size_t VectorSize = Traits::VectorSize;
+
+    float Maximum = std::numeric_limits<float>::lowest();
+
+    if (N >= VectorSize) {
+
+        Vector_t MaximumVector0 = Traits::Broadcast(Maximum);
+
+        if (N >= VectorSize * 4) {
+
+            Vector_t MaximumVector1 = MaximumVector0;
+            Vector_t MaximumVector2 = MaximumVector0;
+            Vector_t MaximumVector3 = MaximumVector0;
+
+            while (N >= VectorSize * 4) {
+
+                MaximumVector0 = Traits::Maximum(MaximumVector0, Traits::Load(Input));
+                MaximumVector1 = Traits::Maximum(MaximumVector1, Traits::Load(Input + VectorSize));
+                MaximumVector2 = Traits::Maximum(MaximumVector2, Traits::Load(Input + VectorSize * 2));
+                MaximumVector3 = Traits::Maximum(MaximumVector3, Traits::Load(Input + VectorSize * 3));
+
+                Input += VectorSize * 4;
+                N -= VectorSize * 4;
+            }
+
+            MaximumVector0 = Traits::Maximum(MaximumVector0, MaximumVector1);
+            MaximumVector2 = Traits::Maximum(MaximumVector2, MaximumVector3);
+            MaximumVector0 = Traits::Maximum(MaximumVector0, MaximumVector2);
+        }
+
+        while (N >= VectorSize) {
+
+            MaximumVector0 = Traits::Maximum(MaximumVector0, Traits::Load(Input));
+
+            Input += VectorSize;
+            N -= VectorSize;
+        }
+
+        Maximum = Traits::ReduceMaximum(MaximumVector0);
+    }
+
+    while (N > 0) {
+
+        Maximum = (std::max)(Maximum, *Input);
+
+        Input += 1;
+        N -= 1;
+    }
+
+    return Maximum;
+}
+
+template<typename Traits>
+float
+MlasComputeSumExpKernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float NegativeMaximum
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function of the input buffer offset
+    by the negative of its maximum value and returns the sum of the results.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Optionally supplies the output buffer. When used for log softmax,
+        only the sum is needed and the results are not stored.
+
+    N - Supplies the number of elements to process.
+
+    NegativeMaximum - Supplies the negative of the maximum value of the input
+        buffer.
+
+Return Value:
+
+    Returns the sum of the exponential function of each element.
+
+--*/
+{
+    typedef typename Traits::Vector Vector_t;
+    constexpr size_t VectorSize = Traits::VectorSize;
+
+    Vector_t NegativeMaximumVector = Traits::Broadcast(NegativeMaximum);
+    Vector_t AccumulatorVector = Traits::Zero();
+
+    while (N >= VectorSize * 2) {
+
+        Vector_t Vector0 = Traits::Add(Traits::Load(Input), NegativeMaximumVector);
+        Vector_t Vector1 = Traits::Add(Traits::Load(Input + VectorSize), NegativeMaximumVector);
+
+        Vector0 = MlasComputeExpVector<Traits>(Vector0);
+        Vector1 = MlasComputeExpVector<Traits>(Vector1);
+
+        AccumulatorVector = Traits::Add(AccumulatorVector, Traits::Add(Vector0, Vector1));
+
+        if (Output != nullptr) {
+            Traits::Store(Output, Vector0);
+            Traits::Store(Output + VectorSize, Vector1);
+            Output += VectorSize * 2;
+        }
+
+        Input += VectorSize * 2;
+        N -= VectorSize * 2;
+    }
+
+    if (N >= VectorSize) {
+
+        Vector_t Vector = Traits::Add(Traits::Load(Input), NegativeMaximumVector);
+
+        Vector = MlasComputeExpVector<Traits>(Vector);
+
+        AccumulatorVector = Traits::Add(AccumulatorVector, Vector);
+
+        if (Output != nullptr) {
+            Traits::Store(Output, Vector);
+            Output += VectorSize;
+        }
+
+        Input += VectorSize;
+        N -= VectorSize;
+    }
+
+    float Accumulator = Traits::ReduceAdd(AccumulatorVector);
+
+    if (N > 0) {
+
+        //
+        // Process the remaining elements as a partial vector so that the
+        // exponential function is computed the same way for every element.
+        //
+
+        float Buffer[VectorSize] = { 0.0f };
+
+        for (size_t n = 0; n < N; n++) {
+            Buffer[n] = Input[n];
+        }
+
+        Vector_t Vector = Traits::Add(Traits::Load(Buffer), NegativeMaximumVector);
+
+        Traits::Store(Buffer, MlasComputeExpVector<Traits>(Vector));
+
+        for (size_t n = 0; n < N; n++) {
+
+            Accumulator += Buffer[n];
+
+            if (Output != nullptr) {
+                Output[n] = Buffer[n];
+            }
+        }
+    }
+
+    return Accumulator;
+}
+
+template<typename Traits>
+void
+MlasComputeSoftmaxOutputKernel(
+    float* Output,
+    size_t N,
+    float Scale
+    )
+/*++
+
+Routine Description:
+
+    This routine scales the output buffer of the softmax function by the
+    reciprocal of the sum of the exponentials.
+
+Arguments:
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the reciprocal of the sum of the exponentials.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    typedef typename Traits::Vector Vector_t;
+    constexpr size_t VectorSize = Traits::VectorSize;
+
+    Vector_t ScaleVector = Traits::Broadcast(Scale);
+
+    while (N >= VectorSize * 4) {
+
+        Vector_t Vector0 = Traits::Multiply(ScaleVector, Traits::Load(Output));
+        Vector_t Vector1 = Traits::Multiply(ScaleVector, Traits::Load(Output + VectorSize));
+        Vector_t Vector2 = Traits::Multiply(ScaleVector, Traits::Load(Output + VectorSize * 2));
+        Vector_t Vector3 = Traits::Multiply(ScaleVector, Traits::Load(Output + VectorSize * 3));
+
+        Traits::Store(Output, Vector0);
+        Traits::Store(Output + VectorSize, Vector1);
+        Traits::Store(Output + VectorSize * 2, Vector2);
+        Traits::Store(Output + VectorSize * 3, Vector3);
+
+        Output += VectorSize * 4;
+        N -= VectorSize * 4;
+    }
+
+    while (N >= VectorSize) {
+
+        Traits::Store(Output, Traits::Multiply(ScaleVector, Traits::Load(Output)));
+
+        Output += VectorSize;
+        N -= VectorSize;
+    }
+
+    while (N > 0) {
+
+        *Output *= Scale;
+
+        Output += 1;
+        N -= 1;
+    }
+}
+
+template<typename Traits>
+void
+MlasComputeLogSoftmaxOutputKernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float NegativeMaximum,
+    float Logarithm
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the output buffer of the log softmax function by
+    subtracting the maximum value and the logarithm of the sum of the
+    exponentials from the input buffer.
+
+    The maximum value is subtracted first so that inputs near the maximum
+    keep their precision.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    NegativeMaximum - Supplies the negative of the maximum value of the input
+        buffer.
+
+    Logarithm - Supplies the logarithm of the sum of the exponentials.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    typedef typename Traits::Vector Vector_t;
+    constexpr size_t VectorSize = Traits::VectorSize;
+
+    Vector_t NegativeMaximumVector = Traits::Broadcast(NegativeMaximum);
+    Vector_t LogarithmVector = Traits::Broadcast(Logarithm);
+
+    while (N >= VectorSize * 4) {
+
+        Vector_t Vector0 = Traits::Add(NegativeMaximumVector, Traits::Load(Input));
+        Vector_t Vector1 = Traits::Add(NegativeMaximumVector, Traits::Load(Input + VectorSize));
+        Vector_t Vector2 = Traits::Add(NegativeMaximumVector, Traits::Load(Input + VectorSize * 2));
+        Vector_t Vector3 = Traits::Add(NegativeMaximumVector, Traits::Load(Input + VectorSize * 3));
+
+        Vector0 = Traits::Subtract(Vector0, LogarithmVector);
+        Vector1 = Traits::Subtract(Vector1, LogarithmVector);
+        Vector2 = Traits::Subtract(Vector2, LogarithmVector);
+        Vector3 = Traits::Subtract(Vector3, LogarithmVector);
+
+        Traits::Store(Output, Vector0);
+        Traits::Store(Output + VectorSize, Vector1);
+        Traits::Store(Output + VectorSize * 2, Vector2);
+        Traits::Store(Output + VectorSize * 3, Vector3);
+
+        Input += VectorSize * 4;
+        Output += VectorSize * 4;
+        N -= VectorSize * 4;
+    }
+
+    while (N >= VectorSize) {
+
+        Vector_t Vector = Traits::Add(NegativeMaximumVector, Traits::Load(Input));
+        Vector = Traits::Subtract(Vector, LogarithmVector);
+        Traits::Store(Output, Vector);
+
+        Input += VectorSize;
+        Output += VectorSize;
+        N -= VectorSize;
+    }
+
+    while (N > 0) {
+
+        *Output = *Input + NegativeMaximum - Logarithm;
+
+        Input += 1;
+        Output += 1;
+        N -= 1;
+    }
+}
+
+template<typename Traits>
+void
+MlasComputeSoftmaxRows(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function along each row
+    of a range of rows.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer. The output buffer may be the same as
+        the input buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N > 0) {
+
+        const float Maximum = MlasReduceMaximumKernel<Traits>(Input, D);
+
+        if (LogSoftmax) {
+
+            const float Accumulation = MlasComputeSumExpKernel<Traits>(Input, nullptr, D, -Maximum);
+
+            MlasComputeLogSoftmaxOutputKernel<Traits>(Input, Output, D, -Maximum, std::log(Accumulation));
+
+        } else {
+
+            const float Accumulation = MlasComputeSumExpKernel<Traits>(Input, Output, D, -Maximum);
+
+            MlasComputeSoftmaxOutputKernel<Traits>(Output, D, 1.0f / Accumulation);
+        }
+
+        Input += D;
+        Output += D;
+        N--;
+    }
+}
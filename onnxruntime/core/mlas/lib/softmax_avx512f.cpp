@@ -0,0 +1,105 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    softmax_avx512f.cpp
+
+Abstract:
+
+    This module implements routines to compute the softmax and log softmax
+    functions with AVX512F instructions.
+
+    This module is compiled with the compiler flags for AVX512F, and its
+    routines are only used if the processor supports it.
+
+--*/
+
+//
+// GCC reports the undefined vectors that the AVX512F intrinsics use for their
+// masked forms as uninitialized once the intrinsics are inlined.
+//
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include "softmax.h"
+
+struct MLAS_SOFTMAX_AVX512F_TRAITS
+{
+    typedef __m512 Vector;
+
+    static constexpr size_t VectorSize = 16;
+
+    static Vector Zero(void) { return _mm512_setzero_ps(); }
+
+    static Vector Load(const float* Buffer) { return _mm512_loadu_ps(Buffer); }
+
+    static void Store(float* Buffer, Vector Value) { _mm512_storeu_ps(Buffer, Value); }
+
+    static Vector Broadcast(float Value) { return _mm512_set1_ps(Value); }
+
+    static Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3) { return _mm512_fmadd_ps(Vector1, Vector2, Vector3); }
+
+    static Vector Add(Vector Vector1, Vector Vector2) { return _mm512_add_ps(Vector1, Vector2); }
+
+    static Vector Subtract(Vector Vector1, Vector Vector2) { return _mm512_sub_ps(Vector1, Vector2); }
+
+    static Vector Multiply(Vector Vector1, Vector Vector2) { return _mm512_mul_ps(Vector1, Vector2); }
+
+    static Vector Maximum(Vector Vector1, Vector Vector2) { return _mm512_max_ps(Vector1, Vector2); }
+
+    static Vector PowerOfTwo(Vector Biased, int32_t ExponentBias)
+    {
+        __m512i Exponent = _mm512_slli_epi32(_mm512_castps_si512(Biased), 23);
+        Exponent = _mm512_add_epi32(Exponent, _mm512_set1_epi32(ExponentBias));
+        return _mm512_castsi512_ps(Exponent);
+    }
+
+    static float ReduceAdd(Vector Value) { return _mm512_reduce_add_ps(Value); }
+
+    static float ReduceMaximum(Vector Value) { return _mm512_reduce_max_ps(Value); }
+};
+
+void
+MLASCALL
+MlasSoftmaxKernelAvx512F(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function along each row
+    of a range of rows with 512-bit vectors.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeSoftmaxRows<MLAS_SOFTMAX_AVX512F_TRAITS>(Input, Output, N, D, LogSoftmax);
+}
@@ -0,0 +1,107 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    softmax_fma3.cpp
+
+Abstract:
+
+    This module implements routines to compute the softmax and log softmax
+    functions with AVX2 and FMA3 instructions.
+
+    This module is compiled with the compiler flags for AVX2 and FMA3, and its
+    routines are only used if the processor supports them.
+
+--*/
+
+#include "softmax.h"
+
+struct MLAS_SOFTMAX_FMA3_TRAITS
+{
+    typedef __m256 Vector;
+
+    static constexpr size_t VectorSize = 8;
+
+    static Vector Zero(void) { return _mm256_setzero_ps(); }
+
+    static Vector Load(const float* Buffer) { return _mm256_loadu_ps(Buffer); }
+
+    static void Store(float* Buffer, Vector Value) { _mm256_storeu_ps(Buffer, Value); }
+
+    static Vector Broadcast(float Value) { return _mm256_set1_ps(Value); }
+
+    static Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3) { return _mm256_fmadd_ps(Vector1, Vector2, Vector3); }
+
+    static Vector Add(Vector Vector1, Vector Vector2) { return _mm256_add_ps(Vector1, Vector2); }
+
+    static Vector Subtract(Vector Vector1, Vector Vector2) { return _mm256_sub_ps(Vector1, Vector2); }
+
+    static Vector Multiply(Vector Vector1, Vector Vector2) { return _mm256_mul_ps(Vector1, Vector2); }
+
+    static Vector Maximum(Vector Vector1, Vector Vector2) { return _mm256_max_ps(Vector1, Vector2); }
+
+    static Vector PowerOfTwo(Vector Biased, int32_t ExponentBias)
+    {
+        __m256i Exponent = _mm256_slli_epi32(_mm256_castps_si256(Biased), 23);
+        Exponent = _mm256_add_epi32(Exponent, _mm256_set1_epi32(ExponentBias));
+        return _mm256_castsi256_ps(Exponent);
+    }
+
+    static float ReduceAdd(Vector Value)
+    {
+        __m128 Reduced = _mm_add_ps(_mm256_castps256_ps128(Value), _mm256_extractf128_ps(Value, 1));
+        Reduced = _mm_add_ps(Reduced, _mm_movehl_ps(Reduced, Reduced));
+        Reduced = _mm_add_ss(Reduced, _mm_shuffle_ps(Reduced, Reduced, 1));
+        return _mm_cvtss_f32(Reduced);
+    }
+
+    static float ReduceMaximum(Vector Value)
+    {
+        __m128 Reduced = _mm_max_ps(_mm256_castps256_ps128(Value), _mm256_extractf128_ps(Value, 1));
+        Reduced = _mm_max_ps(Reduced, _mm_movehl_ps(Reduced, Reduced));
+        Reduced = _mm_max_ss(Reduced, _mm_shuffle_ps(Reduced, Reduced, 1));
+        return _mm_cvtss_f32(Reduced);
+    }
+};
+
+void
+MLASCALL
+MlasSoftmaxKernelFma3(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function along each row
+    of a range of rows with 256-bit vectors.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeSoftmaxRows<MLAS_SOFTMAX_FMA3_TRAITS>(Input, Output, N, D, LogSoftmax);
+}
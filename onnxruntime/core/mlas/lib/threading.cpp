@@ -16,6 +16,46 @@ Abstract:
 
 #include "mlasi.h"
 
+//
+// Stores the threading callbacks supplied by the host application.
+//
+
+MLAS_THREADING_CALLBACKS MlasThreadingCallbacks;
+
+void
+MLASCALL
+MlasSetThreadingCallbacks(
+    const MLAS_THREADING_CALLBACKS* Callbacks
+    )
+/*++
+
+Routine Description:
+
+    This routine sets the callbacks used to execute threaded work on a thread
+    pool owned by the host application.
+
+    N.B. This routine is not synchronized with threaded work in progress, so
+    the callbacks should be set once before any other MLAS routine is used.
+
+Arguments:
+
+    Callbacks - Supplies the threading callbacks, or nullptr to restore the
+        default threading support.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Callbacks != nullptr) {
+        MlasThreadingCallbacks = *Callbacks;
+    } else {
+        MlasThreadingCallbacks.GetMaximumThreadCount = nullptr;
+        MlasThreadingCallbacks.ExecuteThreaded = nullptr;
+    }
+}
+
 #if defined(MLAS_USE_WIN32_THREADPOOL)
 
 //
@@ -85,6 +125,16 @@ MlasExecuteThreaded(
         return;
     }
 
+    //
+    // Execute the iterations on the host application's thread pool if one is
+    // available to this thread.
+    //
+
+    if (MlasGetCallbackThreadCount() > 0) {
+        MlasThreadingCallbacks.ExecuteThreaded(ThreadedRoutine, Context, Iterations);
+        return;
+    }
+
 #if defined(MLAS_USE_WIN32_THREADPOOL)
 
     //
@@ -0,0 +1,212 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/constant_folding.h"
+
+#include <unordered_set>
+
+#include "core/common/profiler.h"
+#include "core/framework/session_state.h"
+#include "core/framework/session_state_initializer.h"
+#include "core/framework/utils.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/model.h"
+#include "core/optimizer/initializer.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+
+namespace onnxruntime {
+
+constexpr size_t ConstantFolding::kDefaultMaxOutputBytes;
+
+// ops whose output differs between runs even if the inputs don't
+static const std::unordered_set<std::string> kNonDeterministicOps = {
+    "RandomNormal", "RandomNormalLike", "RandomUniform", "RandomUniformLike", "Multinomial"};
+
+// size of an element of a fixed size tensor type, or 0 if the type isn't one
+static size_t ElementSize(int32_t elem_type) {
+  switch (elem_type) {
+    case TensorProto_DataType_BOOL:
+    case TensorProto_DataType_INT8:
+    case TensorProto_DataType_UINT8:
+      return 1;
+    case TensorProto_DataType_INT16:
+    case TensorProto_DataType_UINT16:
+    case TensorProto_DataType_FLOAT16:
+    case TensorProto_DataType_BFLOAT16:
+      return 2;
+    case TensorProto_DataType_INT32:
+    case TensorProto_DataType_UINT32:
+    case TensorProto_DataType_FLOAT:
+      return 4;
+    case TensorProto_DataType_INT64:
+    case TensorProto_DataType_UINT64:
+    case TensorProto_DataType_DOUBLE:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+// returns true if the tensor type has a fixed size element type and a static shape, and is at most max_bytes
+static bool OutputFitsIn(const TypeProto& type, size_t max_bytes) {
+  const auto& tensor_type = type.tensor_type();
+  size_t bytes = ElementSize(tensor_type.elem_type());
+  if (bytes == 0 || !tensor_type.has_shape()) {
+    return false;
+  }
+
+  for (const auto& dim : tensor_type.shape().dim()) {
+    // an empty tensor has no raw data to write
+    if (!dim.has_dim_value() || dim.dim_value() <= 0) {
+      return false;
+    }
+
+    const auto dim_value = static_cast<size_t>(dim.dim_value());
+    if (dim_value > max_bytes / bytes) {
+      return false;
+    }
+
+    bytes *= dim_value;
+  }
+
+  return true;
+}
+
+ConstantFolding::ConstantFolding(size_t max_output_bytes)
+    : GraphTransformer("ConstantFolding", "Replace nodes with constant inputs by initializers holding their outputs"),
+      max_output_bytes_(max_output_bytes),
+      kernel_registry_manager_(std::make_unique<KernelRegistryManager>()) {
+  // the kernels run once while the graph is transformed, so there's no arena
+  auto cpu_provider = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo(false));
+  cpu_kernel_registry_ = cpu_provider->GetKernelRegistry();
+  ORT_ENFORCE(execution_providers_.Add(kCpuExecutionProvider, std::move(cpu_provider)).IsOK());
+  kernel_registry_manager_->RegisterKernels(execution_providers_);
+}
+
+bool ConstantFolding::CanFold(const Graph& graph, const Node& node) const {
+  if (kNonDeterministicOps.count(node.OpType()) != 0) {
+    return false;
+  }
+
+  for (const auto& attr : node.GetAttributes()) {
+    if (attr.second.has_g() || attr.second.graphs_size() != 0) {
+      return false;
+    }
+  }
+
+  for (const auto* input_def : node.InputDefs()) {
+    if (input_def->Exists() && !utils::IsConstantInitializer(graph, input_def->Name())) {
+      return false;
+    }
+  }
+
+  for (const auto* output_def : node.OutputDefs()) {
+    if (!output_def->Exists()) {
+      continue;
+    }
+
+    // the size is checked before the node runs, so the shape has to be known
+    const auto* type = output_def->TypeAsProto();
+    if (type == nullptr || !type->has_tensor_type() || !OutputFitsIn(*type, max_output_bytes_)) {
+      return false;
+    }
+  }
+
+  return cpu_kernel_registry_->TryFindKernel(node, kCpuExecutionProvider) != nullptr;
+}
+
+Status ConstantFolding::FoldNode(Graph& graph, Node& node, bool& folded) const {
+  folded = false;
+
+  // a graph with just the node, and its inputs as initializers
+  Model model("ConstantFolding", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              graph.DomainToVersionMap());
+  Graph& fold_graph = model.MainGraph();
+  std::unordered_set<std::string> added_inputs;
+  for (const auto* input_def : node.InputDefs()) {
+    if (input_def->Exists() && added_inputs.insert(input_def->Name()).second) {
+      const TensorProto* initializer = nullptr;
+      graph.GetInitializedTensor(input_def->Name(), initializer);
+      fold_graph.AddInitializedTensor(*initializer);
+    }
+  }
+
+  fold_graph.AddNode(node).SetExecutionProviderType(kCpuExecutionProvider);
+  ORT_RETURN_IF_ERROR(fold_graph.Resolve());
+
+  profiling::Profiler profiler;
+  SessionState session_state{execution_providers_};
+  session_state.SetProfiler(profiler);
+
+  SessionStateInitializer initializer{fold_graph, session_state, execution_providers_, *kernel_registry_manager_};
+  ORT_RETURN_IF_ERROR(initializer.CreatePlan({}, true));
+  ORT_RETURN_IF_ERROR(initializer.InitializeAndSave(false));
+
+  // only the outputs that are used become initializers
+  std::unordered_set<int> used_outputs;
+  for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+    used_outputs.insert(it->GetSrcArgIndex());
+  }
+
+  std::vector<std::string> output_names;
+  const auto& output_defs = node.OutputDefs();
+  for (int i = 0, end = static_cast<int>(output_defs.size()); i < end; ++i) {
+    if (output_defs[i]->Exists() && used_outputs.count(i) != 0) {
+      output_names.push_back(output_defs[i]->Name());
+    }
+  }
+
+  bool terminate = false;
+  std::vector<MLValue> fetches;
+  ORT_RETURN_IF_ERROR(utils::ExecuteGraph(session_state, {}, output_names, fetches, {},
+                                          /*sequential_execution*/ true, terminate, session_state.Logger()));
+
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    TensorProto tensor_proto;
+    Initializer(output_names[i], fetches[i].Get<Tensor>()).ToProto(&tensor_proto);
+    graph.AddInitializedTensor(tensor_proto);
+  }
+
+  // the consumers now read the initializers
+  std::vector<Node::EdgeEnd> output_edges(node.OutputEdgesBegin(), node.OutputEdgesEnd());
+  for (const auto& edge : output_edges) {
+    graph.RemoveEdge(node.Index(), edge.GetNode().Index(), edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+  }
+
+  graph.RemoveNode(node.Index());
+  folded = true;
+
+  return Status::OK();
+}
+
+Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto index : order) {
+    auto* node = graph.GetNode(index);
+    if (node == nullptr) {
+      continue;
+    }
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level));
+
+    if (graph.IsNodeOutputsInGraphOutputs(*node) || !CanFold(graph, *node)) {
+      continue;
+    }
+
+    bool folded = false;
+    ORT_RETURN_IF_ERROR(FoldNode(graph, *node, folded));
+    if (folded) {
+      modified = true;
+      RecordRewrites();
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+
+#include "core/framework/execution_providers.h"
+#include "core/framework/kernel_registry_manager.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class ConstantFolding
+
+Transformer that evaluates nodes whose inputs are all constant initializers with the CPU kernels, and replaces each
+of them with initializers holding its outputs. Nodes are visited in topological order so chains of such nodes are
+folded in a single pass.
+
+Nodes are left as they are if they are non-deterministic, contain subgraphs, produce a graph output, have no CPU
+kernel, or have an output that is not a tensor of a fixed size type and static shape, or is larger than
+max_output_bytes. The output size is checked before the node runs.
+Initializers that can be overridden by a graph input are not constant.
+*/
+class ConstantFolding : public GraphTransformer {
+ public:
+  static constexpr size_t kDefaultMaxOutputBytes = 16 * 1024 * 1024;
+
+  explicit ConstantFolding(size_t max_output_bytes = kDefaultMaxOutputBytes);
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+
+  bool CanFold(const Graph& graph, const Node& node) const;
+
+  // run node and replace it with its outputs
+  Status FoldNode(Graph& graph, Node& node, bool& folded) const;
+
+  const size_t max_output_bytes_;
+
+  ExecutionProviders execution_providers_;
+  // SessionStateInitializer needs a non-const manager
+  std::unique_ptr<KernelRegistryManager> kernel_registry_manager_;
+  std::shared_ptr<KernelRegistry> cpu_kernel_registry_;
+};
+
+}  // namespace onnxruntime
@@ -97,6 +97,7 @@ Status ConvActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
 
     removed_nodes.push_front(conv_node->Index());
     removed_nodes.push_front(act_node.Index());
+    RecordRewrites();
   }
 
   for (auto node : removed_nodes) {
@@ -11,6 +11,7 @@ namespace onnxruntime {
 
 Status ConvAddFusion::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const {
   std::vector<onnxruntime::NodeIndex> removed_nodes;
+  const auto consumer_counts = utils::CountNodeArgConsumers(graph);
   for (auto& node : graph.Nodes()) {
     ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
 
@@ -38,7 +39,8 @@ Status ConvAddFusion::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int g
     graph.GetInitializedTensor(add_inputs[1]->Name(), add_B_tensor_proto);
 
     // Currently, fusion is only supported for float or double data type.
-    if (!Initializer::IsSupportedDataType(add_B_tensor_proto) ||
+    if (conv_W_tensor_proto == nullptr ||
+        !Initializer::IsSupportedDataType(add_B_tensor_proto) ||
         conv_W_tensor_proto->dims_size() < 4 ||
         add_B_tensor_proto->dims_size() != conv_W_tensor_proto->dims_size() - 1 ||
         conv_W_tensor_proto->dims(0) != add_B_tensor_proto->dims(0)) {
@@ -58,6 +60,15 @@ Status ConvAddFusion::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int g
       continue;
     }
 
+    // the initializers are replaced by ones with the fused values under the same names, so they must be constant
+    // and not used by any other node
+    if (!utils::IsConstantInitializer(graph, conv_inputs[1]->Name()) ||
+        !utils::IsOnlyConsumer(consumer_counts, *conv_inputs[1]) ||
+        !utils::IsConstantInitializer(graph, add_inputs[1]->Name()) ||
+        !utils::IsOnlyConsumer(consumer_counts, *add_inputs[1])) {
+      continue;
+    }
+
     const ONNX_NAMESPACE::TensorProto* conv_B_tensor_proto = nullptr;
     if (conv_inputs.size() == 3) {
       graph.GetInitializedTensor(conv_inputs[2]->Name(), conv_B_tensor_proto);
@@ -65,7 +76,9 @@ Status ConvAddFusion::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int g
       if (!Initializer::IsSupportedDataType(conv_B_tensor_proto) ||
           conv_B_tensor_proto->data_type() != add_B_tensor_proto->data_type() ||
           conv_B_tensor_proto->dims_size() != 1 ||
-          conv_B_tensor_proto->dims(0) != add_B_tensor_proto->dims(0)) {
+          conv_B_tensor_proto->dims(0) != add_B_tensor_proto->dims(0) ||
+          !utils::IsConstantInitializer(graph, conv_inputs[2]->Name()) ||
+          !utils::IsOnlyConsumer(consumer_counts, *conv_inputs[2])) {
         continue;
       }
 
@@ -126,6 +139,7 @@ Status ConvAddFusion::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int g
     }
 
     removed_nodes.push_back(add_node.Index());
+    RecordRewrites();
   }
 
   for (auto i : removed_nodes) {
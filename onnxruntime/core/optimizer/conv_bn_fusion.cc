@@ -11,6 +11,7 @@ namespace onnxruntime {
 
 Status ConvBNFusion::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const {
   std::vector<onnxruntime::NodeIndex> removed_nodes;
+  const auto consumer_counts = utils::CountNodeArgConsumers(graph);
   for (auto& node : graph.Nodes()) {
     ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
 
@@ -30,7 +31,8 @@ Status ConvBNFusion::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int gr
 
     // Get value of attribute group
     const onnxruntime::NodeAttributes& conv_attributes = conv_node.GetAttributes();
-    const onnx::AttributeProto* group_attr = &(conv_attributes.find("group")->second);
+    auto group_entry = conv_attributes.find("group");
+    const onnx::AttributeProto* group_attr = group_entry != conv_attributes.end() ? &group_entry->second : nullptr;
     if (group_attr != nullptr &&
         group_attr->type() == AttributeProto_AttributeType_INT &&
         group_attr->has_i() && group_attr->i() != 1) {
@@ -39,11 +41,16 @@ Status ConvBNFusion::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int gr
 
     // Get value of attribute epsilon
     const onnxruntime::NodeAttributes& attributes = bn_node.GetAttributes();
-    const onnx::AttributeProto* attr = &(attributes.find("epsilon")->second);
-    if (attr == nullptr || attr->type() != AttributeProto_AttributeType_FLOAT) {
-      continue;
+    // epsilon is optional
+    float epsilon = 1e-5f;
+    auto epsilon_entry = attributes.find("epsilon");
+    if (epsilon_entry != attributes.end()) {
+      const onnx::AttributeProto* attr = &epsilon_entry->second;
+      if (attr->type() != AttributeProto_AttributeType_FLOAT) {
+        continue;
+      }
+      epsilon = static_cast<float>(attr->f());
     }
-    float epsilon = static_cast<float>(attr->f());
 
     // Get initializers of BatchNormalization
     const auto& bn_inputs = bn_node.InputDefs();
@@ -84,6 +91,19 @@ Status ConvBNFusion::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int gr
       continue;
     }
 
+    // the initializers are replaced by ones with the fused values under the same names, so they must be constant
+    // and not used by any other node
+    bool can_fuse = utils::IsConstantInitializer(graph, conv_inputs[1]->Name()) &&
+                    utils::IsOnlyConsumer(consumer_counts, *conv_inputs[1]);
+    for (size_t i = 1; i < 5 && can_fuse; ++i) {
+      can_fuse = utils::IsConstantInitializer(graph, bn_inputs[i]->Name()) &&
+                 utils::IsOnlyConsumer(consumer_counts, *bn_inputs[i]);
+    }
+
+    if (!can_fuse) {
+      continue;
+    }
+
     auto bn_scale = std::make_unique<Initializer>(bn_scale_tensor_proto);
     auto bn_B = std::make_unique<Initializer>(bn_B_tensor_proto);
     auto bn_mean = std::make_unique<Initializer>(bn_mean_tensor_proto);
@@ -99,7 +119,9 @@ Status ConvBNFusion::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int gr
       if (!Initializer::IsSupportedDataType(conv_B_tensor_proto) ||
           conv_B_tensor_proto->dims_size() != 1 ||
           conv_B_tensor_proto->dims(0) != bn_B_tensor_proto->dims(0) ||
-          conv_B_tensor_proto->data_type() != bn_B_tensor_proto->data_type()) {
+          conv_B_tensor_proto->data_type() != bn_B_tensor_proto->data_type() ||
+          !utils::IsConstantInitializer(graph, conv_inputs[2]->Name()) ||
+          !utils::IsOnlyConsumer(consumer_counts, *conv_inputs[2])) {
         continue;
       }
       conv_B = std::make_unique<Initializer>(conv_B_tensor_proto);
@@ -173,6 +195,7 @@ Status ConvBNFusion::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int gr
       }
     }
     removed_nodes.push_back(bn_node.Index());
+    RecordRewrites();
   }
 
   for (auto i : removed_nodes) {
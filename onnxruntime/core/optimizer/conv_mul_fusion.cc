@@ -11,6 +11,7 @@ namespace onnxruntime {
 
 Status ConvMulFusion::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const {
   std::vector<onnxruntime::NodeIndex> removed_nodes;
+  const auto consumer_counts = utils::CountNodeArgConsumers(graph);
   for (auto& node : graph.Nodes()) {
     ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
 
@@ -61,6 +62,16 @@ Status ConvMulFusion::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int g
         continue;
       }
     }
+
+    // the initializers are replaced by ones with the fused values under the same names, so they must be constant
+    // and not used by any other node
+    if (!utils::IsConstantInitializer(graph, conv_inputs[1]->Name()) ||
+        !utils::IsOnlyConsumer(consumer_counts, *conv_inputs[1]) ||
+        !utils::IsConstantInitializer(graph, mul_inputs[1]->Name()) ||
+        !utils::IsOnlyConsumer(consumer_counts, *mul_inputs[1])) {
+      continue;
+    }
+
     auto conv_W = std::make_unique<Initializer>(conv_W_tensor_proto);
     auto mul_B = std::make_unique<Initializer>(mul_B_tensor_proto);
 
@@ -74,7 +85,9 @@ Status ConvMulFusion::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int g
         return Status(ONNXRUNTIME, FAIL, "Internal error in ConvMulFusion. conv_B_tensor_proto is NULL");
       if (!Initializer::IsSupportedDataType(conv_B_tensor_proto) ||
           conv_B_tensor_proto->data_type() != mul_B_tensor_proto->data_type() ||
-          conv_B_tensor_proto->dims_size() != 1 || (mul_B_tensor_proto->dims_size() != 0 && conv_B_tensor_proto->dims(0) != mul_B_tensor_proto->dims(0))) {
+          conv_B_tensor_proto->dims_size() != 1 || (mul_B_tensor_proto->dims_size() != 0 && conv_B_tensor_proto->dims(0) != mul_B_tensor_proto->dims(0)) ||
+          !utils::IsConstantInitializer(graph, conv_inputs[2]->Name()) ||
+          !utils::IsOnlyConsumer(consumer_counts, *conv_inputs[2])) {
         continue;
       }
       conv_B = std::make_unique<Initializer>(conv_B_tensor_proto);
@@ -124,6 +137,7 @@ Status ConvMulFusion::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int g
     }
 
     removed_nodes.push_back(mul_node.Index());
+    RecordRewrites();
   }
 
   for (auto i : removed_nodes) {
@@ -99,6 +99,7 @@ Status GemmActivationFusion::ApplyImpl(Graph& graph, bool& modified, int graph_l
 
     removed_nodes.push_front(gemm_node.Index());
     removed_nodes.push_front(act_node.Index());
+    RecordRewrites();
   }
 
   for (auto node : removed_nodes) {
@@ -11,6 +11,7 @@ Status GraphTransformer::Apply(Graph& graph, bool& modified) const {
   // the Graph should be in a good state prior this being called, so there should be no need to call Resolve here
   // ORT_RETURN_IF_ERROR(graph.Resolve());
 
+  num_rewrites_ = 0;
   auto status = ApplyImpl(graph, modified, 0);
   ORT_RETURN_IF_ERROR(status);
 
@@ -48,9 +49,14 @@ Status TopDownRuleBasedTransformer::ApplyImpl(Graph& graph, bool& modified, int
     bool deleted = false;
     if (rules) {
       for (const auto& rule : *rules) {
-        ORT_RETURN_IF_ERROR(rule->CheckConditionAndApply(graph, *node, modified, deleted));
-        if (deleted) {
+        bool rule_modified = false;
+        ORT_RETURN_IF_ERROR(rule->CheckConditionAndApply(graph, *node, rule_modified, deleted));
+        if (rule_modified || deleted) {
           modified = true;  // should be set by rewriter but in case it wasn't...
+          RecordRewrites();
+        }
+
+        if (deleted) {
           break;
         }
       }
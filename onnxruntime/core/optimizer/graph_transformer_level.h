@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+namespace onnxruntime {
+
+// The graph transformers a GraphTransformerManager registers by default. Each level includes the ones below it.
+enum class TransformerLevel {
+  // none. only the transformers registered by the caller are applied.
+  kNone = 0,
+  // rewrites that produce standard ONNX ops: replacing nodes with constant inputs by their outputs, removing no-op
+  // Identity, Slice and Unsqueeze nodes, and folding BatchNormalization, Mul and Add with constant inputs into the
+  // weights of the Conv before them.
+  kBasic = 1,
+  // fusions into larger kernels: MatMul + Add into Gemm, and Conv or Gemm + activation into the FusedConv and
+  // FusedGemm ops in the com.microsoft domain. the fused ops only have CPU kernels.
+  kExtended = 2,
+  // layout transformations: computing the convolutions and the ops around them in the channel blocked NCHWc layout
+  // of MLAS. the block size depends on the processor, so a model saved after these only runs on similar machines.
+  kLayout = 3,
+};
+
+}  // namespace onnxruntime
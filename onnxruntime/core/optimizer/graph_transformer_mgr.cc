@@ -2,20 +2,83 @@
 // Licensed under the MIT License.
 
 #include "core/optimizer/graph_transformer_mgr.h"
+#include "core/common/profiler.h"
+#include "core/optimizer/constant_folding.h"
+#include "core/optimizer/conv_activation_fusion.h"
+#include "core/optimizer/conv_add_fusion.h"
+#include "core/optimizer/conv_bn_fusion.h"
+#include "core/optimizer/conv_mul_fusion.h"
+#include "core/optimizer/gemm_activation_fusion.h"
+#include "core/optimizer/identity_elimination.h"
+#include "core/optimizer/matmul_add_fusion.h"
+#include "core/optimizer/nchwc_transformer.h"
+#include "core/optimizer/slice_elimination.h"
+#include "core/optimizer/unsqueeze_elimination.h"
 using namespace onnxruntime;
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
 
-Status GraphTransformerManager::ApplyAll(Graph& graph) const {
+GraphTransformerManager::GraphTransformerManager(unsigned steps, TransformerLevel level) : steps_(steps) {
+  if (level >= TransformerLevel::kBasic) {
+    // folded values become initializers the rewrites below can use
+    transformers_.push_back(std::make_unique<ConstantFolding>());
+
+    auto rule_transformer = std::make_unique<TopDownRuleBasedTransformer>("EliminationRuleTransformer",
+                                                                          "Remove no-op Identity and Slice nodes");
+    rule_transformer->Register("Identity", std::make_unique<EliminateIdentity>());
+    rule_transformer->Register("Slice", std::make_unique<EliminateSlice>());
+    transformers_.push_back(std::move(rule_transformer));
+    transformers_.push_back(std::make_unique<UnsqueezeElimination>());
+
+    // fold BatchNormalization first, as it may be followed by a Mul or Add
+    transformers_.push_back(std::make_unique<ConvBNFusion>());
+    transformers_.push_back(std::make_unique<ConvMulFusion>());
+    transformers_.push_back(std::make_unique<ConvAddFusion>());
+  }
+
+  if (level >= TransformerLevel::kExtended) {
+    // the activation fusions run after the Conv bias is folded and MatMul + Add becomes Gemm
+    transformers_.push_back(std::make_unique<MatMulAddFusion>());
+    transformers_.push_back(std::make_unique<ConvActivationFusion>());
+    transformers_.push_back(std::make_unique<GemmActivationFusion>());
+  }
+
+  if (level >= TransformerLevel::kLayout) {
+    // the convolutions are transformed once the activations are fused into them
+    transformers_.push_back(std::make_unique<NchwcTransformer>());
+  }
+}
+
+Status GraphTransformerManager::ApplyAll(Graph& graph, profiling::Profiler* profiler) const {
+  const bool profiling = profiler != nullptr && profiler->FEnabled();
+
   for (unsigned step = 0; step < steps_; ++step) {
     bool changed = false;
     for (auto& transformer : transformers_) {
+      TimePoint start_time;
+      int num_nodes_before = 0;
+      if (profiling) {
+        start_time = profiler->StartTime();
+        num_nodes_before = graph.NumberOfNodes();
+      }
+
       bool t_changed = false;
       Status s = transformer->Apply(graph, t_changed);
       if (!s.IsOK()) {
         return s;
       }
+
+      if (profiling) {
+        profiler->EndTimeAndRecordEvent(profiling::SESSION_EVENT, transformer->Name() + "_graph_transform",
+                                        start_time,
+                                        {{"step", std::to_string(step)},
+                                         {"modified", t_changed ? "1" : "0"},
+                                         {"num_rewrites", std::to_string(transformer->NumRewrites())},
+                                         {"num_nodes_before", std::to_string(num_nodes_before)},
+                                         {"num_nodes_after", std::to_string(graph.NumberOfNodes())}});
+      }
+
       changed = changed || t_changed;
     }
     if (!changed) break;
@@ -4,25 +4,31 @@
 #pragma once
 
 #include "core/optimizer/graph_transformer.h"
+#include "core/optimizer/graph_transformer_level.h"
 
 namespace onnxruntime {
-// Manages a list of graph transformers. It is initialized with a list of graph
-// transformers. Each inference session can further register additional ones.
+namespace profiling {
+class Profiler;
+}
+
+// Manages a list of graph transformers. It is initialized with the default graph
+// transformers for a level. Each inference session can further register additional ones.
 class GraphTransformerManager {
  public:
-  explicit GraphTransformerManager(unsigned steps) noexcept : steps_(steps) {
-    // TODO: Register default transformers.
-  }
+  explicit GraphTransformerManager(unsigned steps, TransformerLevel level = TransformerLevel::kNone);
 
-  // Register a graph transformer.
+  // Register a graph transformer. Transformers are applied in the order they are registered,
+  // after the default ones.
   common::Status Register(std::unique_ptr<GraphTransformer> transformer) {
     transformers_.push_back(std::move(transformer));
     return common::Status::OK();
   }
 
-  // Apply the list of graph transformers registered on the specified graph
-  // up to the given number of steps.
-  common::Status ApplyAll(Graph& graph) const;
+  // Apply the list of graph transformers registered on the specified graph until
+  // none of them modifies it, up to the given number of steps.
+  // If profiler is enabled an event is recorded for each application of a transformer,
+  // with whether it modified the graph and the number of nodes before and after.
+  common::Status ApplyAll(Graph& graph, profiling::Profiler* profiler = nullptr) const;
 
  private:
   GraphTransformerManager() = default;
@@ -8,6 +8,8 @@
 #include <cmath>
 
 #include "core/common/common.h"
+#include "core/framework/tensor.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/graph/onnx_protobuf.h"
 #include "core/util/math.h"
 
@@ -50,6 +52,18 @@ class Initializer final {
     }
   }
 
+  // Copy of the data of a tensor, e.g. the output of a node computed by constant folding. The data is kept as
+  // raw_data so any fixed size type is supported. Strings are not.
+  Initializer(const std::string& name, const Tensor& tensor) : size_(0) {
+    ORT_ENFORCE(tensor.DataType() != DataTypeImpl::GetType<std::string>(), "string tensors are not supported");
+    data_type_ = utils::GetTensorProtoType(tensor);
+    name_ = name;
+    const auto& dims = tensor.Shape().GetDims();
+    dims_.assign(dims.cbegin(), dims.cend());
+    size_ = tensor.Shape().Size();
+    raw_data_.assign(static_cast<const char*>(tensor.DataRaw()), tensor.Size());
+  }
+
   Initializer(const ONNX_NAMESPACE::TensorProto* tensor_proto) : size_(0) {
     data_type_ = tensor_proto->data_type();
     if (tensor_proto->has_name()) {
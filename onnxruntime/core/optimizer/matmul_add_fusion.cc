@@ -21,7 +21,7 @@ Status MatMulAddFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level)
 
     if (!(utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", 1) ||
           utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", 9)) ||
-        node.GetOutputEdgesCount() != 1) {
+        node.GetOutputEdgesCount() != 1 || graph.IsNodeOutputsInGraphOutputs(node)) {
       continue;
     }
 
@@ -71,14 +71,14 @@ Status MatMulAddFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level)
     if (matmul_output_name == add_input_defs[0]->Name()) {
       // matmul output as Add_A, should use Add_B as input C for gemm
       // Gemm only support unidirectional broadcast on C
-      if (add_input_defs[1]->Shape()->dim_size() > 2) {
+      if (add_input_defs[1]->Shape() == nullptr || add_input_defs[1]->Shape()->dim_size() > 2) {
         continue;
       }
       gemm_input_defs.push_back(add_input_defs[1]);
     } else {
       // matmul output as Add_B, should use Add_A as input C for gemm
       // Gemm only support unidirectional broadcast on C
-      if (add_input_defs[0]->Shape()->dim_size() > 2) {
+      if (add_input_defs[0]->Shape() == nullptr || add_input_defs[0]->Shape()->dim_size() > 2) {
         continue;
       }
       gemm_input_defs.push_back(add_input_defs[0]);
@@ -92,6 +92,7 @@ Status MatMulAddFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level)
 
     removed_nodes.push_front(matmul_node.Index());
     removed_nodes.push_front(add_node.Index());
+    RecordRewrites();
   }
 
   // Have to remove node in reversed order for now to walk around the issue in RemoveNode
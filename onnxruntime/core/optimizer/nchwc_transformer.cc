@@ -0,0 +1,356 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/nchwc_transformer.h"
+#include "core/mlas/inc/mlas.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// A value of the transformed graph in the NCHWc layout, which holds the value of a NodeArg of the original graph.
+struct NchwcArgument {
+  NodeArg* nchwc_arg;
+  // the number of channels of the original value, without the padding
+  int64_t channels;
+  // the execution provider of the node that computes the value
+  ProviderType provider;
+};
+
+bool HasKnownShape(const NodeArg& arg) {
+  const auto* shape = arg.Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+  for (const auto& dim : shape->dim()) {
+    if (!dim.has_dim_value()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool HaveSameShape(const NodeArg& arg1, const NodeArg& arg2) {
+  if (!HasKnownShape(arg1) || !HasKnownShape(arg2)) {
+    return false;
+  }
+  const auto& shape1 = *arg1.Shape();
+  const auto& shape2 = *arg2.Shape();
+  if (shape1.dim_size() != shape2.dim_size()) {
+    return false;
+  }
+  for (int i = 0; i < shape1.dim_size(); ++i) {
+    if (shape1.dim(i).dim_value() != shape2.dim(i).dim_value()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsAutoPadNotSet(const Node& node) {
+  const auto* auto_pad = utils::GetNodeAttribute(node, "auto_pad");
+  return auto_pad == nullptr || auto_pad->s() == "NOTSET";
+}
+
+class NchwcTransformerImpl {
+ public:
+  explicit NchwcTransformerImpl(Graph& graph) noexcept : graph_(graph) {}
+
+  void Transform(Node& node);
+  void Finalize(bool& modified);
+
+  int NumTransformedNodes() const { return static_cast<int>(removed_nodes_.size()); }
+
+ private:
+  NodeArg* CreateNchwcArgument(const NodeArg& arg);
+  NodeArg* ReorderInput(NodeArg& input, const Node& consumer);
+  Node& AddNchwcNode(Node& node, const std::string& op_type, const std::string& domain,
+                     const std::vector<NodeArg*>& inputs, const NodeAttributes* attributes, int64_t channels);
+
+  void TransformConv(Node& node);
+  void TransformPool(Node& node);
+  void TransformActivation(Node& node);
+  void TransformAdd(Node& node);
+
+  Graph& graph_;
+
+  // the NCHWc values computed by the transformed nodes, keyed by the NodeArg of the original graph they hold
+  std::unordered_map<const NodeArg*, NchwcArgument> nchwc_args_;
+  // the NodeArgs of the original graph with a NCHWc value, in the order the values are computed
+  std::vector<NodeArg*> nchwc_outputs_;
+  // the NCHWc copies of values that aren't computed by transformed nodes
+  std::unordered_map<const NodeArg*, NodeArg*> reorder_inputs_;
+
+  std::deque<NodeIndex> removed_nodes_;
+};
+
+NodeArg* NchwcTransformerImpl::CreateNchwcArgument(const NodeArg& arg) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  return &graph_.GetOrCreateNodeArg(graph_.GenerateNodeArgName(arg.Name() + "_nchwc"), &type);
+}
+
+NodeArg* NchwcTransformerImpl::ReorderInput(NodeArg& input, const Node& consumer) {
+  auto it = reorder_inputs_.find(&input);
+  if (it != reorder_inputs_.end()) {
+    return it->second;
+  }
+
+  NodeArg* nchwc_input = CreateNchwcArgument(input);
+  Node& reorder = graph_.AddNode(graph_.GenerateNodeName("ReorderInput"), "ReorderInput",
+                                 "reorder " + input.Name() + " to NCHWc",
+                                 std::vector<NodeArg*>{&input}, std::vector<NodeArg*>{nchwc_input},
+                                 nullptr, kMSDomain);
+  reorder.SetExecutionProviderType(consumer.GetExecutionProviderType());
+
+  reorder_inputs_.emplace(&input, nchwc_input);
+  return nchwc_input;
+}
+
+Node& NchwcTransformerImpl::AddNchwcNode(Node& node, const std::string& op_type, const std::string& domain,
+                                         const std::vector<NodeArg*>& inputs, const NodeAttributes* attributes,
+                                         int64_t channels) {
+  NodeArg* output = node.MutableOutputDefs()[0];
+  NodeArg* nchwc_output = CreateNchwcArgument(*output);
+
+  Node& nchwc_node = graph_.AddNode(graph_.GenerateNodeName("Nchwc" + node.Name()), op_type,
+                                    "NCHWc " + node.OpType() + " " + node.Name(),
+                                    inputs, std::vector<NodeArg*>{nchwc_output}, attributes, domain);
+  nchwc_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+  nchwc_args_[output] = NchwcArgument{nchwc_output, channels, node.GetExecutionProviderType()};
+  nchwc_outputs_.push_back(output);
+  removed_nodes_.push_front(node.Index());
+  return nchwc_node;
+}
+
+void NchwcTransformerImpl::TransformConv(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  if (input_defs.size() < 2 || node.OutputDefs().size() != 1) {
+    return;
+  }
+
+  // the filter shape tells the number of input channels
+  const TensorProto* filter = nullptr;
+  if (!graph_.GetInitializedTensor(input_defs[1]->Name(), filter) ||
+      filter->data_type() != TensorProto_DataType_FLOAT || filter->dims_size() != 4) {
+    return;
+  }
+
+  if (!IsAutoPadNotSet(node)) {
+    return;
+  }
+
+  const int64_t output_channels = filter->dims(0);
+  const auto* group_attr = utils::GetNodeAttribute(node, "group");
+  const int64_t group = group_attr != nullptr ? group_attr->i() : 1;
+
+  // grouped convolutions must be depthwise
+  if (group != 1 && (filter->dims(1) != 1 || group != output_channels)) {
+    return;
+  }
+
+  const int64_t channels = filter->dims(1) * group;
+  NodeArg* input = input_defs[0];
+  NodeArg* nchwc_input;
+
+  if (group == 1 && channels < static_cast<int64_t>(MlasNchwcGetBlockSize())) {
+    // the convolution reads the NCHW input
+    nchwc_input = input;
+  } else {
+    auto it = nchwc_args_.find(input);
+    if (it != nchwc_args_.end()) {
+      if (it->second.channels != channels) {
+        return;
+      }
+      nchwc_input = it->second.nchwc_arg;
+    } else {
+      nchwc_input = ReorderInput(*input, node);
+    }
+  }
+
+  std::vector<NodeArg*> inputs{nchwc_input, input_defs[1]};
+  if (input_defs.size() >= 3 && input_defs[2]->Exists()) {
+    inputs.push_back(input_defs[2]);
+  }
+
+  // the attributes of Conv and FusedConv are the same as NchwcConv
+  AddNchwcNode(node, "NchwcConv", kMSDomain, inputs, &node.GetAttributes(), output_channels);
+}
+
+void NchwcTransformerImpl::TransformPool(Node& node) {
+  // MaxPool with the indices output isn't supported
+  for (size_t i = 1; i < node.OutputDefs().size(); ++i) {
+    if (node.OutputDefs()[i]->Exists()) {
+      return;
+    }
+  }
+
+  auto it = nchwc_args_.find(node.InputDefs()[0]);
+  if (it == nchwc_args_.end()) {
+    return;
+  }
+
+  std::string op_type;
+  std::vector<std::string> attribute_names;
+  if (node.OpType() == "GlobalMaxPool") {
+    op_type = "NchwcGlobalMaxPool";
+  } else if (node.OpType() == "GlobalAveragePool") {
+    op_type = "NchwcGlobalAveragePool";
+  } else {
+    const auto* kernel_shape = utils::GetNodeAttribute(node, "kernel_shape");
+    if (kernel_shape == nullptr || kernel_shape->ints_size() != 2 || !IsAutoPadNotSet(node)) {
+      return;
+    }
+
+    attribute_names = {"kernel_shape", "pads", "strides"};
+    if (node.OpType() == "MaxPool") {
+      op_type = "NchwcMaxPool";
+    } else {
+      op_type = "NchwcAveragePool";
+      attribute_names.push_back("count_include_pad");
+    }
+  }
+
+  NodeAttributes attributes;
+  for (const auto& name : attribute_names) {
+    const auto* attribute = utils::GetNodeAttribute(node, name);
+    if (attribute != nullptr) {
+      attributes[name] = *attribute;
+    }
+  }
+
+  const NchwcArgument input = it->second;
+  AddNchwcNode(node, op_type, kMSDomain, {input.nchwc_arg}, &attributes, input.channels);
+}
+
+void NchwcTransformerImpl::TransformActivation(Node& node) {
+  auto it = nchwc_args_.find(node.InputDefs()[0]);
+  if (it == nchwc_args_.end()) {
+    return;
+  }
+
+  // the op computes each element on its own, so it doesn't depend on the layout. the padding channels get
+  // values like Sigmoid(0), which the ops that read them ignore.
+  const NchwcArgument input = it->second;
+  AddNchwcNode(node, node.OpType(), node.Domain(), {input.nchwc_arg}, &node.GetAttributes(), input.channels);
+}
+
+void NchwcTransformerImpl::TransformAdd(Node& node) {
+  const auto& input_defs = node.InputDefs();
+  if (input_defs.empty()) {
+    return;
+  }
+
+  // the inputs must hold values of the same shape, as broadcasting depends on the layout
+  std::vector<NodeArg*> nchwc_inputs;
+  for (const auto* input : input_defs) {
+    auto it = nchwc_args_.find(input);
+    if (it == nchwc_args_.end() || !HaveSameShape(*input, *input_defs[0])) {
+      return;
+    }
+    nchwc_inputs.push_back(it->second.nchwc_arg);
+  }
+
+  const int64_t channels = nchwc_args_[input_defs[0]].channels;
+  AddNchwcNode(node, node.OpType(), node.Domain(), nchwc_inputs, &node.GetAttributes(), channels);
+}
+
+void NchwcTransformerImpl::Transform(Node& node) {
+  // the Nchwc ops only have CPU kernels
+  const auto& provider = node.GetExecutionProviderType();
+  if (!provider.empty() && provider != kCpuExecutionProvider) {
+    return;
+  }
+
+  if (utils::IsSupportedOptypeVersionAndDomain(node, "Conv", 1) ||
+      utils::IsSupportedOptypeVersionAndDomain(node, "FusedConv", 1, kMSDomain)) {
+    TransformConv(node);
+  } else if (utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", 1) ||
+             utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", 8) ||
+             utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", 7) ||
+             utils::IsSupportedOptypeVersionAndDomain(node, "GlobalMaxPool", 1) ||
+             utils::IsSupportedOptypeVersionAndDomain(node, "GlobalAveragePool", 1)) {
+    TransformPool(node);
+  } else if (utils::IsSupportedOptypeVersionAndDomain(node, "Relu", 6) ||
+             utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", 6) ||
+             utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", 6) ||
+             utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", 6)) {
+    TransformActivation(node);
+  } else if (utils::IsSupportedOptypeVersionAndDomain(node, "Add", 7) ||
+             utils::IsSupportedOptypeVersionAndDomain(node, "Sum", 6) ||
+             utils::IsSupportedOptypeVersionAndDomain(node, "Sum", 8)) {
+    TransformAdd(node);
+  }
+}
+
+void NchwcTransformerImpl::Finalize(bool& modified) {
+  if (removed_nodes_.empty()) {
+    return;
+  }
+
+  // RemoveNode only removes the input edges of the node
+  for (auto index : removed_nodes_) {
+    Node& node = *graph_.GetNode(index);
+    std::vector<Node::EdgeEnd> output_edges(node.OutputEdgesBegin(), node.OutputEdgesEnd());
+    for (const auto& edge : output_edges) {
+      graph_.RemoveEdge(node.Index(), edge.GetNode().Index(), edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+    }
+  }
+
+  for (auto index : removed_nodes_) {
+    graph_.RemoveNode(index);
+  }
+
+  // reorder the values still used in the NCHW layout, by the nodes that weren't transformed or the graph outputs
+  std::unordered_set<const NodeArg*> used_args(graph_.GetOutputs().cbegin(), graph_.GetOutputs().cend());
+  for (const auto& node : graph_.Nodes()) {
+    used_args.insert(node.InputDefs().cbegin(), node.InputDefs().cend());
+    used_args.insert(node.ImplicitInputDefs().cbegin(), node.ImplicitInputDefs().cend());
+  }
+
+  for (auto* output : nchwc_outputs_) {
+    if (used_args.count(output) == 0) {
+      continue;
+    }
+
+    const NchwcArgument& nchwc_output = nchwc_args_[output];
+    NodeAttributes attributes;
+    attributes["channels"].set_name("channels");
+    attributes["channels"].set_type(AttributeProto_AttributeType_INT);
+    attributes["channels"].set_i(nchwc_output.channels);
+
+    graph_.AddNode(graph_.GenerateNodeName("ReorderOutput"), "ReorderOutput",
+                   "reorder " + output->Name() + " from NCHWc",
+                   std::vector<NodeArg*>{nchwc_output.nchwc_arg}, std::vector<NodeArg*>{output},
+                   &attributes, kMSDomain)
+        .SetExecutionProviderType(nchwc_output.provider);
+  }
+
+  modified = true;
+}
+
+}  // namespace
+
+Status NchwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  NchwcTransformerImpl impl(graph);
+  GraphViewer graph_viewer(graph);
+
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    auto& node = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+    impl.Transform(node);
+  }
+
+  impl.Finalize(modified);
+  RecordRewrites(impl.NumTransformedNodes());
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
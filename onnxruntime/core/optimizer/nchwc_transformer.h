@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class NchwcTransformer
+
+Transform the 2D convolutions to the NchwcConv op, which computes them in the channel blocked NCHWc layout of MLAS,
+along with the pooling, activation and Add ops that read their outputs. ReorderInput and ReorderOutput nodes convert
+the values at the edges of the transformed regions, so a chain of convolutions only reorders once on each side.
+The NCHWc block size depends on the processor.
+*/
+class NchwcTransformer : public onnxruntime::GraphTransformer {
+ public:
+  NchwcTransformer() noexcept
+      : onnxruntime::GraphTransformer("NchwcTransformer", "Transform convolutions to the NCHWc layout") {}
+
+ private:
+  Status ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/shared_key_zipmap_transformer.h"
+#include "core/framework/data_types.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+Status SharedKeyZipMapTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  // only the outputs of the main graph are returned to the caller, so the subgraphs are left alone
+  if (graph_level > 0) {
+    return Status::OK();
+  }
+
+  std::vector<NodeIndex> zipmaps;
+  for (const auto& node : graph.Nodes()) {
+    if (utils::IsSupportedOptypeVersionAndDomain(node, "ZipMap", 1, kMLDomain) &&
+        node.GetOutputEdgesCount() == 0 && graph.IsNodeOutputsInGraphOutputs(node) &&
+        (node.GetExecutionProviderType().empty() || node.GetExecutionProviderType() == kCpuExecutionProvider)) {
+      zipmaps.push_back(node.Index());
+    }
+  }
+
+  for (auto index : zipmaps) {
+    Node& zipmap = *graph.GetNode(index);
+    const auto* classlabels_strings = utils::GetNodeAttribute(zipmap, "classlabels_strings");
+    const bool using_strings = classlabels_strings != nullptr && classlabels_strings->strings_size() > 0;
+    MLDataType output_type = using_strings ? DataTypeImpl::GetType<SharedKeyMapsString>()
+                                           : DataTypeImpl::GetType<SharedKeyMapsInt64>();
+
+    Node& shared_key_zipmap = graph.AddNode(graph.GenerateNodeName("SharedKey" + zipmap.Name()), "SharedKeyZipMap",
+                                            "ZipMap " + zipmap.Name() + " with shared keys",
+                                            zipmap.MutableInputDefs(),
+                                            zipmap.MutableOutputDefs(),
+                                            &zipmap.GetAttributes(),
+                                            kMSDomain);
+    shared_key_zipmap.SetExecutionProviderType(zipmap.GetExecutionProviderType());
+    graph.SetNodeArgType(*zipmap.MutableOutputDefs()[0], *output_type->GetTypeProto());
+
+    graph.RemoveNode(index);
+    modified = true;
+    RecordRewrites();
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
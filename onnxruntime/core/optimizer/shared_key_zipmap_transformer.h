@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class SharedKeyZipMapTransformer
+
+Transform the ZipMap nodes whose output is only a graph output to SharedKeyZipMap, which outputs the maps as one
+SharedKeyMaps batch instead of a sequence of maps. This changes the type of the graph output, so the session only
+registers it when SessionOptions::enable_zipmap_shared_keys is set.
+*/
+class SharedKeyZipMapTransformer : public onnxruntime::GraphTransformer {
+ public:
+  SharedKeyZipMapTransformer() noexcept
+      : onnxruntime::GraphTransformer("SharedKeyZipMapTransformer",
+                                      "Transform ZipMap graph outputs to batches of maps with shared keys") {}
+
+ private:
+  Status ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
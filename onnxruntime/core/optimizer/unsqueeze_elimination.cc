@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/optimizer/unsqueeze_elimination.h"
+#include "core/graph/graph_utils.h"
 
 using namespace onnx;
 using namespace ::onnxruntime::common;
@@ -10,6 +11,7 @@ namespace onnxruntime {
 
 Status UnsqueezeElimination::ApplyImpl(onnxruntime::Graph& graph, bool& modified, int graph_level) const {
   std::vector<onnxruntime::NodeIndex> removed_nodes;
+  const auto consumer_counts = utils::CountNodeArgConsumers(graph);
 
   for (auto& node : graph.Nodes()) {
     // recurse first as there are early exits in the processing here
@@ -35,7 +37,9 @@ Status UnsqueezeElimination::ApplyImpl(onnxruntime::Graph& graph, bool& modified
     NodeArg* input_def = node.MutableInputDefs()[0];
     const ONNX_NAMESPACE::TensorProto* tensor_proto = nullptr;
     graph.GetInitializedTensor(input_def->Name(), tensor_proto);
-    if (tensor_proto == nullptr) {
+    // the initializer is reshaped in place, so no other node can be using it and no feed can replace it
+    if (tensor_proto == nullptr || !utils::IsConstantInitializer(graph, input_def->Name()) ||
+        !utils::IsOnlyConsumer(consumer_counts, *input_def)) {
       continue;
     }
     std::vector<int64_t> new_dims(axes.size() + tensor_proto->dims().size(), 0);
@@ -90,6 +94,7 @@ Status UnsqueezeElimination::ApplyImpl(onnxruntime::Graph& graph, bool& modified
     }
 
     removed_nodes.push_back(node.Index());
+    RecordRewrites();
   }
 
   for (auto i : removed_nodes) {
@@ -109,6 +109,13 @@ class Env {
   virtual common::Status FileOpenWr(const std::string& path, /*out*/ int& fd) const = 0;
   //Mainly for use with protobuf library
   virtual common::Status FileClose(int fd) const = 0;
+  // \brief Map the whole file at "path" into memory.
+  //
+  // The pages are copy-on-write, so writes to the mapping are private to the process and never reach the file, and
+  // the pages nobody writes to are shared with other processes mapping the same file. On success "*mapped" points
+  // at the contents and unmaps the file when the last reference is released, and "*length" is the file size.
+  virtual common::Status MapFileIntoMemory(const std::string& path, /*out*/ std::shared_ptr<void>& mapped,
+                                           /*out*/ size_t& length) const = 0;
   //This functions is always successful. It can't fail.
   virtual PIDType GetSelfPid() const = 0;
 
@@ -15,6 +15,7 @@ limitations under the License.
 // Portions Copyright (c) Microsoft Corporation
 
 #include <unistd.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -119,6 +120,38 @@ class PosixEnv : public Env {
     return Status::OK();
   }
 
+  common::Status MapFileIntoMemory(const std::string& path, std::shared_ptr<void>& mapped,
+                                   size_t& length) const override {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (0 > fd) {
+      return common::Status(common::SYSTEM, errno);
+    }
+
+    struct stat file_stat;
+    if (0 != fstat(fd, &file_stat)) {
+      int err = errno;
+      close(fd);
+      return common::Status(common::SYSTEM, err);
+    }
+
+    length = static_cast<size_t>(file_stat.st_size);
+    if (length == 0) {
+      close(fd);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Can't map the empty file ", path);
+    }
+
+    // the mapping holds its own reference to the file
+    void* addr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    int err = errno;
+    close(fd);
+    if (addr == MAP_FAILED) {
+      return common::Status(common::SYSTEM, err);
+    }
+
+    mapped = std::shared_ptr<void>(addr, [length](void* p) { munmap(p, length); });
+    return Status::OK();
+  }
+
   common::Status LoadDynamicLibrary(const std::string& library_filename, void** handle) const override {
     char* error_str = dlerror();  // clear any old error_str
     *handle = dlopen(library_filename.c_str(), RTLD_NOW | RTLD_LOCAL);
@@ -134,6 +134,39 @@ class WindowsEnv : public Env {
     return Status::OK();
   }
 
+  common::Status MapFileIntoMemory(const std::string& path, std::shared_ptr<void>& mapped,
+                                   size_t& length) const override {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+      return ORT_MAKE_STATUS(SYSTEM, FAIL, "CreateFile failed for ", path, " with error ", GetLastError());
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+      CloseHandle(file);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Can't map the empty or unreadable file ", path);
+    }
+
+    length = static_cast<size_t>(file_size.QuadPart);
+
+    // the view holds its own references to the file and the mapping object
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+      return ORT_MAKE_STATUS(SYSTEM, FAIL, "CreateFileMapping failed for ", path, " with error ", GetLastError());
+    }
+
+    void* addr = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    if (addr == nullptr) {
+      return ORT_MAKE_STATUS(SYSTEM, FAIL, "MapViewOfFile failed for ", path, " with error ", GetLastError());
+    }
+
+    mapped = std::shared_ptr<void>(addr, [](void* p) { UnmapViewOfFile(p); });
+    return Status::OK();
+  }
+
   virtual Status LoadDynamicLibrary(const std::string& library_filename, void** handle) const override {
     *handle = ::LoadLibraryA(library_filename.c_str());
     if (!handle)
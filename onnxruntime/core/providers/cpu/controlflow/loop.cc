@@ -15,6 +15,7 @@
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/sequential_executor.h"
 #include "core/framework/session_state.h"
+#include "core/framework/subgraph_executor.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/providers/cpu/tensor/utils.h"
@@ -99,8 +100,9 @@ class LoopImpl {
   Status Execute();
 
  private:
-  NameMLValMap CreateInitialFeeds();
-  void UpdateFeeds(const std::vector<MLValue>& last_output, NameMLValMap& next_input);
+  // create the executor that runs the subgraph for all the iterations, and set its initial feeds
+  Status CreateSubgraphExecutor();
+  void UpdateFeeds(const std::vector<MLValue>& last_output, std::vector<MLValue>& next_input);
 
   // create the single Loop output from a collection of per-iteration outputs
   Status ConcatenateLoopOutput(std::vector<MLValue>& per_iteration_output, int output_index);
@@ -124,6 +126,8 @@ class LoopImpl {
   std::vector<std::string> subgraph_input_names_;
   std::vector<std::string> subgraph_output_names_;
 
+  std::unique_ptr<SubgraphExecutor> subgraph_executor_;
+
   // collection of MLValue outputs from each loop iteration for the loop outputs.
   // the order from the subgraph matches the order from the loop output
   std::vector<std::vector<MLValue>> loop_output_tensors_;
@@ -223,39 +227,49 @@ Status LoopImpl::Initialize() {
     subgraph_output_names_.push_back(output->Name());
   }
 
-  return status;
+  return CreateSubgraphExecutor();
 }
 
-NameMLValMap LoopImpl::CreateInitialFeeds() {
-  NameMLValMap feeds;
+Status LoopImpl::CreateSubgraphExecutor() {
+  // the subgraph inputs are followed by the implicit inputs, which are the same for all iterations
+  std::vector<std::string> feed_names{subgraph_input_names_};
+  feed_names.reserve(num_subgraph_inputs_ + implicit_inputs_.size());
+  for (auto& entry : implicit_inputs_) {
+    ORT_ENFORCE(entry.second, "All implicit inputs should have MLValue instances by now. ",
+                entry.first, " did not.");
+    feed_names.push_back(entry.first);
+  }
 
-  feeds.reserve(num_subgraph_inputs_ + implicit_inputs_.size());
+  subgraph_executor_ = std::make_unique<SubgraphExecutor>(session_state_, feed_names, subgraph_output_names_,
+                                                          context_.GetTerminateFlag(), context_.Logger());
+  ORT_RETURN_IF_ERROR(subgraph_executor_->Initialize());
 
-  feeds[subgraph_input_names_[0]] = iter_num_mlvalue_;
-  feeds[subgraph_input_names_[1]] = condition_mlvalue_;
+  auto& feeds = subgraph_executor_->Feeds();
+
+  feeds[0] = iter_num_mlvalue_;
+  feeds[1] = condition_mlvalue_;
 
   // populate loop carried var inputs which conveniently start at slot 2 in both the Loop and subgraph inputs
   for (int i = 2; i < num_subgraph_inputs_; ++i) {
-    feeds[subgraph_input_names_[i]] = *context_.GetInputMLValue(i);
+    feeds[i] = *context_.GetInputMLValue(i);
   }
 
   // pass in implicit inputs as feeds.
+  size_t feed_idx = num_subgraph_inputs_;
   for (auto& entry : implicit_inputs_) {
-    ORT_ENFORCE(entry.second, "All implicit inputs should have MLValue instances by now. ",
-                entry.first, " did not.");
-    feeds[entry.first] = *entry.second;
+    feeds[feed_idx++] = *entry.second;
   }
 
-  return feeds;
+  return Status::OK();
 }
 
-void LoopImpl::UpdateFeeds(const std::vector<MLValue>& last_output, NameMLValMap& next_input) {
+void LoopImpl::UpdateFeeds(const std::vector<MLValue>& last_output, std::vector<MLValue>& next_input) {
   // last_output: cond, loop vars..., loop output...
-  // next_input: iter_num, cond, loop_vars. iter_num is re-used
+  // next_input: iter_num, cond, loop_vars, implicit inputs. iter_num and the implicit inputs are re-used
 
-  // simple copy for cond and loop carried vars.
+  // the outputs for cond and the loop carried vars become the next inputs without a copy
   for (int i = 1; i < num_subgraph_inputs_; ++i) {
-    next_input[subgraph_input_names_[i]] = last_output[i - 1];  // skip iter_num in input
+    next_input[i] = last_output[i - 1];  // skip iter_num in input
   }
 
   // save loop outputs as we have to concatenate at the end
@@ -305,22 +319,24 @@ Status LoopImpl::ConcatenateLoopOutput(std::vector<MLValue>& per_iteration_outpu
 Status LoopImpl::Execute() {
   auto status = Status::OK();
 
-  NameMLValMap feeds{CreateInitialFeeds()};
-  std::vector<MLValue> fetches;
+  auto& feeds = subgraph_executor_->Feeds();
+  auto& fetches = subgraph_executor_->Fetches();
 
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
     if (iter_num_value != 0) {
       UpdateFeeds(fetches, feeds);
-      fetches.clear();
+
+      // the last outputs are now held by the feeds. empty the fetches so the subgraph allocates new ones rather
+      // than writing to its inputs.
+      std::fill(fetches.begin(), fetches.end(), MLValue{});
     }
 
     // loop carried variables can change shape across iterations, and we don't know how many iterations
     // there will be to allocate loop outputs upfront. due to that we can't use a custom fetch allocator
     // for any outputs
-    status = utils::ExecuteGraph(session_state_, feeds, subgraph_output_names_, fetches, {},
-                                 /*sequential_execution*/ true, context_.GetTerminateFlag(), context_.Logger());
+    status = subgraph_executor_->Execute();
     ORT_RETURN_IF_ERROR(status);
 
     condition_mlvalue_ = fetches[0];
@@ -356,7 +372,7 @@ Status LoopImpl::Execute() {
     // no iterations.
     // copy input loop carried vars to output.
     for (int i = 0; i < num_loop_carried_vars_; ++i) {
-      copy_tensor_from_mlvalue_to_output(feeds[subgraph_input_names_[i + 2]], i);  // skip iter# and cond
+      copy_tensor_from_mlvalue_to_output(feeds[i + 2], i);  // skip iter# and cond
     }
 
     // create empty outputs for loop outputs
@@ -14,6 +14,7 @@
 #include "core/framework/framework_common.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/session_state.h"
+#include "core/framework/subgraph_executor.h"
 #include "core/framework/tensorprotoutils.h"
 
 #include "core/providers/cpu/tensor/utils.h"
@@ -384,6 +385,12 @@ Status Scan8Impl::Execute() {
   status = CreateLoopStateVariables(batch_loop_state_variables);
   ORT_RETURN_IF_ERROR(status);
 
+  // bind the subgraph feeds and fetches once for all the batch items and iterations
+  std::unique_ptr<SubgraphExecutor> subgraph_executor;
+  status = CreateSubgraphExecutor(context_, session_state_, subgraph_, num_variadic_inputs_, implicit_inputs_,
+                                  subgraph_output_names_, subgraph_executor);
+  ORT_RETURN_IF_ERROR(status);
+
   for (int64_t b = 0; b < batch_size_; ++b) {
     auto sequence_len = sequence_lens_[b];
 
@@ -410,10 +417,9 @@ Status Scan8Impl::Execute() {
     }
 
     // Call the subgraph for each item in the sequence
-    status = IterateSequence(context_, session_state_, subgraph_, batch_loop_state_variables[b],
+    status = IterateSequence(*subgraph_executor, batch_loop_state_variables[b],
                              scan_input_stream_iterators, sequence_len, num_loop_state_variables_,
-                             num_variadic_inputs_, num_variadic_outputs_, implicit_inputs_,
-                             subgraph_output_names_, output_iterators_);
+                             num_variadic_inputs_, num_variadic_outputs_, output_iterators_);
 
     // zero out any remaining values in the sequence
     for (int64_t i = sequence_len; i < max_sequence_len_; ++i) {
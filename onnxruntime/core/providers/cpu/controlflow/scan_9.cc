@@ -14,6 +14,7 @@
 #include "core/framework/framework_common.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/session_state.h"
+#include "core/framework/subgraph_executor.h"
 #include "core/framework/tensorprotoutils.h"
 
 #include "core/providers/common.h"
@@ -439,11 +440,15 @@ Status ScanImpl::Execute() {
     }
   }
 
+  std::unique_ptr<SubgraphExecutor> subgraph_executor;
+  status = CreateSubgraphExecutor(context_, session_state_, subgraph_, num_variadic_inputs_, implicit_inputs_,
+                                  subgraph_output_names_, subgraph_executor);
+  ORT_RETURN_IF_ERROR(status);
+
   // Call the subgraph for each item in the sequence
-  status = IterateSequence(context_, session_state_, subgraph_, loop_state_variables,
+  status = IterateSequence(*subgraph_executor, loop_state_variables,
                            scan_input_stream_iterators, sequence_len_, num_loop_state_variables_,
-                           num_variadic_inputs_, num_variadic_outputs_, implicit_inputs_,
-                           subgraph_output_names_, output_iterators_);
+                           num_variadic_inputs_, num_variadic_outputs_, output_iterators_);
 
   ORT_RETURN_IF_ERROR(status);
 
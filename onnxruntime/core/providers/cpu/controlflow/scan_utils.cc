@@ -16,6 +16,7 @@
 #include "core/framework/mldata_type_utils.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/sequential_executor.h"
+#include "core/framework/subgraph_executor.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 
@@ -96,20 +97,13 @@ Status AllocateOutput(OpKernelContextInternal& context, const GraphViewer& subgr
   return Status::OK();
 }
 
-Status IterateSequence(OpKernelContextInternal& context,
-                       const SessionState& session_state,
-                       const GraphViewer& subgraph,
-                       std::vector<LoopStateVariable>& loop_state_variables,
-                       std::vector<MLValueTensorSlicer<const MLValue>::Iterator>& scan_input_stream_iterators,
-                       int64_t seq_length,
-                       int num_loop_state_variables,
-                       int num_variadic_inputs,
-                       int num_variadic_outputs,
-                       std::unordered_map<std::string, const MLValue*>& implicit_inputs,
-                       std::vector<std::string>& subgraph_output_names,
-                       std::vector<std::unique_ptr<OutputIterator>>& output_iterators) {
-  Status status = Status::OK();
-
+Status CreateSubgraphExecutor(OpKernelContextInternal& context,
+                              const SessionState& session_state,
+                              const GraphViewer& subgraph,
+                              int num_variadic_inputs,
+                              const std::unordered_map<std::string, const MLValue*>& implicit_inputs,
+                              const std::vector<std::string>& subgraph_output_names,
+                              std::unique_ptr<SubgraphExecutor>& executor) {
   // prefer matching all inputs to the subgraph as per the Scan spec,
   auto* graph_inputs = &subgraph.GetInputsIncludingInitializers();
   if (static_cast<size_t>(num_variadic_inputs) < graph_inputs->size()) {
@@ -120,49 +114,75 @@ Status IterateSequence(OpKernelContextInternal& context,
                 "num_variadic_inputs matched the subgraph inputs or required inputs.");
   }
 
-  NameMLValMap feeds;
-  std::vector<MLValue> fetches;
-  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
-  feeds.reserve(num_variadic_inputs + implicit_inputs.size());
-  fetches.resize(num_variadic_outputs);
+  // the ordering of the Scan inputs should match the ordering of the subgraph inputs.
+  // the implicit inputs are the same for all iterations so follow those.
+  std::vector<std::string> feed_names;
+  feed_names.reserve(num_variadic_inputs + implicit_inputs.size());
+
+  for (int input = 0; input < num_variadic_inputs; ++input) {
+    feed_names.push_back((*graph_inputs)[input]->Name());
+  }
 
-  // pass in implicit inputs as feeds.
   for (auto& entry : implicit_inputs) {
     ORT_ENFORCE(entry.second, "All implicit inputs should have MLValue instances by now. ", entry.first, " did not.");
-    feeds[entry.first] = *entry.second;
+    feed_names.push_back(entry.first);
+  }
+
+  executor = std::make_unique<SubgraphExecutor>(session_state, feed_names, subgraph_output_names,
+                                                context.GetTerminateFlag(), context.Logger());
+  ORT_RETURN_IF_ERROR(executor->Initialize());
+
+  // pass in implicit inputs as feeds.
+  auto& feeds = executor->Feeds();
+  size_t feed_idx = num_variadic_inputs;
+  for (auto& entry : implicit_inputs) {
+    feeds[feed_idx++] = *entry.second;
   }
 
+  return Status::OK();
+}
+
+Status IterateSequence(SubgraphExecutor& executor,
+                       std::vector<LoopStateVariable>& loop_state_variables,
+                       std::vector<MLValueTensorSlicer<const MLValue>::Iterator>& scan_input_stream_iterators,
+                       int64_t seq_length,
+                       int num_loop_state_variables,
+                       int num_variadic_inputs,
+                       int num_variadic_outputs,
+                       std::vector<std::unique_ptr<OutputIterator>>& output_iterators) {
+  Status status = Status::OK();
+
+  // the implicit inputs were set when the executor was created, so only the loop state variables and the slices
+  // of the scan inputs and outputs need to be bound for each iteration
+  auto& feeds = executor.Feeds();
+  auto& fetches = executor.Fetches();
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+
   int64_t seq_no = 0;
   for (; seq_no < seq_length; ++seq_no) {
     for (int input = 0; input < num_variadic_inputs; ++input) {
-      // the ordering of the Scan inputs should match the ordering of the subgraph inputs
-      auto name = (*graph_inputs)[input]->Name();
-
       if (input < num_loop_state_variables) {
         // add loop state variable input
-        feeds[name] = loop_state_variables[input].Input();
+        feeds[input] = loop_state_variables[input].Input();
       } else {
         // add sliced input
         auto& iterator = scan_input_stream_iterators[input - num_loop_state_variables];
-        feeds[name] = *iterator;
+        feeds[input] = *iterator;
 
         ++iterator;
       }
     }
 
-    fetches.clear();
-
     for (int output = 0, end = num_variadic_outputs; output < end; ++output) {
       if (output < num_loop_state_variables) {
         // add loop state variable output
-        fetches.push_back(loop_state_variables[output].Output());
+        fetches[output] = loop_state_variables[output].Output();
       } else {
         auto& iterator = *output_iterators[output];
 
         if (iterator.FinalOutputAllocated()) {
           // add MLValue from sliced output
-          auto& mlvalue = *iterator;
-          fetches.push_back(mlvalue);
+          fetches[output] = *iterator;
         } else {
           // use a custom allocator that will forward the allocation request to the Scan context
           // and add the sequence length dimension. this avoids using a temporary value for the first output
@@ -171,15 +191,13 @@ Status IterateSequence(OpKernelContextInternal& context,
                 return iterator.AllocateSubgraphOutput(shape, mlvalue);
               };
 
-          // also need a dummy empty entry in fetches so the order matches the output names
-          fetches.push_back({});
+          // the entry must be empty so the custom allocator is used
+          fetches[output] = {};
         }
       }
     }
 
-    // Create Executor and run graph.
-    status = utils::ExecuteGraph(session_state, feeds, subgraph_output_names, fetches, fetch_allocators,
-                                 /*sequential_execution*/ true, context.GetTerminateFlag(), context.Logger());
+    status = executor.Execute(fetch_allocators);
     ORT_RETURN_IF_ERROR(status);
 
     // cycle the LoopStateVariable input/output in preparation for the next iteration
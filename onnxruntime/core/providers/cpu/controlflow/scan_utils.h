@@ -15,6 +15,8 @@
 namespace onnxruntime {
 class GraphViewer;
 class OpKernelContextInternal;
+class SessionState;
+class SubgraphExecutor;
 namespace scan {
 namespace detail {
 
@@ -157,17 +159,25 @@ Status AllocateOutput(OpKernelContextInternal& context, const GraphViewer& subgr
                       ScanDirection direction = ScanDirection::kForward,
                       bool temporary = false);
 
-Status IterateSequence(OpKernelContextInternal& context,
-                       const SessionState& session_state,
-                       const GraphViewer& subgraph,
+/**
+Create the executor used to run the subgraph for each iteration of a Scan.
+The feeds are the variadic inputs followed by the implicit inputs, which are set here as they don't change.
+*/
+Status CreateSubgraphExecutor(OpKernelContextInternal& context,
+                              const SessionState& session_state,
+                              const GraphViewer& subgraph,
+                              int num_variadic_inputs,
+                              const std::unordered_map<std::string, const MLValue*>& implicit_inputs,
+                              const std::vector<std::string>& subgraph_output_names,
+                              std::unique_ptr<SubgraphExecutor>& executor);
+
+Status IterateSequence(SubgraphExecutor& executor,
                        std::vector<LoopStateVariable>& loop_state_variables,
                        std::vector<MLValueTensorSlicer<const MLValue>::Iterator>& scan_input_stream_iterators,
                        int64_t seq_length,
                        int num_loop_state_variables,
                        int num_variadic_inputs,
                        int num_variadic_outputs,
-                       std::unordered_map<std::string, const MLValue*>& implicit_inputs,
-                       std::vector<std::string>& subgraph_output_names,
                        std::vector<std::unique_ptr<OutputIterator>>& output_iterators);
 
 MLValue AllocateTensorInMLValue(const MLDataType data_type, const TensorShape& shape, AllocatorPtr& allocator);
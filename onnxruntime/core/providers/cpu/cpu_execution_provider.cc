@@ -6,6 +6,8 @@
 #include "core/framework/kernel_registry.h"
 #include "contrib_ops/contrib_kernels.h"
 #include "core/framework/compute_capability.h"
+#include "core/common/work_stealing_thread_pool.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
@@ -640,4 +642,32 @@ CPUExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph,
 void CPUExecutionProvider::InsertFusedRules(FuseRuleFn rule) {
   fuse_rules_.push_back(rule);
 }
+
+// Number of threads MLAS may use on the calling thread, or 0 to let MLAS use its default threading
+// when called from outside of a session.
+static int32_t MLASCALL GetIntraOpThreadCount() {
+  const IntraOpThreadPoolScope* scope = IntraOpThreadPoolScope::GetCurrent();
+  if (scope == nullptr) {
+    return 0;
+  }
+
+  WorkStealingThreadPool* thread_pool = scope->ThreadPool();
+  return thread_pool ? static_cast<int32_t>(thread_pool->NumThreads()) + 1 : 1;
+}
+
+static void MLASCALL ExecuteOnIntraOpThreadPool(MLAS_THREADED_WORK_ROUTINE* work_routine, void* context,
+                                                int32_t iterations) {
+  WorkStealingThreadPool::TryParallelFor(IntraOpThreadPoolScope::GetCurrent()->ThreadPool(), iterations,
+                                         [work_routine, context](int32_t i) { work_routine(context, i); });
+}
+
+void CPUExecutionProvider::RegisterMlasThreadingCallbacks() {
+  static const bool registered = []() {
+    MLAS_THREADING_CALLBACKS callbacks{GetIntraOpThreadCount, ExecuteOnIntraOpThreadPool};
+    MlasSetThreadingCallbacks(&callbacks);
+    return true;
+  }();
+
+  ORT_UNUSED_PARAMETER(registered);
+}
 }  // namespace onnxruntime
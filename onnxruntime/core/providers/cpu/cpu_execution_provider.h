@@ -12,6 +12,11 @@ namespace onnxruntime {
 // Information needed to construct CPU execution providers.
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
+  // put a ThreadCachingArena in front of the arena
+  bool use_arena_thread_cache{false};
+  // limit of the memory the arena allocates. 0 for no limit.
+  size_t arena_max_bytes{0};
+  ArenaExtendStrategy arena_extend_strategy{ArenaExtendStrategy::kNextPowerOfTwo};
 
   explicit CPUExecutionProviderInfo(bool use_arena)
       : create_arena(use_arena) {}
@@ -24,7 +29,13 @@ using FuseRuleFn = std::function<void(const onnxruntime::GraphViewer&, std::vect
 class CPUExecutionProvider : public IExecutionProvider {
  public:
   explicit CPUExecutionProvider(const CPUExecutionProviderInfo& info) {
+    RegisterMlasThreadingCallbacks();
+
     DeviceAllocatorRegistrationInfo device_info({OrtMemTypeDefault, [](int) { return std::make_unique<CPUAllocator>(); }, std::numeric_limits<size_t>::max()});
+    device_info.use_thread_cache = info.use_arena_thread_cache;
+    device_info.arena_extend_strategy = info.arena_extend_strategy;
+    if (info.arena_max_bytes > 0)
+      device_info.max_mem = info.arena_max_bytes;
 #ifdef USE_JEMALLOC
     ORT_UNUSED_PARAMETER(info);
     //JEMalloc already has memory pool, so just use device allocator.
@@ -65,5 +76,9 @@ class CPUExecutionProvider : public IExecutionProvider {
 
  protected:
   std::vector<FuseRuleFn> fuse_rules_;
+
+ private:
+  // Route MLAS threading through the session's intra-op thread pool. Only the first call has any effect.
+  static void RegisterMlasThreadingCallbacks();
 };
 }  // namespace onnxruntime
@@ -3,8 +3,11 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
@@ -29,11 +32,38 @@ class Gemm : public OpKernel {
     ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override {
+    is_packed = false;
+
+    // MlasSgemm takes a packed B in single precision only
+    const bool is_float = std::is_same<T_X, float>::value && std::is_same<T_W, float>::value &&
+                          std::is_same<T_Y, float>::value;
+    if (!is_float || input_idx != 1 || tensor.Shape().NumDimensions() != 2) {
+      return Status::OK();
+    }
+
+    const size_t K = static_cast<size_t>(trans_B_ == CblasNoTrans ? tensor.Shape()[0] : tensor.Shape()[1]);
+    const size_t N = static_cast<size_t>(trans_B_ == CblasNoTrans ? tensor.Shape()[1] : tensor.Shape()[0]);
+    if (K == 0 || N == 0) {
+      return Status::OK();
+    }
+
+    auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+    packed_w_ = BufferUniquePtr(alloc->Alloc(MlasSgemmPackBSize(N, K)), BufferDeleter(alloc));
+    MlasSgemmPackB(trans_B_, N, K, tensor.template Data<float>(), static_cast<size_t>(tensor.Shape()[1]),
+                   packed_w_.get());
+    packed_w_shape_ = tensor.Shape();
+
+    is_packed = true;
+    return Status::OK();
+  }
+
   Status Compute(OpKernelContext* context) const override {
     const auto X = context->Input<Tensor>(0);
-    const auto W = context->Input<Tensor>(1);
+    const auto W = packed_w_ ? nullptr : context->Input<Tensor>(1);
     const auto B = context->Input<Tensor>(2);
-    GemmHelper helper(X->Shape(), trans_A_ != CblasNoTrans, W->Shape(), trans_B_ != CblasNoTrans, B->Shape());
+    GemmHelper helper(X->Shape(), trans_A_ != CblasNoTrans, packed_w_ ? packed_w_shape_ : W->Shape(),
+                      trans_B_ != CblasNoTrans, B->Shape());
 
     if (!helper.State().IsOK())
       return helper.State();
@@ -95,18 +125,32 @@ class Gemm : public OpKernel {
     }
 
     // W * x
-    math::Gemm<T_X, CPUMathUtil>(
-        trans_A_,
-        trans_B_,
-        M,
-        N,
-        K,
-        alpha_,
-        X->template Data<T_X>(),
-        W->template Data<T_W>(),
-        beta_,
-        y_data,
-        &CPUMathUtil::Instance());
+    if (packed_w_) {
+      MlasSgemm(trans_A_,
+                static_cast<size_t>(M),
+                static_cast<size_t>(N),
+                static_cast<size_t>(K),
+                alpha_,
+                X->template Data<float>(),
+                static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+                packed_w_.get(),
+                beta_,
+                Y->template MutableData<float>(),
+                static_cast<size_t>(N));
+    } else {
+      math::Gemm<T_X, CPUMathUtil>(
+          trans_A_,
+          trans_B_,
+          M,
+          N,
+          K,
+          alpha_,
+          X->template Data<T_X>(),
+          W->template Data<T_W>(),
+          beta_,
+          y_data,
+          &CPUMathUtil::Instance());
+    }
 
     FuseActivation<T_Y>(activation_, y_data, M * N, leaky_relu_alpha_);
 
@@ -119,6 +163,10 @@ class Gemm : public OpKernel {
   float alpha_;
   float beta_;
 
+  // W when it's a constant matrix, packed for MlasSgemm
+  TensorShape packed_w_shape_;
+  BufferUniquePtr packed_w_;
+
 protected:
   // For fused gemm + activation
   std::string activation_;
@@ -3,6 +3,7 @@
 
 #include "core/providers/cpu/math/matmul.h"
 
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "matmul_helper.h"
@@ -16,9 +17,65 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
   KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
   MatMul<float>);
 
+// get the distance between consecutive offsets if it's the same for all of them
+static bool GetUniformStride(const std::vector<size_t>& offsets, size_t& stride) {
+  stride = offsets.size() > 1 ? offsets[1] - offsets[0] : 0;
+  for (size_t i = 2; i < offsets.size(); ++i) {
+    if (offsets[i] - offsets[i - 1] != stride) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+template <>
+Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, bool& is_packed) {
+  is_packed = false;
+
+  // a batch of right matrices is used once each, so there's nothing to gain from packing it
+  if (input_idx != 1 || tensor.Shape().NumDimensions() != 2) {
+    return Status::OK();
+  }
+
+  const size_t K = static_cast<size_t>(tensor.Shape()[0]);
+  const size_t N = static_cast<size_t>(tensor.Shape()[1]);
+  if (K == 0 || N == 0) {
+    return Status::OK();
+  }
+
+  auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+  packed_b_ = BufferUniquePtr(alloc->Alloc(MlasSgemmPackBSize(N, K)), BufferDeleter(alloc));
+  MlasSgemmPackB(CblasNoTrans, N, K, tensor.Data<float>(), N, packed_b_.get());
+  packed_b_shape_ = tensor.Shape();
+
+  is_packed = true;
+  return Status::OK();
+}
+
 template <>
 Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   const Tensor* left_X = ctx->Input<Tensor>(0);
+
+  if (packed_b_) {
+    MatMulComputeHelper helper;
+    ORT_RETURN_IF_ERROR(helper.Compute(left_X->Shape(), packed_b_shape_));
+
+    Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+    // the right matrix is broadcast across the batch, and the left matrices and the output are contiguous, so the
+    // batch is multiplied as one matrix of all their rows
+    const size_t N = static_cast<size_t>(helper.N());
+    const size_t K = static_cast<size_t>(helper.K());
+    const size_t M = static_cast<size_t>(helper.M()) * helper.OutputOffsets().size();
+    if (M != 0) {
+      MlasSgemm(CblasNoTrans, M, N, K, 1.0f, left_X->template Data<float>(), K, packed_b_.get(),
+                0.0f, Y->template MutableData<float>(), N);
+    }
+
+    return Status::OK();
+  }
+
   const Tensor* right_X = ctx->Input<Tensor>(1);
 
   MatMulComputeHelper helper;
@@ -26,19 +83,54 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
 
   Tensor* Y = ctx->Output(0, helper.OutputShape());
 
-  // TODO: replace it with GemmBatch for performance, it's OK for now as GemmBatch unrolls as well
-  for (int i = 0; i < helper.OutputOffsets().size(); i++) {
+  const int M = static_cast<int>(helper.M());
+  const int N = static_cast<int>(helper.N());
+  const int K = static_cast<int>(helper.K());
+  const float* left_data = left_X->template Data<float>();
+  const float* right_data = right_X->template Data<float>();
+  float* output_data = Y->template MutableData<float>();
+
+  // the matrices are usually evenly spaced, with a stride of 0 for an input that's broadcast, so the whole batch is
+  // a single strided batched gemm. that's not the case when both inputs are broadcast in different dims, e.g.
+  // [2,1,M,K] x [1,3,K,N], so those fall back to a gemm per output matrix.
+  size_t left_stride, right_stride, output_stride;
+  if (GetUniformStride(helper.LeftOffsets(), left_stride) &&
+      GetUniformStride(helper.RightOffsets(), right_stride) &&
+      GetUniformStride(helper.OutputOffsets(), output_stride)) {
+    math::GemmStridedBatched<float, CPUMathUtil>(
+        CblasNoTrans,
+        CblasNoTrans,
+        M,
+        N,
+        K,
+        /* alpha */ 1.0f,
+        left_data,
+        K,
+        static_cast<int64_t>(left_stride),
+        right_data,
+        N,
+        static_cast<int64_t>(right_stride),
+        /* beta */ 0.0f,
+        output_data,
+        N,
+        static_cast<int64_t>(output_stride),
+        static_cast<int>(helper.OutputOffsets().size()),
+        &CPUMathUtil::Instance());
+    return Status::OK();
+  }
+
+  for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
     math::Gemm<float, CPUMathUtil>(
         CblasNoTrans,
         CblasNoTrans,
-        static_cast<int>(helper.M()),
-        static_cast<int>(helper.N()),
-        static_cast<int>(helper.K()),
+        M,
+        N,
+        K,
         /* alpha */ 1.0f,
-        left_X->template Data<float>() + helper.LeftOffsets()[i],
-        right_X->template Data<float>() + helper.RightOffsets()[i],
+        left_data + helper.LeftOffsets()[i],
+        right_data + helper.RightOffsets()[i],
         /* beta */ 0.0f,
-        Y->template MutableData<float>() + helper.OutputOffsets()[i],
+        output_data + helper.OutputOffsets()[i],
         &CPUMathUtil::Instance());
   }
 
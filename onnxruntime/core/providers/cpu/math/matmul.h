@@ -15,7 +15,14 @@ class MatMul final : public OpKernel {
       : OpKernel(info) {
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, bool& is_packed) override;
+
   Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // the right input when it's a constant matrix, packed for MlasSgemm
+  TensorShape packed_b_shape_;
+  BufferUniquePtr packed_b_;
 };
 
 }  // namespace onnxruntime
@@ -73,30 +73,35 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
   }
   Tensor* Z = ctx->Output(1, TensorShape({N, output_classes}));
 
-  int64_t zindex = 0;
-  const auto* x_data = X->template Data<T>();
-
   size_t class_count = static_cast<size_t>(class_count_);
-  std::vector<float> scores;
-  scores.reserve(class_count);
+  if (coefficients_.size() != class_count * static_cast<size_t>(stride)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The input has ", stride, " features but there are ",
+                           coefficients_.size(), " coefficients for ", class_count, " classes.");
+  }
+
+  // the scores of every point are computed at once, as intercepts + X * coefficients^T
+  std::vector<float> x_buffer;
+  const float* x_data = input_as_float(X->template Data<T>(), N * stride, x_buffer);
+  std::vector<float> scores(N * class_count, 0.f);
+  if (intercepts_.size() == class_count) {
+    for (int64_t i = 0; i < N; i++) {
+      std::copy(intercepts_.begin(), intercepts_.end(), scores.begin() + i * class_count);
+    }
+  }
+  if (N > 0 && class_count > 0 && stride > 0) {
+    MlasSgemm(CblasNoTrans, CblasTrans, static_cast<size_t>(N), class_count, static_cast<size_t>(stride), 1.f,
+              x_data, static_cast<size_t>(stride), coefficients_.data(), static_cast<size_t>(stride), 1.f,
+              scores.data(), class_count);
+  }
+
   for (int64_t i = 0; i < N; i++)  //for each point
   {
-    scores.clear();
-    size_t current_weight_0 = i * stride;
+    const float* point_scores = scores.data() + i * class_count;
     int maxclass = -1;
     float maxweight = 0.f;
     for (int j = 0; j < class_count; j++)  //for each class
     {
-      size_t current_coeff_0 = j * stride;
-      float weight = 0.f;
-      for (int64_t k = 0; k < stride; k++)  //for each weight
-      {
-        weight += static_cast<float>(x_data[current_weight_0 + k] * coefficients_[current_coeff_0 + k]);
-      }
-      if (intercepts_.size() == class_count) {
-        weight += intercepts_[j];
-      }
-      scores.push_back(weight);
+      float weight = point_scores[j];
       if (weight > maxweight || maxclass == -1) {
         maxweight = weight;
         maxclass = j;
@@ -135,16 +140,23 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
         Y->template MutableData<int64_t>()[i] = classlabels_ints_[maxclass];
       }
     }
-    //write float values
-    if (add_second_class && maxweight > 0) {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, 0);
+  }  //for each point
+
+  //write float values. the top classes are chosen above, before the scores are transformed.
+  POST_EVAL_TRANSFORM post_transform = batch_post_transform(scores.data(), N, class_count_, post_transform_);
+  int64_t zindex = 0;
+  std::vector<float> point_scores;
+  for (int64_t i = 0; i < N; i++) {
+    point_scores.assign(scores.begin() + i * class_count, scores.begin() + (i + 1) * class_count);
+    if (add_second_class && point_scores[0] > 0) {
+      ::onnxruntime::ml::write_scores(point_scores, post_transform, zindex, Z, 0);
     } else if (add_second_class) {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, 1);
+      ::onnxruntime::ml::write_scores(point_scores, post_transform, zindex, Z, 1);
     } else {
-      ::onnxruntime::ml::write_scores(scores, post_transform_, zindex, Z, -1);
+      ::onnxruntime::ml::write_scores(point_scores, post_transform, zindex, Z, -1);
     }
-    zindex += scores.size();
-  }  //for each point
+    zindex += point_scores.size();
+  }
   return Status::OK();
 }
 
@@ -32,28 +32,33 @@ Status LinearRegressor<float>::Compute(OpKernelContext* ctx) const {
   int64_t N = X->Shape().NumDimensions() == 1 ? 1 : X->Shape()[0];
   Tensor* Y = ctx->Output(0, TensorShape({N, targets_}));
   const auto* Xdata = X->template Data<float>();
-  int64_t yindex = 0;
+  if (static_cast<int64_t>(coefficients_.size()) != targets_ * stride) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The input has ", stride, " features but there are ",
+                           coefficients_.size(), " coefficients for ", targets_, " targets.");
+  }
 
+  // the scores of every point are computed at once, as intercepts + X * coefficients^T
+  std::vector<float> scores(N * targets_, 0.f);
   bool useIntercepts = intercepts_.size() == static_cast<size_t>(targets_) ? true : false;
+  if (useIntercepts) {
+    for (int64_t i = 0; i < N; i++) {
+      std::copy(intercepts_.begin(), intercepts_.end(), scores.begin() + i * targets_);
+    }
+  }
+  if (N > 0 && targets_ > 0 && stride > 0) {
+    MlasSgemm(CblasNoTrans, CblasTrans, static_cast<size_t>(N), static_cast<size_t>(targets_),
+              static_cast<size_t>(stride), 1.f, Xdata, static_cast<size_t>(stride), coefficients_.data(),
+              static_cast<size_t>(stride), 1.f, scores.data(), static_cast<size_t>(targets_));
+  }
+
+  POST_EVAL_TRANSFORM post_transform = batch_post_transform(scores.data(), N, targets_, post_transform_);
+  int64_t yindex = 0;
+  std::vector<float> point_scores;
   for (int64_t i = 0; i < N; i++)  //for each point
   {
-    std::vector<float> scores;
-    int64_t current_weight_0 = i * stride;
-    for (int j = 0; j < targets_; j++)  //for each target
-    {
-      int64_t current_coeff_0 = j * stride;
-      float weight = 0.f;
-      for (int64_t k = 0; k < stride; k++)  //for each weight
-      {
-        weight = weight + Xdata[current_weight_0 + k] * coefficients_[current_coeff_0 + k];
-      }
-      if (useIntercepts) {
-        weight = weight + intercepts_[j];
-      }
-      scores.push_back(weight);
-    }
-    ::onnxruntime::ml::write_scores(scores, post_transform_, yindex, Y, -1);
-    yindex += scores.size();
+    point_scores.assign(scores.begin() + i * targets_, scores.begin() + (i + 1) * targets_);
+    ::onnxruntime::ml::write_scores(point_scores, post_transform, yindex, Y, -1);
+    yindex += point_scores.size();
   }
   return Status::OK();
 }
@@ -4,6 +4,7 @@
 #pragma once
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -236,48 +237,74 @@ static inline float sigmoid_probability(float score, float proba, float probb) {
 
 static const float ml_sqrt2 = 1.41421356f;
 
+static inline void compute_softmax(float* values, int64_t count) {
+  MlasComputeSoftmax(values, values, 1, static_cast<size_t>(count), false);
+}
+
 static inline void compute_softmax(std::vector<float>& values) {
-  std::vector<float> newscores;
+  compute_softmax(values.data(), static_cast<int64_t>(values.size()));
+}
+
+//this function skips zero values (since exp(0) is non zero)
+static inline void compute_softmax_zero(float* values, int64_t count) {
   // compute exp with negative number to be numerically stable
   float v_max = -std::numeric_limits<float>::max();
-  for (float value : values) {
-    if (value > v_max)
-      v_max = value;
+  for (int64_t k = 0; k < count; k++) {
+    if (values[k] > v_max)
+      v_max = values[k];
   }
+  float exp_neg_v_max = std::exp(-v_max);
   float this_sum = 0.f;
-  for (float value : values) {
-    float val2 = std::exp(value - v_max);
-    this_sum += val2;
-    newscores.push_back(val2);
+  for (int64_t k = 0; k < count; k++) {
+    if (values[k] > 0.0000001f || values[k] < -0.0000001f) {
+      values[k] = std::exp(values[k] - v_max);
+      this_sum += values[k];
+    } else {
+      values[k] *= exp_neg_v_max;
+    }
   }
-  for (int64_t k = 0; k < static_cast<int64_t>(values.size()); k++) {
-    values[k] = newscores[k] / this_sum;
+  for (int64_t k = 0; k < count; k++) {
+    values[k] /= this_sum;
   }
 }
 
-//this function skips zero values (since exp(0) is non zero)
 static inline void compute_softmax_zero(std::vector<float>& values) {
-  std::vector<float> newscores;
-  // compute exp with negative number to be numerically stable
-  float v_max = -std::numeric_limits<float>::max();
-  for (float value : values) {
-    if (value > v_max)
-      v_max = value;
+  compute_softmax_zero(values.data(), static_cast<int64_t>(values.size()));
+}
+
+// Applies the post transform of N rows of row_size scores to the whole batch when the rows have two or more scores,
+// and returns the transform that write_scores still has to apply to each row.
+static inline POST_EVAL_TRANSFORM batch_post_transform(float* scores, int64_t N, int64_t row_size,
+                                                       POST_EVAL_TRANSFORM post_transform) {
+  if (row_size < 2) {
+    return post_transform;
   }
-  float exp_neg_v_max = std::exp(-v_max);
-  float this_sum = 0.f;
-  for (float value : values) {
-    if (value > 0.0000001f || value < -0.0000001f) {
-      float val2 = std::exp(value - v_max);
-      this_sum += val2;
-      newscores.push_back(val2);
-    } else {
-      newscores.push_back(value * exp_neg_v_max);
+  if (post_transform == POST_EVAL_TRANSFORM::LOGISTIC) {
+    MlasComputeLogistic(scores, scores, static_cast<size_t>(N * row_size));
+  } else if (post_transform == POST_EVAL_TRANSFORM::SOFTMAX) {
+    MlasComputeSoftmax(scores, scores, static_cast<size_t>(N), static_cast<size_t>(row_size), false);
+  } else if (post_transform == POST_EVAL_TRANSFORM::SOFTMAX_ZERO) {
+    for (int64_t i = 0; i < N; i++) {
+      compute_softmax_zero(scores + i * row_size, row_size);
     }
+  } else {
+    return post_transform;
   }
-  for (int64_t k = 0; k < static_cast<int64_t>(values.size()); k++) {
-    values[k] = newscores[k] / this_sum;
+  return POST_EVAL_TRANSFORM::NONE;
+}
+
+// Returns the count values of x_data as floats, converting them into buffer when they aren't floats already.
+template <typename T>
+static inline const float* input_as_float(const T* x_data, int64_t count, std::vector<float>& buffer) {
+  buffer.resize(static_cast<size_t>(count));
+  for (int64_t i = 0; i < count; i++) {
+    buffer[i] = static_cast<float>(x_data[i]);
   }
+  return buffer.data();
+}
+
+static inline const float* input_as_float(const float* x_data, int64_t /*count*/, std::vector<float>& /*buffer*/) {
+  return x_data;
 }
 
 static inline void write_scores(std::vector<float>& scores, POST_EVAL_TRANSFORM post_transform, int64_t write_index, Tensor* Z, int add_second_class) {
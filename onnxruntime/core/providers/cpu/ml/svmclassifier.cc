@@ -73,6 +73,29 @@ SVMClassifier<T>::SVMClassifier(const OpKernelInfo& info)
       break;
     }
   }
+
+  if (mode_ == SVM_TYPE::SVM_SVC) {
+    int64_t pair_count = class_count_ * (class_count_ - 1) / 2;
+    ORT_ENFORCE(static_cast<int64_t>(vectors_per_class_.size()) >= class_count_);
+    ORT_ENFORCE(static_cast<int64_t>(rho_.size()) >= pair_count);
+    ORT_ENFORCE(static_cast<int64_t>(coefficients_.size()) >= vector_count_ * (class_count_ - 1));
+    pair_coefficients_.resize(pair_count * vector_count_, 0.f);
+    int64_t evals = 0;
+    for (int64_t i = 0; i < class_count_; i++) {        //for each class
+      for (int64_t j = i + 1; j < class_count_; j++) {  //for each class
+        float* pair_coefficients = pair_coefficients_.data() + evals * vector_count_;
+        int64_t pos1 = (vector_count_) * (j - 1);
+        int64_t pos2 = (vector_count_) * (i);
+        for (int64_t m = 0; m < vectors_per_class_[i]; m++) {
+          pair_coefficients[starting_vector_[i] + m] = coefficients_[pos1 + starting_vector_[i] + m];
+        }
+        for (int64_t m = 0; m < vectors_per_class_[j]; m++) {
+          pair_coefficients[starting_vector_[j] + m] = coefficients_[pos2 + starting_vector_[j] + m];
+        }
+        evals++;
+      }
+    }
+  }
 }
 
 template <typename T>
@@ -92,53 +115,58 @@ Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
     dims = {static_cast<int64_t>(N), static_cast<int64_t>(class_count_)};
   Z = ctx->Output(1, TensorShape(dims));
 
-  const auto* x_data = X->template Data<T>();
+  if (stride < feature_count_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The input has ", stride, " features but the model uses ",
+                           feature_count_);
+  }
+
+  std::vector<float> x_buffer;
+  const float* x_data = input_as_float(X->template Data<T>(), N * stride, x_buffer);
+
+  // the decision values of every example are computed at once. a SVC computes the kernel of each example with
+  // each support vector, and the decision value of each pair of classes from those.
+  int64_t score_count = mode_ == SVM_TYPE::SVM_SVC ? class_count_ * (class_count_ - 1) / 2 : class_count_;
+  std::vector<float> batch_scores(N * score_count);
+  if (mode_ == SVM_TYPE::SVM_SVC) {
+    std::vector<float> kernels(N * vector_count_);
+    batched_kernel_dot(x_data, N, stride, support_vectors_, vector_count_, feature_count_, get_kernel_type(),
+                       kernels.data());
+    for (int64_t n = 0; n < N; n++) {
+      std::copy(rho_.begin(), rho_.begin() + score_count, batch_scores.begin() + n * score_count);
+    }
+    if (N > 0 && score_count > 0 && vector_count_ > 0) {
+      MlasSgemm(CblasNoTrans, CblasTrans, static_cast<size_t>(N), static_cast<size_t>(score_count),
+                static_cast<size_t>(vector_count_), 1.f, kernels.data(), static_cast<size_t>(vector_count_),
+                pair_coefficients_.data(), static_cast<size_t>(vector_count_), 1.f, batch_scores.data(),
+                static_cast<size_t>(score_count));
+    }
+  } else if (mode_ == SVM_TYPE::SVM_LINEAR) {  //liblinear
+    batched_kernel_dot(x_data, N, stride, coefficients_, class_count_, feature_count_, get_kernel_type(),
+                       batch_scores.data());
+    for (auto& score : batch_scores) {
+      score += rho_[0];
+    }
+  }
+
   int64_t zindex = 0;
+  std::vector<float> scores;
+  std::vector<int64_t> votes;
+  std::vector<float> estimates;
+  std::vector<float> probsp2;
 
   for (int64_t n = 0; n < N; n++)  //for each example
   {
-    int64_t current_weight_0 = n * stride;
     int64_t maxclass = -1;
     double maxweight = 0.f;
-    std::vector<float> decisions;
-    std::vector<float> scores;
-    std::vector<float> kernels;
-    std::vector<int64_t> votes;
+    scores.assign(batch_scores.begin() + n * score_count, batch_scores.begin() + (n + 1) * score_count);
+    votes.clear();
 
     if (mode_ == SVM_TYPE::SVM_SVC) {
-      for (int64_t j = 0; j < vector_count_; j++) {
-        float val = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j, feature_count_, get_kernel_type());
-        kernels.push_back(val);
-      }
-      for (int64_t j = 0; j < class_count_; j++) {
-        votes.push_back(0);
-      }
+      votes.resize(class_count_, 0);
       int evals = 0;
       for (int64_t i = 0; i < class_count_; i++) {        //for each class
         for (int64_t j = i + 1; j < class_count_; j++) {  //for each class
-          float sum = 0;
-          int64_t start_index_i = starting_vector_[i];  // *feature_count_;
-          int64_t start_index_j = starting_vector_[j];  // *feature_count_;
-
-          int64_t class_i_support_count = vectors_per_class_[i];
-          int64_t class_j_support_count = vectors_per_class_[j];
-
-          int64_t pos1 = (vector_count_) * (j - 1);
-          int64_t pos2 = (vector_count_) * (i);
-          for (int64_t m = 0; m < class_i_support_count; m++) {
-            float val1 = coefficients_[pos1 + start_index_i + m];
-            float val2 = kernels[start_index_i + m];
-            sum += val1 * val2;
-          }
-          for (int64_t m = 0; m < class_j_support_count; m++) {
-            float val1 = coefficients_[pos2 + start_index_j + m];
-            float val2 = kernels[start_index_j + m];
-            sum += val1 * val2;
-          }
-
-          sum += rho_[evals];
-          scores.push_back(sum);
-          if (sum > 0) {
+          if (scores[evals] > 0) {
             votes[i]++;
           } else {
             votes[j]++;
@@ -146,24 +174,11 @@ Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
           evals++;  //index into rho
         }
       }
-    } else if (mode_ == SVM_TYPE::SVM_LINEAR) {     //liblinear
-      for (int64_t j = 0; j < class_count_; j++) {  //for each class
-        float val = kernel_dot(x_data, current_weight_0, coefficients_, feature_count_ * j, feature_count_, get_kernel_type());
-        val += rho_[0];
-        scores.push_back(val);
-      }
     }
     if (proba_.size() > 0 && mode_ == SVM_TYPE::SVM_SVC) {
       //compute probabilities from the scores
-      std::vector<float> estimates;
-      std::vector<float> probsp2;
-      int64_t num = class_count_ * class_count_;
-      for (int64_t m = 0; m < num; m++) {
-        probsp2.push_back(0.f);  //min prob
-      }
-      for (int64_t m = 0; m < class_count_; m++) {
-        estimates.push_back(0.f);  //min prob
-      }
+      probsp2.assign(class_count_ * class_count_, 0.f);  //min prob
+      estimates.assign(class_count_, 0.f);               //min prob
       int64_t index = 0;
       for (int64_t i = 0; i < class_count_; i++) {
         for (int64_t j = i + 1; j < class_count_; j++) {
@@ -176,10 +191,7 @@ Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
       }
       multiclass_probability(class_count_, probsp2, estimates);
       //copy probabilities back into scores
-      scores.resize(estimates.size());
-      for (int64_t k = 0; k < static_cast<int64_t>(estimates.size()); k++) {
-        scores[k] = estimates[k];
-      }
+      scores.assign(estimates.begin(), estimates.end());
     }
     int64_t maxvotes = 0;
     if (votes.size() > 0) {
@@ -29,32 +29,55 @@ class SVMCommon {
   void set_kernel_type(KERNEL new_kernel_type) { kernel_type_ = new_kernel_type; }
   KERNEL get_kernel_type() const { return kernel_type_; }
 
-  float kernel_dot(const T* A, int64_t a, const std::vector<float>& B, int64_t b, int64_t len, KERNEL k) const {
-    float sum = 0.f;
+  // Computes the kernel of each of the N rows of x, which start stride apart, with each of the count vectors of len
+  // values in b, into the N x count matrix out. The dot products of all the rows are a single GEMM. The RBF distances
+  // are summed directly, because |x|^2 - 2 x.b + |b|^2 cancels badly for nearby points far from the origin.
+  void batched_kernel_dot(const float* x, int64_t N, int64_t stride, const std::vector<float>& b, int64_t count,
+                          int64_t len, KERNEL k, float* out) const {
+    const int64_t size = N * count;
+    if (size == 0) {
+      return;
+    }
+
+    if (k == KERNEL::RBF) {
+      // a block of rows is walked through each vector, so the vectors are read from memory once per block
+      const int64_t row_block_size = 16;
+      for (int64_t row_begin = 0; row_begin < N; row_begin += row_block_size) {
+        const int64_t row_end = std::min(N, row_begin + row_block_size);
+        for (int64_t j = 0; j < count; j++) {
+          const float* v = b.data() + j * len;
+          for (int64_t n = row_begin; n < row_end; n++) {
+            const float* row = x + n * stride;
+            float sum = 0.f;
+            for (int64_t i = 0; i < len; i++) {
+              const float diff = row[i] - v[i];
+              sum += diff * diff;
+            }
+            out[n * count + j] = std::exp(-gamma_ * sum);
+          }
+        }
+      }
+      return;
+    }
+
+    if (len > 0) {
+      MlasSgemm(CblasNoTrans, CblasTrans, static_cast<size_t>(N), static_cast<size_t>(count),
+                static_cast<size_t>(len), 1.f, x, static_cast<size_t>(stride), b.data(),
+                static_cast<size_t>(len), 0.f, out, static_cast<size_t>(count));
+    } else {
+      std::fill_n(out, size, 0.f);
+    }
+
     if (k == KERNEL::POLY) {
-      for (int64_t i = 0; i < len; i++) {
-        sum += B[b + i] * static_cast<float>(A[a + i]);
+      for (int64_t i = 0; i < size; i++) {
+        out[i] = std::pow(gamma_ * out[i] + coef0_, degree_);
       }
-      sum = gamma_ * sum + coef0_;
-      sum = std::pow(sum, degree_);
     } else if (k == KERNEL::SIGMOID) {
-      for (int64_t i = 0; i < len; i++) {
-        sum += B[b + i] * static_cast<float>(A[a + i]);
-      }
-      sum = gamma_ * sum + coef0_;
-      sum = std::tanh(sum);
-    } else if (k == KERNEL::RBF) {
-      for (int64_t i = 0; i < len; i++) {
-        float val = static_cast<float>(A[a + i]) - B[b + i];
-        sum += (val * val);
-      }
-      sum = std::exp(-gamma_ * sum);
-    } else if (k == KERNEL::LINEAR) {
-      for (int64_t i = 0; i < len; i++) {
-        sum += B[b + i] * static_cast<float>(A[a + i]);
+      for (int64_t i = 0; i < size; i++) {
+        out[i] = gamma_ * out[i] + coef0_;
       }
+      MlasComputeTanh(out, out, static_cast<size_t>(size));
     }
-    return sum;
   }
 
  private:
@@ -66,7 +89,7 @@ class SVMCommon {
 
 template <typename T>
 class SVMClassifier final : public OpKernel, private SVMCommon<T> {
-  using SVMCommon<T>::kernel_dot;
+  using SVMCommon<T>::batched_kernel_dot;
   using SVMCommon<T>::set_kernel_type;
   using SVMCommon<T>::get_kernel_type;
 
@@ -89,6 +112,9 @@ class SVMClassifier final : public OpKernel, private SVMCommon<T> {
   std::vector<float> support_vectors_;
   std::vector<int64_t> classlabels_ints_;
   std::vector<std::string> classlabels_strings_;
+  // the coefficients of each pair of classes, with a column for every support vector, so the decision values of a
+  // batch are a single GEMM of the kernel values
+  std::vector<float> pair_coefficients_;
   POST_EVAL_TRANSFORM post_transform_;
   SVM_TYPE mode_;  //how are we computing SVM? 0=LibSVC, 1=LibLinear
 };
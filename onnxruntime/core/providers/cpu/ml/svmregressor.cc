@@ -27,6 +27,7 @@ SVMRegressor<T>::SVMRegressor(const OpKernelInfo& info)
   one_class_ = (onec != 0);
 
   if (vector_count_ > 0) {
+    ORT_ENFORCE(static_cast<int64_t>(coefficients_.size()) >= vector_count_);
     feature_count_ = support_vectors_.size() / vector_count_;  //length of each support vector
     mode_ = SVM_TYPE::SVM_SVC;
   } else {
@@ -45,24 +46,32 @@ Status SVMRegressor<T>::Compute(OpKernelContext* ctx) const {
 
   Tensor* Y = ctx->Output(0, TensorShape({N, 1}));  // this op outputs for one target only
   const auto* x_data = X->template Data<T>();
+  if (stride < feature_count_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The input has ", stride, " features but the model uses ",
+                           feature_count_);
+  }
 
-  for (int64_t n = 0; n < N; n++) {  //for each example
-    int64_t current_weight_0 = n * stride;
-    std::vector<float> scores;
-
-    float sum = 0.f;
-    if (mode_ == SVM_TYPE::SVM_SVC) {
-      for (int64_t j = 0; j < vector_count_; j++) {
-        float val1 = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j, feature_count_, get_kernel_type());
-        float val2 = coefficients_[j];
-        float val3 = val1 * val2;
-        sum += val3;
-      }
-      sum += rho_[0];
-    } else if (mode_ == SVM_TYPE::SVM_LINEAR) {  //liblinear
-      sum = kernel_dot(x_data, current_weight_0, coefficients_, 0, feature_count_, get_kernel_type());
-      sum += rho_[0];
+  // the value of every example is computed at once
+  std::vector<float> sums(N, rho_[0]);
+  if (mode_ == SVM_TYPE::SVM_SVC) {
+    // sum = rho + kernels * coefficients
+    std::vector<float> kernels(N * vector_count_);
+    batched_kernel_dot(x_data, N, stride, support_vectors_, vector_count_, feature_count_, get_kernel_type(),
+                       kernels.data());
+    if (N > 0) {
+      MlasSgemm(CblasNoTrans, CblasNoTrans, static_cast<size_t>(N), 1, static_cast<size_t>(vector_count_), 1.f,
+                kernels.data(), static_cast<size_t>(vector_count_), coefficients_.data(), 1, 1.f, sums.data(), 1);
+    }
+  } else if (mode_ == SVM_TYPE::SVM_LINEAR) {  //liblinear
+    std::vector<float> dots(N);
+    batched_kernel_dot(x_data, N, stride, coefficients_, 1, feature_count_, get_kernel_type(), dots.data());
+    for (int64_t n = 0; n < N; n++) {
+      sums[n] += dots[n];
     }
+  }
+
+  for (int64_t n = 0; n < N; n++) {  //for each example
+    float sum = sums[n];
     if (one_class_ && sum > 0) {
       Y->template MutableData<float>()[n] = 1.f;
     } else if (one_class_) {
@@ -0,0 +1,154 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/ml/tree_ensemble_common.h"
+
+#include <limits>
+
+namespace onnxruntime {
+namespace ml {
+
+const int64_t TreeEnsemble::kMaxTreeDepth;
+const int64_t TreeEnsemble::kRowBlockSize;
+const int64_t TreeEnsemble::kMaxRowsTogetherDepth;
+const int64_t TreeEnsemble::kParallelTreeEvaluations;
+
+TreeEnsemble::TreeEnsemble(const std::vector<int64_t>& nodes_treeids,
+                           const std::vector<int64_t>& nodes_nodeids,
+                           const std::vector<int64_t>& nodes_featureids,
+                           const std::vector<float>& nodes_values,
+                           const std::vector<NODE_MODE>& nodes_modes,
+                           const std::vector<int64_t>& nodes_truenodeids,
+                           const std::vector<int64_t>& nodes_falsenodeids,
+                           const std::vector<int64_t>& missing_tracks_true,
+                           const std::vector<int64_t>& weights_treeids,
+                           const std::vector<int64_t>& weights_nodeids,
+                           const std::vector<int64_t>& weights_ids,
+                           const std::vector<float>& weights_values)
+    : modes_(nodes_modes), feature_ids_(nodes_featureids), values_(nodes_values) {
+  const size_t num_nodes = nodes_treeids.size();
+  ORT_ENFORCE(num_nodes < std::numeric_limits<uint32_t>::max(), "Too many tree nodes: ", num_nodes);
+  ORT_ENFORCE(weights_treeids.size() == weights_nodeids.size() &&
+              weights_treeids.size() == weights_ids.size() &&
+              weights_treeids.size() == weights_values.size());
+
+  // the flags only apply when there is one for every node
+  missing_tracks_true_.resize(num_nodes, 0);
+  if (missing_tracks_true.size() == num_nodes) {
+    for (size_t i = 0; i < num_nodes; ++i) {
+      missing_tracks_true_[i] = missing_tracks_true[i] != 0 ? 1 : 0;
+    }
+  }
+
+  // index the nodes by tree and node id
+  const int64_t kOffset = 4000000000L;
+  std::unordered_map<int64_t, size_t> indices;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    indices.insert({nodes_treeids[i] * kOffset + nodes_nodeids[i], i});
+  }
+
+  auto find_node = [&](int64_t treeid, int64_t nodeid) {
+    auto it = indices.find(treeid * kOffset + nodeid);
+    return it != indices.end() ? static_cast<int64_t>(it->second) : -1;
+  };
+
+  // link the children, and find the roots, which are the nodes that aren't the child of another node. a leaf is
+  // its own child and reads feature 0, so walking past a leaf stays on it.
+  true_children_.resize(num_nodes, 0);
+  false_children_.resize(num_nodes, 0);
+  std::vector<bool> has_parent(num_nodes, false);
+  bool has_branches = false;
+  bool same_branch_modes = true;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    if (modes_[i] == NODE_MODE::LEAF) {
+      true_children_[i] = static_cast<uint32_t>(i);
+      false_children_[i] = static_cast<uint32_t>(i);
+      feature_ids_[i] = 0;
+      continue;
+    }
+    if (!has_branches) {
+      branch_mode_ = modes_[i];
+      has_branches = true;
+    }
+    same_branch_modes = same_branch_modes && modes_[i] == branch_mode_;
+    int64_t true_child = find_node(nodes_treeids[i], nodes_truenodeids[i]);
+    int64_t false_child = find_node(nodes_treeids[i], nodes_falsenodeids[i]);
+    ORT_ENFORCE(true_child >= 0 && false_child >= 0, "Invalid child node for node ", nodes_nodeids[i],
+                " of tree ", nodes_treeids[i]);
+    ORT_ENFORCE(feature_ids_[i] >= 0, "Invalid feature id for node ", nodes_nodeids[i], " of tree ",
+                nodes_treeids[i]);
+    true_children_[i] = static_cast<uint32_t>(true_child);
+    false_children_[i] = static_cast<uint32_t>(false_child);
+    has_parent[true_child] = true;
+    has_parent[false_child] = true;
+    max_feature_id_ = std::max(max_feature_id_, feature_ids_[i]);
+  }
+
+  for (size_t i = 0; i < num_nodes; ++i) {
+    if (!has_parent[i]) {
+      roots_.push_back(i);
+    }
+  }
+
+  // shallow trees that all branch the same way are walked a block of rows at a time, with every row taking the
+  // same number of steps so the loop over the rows has no branches. the depth of each tree is the largest number
+  // of branches from its root to a leaf. the search walks paths rather than nodes, so it gives up as soon as a
+  // tree is too deep for the block walk; nodes shared between branches would otherwise make it exponential.
+  walk_rows_together_ = same_branch_modes;
+  std::vector<std::pair<size_t, int64_t>> pending;
+  for (size_t t = 0; t < roots_.size() && walk_rows_together_; ++t) {
+    int64_t depth = 0;
+    pending.clear();
+    pending.emplace_back(roots_[t], 0);
+    while (!pending.empty()) {
+      size_t node = pending.back().first;
+      int64_t node_depth = pending.back().second;
+      pending.pop_back();
+      if (node_depth > kMaxRowsTogetherDepth) {
+        walk_rows_together_ = false;
+        break;
+      }
+      depth = std::max(depth, node_depth);
+      if (modes_[node] != NODE_MODE::LEAF) {
+        pending.emplace_back(true_children_[node], node_depth + 1);
+        pending.emplace_back(false_children_[node], node_depth + 1);
+      }
+    }
+    tree_depths_.push_back(depth);
+  }
+
+  if (!walk_rows_together_) {
+    tree_depths_.clear();
+  }
+
+  // group the weights by node, keeping the order of the weights of each node. weights for nodes that don't
+  // exist are never reached so they're dropped.
+  std::vector<int64_t> weight_nodes(weights_treeids.size());
+  weights_begin_.resize(num_nodes + 1, 0);
+  for (size_t i = 0; i < weights_treeids.size(); ++i) {
+    ORT_ENFORCE(weights_ids[i] >= 0, "Invalid weight id ", weights_ids[i]);
+    weight_nodes[i] = find_node(weights_treeids[i], weights_nodeids[i]);
+    if (weight_nodes[i] >= 0) {
+      ++weights_begin_[weight_nodes[i] + 1];
+    }
+  }
+
+  for (size_t i = 0; i < num_nodes; ++i) {
+    weights_begin_[i + 1] += weights_begin_[i];
+  }
+
+  weight_ids_.resize(weights_begin_[num_nodes]);
+  weight_values_.resize(weights_begin_[num_nodes]);
+  std::vector<size_t> next(weights_begin_.begin(), weights_begin_.end() - 1);
+  for (size_t i = 0; i < weights_treeids.size(); ++i) {
+    if (weight_nodes[i] >= 0) {
+      size_t position = next[weight_nodes[i]]++;
+      weight_ids_[position] = weights_ids[i];
+      weight_values_[position] = weights_values[i];
+      num_scores_ = std::max(num_scores_, weights_ids[i] + 1);
+    }
+  }
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
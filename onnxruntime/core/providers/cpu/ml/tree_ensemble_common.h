@@ -0,0 +1,304 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/common/common.h"
+#include "core/common/work_stealing_thread_pool.h"
+#include "ml_common.h"
+
+namespace onnxruntime {
+namespace ml {
+
+/**
+The trees of a TreeEnsembleClassifier or TreeEnsembleRegressor, compiled into flat arrays when the kernel is
+created. The nodes keep the order of the nodes_* attributes, the children of a node are stored as node indices,
+and the leaf weights of each node are stored next to each other, so walking a tree and adding up its leaf weights
+needs no lookups.
+
+Each weight has an id, which is the class id of a classifier or the target id of a regressor. A row's scores are
+a dense array with one entry per id, plus a flag per id that is set when a leaf added a weight for that id.
+*/
+class TreeEnsemble {
+ public:
+  // The node ids and the weight node ids are relative to the first node of each tree.
+  TreeEnsemble(const std::vector<int64_t>& nodes_treeids,
+               const std::vector<int64_t>& nodes_nodeids,
+               const std::vector<int64_t>& nodes_featureids,
+               const std::vector<float>& nodes_values,
+               const std::vector<NODE_MODE>& nodes_modes,
+               const std::vector<int64_t>& nodes_truenodeids,
+               const std::vector<int64_t>& nodes_falsenodeids,
+               const std::vector<int64_t>& missing_tracks_true,
+               const std::vector<int64_t>& weights_treeids,
+               const std::vector<int64_t>& weights_nodeids,
+               const std::vector<int64_t>& weights_ids,
+               const std::vector<float>& weights_values);
+
+  size_t NumTrees() const { return roots_.size(); }
+
+  // Number of score entries needed for each row, which is one more than the largest weight id.
+  int64_t NumScores() const { return num_scores_; }
+
+  /**
+  Adds the leaf weights reached by N rows of stride features to scores and sets the matching has_score flags.
+  scores and has_score hold num_scores entries per row, with num_scores >= NumScores(), and are initialized by the
+  caller. The rows, or the trees when there are too few rows, are split across thread_pool if it is not null.
+  */
+  template <typename T>
+  Status ComputeScores(const T* x_data, int64_t N, int64_t stride, int64_t num_scores,
+                       float* scores, uint8_t* has_score, WorkStealingThreadPool* thread_pool) const;
+
+ private:
+  template <typename T>
+  size_t FindLeaf(const T* x_row, size_t root) const;
+
+  template <typename T>
+  void AddLeafWeights(const T* x_data, int64_t row_begin, int64_t row_end, int64_t stride,
+                      size_t tree_begin, size_t tree_end, int64_t num_scores,
+                      float* scores, uint8_t* has_score) const;
+
+  template <typename T, NODE_MODE Mode>
+  void AddLeafWeightsRowsTogether(const T* x_data, int64_t row_begin, int64_t row_end, int64_t stride,
+                                  size_t tree_begin, size_t tree_end, int64_t num_scores,
+                                  float* scores, uint8_t* has_score) const;
+
+  template <typename T>
+  void AddTreeWeights(const T* x_data, int64_t row_begin, int64_t row_end, int64_t stride,
+                      size_t tree_begin, size_t tree_end, int64_t num_scores,
+                      float* scores, uint8_t* has_score) const;
+
+  // the nodes, as parallel arrays indexed by node
+  std::vector<NODE_MODE> modes_;
+  std::vector<int64_t> feature_ids_;
+  std::vector<float> values_;
+  std::vector<uint8_t> missing_tracks_true_;
+  std::vector<uint32_t> true_children_;
+  std::vector<uint32_t> false_children_;
+
+  // the leaf weights of node i are [weights_begin_[i], weights_begin_[i + 1])
+  std::vector<size_t> weights_begin_;
+  std::vector<int64_t> weight_ids_;
+  std::vector<float> weight_values_;
+
+  std::vector<size_t> roots_;
+  std::vector<int64_t> tree_depths_;
+  int64_t num_scores_ = 0;
+  int64_t max_feature_id_ = -1;
+
+  // the mode of the branch nodes when walk_rows_together_ is set
+  NODE_MODE branch_mode_ = NODE_MODE::BRANCH_LEQ;
+  bool walk_rows_together_ = false;
+
+  // a walk stops after this many branches even if it hasn't reached a leaf
+  static const int64_t kMaxTreeDepth = 1000;
+  // rows are evaluated in blocks so the nodes of a tree stay in the cache while the block is walked through it
+  static const int64_t kRowBlockSize = 16;
+  // the deepest trees that are walked a block of rows at a time
+  static const int64_t kMaxRowsTogetherDepth = 8;
+  // the number of trees to evaluate before it's worth splitting the work across threads
+  static const int64_t kParallelTreeEvaluations = 4096;
+};
+
+template <NODE_MODE Mode, typename T>
+inline bool TreeNodeTest(T val, float threshold) {
+  switch (Mode) {
+    case NODE_MODE::BRANCH_LEQ:
+      return val <= threshold;
+    case NODE_MODE::BRANCH_LT:
+      return val < threshold;
+    case NODE_MODE::BRANCH_GTE:
+      return val >= threshold;
+    case NODE_MODE::BRANCH_GT:
+      return val > threshold;
+    case NODE_MODE::BRANCH_EQ:
+      return val == threshold;
+    default:
+      return val != threshold;
+  }
+}
+
+template <typename T>
+size_t TreeEnsemble::FindLeaf(const T* x_row, size_t index) const {
+  for (int64_t depth = 0; modes_[index] != NODE_MODE::LEAF && depth <= kMaxTreeDepth; ++depth) {
+    const T val = x_row[feature_ids_[index]];
+    const float threshold = values_[index];
+    bool result;
+    switch (modes_[index]) {
+      case NODE_MODE::BRANCH_LEQ:
+        result = TreeNodeTest<NODE_MODE::BRANCH_LEQ>(val, threshold);
+        break;
+      case NODE_MODE::BRANCH_LT:
+        result = TreeNodeTest<NODE_MODE::BRANCH_LT>(val, threshold);
+        break;
+      case NODE_MODE::BRANCH_GTE:
+        result = TreeNodeTest<NODE_MODE::BRANCH_GTE>(val, threshold);
+        break;
+      case NODE_MODE::BRANCH_GT:
+        result = TreeNodeTest<NODE_MODE::BRANCH_GT>(val, threshold);
+        break;
+      case NODE_MODE::BRANCH_EQ:
+        result = TreeNodeTest<NODE_MODE::BRANCH_EQ>(val, threshold);
+        break;
+      default:
+        result = TreeNodeTest<NODE_MODE::BRANCH_NEQ>(val, threshold);
+        break;
+    }
+    if (!result && missing_tracks_true_[index]) {
+      result = std::isnan(static_cast<float>(val));
+    }
+    index = result ? true_children_[index] : false_children_[index];
+  }
+  return index;
+}
+
+template <typename T>
+void TreeEnsemble::AddLeafWeights(const T* x_data, int64_t row_begin, int64_t row_end, int64_t stride,
+                                  size_t tree_begin, size_t tree_end, int64_t num_scores,
+                                  float* scores, uint8_t* has_score) const {
+  for (int64_t block_begin = row_begin; block_begin < row_end; block_begin += kRowBlockSize) {
+    const int64_t block_end = std::min(row_end, block_begin + kRowBlockSize);
+    for (size_t tree = tree_begin; tree < tree_end; ++tree) {
+      const size_t root = roots_[tree];
+      for (int64_t row = block_begin; row < block_end; ++row) {
+        const size_t leaf = FindLeaf(x_data + row * stride, root);
+        float* row_scores = scores + row * num_scores;
+        uint8_t* row_has_score = has_score + row * num_scores;
+        for (size_t w = weights_begin_[leaf], end = weights_begin_[leaf + 1]; w < end; ++w) {
+          row_scores[weight_ids_[w]] += weight_values_[w];
+          row_has_score[weight_ids_[w]] = 1;
+        }
+      }
+    }
+  }
+}
+
+// Walks a block of rows through each tree together. Every row takes as many steps as the tree is deep, staying on
+// its leaf once it gets there, so the steps of the rows are independent and have no branches.
+template <typename T, NODE_MODE Mode>
+void TreeEnsemble::AddLeafWeightsRowsTogether(const T* x_data, int64_t row_begin, int64_t row_end, int64_t stride,
+                                              size_t tree_begin, size_t tree_end, int64_t num_scores,
+                                              float* scores, uint8_t* has_score) const {
+  const int64_t* feature_ids = feature_ids_.data();
+  const float* values = values_.data();
+  const uint8_t* missing_tracks_true = missing_tracks_true_.data();
+  const uint32_t* true_children = true_children_.data();
+  const uint32_t* false_children = false_children_.data();
+  uint32_t indices[kRowBlockSize];
+
+  for (int64_t block_begin = row_begin; block_begin < row_end; block_begin += kRowBlockSize) {
+    const int64_t block_size = std::min(row_end - block_begin, kRowBlockSize);
+    const T* x_block = x_data + block_begin * stride;
+    for (size_t tree = tree_begin; tree < tree_end; ++tree) {
+      std::fill_n(indices, block_size, static_cast<uint32_t>(roots_[tree]));
+      for (int64_t depth = 0; depth < tree_depths_[tree]; ++depth) {
+        for (int64_t row = 0; row < block_size; ++row) {
+          const uint32_t index = indices[row];
+          const T val = x_block[row * stride + feature_ids[index]];
+          const bool result = TreeNodeTest<Mode>(val, values[index]) |
+                              (missing_tracks_true[index] & std::isnan(static_cast<float>(val)));
+          indices[row] = result ? true_children[index] : false_children[index];
+        }
+      }
+      for (int64_t row = 0; row < block_size; ++row) {
+        float* row_scores = scores + (block_begin + row) * num_scores;
+        uint8_t* row_has_score = has_score + (block_begin + row) * num_scores;
+        for (size_t w = weights_begin_[indices[row]], end = weights_begin_[indices[row] + 1]; w < end; ++w) {
+          row_scores[weight_ids_[w]] += weight_values_[w];
+          row_has_score[weight_ids_[w]] = 1;
+        }
+      }
+    }
+  }
+}
+
+template <typename T>
+void TreeEnsemble::AddTreeWeights(const T* x_data, int64_t row_begin, int64_t row_end, int64_t stride,
+                                  size_t tree_begin, size_t tree_end, int64_t num_scores,
+                                  float* scores, uint8_t* has_score) const {
+  if (!walk_rows_together_) {
+    AddLeafWeights(x_data, row_begin, row_end, stride, tree_begin, tree_end, num_scores, scores, has_score);
+    return;
+  }
+
+  switch (branch_mode_) {
+    case NODE_MODE::BRANCH_LEQ:
+      AddLeafWeightsRowsTogether<T, NODE_MODE::BRANCH_LEQ>(x_data, row_begin, row_end, stride, tree_begin, tree_end,
+                                                           num_scores, scores, has_score);
+      break;
+    case NODE_MODE::BRANCH_LT:
+      AddLeafWeightsRowsTogether<T, NODE_MODE::BRANCH_LT>(x_data, row_begin, row_end, stride, tree_begin, tree_end,
+                                                          num_scores, scores, has_score);
+      break;
+    case NODE_MODE::BRANCH_GTE:
+      AddLeafWeightsRowsTogether<T, NODE_MODE::BRANCH_GTE>(x_data, row_begin, row_end, stride, tree_begin, tree_end,
+                                                           num_scores, scores, has_score);
+      break;
+    case NODE_MODE::BRANCH_GT:
+      AddLeafWeightsRowsTogether<T, NODE_MODE::BRANCH_GT>(x_data, row_begin, row_end, stride, tree_begin, tree_end,
+                                                          num_scores, scores, has_score);
+      break;
+    case NODE_MODE::BRANCH_EQ:
+      AddLeafWeightsRowsTogether<T, NODE_MODE::BRANCH_EQ>(x_data, row_begin, row_end, stride, tree_begin, tree_end,
+                                                          num_scores, scores, has_score);
+      break;
+    default:
+      AddLeafWeightsRowsTogether<T, NODE_MODE::BRANCH_NEQ>(x_data, row_begin, row_end, stride, tree_begin, tree_end,
+                                                           num_scores, scores, has_score);
+      break;
+  }
+}
+
+template <typename T>
+Status TreeEnsemble::ComputeScores(const T* x_data, int64_t N, int64_t stride, int64_t num_scores,
+                                   float* scores, uint8_t* has_score, WorkStealingThreadPool* thread_pool) const {
+  if (max_feature_id_ >= stride) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The trees use feature ", max_feature_id_,
+                           " but the input only has ", stride, " features.");
+  }
+
+  const int64_t num_trees = static_cast<int64_t>(roots_.size());
+  int64_t num_ranges = 1;
+  if (thread_pool != nullptr && N * num_trees >= kParallelTreeEvaluations) {
+    num_ranges = static_cast<int64_t>(thread_pool->NumThreads()) + 1;
+  }
+
+  if (num_ranges == 1) {
+    AddTreeWeights(x_data, 0, N, stride, 0, roots_.size(), num_scores, scores, has_score);
+  } else if (N >= num_ranges) {
+    // split the rows
+    const int64_t range_size = (N + num_ranges - 1) / num_ranges;
+    WorkStealingThreadPool::TryParallelFor(thread_pool, static_cast<int32_t>(num_ranges), [&](int32_t range) {
+      const int64_t row_begin = range * range_size;
+      const int64_t row_end = std::min(N, row_begin + range_size);
+      if (row_begin < row_end) {
+        AddTreeWeights(x_data, row_begin, row_end, stride, 0, roots_.size(), num_scores, scores, has_score);
+      }
+    });
+  } else {
+    // split the trees. each range adds its weights to its own scores, which are then added up in range order
+    num_ranges = std::min(num_ranges, num_trees);
+    const int64_t range_size = (num_trees + num_ranges - 1) / num_ranges;
+    const size_t range_scores = static_cast<size_t>(N * num_scores);
+    std::vector<float> partial_scores(range_scores * num_ranges, 0.f);
+    std::vector<uint8_t> partial_has_score(range_scores * num_ranges, 0);
+    WorkStealingThreadPool::TryParallelFor(thread_pool, static_cast<int32_t>(num_ranges), [&](int32_t range) {
+      const size_t tree_begin = static_cast<size_t>(range * range_size);
+      const size_t tree_end = std::min(roots_.size(), tree_begin + static_cast<size_t>(range_size));
+      if (tree_begin < tree_end) {
+        AddTreeWeights(x_data, 0, N, stride, tree_begin, tree_end, num_scores,
+                       partial_scores.data() + range * range_scores, partial_has_score.data() + range * range_scores);
+      }
+    });
+    for (int64_t range = 0; range < num_ranges; ++range) {
+      for (size_t i = 0; i < range_scores; ++i) {
+        scores[i] += partial_scores[range * range_scores + i];
+        has_score[i] |= partial_has_score[range * range_scores + i];
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
@@ -177,11 +177,7 @@ class UniDirectionalGru {
                     const ActivationFuncs::Entry& activation_func_f,
                     const ActivationFuncs::Entry& activation_func_g,
                     const float clip,
-#ifdef USE_EIGEN_THREADPOOL
-                    Eigen::NonBlockingThreadPool& ttp_);
-#else
-                    TaskThreadPool& ttp_);
-#endif
+                    WorkStealingThreadPool* thread_pool);
 
   void Compute(const gsl::span<const T>& inputs,
                const gsl::span<const int>& sequence_lengths,
@@ -197,11 +193,7 @@ class UniDirectionalGru {
   AllocatorPtr allocator_;
   const logging::Logger& logger_;
 
-#ifdef USE_EIGEN_THREADPOOL
-  Eigen::NonBlockingThreadPool& ttp_;
-#else
-  TaskThreadPool& ttp_;
-#endif
+  WorkStealingThreadPool* thread_pool_;
 
   int seq_length_;
   int batch_size_;
@@ -292,6 +284,7 @@ Status DeepCpuGruOp::Compute(OpKernelContext* context) const {
 template <typename T>
 Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   auto& logger = context.Logger();
+  WorkStealingThreadPool* thread_pool = context.GetIntraOpThreadPool();
 
   const Tensor& X = *context.Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
   const Tensor& W = *context.Input<Tensor>(1);  // weights. [num_directions, 3*hidden_size, input_size]
@@ -383,62 +376,36 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
     gsl::span<T> hidden_output_2 = hidden_output.subspan(hidden_output_size_per_direction,
                                                          hidden_output_size_per_direction);
 
-#if defined(USE_MLAS) && !defined(USE_OPENMP)
-#ifdef USE_EIGEN_THREADPOOL
-    auto fn =
-#else
-    std::packaged_task<void()> task_fw{
-#endif
-        [&]() {
-#endif  // USE_MLAS && ! USE_OPENMP
-          std::unique_ptr<detail::UniDirectionalGru<T>> fw = std::make_unique<detail::UniDirectionalGru<T>>(
-              alloc, logger,
-              seq_length, batch_size, input_size, hidden_size_, linear_before_reset_, Direction::kForward,
-              bias_1, initial_hidden_1,
-              activation_funcs_.Entries()[0],
-              activation_funcs_.Entries()[1],
-              clip_, ttp_);
-          fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1);
-
-#if defined(USE_MLAS) && !defined(USE_OPENMP)
-#ifndef USE_EIGEN_THREADPOOL
-        }
-  };
-  auto task_results_fw = task_fw.get_future();
-  ttp_.RunTask(std::move(task_fw));
-#else
-        };
-    OrtCondVar cv;
-    OrtMutex lock;
-    bool done = false;
-
-    ttp_.Schedule([&]() {
-      fn();
-      auto ul = std::unique_lock<OrtMutex>(lock);
-      done = true;
-      cv.notify_one();
-    });
-#endif  // USE_EIGEN_THREADPOOL
-#endif  // USE_MLAS && ! USE_OPENMP
-
-  std::unique_ptr<detail::UniDirectionalGru<T>> bw = std::make_unique<detail::UniDirectionalGru<T>>(
-      alloc, logger,
-      seq_length, batch_size, input_size, hidden_size_, linear_before_reset_, Direction::kReverse,
-      bias_2, initial_hidden_2,
-      activation_funcs_.Entries()[2],
-      activation_funcs_.Entries()[3],
-      clip_, ttp_);
-  bw->Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2, output_2, hidden_output_2);
+    auto compute_direction = [&](int32_t direction) {
+      if (direction == 0) {
+        std::unique_ptr<detail::UniDirectionalGru<T>> fw = std::make_unique<detail::UniDirectionalGru<T>>(
+            alloc, logger,
+            seq_length, batch_size, input_size, hidden_size_, linear_before_reset_, Direction::kForward,
+            bias_1, initial_hidden_1,
+            activation_funcs_.Entries()[0],
+            activation_funcs_.Entries()[1],
+            clip_, thread_pool);
+        fw->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1);
+      } else {
+        std::unique_ptr<detail::UniDirectionalGru<T>> bw = std::make_unique<detail::UniDirectionalGru<T>>(
+            alloc, logger,
+            seq_length, batch_size, input_size, hidden_size_, linear_before_reset_, Direction::kReverse,
+            bias_2, initial_hidden_2,
+            activation_funcs_.Entries()[2],
+            activation_funcs_.Entries()[3],
+            clip_, thread_pool);
+        bw->Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2, output_2, hidden_output_2);
+      }
+    };
 
 #if defined(USE_MLAS) && !defined(USE_OPENMP)
-#ifdef USE_EIGEN_THREADPOOL
-  auto ul = std::unique_lock<OrtMutex>(lock);
-  if (!done) cv.wait(ul);
+    // run the two directions concurrently on the session's intra-op pool
+    WorkStealingThreadPool::TryParallelFor(thread_pool, 2, compute_direction);
 #else
-    task_results_fw.get();
-#endif
+    compute_direction(0);
+    compute_direction(1);
 #endif  // USE_MLAS && ! USE_OPENMP
-}  // namespace onnxruntime
+}
 else {
   std::unique_ptr<detail::UniDirectionalGru<T>> gru_p = std::make_unique<detail::UniDirectionalGru<T>>(
       alloc, logger,
@@ -446,7 +413,7 @@ else {
       bias_1, initial_hidden_1,
       activation_funcs_.Entries()[0],
       activation_funcs_.Entries()[1],
-      clip_, ttp_);
+      clip_, thread_pool);
 
   gru_p->Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1);
 }
@@ -477,14 +444,10 @@ UniDirectionalGru<T>::UniDirectionalGru(AllocatorPtr allocator,
                                         const ActivationFuncs::Entry& activation_func_f,
                                         const ActivationFuncs::Entry& activation_func_g,
                                         const float clip,
-#ifdef USE_EIGEN_THREADPOOL
-                                        Eigen::NonBlockingThreadPool& ttp)
-#else
-                                        TaskThreadPool& ttp)
-#endif
+                                        WorkStealingThreadPool* thread_pool)
     : allocator_(allocator),
       logger_(logger),
-      ttp_(ttp),
+      thread_pool_(thread_pool),
       seq_length_(seq_length),
       batch_size_(batch_size),
       input_size_(input_size),
@@ -642,7 +605,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
     if (batch_size_ % hidden_num_threads_ != 0)
       fused_hidden_rows++;
 
-    // lambda executed by Eigen::NonBlockingThreadPool
+    // lambda executed on the intra-op thread pool
     auto hidden_gemm_and_activations = [&](const int row) {
       //handling boundaries
       int local_fused_hidden_rows = fused_hidden_rows;
@@ -854,7 +817,7 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       }
     };
 
-    ExecuteLambdaInParallel("Processing batch", hidden_gemm_and_activations, batch_size_, fused_hidden_rows, ttp_, logger_);
+    ExecuteLambdaInParallel("Processing batch", hidden_gemm_and_activations, batch_size_, fused_hidden_rows, thread_pool_, logger_);
   } else {
     size_t out_added_offset;
 
@@ -1109,10 +1072,8 @@ void UniDirectionalGru<T>::AllocateBuffers() {
 
 template <typename T>
 void UniDirectionalGru<T>::SetNumThreads() {
-  int threads = std::thread::hardware_concurrency() - 1;
-
-  if (threads < 1)
-    threads = 1;
+  // the thread calling Compute runs tasks alongside the intra-op pool's threads
+  int threads = thread_pool_ ? static_cast<int>(thread_pool_->NumThreads()) + 1 : 1;
 
   hidden_num_threads_ = threads;
   batch_parallel_ = false;
@@ -9,7 +9,6 @@
 
 #include <algorithm>
 #include <functional>
-#include <future>
 #include <string>
 #include <vector>
 
@@ -22,11 +21,7 @@
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
-#ifdef USE_EIGEN_THREADPOOL
-#include <unsupported/Eigen/CXX11/ThreadPool>
-#else
-#include "core/common/task_thread_pool.h"
-#endif
+#include "core/common/work_stealing_thread_pool.h"
 
 namespace onnxruntime {
 class Tensor;
@@ -218,16 +213,12 @@ T* SafeRawPointer(typename gsl::span<T> span, size_t offset, size_t size) {
 
 template <typename TLambda>
 void ExecuteLambdaInParallel(const std::string& name, TLambda lambda, int max, int step,
-#ifdef USE_EIGEN_THREADPOOL
-                             Eigen::NonBlockingThreadPool& ttp,
-#else
-                             TaskThreadPool& ttp,
-#endif
+                             WorkStealingThreadPool* thread_pool,
                              const ::onnxruntime::logging::Logger& logger) {
   // #define NOTHREADS to execute the lambdas directly and in order if you need to do that to debug
 
 #ifdef NOTHREADS
-  ORT_UNUSED_PARAMETER(ttp);
+  ORT_UNUSED_PARAMETER(thread_pool);
   ORT_UNUSED_PARAMETER(logger);
 
   for (int i = 0; i < max; i += step) {
@@ -235,40 +226,15 @@ void ExecuteLambdaInParallel(const std::string& name, TLambda lambda, int max, i
     std::bind(lambda, i)();
   }
 #else
+  const int num_tasks = step > 0 ? (max + step - 1) / step : 0;
 
-#ifdef USE_EIGEN_THREADPOOL
-  ORT_UNUSED_PARAMETER(name);
-  ORT_UNUSED_PARAMETER(logger);
-
-  std::atomic<int> done(0);
-  for (int i = 0; i < max; i += step) {
-    ttp.Schedule([lambda, i, &done]() {
-      lambda(i);
-      ++done;
-    });
-  }
-
-  int totalTasks = (int)max / (step > 0 ? step : 1) + (max % step > 0 ? 1 : 0);
-  while (done != totalTasks) {
-  }
-#else
-  std::vector<std::future<void> > task_results{};
-  task_results.reserve(static_cast<size_t>(std::ceil(max / step)));
-
-  for (int i = 0; i < max; i += step) {
-    std::packaged_task<void()> task{std::bind(lambda, i)};
-    task_results.emplace_back(task.get_future());
-    ttp.RunTask(std::move(task));
-  }
   try {
-    // wait for all and propagate any exceptions
-    for (auto& future : task_results)
-      future.get();
+    // the calling thread runs tasks too, and everything runs serially if the session has no intra-op pool
+    WorkStealingThreadPool::TryParallelFor(thread_pool, num_tasks, [&lambda, step](int32_t i) { lambda(i * step); });
   } catch (const std::exception& ex) {
     LOGS(logger, ERROR) << name << " - exception running tasks: " << ex.what();
     throw;
   }
-#endif  // else part of #ifdef USE_EIGEN_THREADPOOLs
 #endif  // else part of #ifdef NOTHREADS
 }
 
@@ -4,6 +4,7 @@
 //https://github.com/onnx/onnx/blob/master/docs/Operators.md#Gather
 #include "core/providers/cpu/tensor/gather.h"
 #include "core/common/common.h"
+#include "core/common/work_stealing_thread_pool.h"
 
 namespace onnxruntime {
 
@@ -30,15 +31,19 @@ Status GatherBase::PrepareForCompute(OpKernelContext* context, Prepare& p) const
   return Status::OK();
 }
 
+// minimum number of bytes to copy before splitting the copy across the intra-op thread pool
+static constexpr int64_t kParallelCopyThresholdBytes = 64 * 1024;
+
 template <typename Tin>
 Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uint8_t* dst_base, bool is_string_type,
                       const size_t element_bytes, const int64_t block_size, const int64_t M,
                       const int64_t N, const int64_t data_batch_bytes, const int64_t gathered_batch_bytes,
-                      const TensorShape& input_data_shape, const int64_t axis) {
+                      const TensorShape& input_data_shape, const int64_t axis,
+                      WorkStealingThreadPool* thread_pool) {
   const Tin* indices_data = indices_tensor->template Data<Tin>();
 
   // Check the indices first in case there's a out of bound index.
-  // We can't merge this code in the omp loop below as omp does not allow return in the loop
+  // Doing it up front means the copy below can't fail part way through
   for (int64_t i = 0; i < N; ++i) {
     Tin idx = indices_data[i];
     if (idx < 0 || idx >= input_data_shape[axis]) {
@@ -47,10 +52,7 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
     }
   }
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t index = 0; index < M * N; ++index) {
+  auto copy_one = [&](int64_t index) {
     int64_t batch = index / N, i = index % N;
 
     const int64_t src_offset_batch = batch * data_batch_bytes;
@@ -65,8 +67,25 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
     } else {
       memcpy(dst_base + dst_offset, src_base + src_offset, block_size);
     }
+  };
+
+  // split the copies into contiguous ranges, one per thread including the one running this kernel,
+  // unless there's too little data for that to pay off
+  const int64_t total = M * N;
+  int64_t num_ranges = 1;
+  if (thread_pool && total * block_size >= kParallelCopyThresholdBytes) {
+    num_ranges = std::min<int64_t>(total, static_cast<int64_t>(thread_pool->NumThreads()) + 1);
   }
 
+  const int64_t range_size = (total + num_ranges - 1) / num_ranges;
+
+  WorkStealingThreadPool::TryParallelFor(thread_pool, static_cast<int32_t>(num_ranges), [&](int32_t range) {
+    const int64_t end = std::min(total, (range + 1) * range_size);
+    for (int64_t index = range * range_size; index < end; ++index) {
+      copy_one(index);
+    }
+  });
+
   return Status::OK();
 }
 
@@ -92,10 +111,12 @@ Status Gather::Compute(OpKernelContext* context) const {
   MLDataType Tind_type = p.indices_tensor->DataType();
   if (Tind_type == DataTypeImpl::GetType<int32_t>()) {
     return GatherCopyData<int32_t>(p.indices_tensor, src_base, dst_base, is_string_type, element_bytes,
-                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis);
+                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis,
+                                   context->GetIntraOpThreadPool());
   } else if (Tind_type == DataTypeImpl::GetType<int64_t>()) {
     return GatherCopyData<int64_t>(p.indices_tensor, src_base, dst_base, is_string_type, element_bytes,
-                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis);
+                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis,
+                                   context->GetIntraOpThreadPool());
   }
 
   return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in Gather.");
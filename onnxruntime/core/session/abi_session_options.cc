@@ -14,7 +14,10 @@ OrtSessionOptions& OrtSessionOptions::operator=(const OrtSessionOptions&) {
   throw std::runtime_error("not implemented");
 }
 OrtSessionOptions::OrtSessionOptions(const OrtSessionOptions& other)
-    : value(other.value), custom_op_paths(other.custom_op_paths), provider_factories(other.provider_factories) {
+    : value(other.value),
+      custom_op_paths(other.custom_op_paths),
+      provider_factories(other.provider_factories),
+      use_shared_initializers(other.use_shared_initializers) {
 }
 
 ORT_API(OrtSessionOptions*, OrtCreateSessionOptions) {
@@ -73,6 +76,82 @@ ORT_API(void, OrtDisableCpuMemArena, _In_ OrtSessionOptions* options) {
   options->value.enable_cpu_mem_arena = false;
 }
 
+ORT_API(void, OrtEnableModelFileMapping, _In_ OrtSessionOptions* options) {
+  options->value.enable_model_file_mapping = true;
+}
+
+ORT_API(void, OrtDisableModelFileMapping, _In_ OrtSessionOptions* options) {
+  options->value.enable_model_file_mapping = false;
+}
+
+ORT_API(void, OrtEnableSharedInitializers, _In_ OrtSessionOptions* options) {
+  options->use_shared_initializers = true;
+}
+
+ORT_API(void, OrtDisableSharedInitializers, _In_ OrtSessionOptions* options) {
+  options->use_shared_initializers = false;
+}
+
+ORT_API(void, OrtSetCpuMemArenaMaxBytes, _In_ OrtSessionOptions* options, size_t max_bytes) {
+  options->value.cpu_mem_arena_max_bytes = max_bytes;
+}
+
+ORT_API(int, OrtSetCpuMemArenaExtendStrategy, _In_ OrtSessionOptions* options, enum OrtArenaExtendStrategy strategy) {
+  switch (strategy) {
+    case OrtArenaExtendNextPowerOfTwo:
+      options->value.cpu_mem_arena_extend_strategy = onnxruntime::ArenaExtendStrategy::kNextPowerOfTwo;
+      return 0;
+    case OrtArenaExtendSameAsRequested:
+      options->value.cpu_mem_arena_extend_strategy = onnxruntime::ArenaExtendStrategy::kSameAsRequested;
+      return 0;
+    default:
+      return -1;
+  }
+}
+
+ORT_API(void, OrtEnableMemArenaShrinkOnIdle, _In_ OrtSessionOptions* options) {
+  options->value.enable_mem_arena_shrink_on_idle = true;
+}
+
+ORT_API(void, OrtDisableMemArenaShrinkOnIdle, _In_ OrtSessionOptions* options) {
+  options->value.enable_mem_arena_shrink_on_idle = false;
+}
+
+ORT_API(void, OrtSetMemArenaShrinkOnIdleMinFreeBytes, _In_ OrtSessionOptions* options, size_t min_free_bytes) {
+  options->value.mem_arena_shrink_on_idle_min_free_bytes = min_free_bytes;
+}
+
+ORT_API(void, OrtEnableZipMapSharedKeys, _In_ OrtSessionOptions* options) {
+  options->value.enable_zipmap_shared_keys = true;
+}
+
+ORT_API(void, OrtDisableZipMapSharedKeys, _In_ OrtSessionOptions* options) {
+  options->value.enable_zipmap_shared_keys = false;
+}
+
+ORT_API(int, OrtSetSessionGraphOptimizationLevel, _In_ OrtSessionOptions* options, enum OrtGraphOptimizationLevel level) {
+  switch (level) {
+    case OrtGraphOptimizationNone:
+      options->value.graph_optimization_level = onnxruntime::TransformerLevel::kNone;
+      return 0;
+    case OrtGraphOptimizationBasic:
+      options->value.graph_optimization_level = onnxruntime::TransformerLevel::kBasic;
+      return 0;
+    case OrtGraphOptimizationExtended:
+      options->value.graph_optimization_level = onnxruntime::TransformerLevel::kExtended;
+      return 0;
+    case OrtGraphOptimizationLayout:
+      options->value.graph_optimization_level = onnxruntime::TransformerLevel::kLayout;
+      return 0;
+    default:
+      return -1;
+  }
+}
+
+ORT_API(void, OrtSetOptimizedModelFilePath, _In_ OrtSessionOptions* options, _In_ const char* optimized_model_filepath) {
+  options->value.optimized_model_filepath = optimized_model_filepath;
+}
+
 ///< logger id to use for session output
 ORT_API(void, OrtSetSessionLogId, _In_ OrtSessionOptions* options, const char* logid) {
   options->value.session_logid = logid;
@@ -90,6 +169,13 @@ ORT_API(int, OrtSetSessionThreadPoolSize, _In_ OrtSessionOptions* options, int s
   return 0;
 }
 
+///How many threads may be used to execute a single node.
+ORT_API(int, OrtSetIntraOpNumThreads, _In_ OrtSessionOptions* options, int intra_op_num_threads) {
+  if (intra_op_num_threads <= 0) return -1;
+  options->value.intra_op_num_threads = intra_op_num_threads;
+  return 0;
+}
+
 ORT_API(void, OrtAppendCustomOpLibPath, _In_ OrtSessionOptions* options, const char* lib_path) {
   options->custom_op_paths.emplace_back(lib_path);
 }
@@ -14,6 +14,8 @@ struct OrtSessionOptions {
   onnxruntime::SessionOptions value;
   std::vector<std::string> custom_op_paths;
   std::vector<std::shared_ptr<onnxruntime::IExecutionProviderFactory>> provider_factories;
+  // take the initializers from the shared initializer cache of the OrtEnv the session is created in
+  bool use_shared_initializers = false;
   OrtSessionOptions() = default;
   ~OrtSessionOptions();
   OrtSessionOptions(const OrtSessionOptions& other);
@@ -7,14 +7,18 @@
 
 #include "core/session/inference_session.h"
 
+#include <fstream>
+#include <map>
 #include <memory>
 #include "core/platform/ort_mutex.h"
 #include <sstream>
 #include <unordered_set>
 #include <list>
+#include <algorithm>
+#include <cstring>
 
 #include "core/common/logging/logging.h"
-#include "core/common/task_thread_pool.h"
+#include "core/common/work_stealing_thread_pool.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/graph_utils.h"
 #include "core/graph/model.h"
@@ -22,6 +26,7 @@
 #include "core/framework/customregistry.h"
 #include "core/framework/environment.h"
 #include "core/framework/execution_frame.h"
+#include "core/framework/feeds_fetches_info.h"
 #include "core/framework/graph_partitioner.h"
 #include "core/framework/kernel_def_builder.h"
 #include "core/framework/kernel_registry.h"
@@ -38,6 +43,7 @@
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/optimizer/shared_key_zipmap_transformer.h"
 #include "core/optimizer/transformer_memcpy.h"
 #include "core/platform/notification.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
@@ -52,11 +58,82 @@ using namespace ONNX_NAMESPACE;
 
 namespace onnxruntime {
 
+// metadata written to a model saved with SessionOptions::optimized_model_filepath
+static const char* const kOptimizedModelProvidersKey = "onnxruntime.optimized_model.execution_providers";
+static const char* const kOptimizedModelPlacementKey = "onnxruntime.optimized_model.node_placement";
+
+// the subgraphs of a node in attribute name order, so the nodes are visited in the same order on save and load
+static std::map<std::string, Graph*> GetSubgraphsByName(Node& node) {
+  std::map<std::string, Graph*> subgraphs;
+  for (auto& entry : node.GetAttributeNameToMutableSubgraphMap()) {
+    subgraphs.emplace(entry.first, entry.second);
+  }
+
+  return subgraphs;
+}
+
+// write a record of the name, op type and execution provider of each node, one per line and separated by tabs, in
+// the order Graph::ToGraphProto writes the nodes. the nodes of a subgraph follow the node that contains it.
+static common::Status WriteNodePlacement(Graph& graph, std::ostringstream& placement) {
+  GraphViewer graph_viewer(graph);
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    Node& node = *graph.GetNode(index);
+    if (node.NodeType() == Node::Type::Fused) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Node ", node.Name(), " was compiled by the ",
+                             node.GetExecutionProviderType(), " execution provider and can't be saved.");
+    }
+
+    placement << node.Name() << '\t' << node.OpType() << '\t' << node.GetExecutionProviderType() << '\n';
+    for (auto& entry : GetSubgraphsByName(node)) {
+      ORT_RETURN_IF_ERROR(WriteNodePlacement(*entry.second, placement));
+    }
+  }
+
+  return Status::OK();
+}
+
+// a loaded model has its nodes in the order they were saved in. each record is checked against the node it's read
+// for, so a model that was edited after it was saved is rejected rather than run with the wrong placement.
+static common::Status ReadNodePlacement(Graph& graph, std::istringstream& placement) {
+  for (auto& node : graph.Nodes()) {
+    std::string record;
+    if (!std::getline(placement, record)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The saved execution provider placement has no entry for ",
+                             "node '", node.Name(), "'.");
+    }
+
+    // the name is the only field that may contain a tab
+    std::string name, op_type, provider_type;
+    const auto provider_pos = record.rfind('\t');
+    if (provider_pos != std::string::npos && provider_pos != 0) {
+      const auto op_type_pos = record.rfind('\t', provider_pos - 1);
+      if (op_type_pos != std::string::npos) {
+        name = record.substr(0, op_type_pos);
+        op_type = record.substr(op_type_pos + 1, provider_pos - op_type_pos - 1);
+        provider_type = record.substr(provider_pos + 1);
+      }
+    }
+
+    if (provider_type.empty() || name != node.Name() || op_type != node.OpType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The saved execution provider placement entry '", record,
+                             "' doesn't match node '", node.Name(), "' (", node.OpType(), ").");
+    }
+
+    node.SetExecutionProviderType(provider_type);
+    for (auto& entry : GetSubgraphsByName(node)) {
+      ORT_RETURN_IF_ERROR(ReadNodePlacement(*entry.second, placement));
+    }
+  }
+
+  return Status::OK();
+}
+
 class InferenceSession::Impl {
  public:
   Impl(const SessionOptions& session_options, logging::LoggingManager* logging_manager)
       : session_options_{session_options},
-        graph_transformation_mgr_{session_options_.max_num_graph_transformation_steps},
+        graph_transformation_mgr_{session_options_.max_num_graph_transformation_steps,
+                                  session_options_.graph_optimization_level},
         logging_manager_{logging_manager},
         session_state_{execution_providers_},
         insert_cast_transformer_{"CastFloat16Transformer"} {
@@ -65,27 +142,62 @@ class InferenceSession::Impl {
 
     InitLogger(logging_manager);
 
+    const int hardware_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    int inter_op_threads = 0;
+
     // currently the threadpool is used by the parallel executor only and hence
     // there is no point creating it when only sequential execution is enabled.
     if (!session_options.enable_sequential_execution) {
-      int pool_size = session_options_.session_thread_pool_size == 0
-                          ? std::thread::hardware_concurrency() / 2
-                          : session_options_.session_thread_pool_size;
+      inter_op_threads = session_options_.session_thread_pool_size == 0
+                             ? std::max(1, hardware_threads / 2)
+                             : session_options_.session_thread_pool_size;
 
 #ifdef USE_EIGEN_THREADPOOL
-      thread_pool_ = std::make_unique<Eigen::NonBlockingThreadPool>(pool_size);
+      thread_pool_ = std::make_unique<Eigen::NonBlockingThreadPool>(inter_op_threads);
 #else
-      thread_pool_ = std::make_unique<TaskThreadPool>(pool_size);
+      thread_pool_ = std::make_unique<WorkStealingThreadPool>(inter_op_threads);
 #endif
     }
 
+    // kernels share one intra-op pool. the thread running a kernel takes part in its loops, so the pool
+    // needs one less thread than the requested parallelism. the inter-op threads run kernels too, so cap
+    // the threads of both pools together so the session doesn't oversubscribe the machine however many
+    // nodes run concurrently.
+    const int max_intra_op_threads = std::max(1, hardware_threads - inter_op_threads);
+    int intra_op_threads = session_options_.intra_op_num_threads == 0 ? max_intra_op_threads
+                                                                       : session_options_.intra_op_num_threads;
+    if (intra_op_threads > max_intra_op_threads) {
+      LOGS(*session_logger_, WARNING) << "intra_op_num_threads of " << intra_op_threads << " reduced to "
+                                      << max_intra_op_threads << " so that with the " << inter_op_threads
+                                      << " inter-op threads the session stays within the " << hardware_threads
+                                      << " hardware threads.";
+      intra_op_threads = max_intra_op_threads;
+    }
+
+    if (intra_op_threads > 1) {
+      intra_op_thread_pool_ = std::make_unique<WorkStealingThreadPool>(intra_op_threads - 1);
+    }
+
     session_state_.SetThreadPool(thread_pool_.get());
+    session_state_.SetIntraOpThreadPool(intra_op_thread_pool_.get());
+    execution_frame_pool_capacity_ = static_cast<size_t>(session_options_.execution_frame_pool_capacity == 0
+                                                             ? std::max(1, inter_op_threads)
+                                                             : session_options_.execution_frame_pool_capacity);
+    session_state_.SetExecutionFramePoolCapacity(execution_frame_pool_capacity_);
     session_state_.SetEnableMemoryPattern(session_options.enable_mem_pattern);
+    session_state_.SetEnableMemoryPatternOfflinePacking(session_options.enable_mem_pattern_offline_packing);
+    session_state_.SetMemoryPatternCacheOptions(session_options.mem_pattern_cache_capacity,
+                                                session_options.mem_pattern_dim_buckets);
     session_profiler_.Initialize(session_logger_);
     session_state_.SetProfiler(session_profiler_);
+    session_state_.SetSharedInitializerCache(session_options.shared_initializer_cache.get());
     if (session_options.enable_profiling) {
       StartProfiling(session_options.profile_file_prefix);
     }
+
+    if (session_options.enable_zipmap_shared_keys) {
+      ORT_ENFORCE(graph_transformation_mgr_.Register(std::make_unique<SharedKeyZipMapTransformer>()).IsOK());
+    }
   }
 
   common::Status RegisterExecutionProvider(std::unique_ptr<IExecutionProvider> p_exec_provider) {
@@ -104,6 +216,7 @@ class InferenceSession::Impl {
     if (p_graph_transformer == nullptr) {
       return Status(common::ONNXRUNTIME, common::FAIL, "Received nullptr for graph transformer");
     }
+    ++num_registered_transformers_;
     return graph_transformation_mgr_.Register(std::move(p_graph_transformer));
   }
 
@@ -178,6 +291,19 @@ class InferenceSession::Impl {
     return Load(loader, "model_loading_uri");
   }
 
+  common::Status Load(const std::string& model_uri) {
+    auto loader = [this, &model_uri](std::shared_ptr<onnxruntime::Model>& model) {
+      auto* local_registries = HasLocalSchema() ? &custom_schema_registries_ : nullptr;
+      if (session_options_.enable_model_file_mapping) {
+        return onnxruntime::Model::LoadMapped(model_uri, model, local_registries);
+      }
+
+      return onnxruntime::Model::Load(model_uri, model, local_registries);
+    };
+
+    return Load(loader, "model_loading_uri");
+  }
+
   common::Status Load(const ModelProto& model_proto) {
     auto loader = [this, &model_proto](std::shared_ptr<onnxruntime::Model>& model) {
       return onnxruntime::Model::Load(model_proto, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr);
@@ -224,7 +350,7 @@ class InferenceSession::Impl {
     // 5. insert cast nodes.
 
     // first apply the default/system/basic graph to graph optimizations.
-    ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyAll(graph));
+    ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyAll(graph, &session_state.Profiler()));
 
     // Do partitioning based on execution providers' capability.
     GraphPartitioner partitioner(kernel_registry_manager, providers);
@@ -247,6 +373,80 @@ class InferenceSession::Impl {
     return common::Status::OK();
   }
 
+  std::string GetProviderTypes() const {
+    std::string provider_types;
+    for (auto& provider_ptr : execution_providers_) {
+      if (!provider_types.empty()) {
+        provider_types += ',';
+      }
+
+      provider_types += provider_ptr->Type();
+    }
+
+    return provider_types;
+  }
+
+  /// Save the transformed model, with the execution provider of each node in its metadata, to
+  /// SessionOptions::optimized_model_filepath.
+  common::Status SaveOptimizedModel() {
+    std::ostringstream placement;
+    ORT_RETURN_IF_ERROR(WriteNodePlacement(model_->MainGraph(), placement));
+
+    ModelProto model_proto = model_->ToProto();
+
+    // replace the entries of a model that was saved before
+    auto* metadata_props = model_proto.mutable_metadata_props();
+    for (int i = metadata_props->size() - 1; i >= 0; --i) {
+      const auto& key = metadata_props->Get(i).key();
+      if (key == kOptimizedModelProvidersKey || key == kOptimizedModelPlacementKey) {
+        metadata_props->DeleteSubrange(i, 1);
+      }
+    }
+
+    auto* providers_prop = model_proto.add_metadata_props();
+    providers_prop->set_key(kOptimizedModelProvidersKey);
+    providers_prop->set_value(GetProviderTypes());
+    auto* placement_prop = model_proto.add_metadata_props();
+    placement_prop->set_key(kOptimizedModelPlacementKey);
+    placement_prop->set_value(placement.str());
+
+    const auto& path = session_options_.optimized_model_filepath;
+    std::ofstream model_file(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!model_file || !model_proto.SerializeToOstream(&model_file)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to save the optimized model to ", path);
+    }
+
+    LOGS(*session_logger_, INFO) << "Saved the optimized model to " << path;
+    return Status::OK();
+  }
+
+  /// Assign the nodes of a model saved with SessionOptions::optimized_model_filepath to the execution providers
+  /// they were assigned to when it was saved. The graph was already transformed so that's all it needs.
+  common::Status ApplySavedPlacement(Graph& graph) {
+    const auto& metadata = model_->MetaData();
+    auto providers = metadata.find(kOptimizedModelProvidersKey);
+    auto placement = metadata.find(kOptimizedModelPlacementKey);
+
+    const std::string provider_types = GetProviderTypes();
+    if (providers == metadata.cend() || providers->second != provider_types) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The model was optimized for the execution providers [",
+                             providers == metadata.cend() ? "" : providers->second, "] but the session has [",
+                             provider_types, "].");
+    }
+
+    std::istringstream placement_stream(placement->second);
+    ORT_RETURN_IF_ERROR(ReadNodePlacement(graph, placement_stream));
+
+    std::string extra;
+    if (std::getline(placement_stream, extra)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH,
+                             "The saved execution provider placement has more entries than the model has nodes.");
+    }
+
+    LOGS(*session_logger_, INFO) << "Using the graph transformations and placement saved in the model.";
+    return Status::OK();
+  }
+
   /// Create SessionState instance for each subgraph as we need that for the GraphPartitioner
   /// This will be initialized by InitializeSubgraphSessions.
   common::Status CreateSubgraphSessionState(Graph& graph, SessionState& session_state) {
@@ -259,6 +459,13 @@ class InferenceSession::Impl {
         auto subgraph_session_state = std::make_unique<SessionState>(execution_providers_);
         subgraph_session_state->SetProfiler(session_profiler_);
         subgraph_session_state->SetLogger(*session_logger_);
+        subgraph_session_state->SetIntraOpThreadPool(intra_op_thread_pool_.get());
+        subgraph_session_state->SetExecutionFramePoolCapacity(execution_frame_pool_capacity_);
+        subgraph_session_state->SetEnableMemoryPatternOfflinePacking(
+            session_options_.enable_mem_pattern_offline_packing);
+        subgraph_session_state->SetMemoryPatternCacheOptions(session_options_.mem_pattern_cache_capacity,
+                                                             session_options_.mem_pattern_dim_buckets);
+        subgraph_session_state->SetSharedInitializerCache(session_options_.shared_initializer_cache.get());
 
         // recurse
         ORT_RETURN_IF_ERROR(CreateSubgraphSessionState(*subgraph, *subgraph_session_state));
@@ -327,6 +534,9 @@ class InferenceSession::Impl {
       if (!execution_providers_.Get(onnxruntime::kCpuExecutionProvider)) {
         LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
         CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+        epi.use_arena_thread_cache = session_options_.enable_cpu_mem_arena_thread_cache;
+        epi.arena_max_bytes = session_options_.cpu_mem_arena_max_bytes;
+        epi.arena_extend_strategy = session_options_.cpu_mem_arena_extend_strategy;
         ORT_RETURN_IF_ERROR(execution_providers_.Add(onnxruntime::kCpuExecutionProvider,
                                                      std::make_unique<CPUExecutionProvider>(epi)));
       }
@@ -349,15 +559,31 @@ class InferenceSession::Impl {
       // create SessionState for subgraphs as it's needed by the transformers
       ORT_RETURN_IF_ERROR(CreateSubgraphSessionState(graph, session_state_));
 
-      // apply any transformations to the main graph and any subgraphs
-      ORT_RETURN_IF_ERROR(TransformGraph(graph, graph_transformation_mgr_,
-                                         execution_providers_, kernel_registry_manager_,
-                                         insert_cast_transformer_,
-                                         session_state_));
+      // apply any transformations to the main graph and any subgraphs, unless the model was saved after them
+      if (model_->MetaData().count(kOptimizedModelPlacementKey) != 0) {
+        // they'd have to run before the nodes were placed, so only the session that saved the model can apply them
+        if (num_registered_transformers_ != 0) {
+          LOGS(*session_logger_, WARNING) << "The model was saved after its graph transformations so the "
+                                          << num_registered_transformers_
+                                          << " registered graph transformer(s) are not applied. Register them in "
+                                          << "the session that saves the optimized model instead.";
+        }
+
+        ORT_RETURN_IF_ERROR(ApplySavedPlacement(graph));
+      } else {
+        ORT_RETURN_IF_ERROR(TransformGraph(graph, graph_transformation_mgr_,
+                                           execution_providers_, kernel_registry_manager_,
+                                           insert_cast_transformer_,
+                                           session_state_));
+      }
 
       // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
       ORT_RETURN_IF_ERROR(graph.Resolve());
 
+      if (!session_options_.optimized_model_filepath.empty()) {
+        ORT_RETURN_IF_ERROR(SaveOptimizedModel());
+      }
+
       ORT_RETURN_IF_ERROR(session_initializer.CreatePlan({}, session_options_.enable_sequential_execution));
       ORT_RETURN_IF_ERROR(session_initializer.InitializeAndSave(session_state_.GetEnableMemoryPattern()));
 
@@ -366,6 +592,17 @@ class InferenceSession::Impl {
 
       session_state_.CalculateNodeIndexInfo();
 
+      // map the model inputs to their MLValue index so a Run with a FeedsFetchesInfo can check the feed types
+      // without looking up any names
+      const auto& mlvalue_name_idx_map = session_state_.GetMLValueNameIdxMap();
+      input_defs_by_mlvalue_idx_.assign(mlvalue_name_idx_map.MaxIdx() + 1, nullptr);
+      for (const auto* input_def : input_def_list_) {
+        int mlvalue_idx;
+        if (mlvalue_name_idx_map.GetIdx(input_def->Name(), mlvalue_idx).IsOK()) {
+          input_defs_by_mlvalue_idx_[mlvalue_idx] = input_def;
+        }
+      }
+
       is_inited_ = true;
 
       LOGS(*session_logger_, INFO) << "Session successfully initialized.";
@@ -390,6 +627,60 @@ class InferenceSession::Impl {
     return current_num_runs_.load();
   }
 
+  size_t ShrinkMemoryArenas() {
+    // the pooled frames hold the memory pattern buffers of the last runs
+    session_state_.ReleaseExecutionFramePool();
+
+    size_t released_bytes = 0;
+    for (auto* arena : GetArenas()) {
+      released_bytes += arena->Shrink();
+    }
+
+    return released_bytes;
+  }
+
+  common::Status GetCpuArenaStats(AllocatorStats* stats) const {
+    const auto* cpu_xp = execution_providers_.Get(onnxruntime::kCpuExecutionProvider);
+    if (cpu_xp == nullptr) {
+      return Status(common::ONNXRUNTIME, common::FAIL, "The session has no CPU execution provider. Initialize it first.");
+    }
+
+    // the stats are all 0 if the CPU arena is disabled
+    auto* arena = dynamic_cast<IArenaAllocator*>(cpu_xp->GetAllocator(0, OrtMemTypeDefault).get());
+    if (arena == nullptr) {
+      stats->Clear();
+    } else {
+      arena->GetStats(stats);
+    }
+
+    return Status::OK();
+  }
+
+  common::Status GetMemoryPatternCacheStats(MemoryPatternCacheStats* stats) const {
+    {
+      std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+      if (!is_inited_) {
+        return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+      }
+    }
+
+    session_state_.GetMemoryPatternCache().GetStats(stats);
+    return Status::OK();
+  }
+
+  common::Status GetGraphAndSessionState(const Graph*& graph, const SessionState*& session_state) const {
+    {
+      std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+      if (!is_inited_) {
+        return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+      }
+    }
+
+    graph = &model_->MainGraph();
+    session_state = &session_state_;
+    return Status::OK();
+  }
+
   common::Status Run(const NameMLValMap& feeds,
                      const std::vector<std::string>& output_names,
                      std::vector<MLValue>* p_fetches) {
@@ -414,34 +705,61 @@ class InferenceSession::Impl {
         continue;
       }
 
-      auto& input_ml_value = feeds.at(arg_name);
-      auto input_type = input_ml_value.Type();
-      auto expected_type = utils::GetMLDataType(*arg);
+      ORT_RETURN_IF_ERROR(ValidateInputType(*arg, feeds.at(arg_name)));
+    }
+    return Status::OK();
+  }
 
-      if (!input_ml_value.IsTensor()) {
-        auto retval = CheckTypes(input_type, expected_type);
-        if (!retval.IsOK()) {
-          return retval;
-        }
-        continue;
+  // feeds are in the order of feeds_fetches_info.feed_names
+  common::Status ValidateInputTypes(const FeedsFetchesInfo& feeds_fetches_info, const std::vector<MLValue>& feeds) {
+    const auto& feeds_mlvalue_idxs = feeds_fetches_info.feeds_mlvalue_idxs;
+    for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+      const int mlvalue_idx = feeds_mlvalue_idxs[i];
+      const NodeArg* arg = mlvalue_idx >= 0 && static_cast<size_t>(mlvalue_idx) < input_defs_by_mlvalue_idx_.size()
+                               ? input_defs_by_mlvalue_idx_[mlvalue_idx]
+                               : nullptr;
+      if (arg == nullptr) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Feed ", feeds_fetches_info.feed_names[i],
+                               " is not an input of the model.");
       }
 
-      auto expected_element_type = expected_type->AsTensorType()->GetElementType();
-      auto input_element_type = input_ml_value.Get<Tensor>().DataType();
-      auto retval = CheckTypes(input_element_type, expected_element_type);
-      if (!retval.IsOK()) {
-        return retval;
-      }
+      ORT_RETURN_IF_ERROR(ValidateInputType(*arg, feeds[i]));
     }
     return Status::OK();
   }
 
-  common::Status ValidateInputNames(const NameMLValMap& feeds) {
+  static common::Status ValidateInputType(const NodeArg& arg, const MLValue& input_ml_value) {
+    auto input_type = input_ml_value.Type();
+    auto expected_type = utils::GetMLDataType(arg);
+
+    if (!input_ml_value.IsTensor()) {
+      return CheckTypes(input_type, expected_type);
+    }
+
+    auto expected_element_type = expected_type->AsTensorType()->GetElementType();
+    auto input_element_type = input_ml_value.Get<Tensor>().DataType();
+    return CheckTypes(input_element_type, expected_element_type);
+  }
+
+  static bool ContainsFeed(const NameMLValMap& feeds, const std::string& name) {
+    return feeds.find(name) != feeds.cend();
+  }
+
+  static bool ContainsFeed(const std::vector<std::string>& feed_names, const std::string& name) {
+    return std::find(feed_names.cbegin(), feed_names.cend(), name) != feed_names.cend();
+  }
+
+  static const std::string& FeedName(const NameMLValMap::value_type& feed) { return feed.first; }
+  static const std::string& FeedName(const std::string& feed_name) { return feed_name; }
+
+  // TFeeds is either a NameMLValMap or a vector of feed names
+  template <typename TFeeds>
+  common::Status ValidateInputNames(const TFeeds& feeds) {
     std::string missing_required_inputs;
 
     std::for_each(required_model_input_names_.cbegin(), required_model_input_names_.cend(),
                   [&](const std::string& required_input) {
-                    if (feeds.find(required_input) == feeds.cend()) {
+                    if (!ContainsFeed(feeds, required_input)) {
                       if (!missing_required_inputs.empty())
                         missing_required_inputs += ",";
 
@@ -456,10 +774,17 @@ class InferenceSession::Impl {
 
     bool valid = true;
     std::ostringstream invalid_names;
-    for (const auto& pair : feeds) {
-      if (model_input_names_.find(pair.first) == model_input_names_.end()) {
+    for (const auto& feed : feeds) {
+      const std::string& feed_name = FeedName(feed);
+      if (constant_initializer_input_names_.count(feed_name) != 0) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", feed_name,
+                               " is an initializer and can't be fed. Initializers are constant in models with an ",
+                               "IR version below 4, even when they are listed as graph inputs.");
+      }
+
+      if (model_input_names_.find(feed_name) == model_input_names_.end()) {
         valid = false;
-        invalid_names << " " << pair.first;
+        invalid_names << " " << feed_name;
       }
     }
 
@@ -492,11 +817,6 @@ class InferenceSession::Impl {
                             "Output vector pointer is NULL");
     }
 
-    if (output_names.empty()) {
-      return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                            "At least one output should be requested.");
-    }
-
     if (!p_fetches->empty() &&
         (output_names.size() != p_fetches->size())) {
       std::ostringstream ostr;
@@ -505,6 +825,15 @@ class InferenceSession::Impl {
       return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, ostr.str());
     }
 
+    return ValidateOutputNames(output_names);
+  }
+
+  common::Status ValidateOutputNames(const std::vector<std::string>& output_names) {
+    if (output_names.empty()) {
+      return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                            "At least one output should be requested.");
+    }
+
     bool valid = true;
     std::ostringstream invalid_names;
     for (const auto& name : output_names) {
@@ -535,60 +864,156 @@ class InferenceSession::Impl {
              const NameMLValMap& feeds,
              const std::vector<std::string>& output_names,
              std::vector<MLValue>* p_fetches) {
-    auto tp = session_profiler_.StartTime();
-    Status retval = Status::OK();
+    return RunImpl(
+        run_options,
+        [&]() {
+          ORT_RETURN_IF_ERROR(ValidateInputs(feeds));
+
+          // if the output vector is non-empty, ensure that its the same size as the output_names
+          return ValidateOutputs(output_names, p_fetches);
+        },
+        [&](const logging::Logger& run_logger) {
+          return utils::ExecuteGraph(session_state_, feeds, output_names, *p_fetches, {},
+                                     session_options_.enable_sequential_execution, run_options.terminate,
+                                     run_logger);
+        });
+  }
 
-    try {
-      {
-        std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
-        if (!is_inited_) {
-          LOGS(*session_logger_, ERROR) << "Session was not initialized";
-          retval = Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
-        }
+  common::Status CreateFeedsFetchesInfo(const std::vector<std::string>& feed_names,
+                                        const std::vector<std::string>& output_names,
+                                        std::unique_ptr<FeedsFetchesInfo>& feeds_fetches_info) {
+    {
+      std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+      if (!is_inited_) {
+        LOGS(*session_logger_, ERROR) << "Session was not initialized";
+        return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
       }
+    }
 
-      ORT_CHECK_AND_SET_RETVAL(ValidateInputs(feeds));
-
-      // if the output vector is non-empty, ensure that its the same size as the output_names
-      ORT_CHECK_AND_SET_RETVAL(ValidateOutputs(output_names, p_fetches));
+    ORT_RETURN_IF_ERROR(ValidateInputNames(feed_names));
+    ORT_RETURN_IF_ERROR(ValidateOutputNames(output_names));
 
-      if (!run_options.run_tag.empty()) {
-        LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
-      }
+    std::unordered_set<std::string> unique_feed_names(feed_names.cbegin(), feed_names.cend());
+    if (unique_feed_names.size() != feed_names.size()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Duplicated feed name.");
+    }
 
-      ++current_num_runs_;
+    auto info = std::make_unique<FeedsFetchesInfo>(feed_names, output_names);
+    ORT_RETURN_IF_ERROR(info->SetMLValueIdxs(session_state_.GetMLValueNameIdxMap()));
+    info->session_state = &session_state_;
 
-      // TODO should we add this exec to the list of executors? i guess its not needed now?
+    feeds_fetches_info = std::move(info);
+    return Status::OK();
+  }
 
-      // scope of owned_run_logger is just the call to Execute.
-      // If Execute ever becomes async we need a different approach
-      std::unique_ptr<logging::Logger> owned_run_logger;
-      auto run_logger = CreateLoggerForRun(run_options, owned_run_logger);
+  Status Run(const RunOptions& run_options,
+             const FeedsFetchesInfo& feeds_fetches_info,
+             const std::vector<MLValue>& feeds,
+             std::vector<MLValue>* p_fetches) {
+    return RunImpl(
+        run_options,
+        [&]() {
+          // the indices are only valid for the session that resolved them
+          if (feeds_fetches_info.session_state != &session_state_) {
+            return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                                   "The FeedsFetchesInfo was not created by this session.");
+          }
+
+          // the names were validated when feeds_fetches_info was created so only the values need checking here
+          if (feeds.size() != feeds_fetches_info.feed_names.size() ||
+              feeds.size() != feeds_fetches_info.feeds_mlvalue_idxs.size()) {
+            return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                                   "Feeds vector incorrectly sized: feed_names.size(): ",
+                                   feeds_fetches_info.feed_names.size(), " feeds.size(): ", feeds.size());
+          }
+
+          ORT_RETURN_IF_ERROR(ValidateInputTypes(feeds_fetches_info, feeds));
+
+          if (!p_fetches) {
+            return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Output vector pointer is NULL");
+          }
+
+          if (!p_fetches->empty() && (feeds_fetches_info.output_names.size() != p_fetches->size())) {
+            return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                                   "Output vector incorrectly sized: output_names.size(): ",
+                                   feeds_fetches_info.output_names.size(), " p_fetches->size(): ", p_fetches->size());
+          }
+
+          return Status::OK();
+        },
+        [&](const logging::Logger& run_logger) {
+          return utils::ExecuteGraph(session_state_, feeds_fetches_info, feeds, *p_fetches, {},
+                                     session_options_.enable_sequential_execution, run_options.terminate,
+                                     run_logger);
+        });
+  }
 
-      // info all execution providers InferenceSession:Run started
-      // TODO: only call OnRunStart for all providers in-use
-      for (auto& xp : execution_providers_) {
-        ORT_CHECK_AND_SET_RETVAL(xp->OnRunStart());
+  common::Status WarmUp(const std::vector<std::unordered_map<std::string, TensorShape>>& input_shapes) {
+    {
+      std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+      if (!is_inited_) {
+        LOGS(*session_logger_, ERROR) << "Session was not initialized";
+        return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
       }
+    }
 
-      ORT_CHECK_AND_SET_RETVAL(
-          utils::ExecuteGraph(session_state_, feeds, output_names, *p_fetches, {},
-                              session_options_.enable_sequential_execution, run_options.terminate, run_logger));
-    } catch (const std::exception& e) {
-      retval = Status(common::ONNXRUNTIME, common::FAIL, e.what());
-    } catch (...) {
-      retval = Status(common::ONNXRUNTIME, common::RUNTIME_EXCEPTION, "Encountered unknown exception in Run()");
+    std::vector<std::string> output_names;
+    output_names.reserve(output_def_list_.size());
+    for (const auto* output_def : output_def_list_) {
+      output_names.push_back(output_def->Name());
     }
 
-    // info all execution providers InferenceSession:Run ended
-    for (auto& xp : execution_providers_)
-      ORT_CHECK_AND_SET_RETVAL(xp->OnRunEnd());
+    // feeds are created on CPU and copied to other devices by Run if needed
+    AllocatorPtr allocator = execution_providers_.Get(onnxruntime::kCpuExecutionProvider)
+                                 ->GetAllocator(0, OrtMemTypeDefault);
 
-    --current_num_runs_;
-    if (session_profiler_.FEnabled()) {
-      session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run", tp);
+    RunOptions run_options;
+    run_options.run_tag = "WarmUp";
+
+    for (const auto& shapes : input_shapes) {
+      NameMLValMap feeds;
+      for (const auto& input : shapes) {
+        const auto& name = input.first;
+        const auto& shape = input.second;
+
+        auto input_def = std::find_if(input_def_list_.cbegin(), input_def_list_.cend(),
+                                      [&name](const NodeArg* def) { return def->Name() == name; });
+        if (input_def == input_def_list_.cend()) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Feed Input Name:", name);
+        }
+
+        const auto* type_proto = (*input_def)->TypeAsProto();
+        if (type_proto == nullptr || !type_proto->has_tensor_type()) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", name,
+                                 " is not a tensor. Only tensor inputs can be warmed up.");
+        }
+
+        if (shape.Size() < 0) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid shape for input ", name, ": ", shape.ToString());
+        }
+
+        MLDataType element_type = DataTypeImpl::TypeFromProto(*type_proto)->AsTensorType()->GetElementType();
+        size_t size = 0;
+        if (!IAllocator::CalcMemSizeForArray(static_cast<size_t>(shape.Size()), element_type->Size(), &size)) {
+          return Status(common::ONNXRUNTIME, common::FAIL, "size overflow");
+        }
+
+        void* buffer = size == 0 ? nullptr : allocator->Alloc(size);
+        if (buffer != nullptr) {
+          memset(buffer, 0, size);
+        }
+
+        auto p_tensor = std::make_unique<Tensor>(element_type, shape, buffer, allocator->Info(), allocator);
+        MLValue value;
+        value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+        feeds.insert({name, value});
+      }
+
+      std::vector<MLValue> fetches;
+      ORT_RETURN_IF_ERROR(Run(run_options, feeds, output_names, &fetches));
     }
-    return retval;
+
+    return Status::OK();
   }
 
   std::pair<common::Status, const ModelMetadata*> GetModelMetadata() const {
@@ -674,10 +1099,106 @@ class InferenceSession::Impl {
   }
 
  private:
+  // Common handling for a Run call. validate() checks the arguments, and execute(run_logger) executes the graph.
+  template <typename TValidate, typename TExecute>
+  Status RunImpl(const RunOptions& run_options, TValidate validate, TExecute execute) {
+    auto tp = session_profiler_.StartTime();
+    Status retval = Status::OK();
+
+    try {
+      {
+        std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+        if (!is_inited_) {
+          LOGS(*session_logger_, ERROR) << "Session was not initialized";
+          retval = Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+        }
+      }
+
+      ORT_CHECK_AND_SET_RETVAL(validate());
+
+      if (!run_options.run_tag.empty()) {
+        LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
+      }
+
+      ++current_num_runs_;
+
+      // TODO should we add this exec to the list of executors? i guess its not needed now?
+
+      // scope of owned_run_logger is just the call to Execute.
+      // If Execute ever becomes async we need a different approach
+      std::unique_ptr<logging::Logger> owned_run_logger;
+      auto run_logger = CreateLoggerForRun(run_options, owned_run_logger);
+
+      // info all execution providers InferenceSession:Run started
+      // TODO: only call OnRunStart for all providers in-use
+      for (auto& xp : execution_providers_) {
+        ORT_CHECK_AND_SET_RETVAL(xp->OnRunStart());
+      }
+
+      ORT_CHECK_AND_SET_RETVAL(execute(run_logger));
+    } catch (const std::exception& e) {
+      retval = Status(common::ONNXRUNTIME, common::FAIL, e.what());
+    } catch (...) {
+      retval = Status(common::ONNXRUNTIME, common::RUNTIME_EXCEPTION, "Encountered unknown exception in Run()");
+    }
+
+    // info all execution providers InferenceSession:Run ended
+    for (auto& xp : execution_providers_)
+      ORT_CHECK_AND_SET_RETVAL(xp->OnRunEnd());
+
+    if (--current_num_runs_ == 0 && session_options_.enable_mem_arena_shrink_on_idle) {
+      ShrinkMemoryArenasOnIdle();
+    }
+
+    if (session_profiler_.FEnabled()) {
+      session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run", tp);
+    }
+    return retval;
+  }
+
   bool HasLocalSchema() const {
     return !custom_schema_registries_.empty();
   }
 
+  std::unordered_set<IArenaAllocator*> GetArenas() const {
+    // execution providers may share an allocator
+    std::unordered_set<IArenaAllocator*> arenas;
+    for (auto& xp : execution_providers_) {
+      for (auto& allocator : xp->GetAllocatorMap()) {
+        auto* arena = dynamic_cast<IArenaAllocator*>(allocator.get());
+        if (arena != nullptr) {
+          arenas.insert(arena);
+        }
+      }
+    }
+
+    return arenas;
+  }
+
+  // shrink the arenas after the last run in progress if they have enough free memory to be worth it. the pooled
+  // frames are kept, as the next run would allocate them again.
+  void ShrinkMemoryArenasOnIdle() {
+    const auto arenas = GetArenas();
+    int64_t free_bytes = 0;
+    for (auto* arena : arenas) {
+      AllocatorStats stats;
+      arena->GetStats(&stats);
+      free_bytes += stats.total_allocated_bytes - stats.bytes_in_use;
+    }
+
+    if (free_bytes <= static_cast<int64_t>(session_options_.mem_arena_shrink_on_idle_min_free_bytes)) {
+      return;
+    }
+
+    size_t released_bytes = 0;
+    for (auto* arena : arenas) {
+      released_bytes += arena->Shrink();
+    }
+
+    VLOGS(*session_logger_, 1) << "Released " << released_bytes << " of " << free_bytes
+                               << " free bytes of arena memory after the last run.";
+  }
+
   // assumes model has already been loaded before
   common::Status DoPostLoadProcessing(onnxruntime::Model& model) {
     // TODO add other post load processing here
@@ -706,11 +1227,17 @@ class InferenceSession::Impl {
       required_model_input_names_.insert(elem->Name());
     }
 
-    // save all valid inputs
+    // save all valid inputs. before IR version 4 every initializer is listed as an input but is constant, so the
+    // graph transformers and the kernels may have already used its value and a feed for it is rejected.
     const auto& all_inputs = graph.GetInputsIncludingInitializers();
     input_def_list_.reserve(all_inputs.size());
     model_input_names_.reserve(all_inputs.size());
     for (const auto& elem : all_inputs) {
+      if (utils::IsConstantInitializer(graph, elem->Name())) {
+        constant_initializer_input_names_.insert(elem->Name());
+        continue;
+      }
+
       input_def_list_.push_back(elem);
       model_input_names_.insert(elem->Name());
     }
@@ -804,6 +1331,8 @@ class InferenceSession::Impl {
   const SessionOptions session_options_;
 
   onnxruntime::GraphTransformerManager graph_transformation_mgr_;
+  // the number of transformers added with RegisterGraphTransformer
+  int num_registered_transformers_ = 0;
 
   /// Logging manager if provided.
   logging::LoggingManager* logging_manager_;
@@ -843,8 +1372,16 @@ class InferenceSession::Impl {
   // names of model inputs and outputs used for quick validation.
   std::unordered_set<std::string> required_model_input_names_;
   std::unordered_set<std::string> model_input_names_;
+  // the initializers listed as graph inputs that can't be overridden by a feed
+  std::unordered_set<std::string> constant_initializer_input_names_;
   std::unordered_set<std::string> model_output_names_;
 
+  // model input definitions indexed by MLValue index. nullptr for values that aren't model inputs.
+  std::vector<const NodeArg*> input_defs_by_mlvalue_idx_;
+
+  // how many execution frames each SessionState, including those of the subgraphs, keeps for reuse
+  size_t execution_frame_pool_capacity_ = 1;
+
   // Environment for this session
   // not used now; we'll need it when we introduce threadpool
   // statically allocated pointer, no need to manage its lifetime.
@@ -855,9 +1392,12 @@ class InferenceSession::Impl {
 #ifdef USE_EIGEN_THREADPOOL
   std::unique_ptr<Eigen::NonBlockingThreadPool> thread_pool_;
 #else
-  std::unique_ptr<TaskThreadPool> thread_pool_;
+  std::unique_ptr<WorkStealingThreadPool> thread_pool_;
 #endif
 
+  // Threadpool shared by all the kernels in this session to parallelize work within a node
+  std::unique_ptr<WorkStealingThreadPool> intra_op_thread_pool_;
+
   // Number of concurrently running executors
   std::atomic<int> current_num_runs_;
 
@@ -907,6 +1447,24 @@ common::Status InferenceSession::Run(const RunOptions& run_options,
   return impl_->Run(run_options, feeds, output_names, p_fetches);
 }
 
+common::Status InferenceSession::CreateFeedsFetchesInfo(const std::vector<std::string>& feed_names,
+                                                        const std::vector<std::string>& output_names,
+                                                        std::unique_ptr<FeedsFetchesInfo>& feeds_fetches_info) {
+  return impl_->CreateFeedsFetchesInfo(feed_names, output_names, feeds_fetches_info);
+}
+
+common::Status InferenceSession::Run(const RunOptions& run_options,
+                                     const FeedsFetchesInfo& feeds_fetches_info,
+                                     const std::vector<MLValue>& feeds,
+                                     std::vector<MLValue>* p_fetches) {
+  return impl_->Run(run_options, feeds_fetches_info, feeds, p_fetches);
+}
+
+common::Status InferenceSession::WarmUp(
+    const std::vector<std::unordered_map<std::string, TensorShape>>& input_shapes) {
+  return impl_->WarmUp(input_shapes);
+}
+
 std::pair<common::Status, const ModelMetadata*> InferenceSession::GetModelMetadata() const {
   return impl_->GetModelMetadata();
 }
@@ -923,6 +1481,23 @@ int InferenceSession::GetCurrentNumRuns() {
   return impl_->GetCurrentNumRuns();
 }
 
+size_t InferenceSession::ShrinkMemoryArenas() {
+  return impl_->ShrinkMemoryArenas();
+}
+
+common::Status InferenceSession::GetCpuArenaStats(AllocatorStats* stats) const {
+  return impl_->GetCpuArenaStats(stats);
+}
+
+common::Status InferenceSession::GetMemoryPatternCacheStats(MemoryPatternCacheStats* stats) const {
+  return impl_->GetMemoryPatternCacheStats(stats);
+}
+
+common::Status InferenceSession::GetGraphAndSessionState(const Graph*& graph,
+                                                         const SessionState*& session_state) const {
+  return impl_->GetGraphAndSessionState(graph, session_state);
+}
+
 void InferenceSession::StartProfiling(const std::string& file_prefix) {
   impl_->StartProfiling(file_prefix);
 }
@@ -3,13 +3,17 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "core/common/common.h"
 #include "core/common/status.h"
+#include "core/framework/arena.h"
 #include "core/framework/framework_common.h"
 #include "core/graph/basic_types.h"
+#include "core/optimizer/graph_transformer_level.h"
 #include "core/common/logging/logging.h"
 
 namespace onnxruntime {  // forward declarations
@@ -23,6 +27,12 @@ class ModelProto;
 namespace onnxruntime {
 class IExecutionProvider;  // forward decl
 class IOBinding;
+class Graph;
+class SessionState;
+class SharedInitializerCache;
+class TensorShape;
+struct FeedsFetchesInfo;
+struct MemoryPatternCacheStats;
 
 class CustomRegistry;
 
@@ -46,11 +56,58 @@ struct SessionOptions {
   // with a big chunk for all the internal memory allocation.
   bool enable_mem_pattern = true;
 
+  // Maximum number of memory patterns to keep, one for each set of input shapes (or dim buckets) seen.
+  // The least recently used pattern is dropped when there are more. 0 for no limit.
+  size_t mem_pattern_cache_capacity = 128;
+
+  // Generate memory patterns by packing the traced allocations after the run, using their lifetimes, instead of
+  // placing each one as it's traced. This usually lowers the peak size of a pattern, at the cost of more time
+  // generating it. Verbose logging reports the peak size of each pattern and its lower bound.
+  bool enable_mem_pattern_offline_packing = false;
+
+  // Sizes to round input dims up to when looking up a memory pattern, e.g. {8, 16, 32, 64, 128} for a
+  // variable sequence length. Inputs with dims in the same buckets share a pattern with blocks large enough for
+  // the largest of them, so the number of patterns and buffers stays bounded. Dims above the largest bucket are
+  // used as is. Empty to use a separate pattern for each set of input shapes.
+  std::vector<int64_t> mem_pattern_dim_buckets;
+
   // enable the memory arena on CPU
   // Arena may pre-allocate memory for future usage.
   // set this option to false if you don't want it.
   bool enable_cpu_mem_arena = true;
 
+  // put a per thread cache of freed small blocks in front of the CPU memory arena, so most small allocations
+  // don't take the arena lock. helps when several threads run the session at once.
+  // only used if enable_cpu_mem_arena is set.
+  bool enable_cpu_mem_arena_thread_cache = false;
+
+  // limit of the memory the CPU arena allocates. a run that needs more fails instead of growing the process.
+  // 0 for no limit.
+  size_t cpu_mem_arena_max_bytes = 0;
+
+  // how the CPU arena sizes the memory it adds when it runs out.
+  // kSameAsRequested keeps a one off large request from growing the arena by more than it needs.
+  ArenaExtendStrategy cpu_mem_arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo;
+
+  // return the memory the arenas aren't using to the system when the session's last run in progress finishes and
+  // they have more than mem_arena_shrink_on_idle_min_free_bytes free, so a one off large request doesn't keep the
+  // process large. makes the next run allocate again. unlike InferenceSession::ShrinkMemoryArenas, the execution
+  // frames pooled for later runs are kept.
+  bool enable_mem_arena_shrink_on_idle = false;
+
+  // the free bytes of the arenas below which shrinking on idle is skipped, so a session that runs steadily doesn't
+  // return and allocate its working memory on every run.
+  size_t mem_arena_shrink_on_idle_min_free_bytes = 64 * 1024 * 1024;
+
+  // map a model loaded from a file path into memory instead of reading it. the CPU tensors for the initializers then
+  // use the file's pages in place of a copy, which lowers the memory used while loading and lets processes that
+  // serve the same model share the pages. the file must not change while the session exists.
+  bool enable_model_file_mapping = false;
+
+  // if set, the CPU initializers with raw data are taken from this cache, which holds one copy of each between all the
+  // sessions using it, e.g. Environment::GetSharedInitializerCache(). nullptr for the session to have its own copy.
+  std::shared_ptr<SharedInitializerCache> shared_initializer_cache;
+
   // the prefix of the profile file. The current time will be appended to the file name.
   std::string profile_file_prefix = "onnxruntime_profile_";
 
@@ -59,8 +116,35 @@ struct SessionOptions {
 
   unsigned max_num_graph_transformation_steps = 5;  // TODO choose a good default here?
 
+  // the graph transformers applied by default when the session is initialized. they run before any registered with
+  // RegisterGraphTransformer, repeatedly until the graph doesn't change or max_num_graph_transformation_steps is
+  // reached. kExtended fuses nodes into ops that only have CPU kernels. kLayout computes convolutions in the NCHWc
+  // layout, which depends on the processor.
+  TransformerLevel graph_optimization_level = TransformerLevel::kBasic;
+
+  // if set, Initialize saves the model to this path once the graph is transformed, partitioned and has its cast and
+  // copy nodes, along with the execution provider of each node. a session that loads the saved model skips those
+  // steps, so it must register the same execution providers in the same order. transformers registered with that
+  // session are not applied either, so register them with the session that saves the model.
+  std::string optimized_model_filepath;
+
+  // transform the ZipMap nodes whose output is a graph output, so it's returned as one batch of maps that share the
+  // keys of the node (a SharedKeyMapsString or SharedKeyMapsInt64) instead of a sequence with a std::map per row.
+  // this changes the type of those outputs.
+  bool enable_zipmap_shared_keys = false;
+
   // How many threads in the session thread pool.
   int session_thread_pool_size = 0;
+
+  // How many execution frames released by finished runs are kept for reuse with their memory pattern buffers, which
+  // is how many concurrent runs avoid setting up a frame. 0 keeps one per thread in the session thread pool, and at
+  // least one.
+  int execution_frame_pool_capacity = 0;
+
+  // How many threads, including the thread calling Run, may be used to execute a single node.
+  // 0 uses all the hardware threads not taken by the session thread pool. The total of this and
+  // session_thread_pool_size is capped at the number of hardware threads.
+  int intra_op_num_threads = 0;
 };
 
 /**
@@ -196,6 +280,41 @@ class InferenceSession {
                      const std::vector<std::string>& output_names,
                      std::vector<MLValue>* p_fetches);
 
+  /**
+    * Resolve the names of the feeds and outputs for repeated Run calls with the same inputs and outputs.
+    * Running with the returned FeedsFetchesInfo takes the feeds and fetches as vectors and skips the per-call
+    * name lookups and validation, which can be a noticeable part of the cost of running a small model.
+    * The session must be initialized first. The FeedsFetchesInfo is valid for as long as the session is, only with
+    * this session, and can be used by multiple threads at once.
+    * @param feed_names names of the inputs that will be fed, in the order the feeds will be provided.
+    * @param output_names names of the outputs to fetch, in the order they will be returned.
+    * @return OK if success.
+    */
+  common::Status CreateFeedsFetchesInfo(const std::vector<std::string>& feed_names,
+                                        const std::vector<std::string>& output_names,
+                                        std::unique_ptr<FeedsFetchesInfo>& feeds_fetches_info);
+
+  /**
+    * Run with the feeds and outputs described by feeds_fetches_info.
+    * @param feeds input values in the order of the feed names in feeds_fetches_info.
+    * @param p_fetches output values in the order of the output names in feeds_fetches_info. Pre-allocated
+    *        values may be provided, otherwise this should be empty and will be resized.
+    * @return OK if success.
+    */
+  common::Status Run(const RunOptions& run_options,
+                     const FeedsFetchesInfo& feeds_fetches_info,
+                     const std::vector<MLValue>& feeds,
+                     std::vector<MLValue>* p_fetches);
+
+  /**
+    * Run the model once for each set of input shapes so the memory patterns for them are ready before the first
+    * real request. Use the upper bound of each dim bucket if SessionOptions::mem_pattern_dim_buckets is set.
+    * The inputs are zero filled tensors, so this fails for a model that can't run with zeros.
+    * @param input_shapes sets of shapes for the inputs, keyed by input name.
+    * @return OK if success.
+    */
+  common::Status WarmUp(const std::vector<std::unordered_map<std::string, TensorShape>>& input_shapes);
+
   /**
   * Creates a new binding object for binding inputs and outputs.
   * @param provider_type specifies the location where the inputs need to be potentially copied. 
@@ -232,6 +351,29 @@ class InferenceSession {
     */
   int GetCurrentNumRuns();
 
+  /**
+    * Return the memory the session's arenas aren't using to the system, e.g. after a one off large request.
+    * Safe to call while runs are in progress, though memory they're using isn't released.
+    * The execution frames pooled for reuse by later runs are released first, along with their memory pattern buffers.
+    * With enable_cpu_mem_arena_thread_cache, only the small blocks cached by the calling thread are returned. Blocks
+    * cached by other threads, e.g. those of the intra-op thread pool, keep their regions.
+    * @return the number of bytes released.
+    */
+  size_t ShrinkMemoryArenas();
+
+  /**
+    * Get the statistics of the CPU memory arena, e.g. the bytes it has allocated and how many are in use.
+    * The stats are all 0 if the CPU arena is disabled.
+    * @return OK if success. FAIL if the session isn't initialized.
+    */
+  common::Status GetCpuArenaStats(AllocatorStats* stats) const;
+
+  /**
+    * Get the size of the main graph's memory pattern cache and how often runs found a pattern in it.
+    * @return OK if success. FAIL if the session isn't initialized.
+    */
+  common::Status GetMemoryPatternCacheStats(MemoryPatternCacheStats* stats) const;
+
   /**
     * Start profiling on this inference session. This simply turns on profiling events to be 
     * recorded. A corresponding EndProfiling has to follow to write profiling data to a file.
@@ -267,6 +409,12 @@ class InferenceSession {
     */
   common::Status Load(std::unique_ptr<ONNX_NAMESPACE::ModelProto> p_model_proto);
 
+  /**
+    * Get the main graph of the model and the SessionState it's run with, e.g. to check them in a test.
+    * @return OK if success. FAIL if the session isn't initialized.
+    */
+  common::Status GetGraphAndSessionState(const Graph*& graph, const SessionState*& session_state) const;
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(InferenceSession);
 
@@ -17,8 +17,10 @@
 #include "core/framework/tensor.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/environment.h"
+#include "core/framework/feeds_fetches_info.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/onnxruntime_typeinfo.h"
+#include "core/framework/shared_initializer_cache.h"
 #include "core/session/inference_session.h"
 
 #include "abi_session_options_impl.h"
@@ -33,7 +35,11 @@ using onnxruntime::MLFloat16;
 using onnxruntime::MLStatus;
 using onnxruntime::MLValue;
 using onnxruntime::OutputDefList;
+using onnxruntime::SharedKeyMaps;
+using onnxruntime::SharedKeyMapsInt64;
+using onnxruntime::SharedKeyMapsString;
 using onnxruntime::Tensor;
+using onnxruntime::TensorShape;
 using onnxruntime::ToOrtStatus;
 using onnxruntime::common::Status;
 
@@ -129,6 +135,18 @@ ORT_API_STATUS_IMPL(OrtCreateEnv, OrtLoggingLevel default_warning_level,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtGetSharedInitializerStats, _In_ OrtEnv* env, _Out_ size_t* num_tensors,
+                    _Out_ size_t* num_bytes, _Out_ size_t* num_references, _Out_ size_t* num_referenced_bytes) {
+  API_IMPL_BEGIN
+  const auto stats = env->value->GetSharedInitializerCache()->GetStats();
+  *num_tensors = stats.num_tensors;
+  *num_bytes = stats.num_bytes;
+  *num_references = stats.num_references;
+  *num_referenced_bytes = stats.num_referenced_bytes;
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtGetStringTensorDataLength, _In_ const OrtValue* value, _Out_ size_t* out) {
   TENSOR_READ_API_BEGIN
   const auto* src = tensor.Data<std::string>();
@@ -356,7 +374,11 @@ static OrtStatus* CreateSessionImpl(_In_ OrtEnv* env, _In_ T model_path,
                                     _In_ const OrtSessionOptions* options,
                                     _Out_ OrtSession** out) {
   API_IMPL_BEGIN
-  auto sess = std::make_unique<::onnxruntime::InferenceSession>(options == nullptr ? onnxruntime::SessionOptions() : options->value, env->loggingManager);
+  onnxruntime::SessionOptions session_options = options == nullptr ? onnxruntime::SessionOptions() : options->value;
+  if (options != nullptr && options->use_shared_initializers) {
+    session_options.shared_initializer_cache = env->value->GetSharedInitializerCache();
+  }
+  auto sess = std::make_unique<::onnxruntime::InferenceSession>(session_options, env->loggingManager);
   Status status;
   if (options != nullptr && !options->custom_op_paths.empty()) {
     status = sess->LoadCustomOps(options->custom_op_paths);
@@ -454,6 +476,86 @@ ORT_API_STATUS_IMPL(OrtRun, _In_ OrtSession* sess,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtCreateRunPlan, _In_ OrtSession* sess,
+                    _In_ const char* const* input_names, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len, _Out_ OrtRunPlan** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  std::vector<std::string> feed_names(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    feed_names[i] = input_names[i];
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtCreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+  }
+
+  std::unique_ptr<::onnxruntime::FeedsFetchesInfo> feeds_fetches_info;
+  auto status = session->CreateFeedsFetchesInfo(feed_names, output_names, feeds_fetches_info);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+
+  *out = reinterpret_cast<OrtRunPlan*>(feeds_fetches_info.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtRunWithPlan, _Inout_ OrtSession* sess,
+                    _In_ OrtRunOptions* run_options, _In_ const OrtRunPlan* run_plan,
+                    _In_ const OrtValue* const* input, _Out_ OrtValue** output) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  const auto& feeds_fetches_info = *reinterpret_cast<const ::onnxruntime::FeedsFetchesInfo*>(run_plan);
+  const int queue_id = 0;
+
+  const size_t input_len = feeds_fetches_info.feed_names.size();
+  std::vector<MLValue> feeds(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    feeds[i] = *reinterpret_cast<const ::onnxruntime::MLValue*>(input[i]);
+    if (feeds[i].Fence())
+      feeds[i].Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+  }
+
+  const size_t output_names_len = feeds_fetches_info.output_names.size();
+  std::vector<MLValue> fetches(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output[i] != nullptr) {
+      ::onnxruntime::MLValue& value = *reinterpret_cast<::onnxruntime::MLValue*>(output[i]);
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsOutput(onnxruntime::kCpuExecutionProvider, queue_id);
+      fetches[i] = value;
+    }
+  }
+
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->Run(op, feeds_fetches_info, feeds, &fetches);
+  } else {
+    status = session->Run(*run_options, feeds_fetches_info, feeds, &fetches);
+  }
+
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    ::onnxruntime::MLValue& value = fetches[i];
+    if (value.Fence())
+      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    if (output[i] == nullptr) {
+      output[i] = reinterpret_cast<OrtValue*>(new MLValue(value));
+    }
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtGetTensorMutableData, _In_ OrtValue* value, _Out_ void** output) {
   TENSOR_READWRITE_API_BEGIN
   //TODO: test if it's a string tensor
@@ -518,6 +620,34 @@ ORT_API_STATUS_IMPL(OrtTensorProtoToOrtValue, _Inout_ OrtAllocator* allocator,
     delete[] reinterpret_cast<REAL_TYPE*>(value);                           \
   }
 
+ORT_API_STATUS_IMPL(OrtSessionShrinkMemoryArenas, _Inout_ OrtSession* sess, _Out_opt_ size_t* released_bytes) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  size_t bytes = session->ShrinkMemoryArenas();
+  if (released_bytes != nullptr)
+    *released_bytes = bytes;
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtSessionGetCpuArenaStats, _In_ const OrtSession* sess, _Out_ OrtArenaStats* out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  ::onnxruntime::AllocatorStats stats;
+  auto status = session->GetCpuArenaStats(&stats);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  out->bytes_limit = stats.bytes_limit;
+  out->total_allocated_bytes = stats.total_allocated_bytes;
+  out->bytes_in_use = stats.bytes_in_use;
+  out->max_bytes_in_use = stats.max_bytes_in_use;
+  out->num_allocs = stats.num_allocs;
+  out->num_extensions = stats.num_arena_extensions;
+  out->num_shrinkages = stats.num_arena_shrinkages;
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtSessionGetInputCount, _In_ const OrtSession* sess, _Out_ size_t* out) {
   API_IMPL_BEGIN
   auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
@@ -593,6 +723,46 @@ ORT_API(int, OrtIsTensor, _In_ const OrtValue* value) {
   return v->IsTensor() ? 1 : 0;
 }
 
+namespace {
+// the tensors point at the data of the batch, so they don't own it
+template <typename K>
+OrtStatus* GetSharedKeyMapsImpl(const SharedKeyMaps<K>& maps, OrtValue** keys, OrtValue** values) {
+  if (maps.keys == nullptr || maps.keys->empty()) {
+    return OrtCreateStatus(ORT_INVALID_ARGUMENT, "the batch of maps has no keys");
+  }
+  const auto num_keys = static_cast<int64_t>(maps.keys->size());
+  const auto num_maps = static_cast<int64_t>(maps.values.size()) / num_keys;
+  const OrtAllocatorInfo cpu_info(onnxruntime::CPU, OrtDeviceAllocator);
+
+  auto keys_value = std::make_unique<MLValue>();
+  keys_value->Init(new Tensor(DataTypeImpl::GetType<K>(), TensorShape({num_keys}),
+                              const_cast<K*>(maps.keys->data()), cpu_info),
+                   DataTypeImpl::GetType<Tensor>(),
+                   DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  auto values_value = std::make_unique<MLValue>();
+  values_value->Init(new Tensor(DataTypeImpl::GetType<float>(), TensorShape({num_maps, num_keys}),
+                                const_cast<float*>(maps.values.data()), cpu_info),
+                     DataTypeImpl::GetType<Tensor>(),
+                     DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  *keys = reinterpret_cast<OrtValue*>(keys_value.release());
+  *values = reinterpret_cast<OrtValue*>(values_value.release());
+  return nullptr;
+}
+}  // namespace
+
+ORT_API_STATUS_IMPL(OrtGetSharedKeyMaps, _In_ const OrtValue* value, _Out_ OrtValue** keys, _Out_ OrtValue** values) {
+  API_IMPL_BEGIN
+  auto v = reinterpret_cast<const ::onnxruntime::MLValue*>(value);
+  if (v->Type() == DataTypeImpl::GetType<SharedKeyMapsString>()) {
+    return GetSharedKeyMapsImpl(v->Get<SharedKeyMapsString>(), keys, values);
+  }
+  if (v->Type() == DataTypeImpl::GetType<SharedKeyMapsInt64>()) {
+    return GetSharedKeyMapsImpl(v->Get<SharedKeyMapsInt64>(), keys, values);
+  }
+  return OrtCreateStatus(ORT_INVALID_ARGUMENT, "the value is not a batch of maps with shared keys");
+  API_IMPL_END
+}
+
 ORT_API(void*, OrtAllocatorAlloc, _Inout_ OrtAllocator* ptr, size_t size) {
   try {
     return ptr->Alloc(ptr, size);
@@ -634,4 +804,5 @@ DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Env, OrtEnv)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Value, MLValue)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(RunOptions, OrtRunOptions)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Session, ::onnxruntime::InferenceSession)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(RunPlan, ::onnxruntime::FeedsFetchesInfo)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION_FOR_ARRAY(Status, char)
@@ -213,6 +213,30 @@ void GemmEx(
     int ldc,
     Provider* provider);
 
+// GemmStridedBatched runs batch_count GemmEx calls where the matrices of each batch entry are stride_a, stride_b and
+// stride_c elements after those of the previous entry. A stride of 0 for A or B uses the same matrix for the whole
+// batch.
+template <typename T, class Provider>
+void GemmStridedBatched(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    int M,
+    int N,
+    int K,
+    T alpha,
+    const T* A,
+    int lda,
+    int64_t stride_a,
+    const T* B,
+    int ldb,
+    int64_t stride_b,
+    T beta,
+    T* C,
+    int ldc,
+    int64_t stride_c,
+    int batch_count,
+    Provider* provider);
+
 // GemmBatched provides a simple abstraction into library routines
 template <typename T, class Provider>
 void GemmBatched(
@@ -229,6 +229,42 @@ void GemmEx<float, CPUMathUtil>(
 #endif
 }
 
+template <>
+void GemmStridedBatched<float, CPUMathUtil>(
+    const CBLAS_TRANSPOSE TransA,
+    const CBLAS_TRANSPOSE TransB,
+    const int M,
+    const int N,
+    const int K,
+    const float alpha,
+    const float* A,
+    const int lda,
+    const int64_t stride_a,
+    const float* B,
+    const int ldb,
+    const int64_t stride_b,
+    const float beta,
+    float* C,
+    const int ldc,
+    const int64_t stride_c,
+    const int batch_count,
+    CPUMathUtil* provider) {
+#if defined(USE_MLAS) && !defined(USE_MKLDNN)
+  // MLAS threads across the batch and packs a broadcast B once
+  ORT_UNUSED_PARAMETER(provider);
+  MlasSgemmBatch(TransA, TransB, M, N, K, alpha,
+                 A, lda, static_cast<size_t>(stride_a),
+                 B, ldb, static_cast<size_t>(stride_b),
+                 beta, C, ldc, static_cast<size_t>(stride_c),
+                 batch_count);
+#else
+  for (int i = 0; i < batch_count; ++i) {
+    GemmEx<float, CPUMathUtil>(TransA, TransB, M, N, K, alpha, A + stride_a * i, lda, B + stride_b * i, ldb,
+                               beta, C + stride_c * i, ldc, provider);
+  }
+#endif
+}
+
 template <>
 void Gemv<float, CPUMathUtil>(
     const CBLAS_TRANSPOSE TransA,
@@ -363,6 +399,32 @@ void GemmEx<float, CPUMathUtil>(
               beta, C, ldc);
 }
 
+template <>
+void GemmStridedBatched<float, CPUMathUtil>(
+    const CBLAS_TRANSPOSE TransA,
+    const CBLAS_TRANSPOSE TransB,
+    const int M,
+    const int N,
+    const int K,
+    const float alpha,
+    const float* A,
+    const int lda,
+    const int64_t stride_a,
+    const float* B,
+    const int ldb,
+    const int64_t stride_b,
+    const float beta,
+    float* C,
+    const int ldc,
+    const int64_t stride_c,
+    const int batch_count,
+    CPUMathUtil* /*context*/) {
+  for (int i = 0; i < batch_count; ++i) {
+    cblas_sgemm(CblasRowMajor, TransA, TransB, M, N, K, alpha, A + stride_a * i, lda, B + stride_b * i, ldb,
+                beta, C + stride_c * i, ldc);
+  }
+}
+
 template <>
 void Gemv<float, CPUMathUtil>(
     const CBLAS_TRANSPOSE TransA,
@@ -96,6 +96,18 @@ template <typename T>
 void AddNonTensor(onnxruntime::MLValue& val, vector<py::object>& pyobjs) {
   pyobjs.push_back(py::cast(val.Get<T>()));
 }
+// a batch of maps with shared keys is returned as the list of keys and an [N, K] array of the values of each map
+template <typename K>
+void AddSharedKeyMaps(onnxruntime::MLValue& val, vector<py::object>& pyobjs) {
+  const auto& maps = val.Get<SharedKeyMaps<K>>();
+  const auto num_keys = static_cast<npy_intp>(maps.keys->size());
+  npy_intp npy_dims[2] = {num_keys == 0 ? 0 : static_cast<npy_intp>(maps.values.size()) / num_keys, num_keys};
+  py::object values = py::reinterpret_steal<py::object>(PyArray_SimpleNew(2, npy_dims, NPY_FLOAT));
+  memcpy(PyArray_DATA(reinterpret_cast<PyArrayObject*>(values.ptr())), maps.values.data(),
+         maps.values.size() * sizeof(float));
+  pyobjs.push_back(py::make_tuple(py::cast(*maps.keys), values));
+}
+
 void AddNonTensorAsPyObj(onnxruntime::MLValue& val, vector<py::object>& pyobjs) {
   // Should be in sync with core/framework/datatypes.h
   if (val.Type() == DataTypeImpl::GetType<MapStringToString>()) {
@@ -126,6 +138,10 @@ void AddNonTensorAsPyObj(onnxruntime::MLValue& val, vector<py::object>& pyobjs)
     AddNonTensor<VectorMapStringToFloat>(val, pyobjs);
   } else if (val.Type() == DataTypeImpl::GetType<VectorMapInt64ToFloat>()) {
     AddNonTensor<VectorMapInt64ToFloat>(val, pyobjs);
+  } else if (val.Type() == DataTypeImpl::GetType<SharedKeyMapsString>()) {
+    AddSharedKeyMaps<std::string>(val, pyobjs);
+  } else if (val.Type() == DataTypeImpl::GetType<SharedKeyMapsInt64>()) {
+    AddSharedKeyMaps<int64_t>(val, pyobjs);
   } else {
     throw std::runtime_error("Output is a non-tensor type which is not supported.");
   }
@@ -237,19 +253,44 @@ with a big chunk for all the internal memory allocation. Default is true.)pbdoc"
       .def_readwrite("enable_cpu_mem_arena", &SessionOptions::enable_cpu_mem_arena,
                      R"pbdoc(Enables the memory arena on CPU. Arena may pre-allocate memory for future usage.
 Set this option to false if you don't want it. Default is True.)pbdoc")
+      .def_readwrite("enable_model_file_mapping", &SessionOptions::enable_model_file_mapping,
+                     R"pbdoc(Maps a model loaded from a file path into memory instead of reading it, so the CPU
+tensors for its initializers use the file's pages in place. The file must not change while the session exists.
+Default is False.)pbdoc")
+      .def_readwrite("enable_zipmap_shared_keys", &SessionOptions::enable_zipmap_shared_keys,
+                     R"pbdoc(Returns the output of the ZipMap nodes that are graph outputs as a tuple of the list of
+keys and a 2D numpy array with the values of each map in a row, instead of a list of dicts. Default is False.)pbdoc")
       .def_readwrite("enable_profiling", &SessionOptions::enable_profiling,
                      R"pbdoc(Enable profiling for this session. Default is false.)pbdoc")
       .def_readwrite("enable_sequential_execution", &SessionOptions::enable_sequential_execution,
                      R"pbdoc(Enables sequential execution, disables parallel execution. Default is true.)pbdoc")
       .def_readwrite("max_num_graph_transformation_steps", &SessionOptions::max_num_graph_transformation_steps,
                      R"pbdoc(Runs optimization steps on the execution graph. Default is 5.)pbdoc")
+      .def_property(
+          "graph_optimization_level",
+          [](const SessionOptions* options) { return static_cast<int>(options->graph_optimization_level); },
+          [](SessionOptions* options, int level) {
+            if (level < static_cast<int>(TransformerLevel::kNone) || level > static_cast<int>(TransformerLevel::kLayout)) {
+              throw std::runtime_error("Invalid graph optimization level " + std::to_string(level));
+            }
+            options->graph_optimization_level = static_cast<TransformerLevel>(level);
+          },
+          R"pbdoc(Graph transformers to apply by default. 0 for none, 1 for basic eliminations and constant folding
+into Conv, 2 to also fuse nodes into larger kernels that only run on CPU, 3 to also compute convolutions in the
+NCHWc layout of the processor. Default is 1.)pbdoc")
+      .def_readwrite("optimized_model_filepath", &SessionOptions::optimized_model_filepath,
+                     R"pbdoc(File path to save the model to after the graph transformations and the assignment of
+nodes to execution providers. A session that loads the saved model skips those steps. Default is empty.)pbdoc")
       .def_readwrite("session_logid", &SessionOptions::session_logid,
                      R"pbdoc(Logger id to use for session output.)pbdoc")
       .def_readwrite("session_log_verbosity_level", &SessionOptions::session_log_verbosity_level,
                      R"pbdoc(Applies to session load, initialization, etc. Default is 0.)pbdoc")
       .def_readwrite("session_thread_pool_size", &SessionOptions::session_thread_pool_size,
                      R"pbdoc(How many threads in the session thread pool. Default is 0 to let onnxruntime choose.
-This parameter is unused unless *enable_sequential_execution* is false.)pbdoc");
+This parameter is unused unless *enable_sequential_execution* is false.)pbdoc")
+      .def_readwrite("intra_op_num_threads", &SessionOptions::intra_op_num_threads,
+                     R"pbdoc(How many threads, including the calling thread, may be used to execute a single node.
+Default is 0 to use the hardware threads not taken by the session thread pool.)pbdoc");
 
   py::class_<RunOptions>(m, "RunOptions", R"pbdoc(Configuration information for a single Run.)pbdoc")
       .def(py::init())
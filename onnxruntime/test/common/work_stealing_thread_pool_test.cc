@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/work_stealing_thread_pool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(WorkStealingDequeTest, OwnerPopsInLifoOrderThiefStealsInFifoOrder) {
+  WorkStealingDeque<int> deque(2);
+  int values[4] = {0, 1, 2, 3};
+
+  for (auto& value : values) {
+    ASSERT_TRUE(deque.Push(&value));
+  }
+
+  // capacity is 4 so the next push must fail
+  int extra = 4;
+  EXPECT_FALSE(deque.Push(&extra));
+
+  EXPECT_EQ(deque.Steal(), &values[0]);
+  EXPECT_EQ(deque.Pop(), &values[3]);
+  EXPECT_EQ(deque.Pop(), &values[2]);
+  EXPECT_EQ(deque.Steal(), &values[1]);
+  EXPECT_EQ(deque.Pop(), nullptr);
+  EXPECT_EQ(deque.Steal(), nullptr);
+  EXPECT_TRUE(deque.Empty());
+}
+
+TEST(WorkStealingThreadPoolTest, RunsAllNestedTasks) {
+  const int num_outer = 200;
+  const int num_inner = 50;
+  const int total = num_outer * (num_inner + 1);
+
+  std::atomic<int> count{0};
+  std::mutex mutex;
+  std::condition_variable cv;
+
+  auto task_done = [&]() {
+    if (count.fetch_add(1) + 1 == total) {
+      std::lock_guard<std::mutex> lock(mutex);
+      cv.notify_all();
+    }
+  };
+
+  {
+    WorkStealingThreadPool pool(4);
+
+    for (int i = 0; i < num_outer; ++i) {
+      pool.Schedule([&]() {
+        // tasks scheduled from a worker go to that worker's deque and can be stolen by the others
+        EXPECT_NE(pool.CurrentThreadId(), -1);
+        for (int j = 0; j < num_inner; ++j) {
+          pool.Schedule(task_done);
+        }
+        task_done();
+      });
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&]() { return count.load() == total; });
+    }
+
+    EXPECT_EQ(pool.CurrentThreadId(), -1);
+
+    ASSERT_EQ(pool.GetStats().size(), 4u);
+  }
+
+  EXPECT_EQ(count.load(), total);
+}
+
+TEST(WorkStealingThreadPoolTest, StatsCountTasks) {
+  std::atomic<int> count{0};
+  uint64_t tasks_run = 0;
+
+  {
+    WorkStealingThreadPool pool(2);
+    for (int i = 0; i < 100; ++i) {
+      pool.Schedule([&count]() { ++count; });
+    }
+
+    while (count.load() < 100) {
+      std::this_thread::yield();
+    }
+
+    // wait for the counters, which are updated after each task completes, to catch up
+    while (tasks_run < 100) {
+      tasks_run = 0;
+      for (const auto& stats : pool.GetStats()) {
+        tasks_run += stats.tasks_run;
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  EXPECT_EQ(tasks_run, 100u);
+}
+
+TEST(WorkStealingThreadPoolTest, ParallelForRunsEachIterationOnce) {
+  WorkStealingThreadPool pool(3);
+
+  std::vector<std::atomic<int>> counts(1000);
+  for (auto& count : counts) {
+    count = 0;
+  }
+
+  pool.ParallelFor(static_cast<int32_t>(counts.size()), [&counts](int32_t i) { ++counts[i]; });
+
+  for (const auto& count : counts) {
+    EXPECT_EQ(count.load(), 1);
+  }
+
+  // nested loops run from inside the pool must not deadlock
+  std::atomic<int> nested{0};
+  std::atomic<int> nested_scopes{0};
+  {
+    IntraOpThreadPoolScope scope(&pool);
+    pool.ParallelFor(8, [&pool, &nested, &nested_scopes](int32_t) {
+      // code inside the loop such as MLAS calls should see that it has to run single threaded
+      const IntraOpThreadPoolScope* current = IntraOpThreadPoolScope::GetCurrent();
+      if (current != nullptr && current->ThreadPool() == nullptr) {
+        ++nested_scopes;
+      }
+
+      pool.ParallelFor(8, [&nested](int32_t) { ++nested; });
+    });
+
+    EXPECT_EQ(IntraOpThreadPoolScope::GetCurrent()->ThreadPool(), &pool);
+  }
+
+  EXPECT_EQ(nested.load(), 64);
+  EXPECT_EQ(nested_scopes.load(), 8);
+  EXPECT_EQ(IntraOpThreadPoolScope::GetCurrent(), nullptr);
+
+  // without a pool the loop runs serially on the calling thread
+  std::vector<int32_t> order;
+  WorkStealingThreadPool::TryParallelFor(nullptr, 4, [&order](int32_t i) { order.push_back(i); });
+  EXPECT_EQ(order, (std::vector<int32_t>{0, 1, 2, 3}));
+}
+
+TEST(WorkStealingThreadPoolTest, ParallelForPropagatesExceptions) {
+  WorkStealingThreadPool pool(2);
+  std::atomic<int> count{0};
+
+  EXPECT_THROW(pool.ParallelFor(16, [&count](int32_t i) {
+    ++count;
+    if (i == 5) {
+      throw std::runtime_error("iteration failed");
+    }
+  }),
+               std::runtime_error);
+
+  // the remaining iterations still run
+  EXPECT_EQ(count.load(), 16);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -234,5 +234,76 @@ TEST(BFCArenaTest, TestReserve) {
   a.GetStats(&stats);
   EXPECT_EQ(stats.total_allocated_bytes, 1048576);
 }
+
+TEST(BFCArenaTest, ReserveRespectsMemoryLimit) {
+  // the first allocation adds a 1MiB region
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 2 << 20);
+
+  void* first_ptr = a.Alloc(1024);
+  EXPECT_EQ(nullptr, a.Reserve(2 << 20));
+
+  void* second_ptr = a.Reserve(1 << 10);
+  EXPECT_NE(nullptr, second_ptr);
+  a.Free(first_ptr);
+  a.Free(second_ptr);
+}
+
+TEST(BFCArenaTest, ExtendStrategy) {
+  const size_t size = 3 << 20;
+
+  BFCArena doubling(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+  void* ptr = doubling.Alloc(size);
+  AllocatorStats stats;
+  doubling.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 4 << 20);
+  EXPECT_EQ(stats.num_arena_extensions, 1);
+  doubling.Free(ptr);
+
+  BFCArena exact(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30,
+                 ArenaExtendStrategy::kSameAsRequested);
+  ptr = exact.Alloc(size);
+  void* ptr2 = exact.Alloc(size);
+  exact.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 2 * size);
+  EXPECT_EQ(stats.num_arena_extensions, 2);
+  exact.Free(ptr);
+  exact.Free(ptr2);
+}
+
+TEST(BFCArenaTest, Shrink) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+
+  void* small_ptr = a.Alloc(1024);
+  void* large_ptr = a.Alloc(64 << 20);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  const int64_t large_region_bytes = stats.total_allocated_bytes - (1 << 20);
+  EXPECT_EQ(stats.num_arena_extensions, 2);
+  EXPECT_GE(large_region_bytes, 64 << 20);
+
+  // nothing to release while both regions are in use
+  EXPECT_EQ(a.Shrink(), 0u);
+
+  a.Free(large_ptr);
+  EXPECT_EQ(a.Shrink(), static_cast<size_t>(large_region_bytes));
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1 << 20);
+  EXPECT_EQ(stats.num_arena_shrinkages, 1);
+
+  // the arena grows again after shrinking
+  large_ptr = a.Alloc(64 << 20);
+  EXPECT_NE(nullptr, large_ptr);
+  a.Free(large_ptr);
+  a.Free(small_ptr);
+
+  a.Shrink();
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+
+  void* ptr = a.Alloc(1024);
+  EXPECT_NE(nullptr, ptr);
+  a.Free(ptr);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,327 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <sstream>
+
+#include "core/framework/arena.h"
+#include "core/framework/execution_frame.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/session_state.h"
+#include "core/graph/model.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "core/session/inference_session.h"
+#include "test/model_proto_builder.h"
+#include "test/test_environment.h"
+#include "test_utils.h"
+#include "gtest/gtest.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+class InferenceSessionStateWrapper : public InferenceSession {
+ public:
+  using InferenceSession::GetGraphAndSessionState;
+  using InferenceSession::InferenceSession;
+};
+
+// T3 = Clip(MatMul(MatMul(X1, X2), X3)), so T1 and T2 are in the memory pattern
+static std::string CreateMatMulClipModel() {
+  GraphProto graph;
+  graph.set_name("matmul_clip");
+  AddValueInfo(graph.add_input(), "X1", {1, 2});
+  AddValueInfo(graph.add_input(), "X2", {2, 2});
+  AddValueInfo(graph.add_input(), "X3", {2, 3});
+  AddValueInfo(graph.add_output(), "T3", {1, 3});
+
+  AddNode(graph, "MatMul", {"X1", "X2"}, {"T1"});
+  AddNode(graph, "MatMul", {"T1", "X3"}, {"T2"});
+  AddNode(graph, "Clip", {"T2"}, {"T3"});
+
+  std::string serialized;
+  CreateModelProto(std::move(graph), 7).SerializeToString(&serialized);
+  return serialized;
+}
+
+TEST(ExecutionFramePoolTest, SteadyStateRunOnlyAllocatesOutputs) {
+  SessionOptions so;
+  so.session_logid = "ExecutionFramePoolTest.SteadyStateRunOnlyAllocatesOutputs";
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  std::istringstream model_stream(CreateMatMulClipModel());
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  auto status = session_object.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  MLValue v1, v2, v3;
+  CreateMLValue<float>(allocator, std::vector<int64_t>{1, 2}, std::vector<float>(2, 1.0f), &v1);
+  CreateMLValue<float>(allocator, std::vector<int64_t>{2, 2}, std::vector<float>(4, 1.0f), &v2);
+  CreateMLValue<float>(allocator, std::vector<int64_t>{2, 3}, std::vector<float>(6, 1.0f), &v3);
+  NameMLValMap feeds{{"X1", v1}, {"X2", v2}, {"X3", v3}};
+  std::vector<std::string> output_names{"T3"};
+
+  // the first run traces the memory pattern and the second binds its buffer to the pooled frame
+  RunOptions run_options;
+  for (int i = 0; i < 2; ++i) {
+    std::vector<MLValue> fetches;
+    status = session_object.Run(run_options, feeds, output_names, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  }
+
+  // steady state. the frame and its memory pattern buffer are reused, so the session's arena only allocates the
+  // output, which the caller keeps.
+  AllocatorStats stats;
+  ASSERT_TRUE(session_object.GetCpuArenaStats(&stats).IsOK());
+  const int64_t allocs_before = stats.num_allocs;
+
+  for (int i = 0; i < 3; ++i) {
+    std::vector<MLValue> fetches;
+    status = session_object.Run(run_options, feeds, output_names, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    ASSERT_EQ(fetches.size(), 1u);
+    const auto& t3 = fetches[0].Get<Tensor>();
+    ASSERT_EQ(t3.Shape(), TensorShape({1, 3}));
+    for (int64_t j = 0; j < 3; ++j) {
+      EXPECT_EQ(t3.Data<float>()[j], 4.f);
+    }
+  }
+
+  ASSERT_TRUE(session_object.GetCpuArenaStats(&stats).IsOK());
+  EXPECT_EQ(stats.num_allocs - allocs_before, 3);
+}
+
+TEST(ExecutionFramePoolTest, SteadyStateRunDoesNotConstructFrame) {
+  SessionOptions so;
+  so.session_logid = "ExecutionFramePoolTest.SteadyStateRunDoesNotConstructFrame";
+
+  InferenceSessionStateWrapper session_object{so, &DefaultLoggingManager()};
+  std::istringstream model_stream(CreateMatMulClipModel());
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  auto status = session_object.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  const Graph* graph = nullptr;
+  const SessionState* session_state = nullptr;
+  ASSERT_TRUE(session_object.GetGraphAndSessionState(graph, session_state).IsOK());
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  MLValue v1, v2, v3;
+  CreateMLValue<float>(allocator, std::vector<int64_t>{1, 2}, std::vector<float>(2, 1.0f), &v1);
+  CreateMLValue<float>(allocator, std::vector<int64_t>{2, 2}, std::vector<float>(4, 1.0f), &v2);
+  CreateMLValue<float>(allocator, std::vector<int64_t>{2, 3}, std::vector<float>(6, 1.0f), &v3);
+  NameMLValMap feeds{{"X1", v1}, {"X2", v2}, {"X3", v3}};
+  std::vector<std::string> output_names{"T3"};
+  RunOptions run_options;
+
+  // the number of allocations one Run makes from the session's arena, which includes the output
+  auto count_run_allocations = [&]() {
+    AllocatorStats stats;
+    EXPECT_TRUE(session_object.GetCpuArenaStats(&stats).IsOK());
+    const int64_t allocs_before = stats.num_allocs;
+    std::vector<MLValue> fetches;
+    status = session_object.Run(run_options, feeds, output_names, &fetches);
+    EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+    EXPECT_TRUE(session_object.GetCpuArenaStats(&stats).IsOK());
+    return stats.num_allocs - allocs_before;
+  };
+
+  for (int i = 0; i < 2; ++i) {
+    count_run_allocations();
+  }
+
+  // steady state runs reuse the pooled frame, so each makes the same allocations
+  const int64_t steady_state_allocations = count_run_allocations();
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(count_run_allocations(), steady_state_allocations);
+    EXPECT_EQ(session_state->GetExecutionFramePoolSize(), 1u);
+  }
+
+  // after the pool is released the next run constructs a frame, which allocates the memory pattern buffer again.
+  // the frame it pools is reused by the runs after it.
+  session_object.ShrinkMemoryArenas();
+  EXPECT_EQ(session_state->GetExecutionFramePoolSize(), 0u);
+  EXPECT_GT(count_run_allocations(), steady_state_allocations);
+  EXPECT_EQ(session_state->GetExecutionFramePoolSize(), 1u);
+  EXPECT_EQ(count_run_allocations(), steady_state_allocations);
+}
+
+TEST(ExecutionFramePoolTest, ShrinkOnIdleKeepsPooledFrame) {
+  for (size_t min_free_bytes : {size_t{0}, size_t{64 * 1024 * 1024}}) {
+    SessionOptions so;
+    so.session_logid = "ExecutionFramePoolTest.ShrinkOnIdleKeepsPooledFrame";
+    // without a memory pattern T1 and T2 are allocated separately, and their region is free when the run finishes
+    so.enable_mem_pattern = false;
+    so.cpu_mem_arena_extend_strategy = ArenaExtendStrategy::kSameAsRequested;
+    so.enable_mem_arena_shrink_on_idle = true;
+    so.mem_arena_shrink_on_idle_min_free_bytes = min_free_bytes;
+
+    InferenceSessionStateWrapper session_object{so, &DefaultLoggingManager()};
+    std::istringstream model_stream(CreateMatMulClipModel());
+    ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+    auto status = session_object.Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    const Graph* graph = nullptr;
+    const SessionState* session_state = nullptr;
+    ASSERT_TRUE(session_object.GetGraphAndSessionState(graph, session_state).IsOK());
+
+    auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+    MLValue v1, v2, v3;
+    CreateMLValue<float>(allocator, std::vector<int64_t>{1, 2}, std::vector<float>(2, 1.0f), &v1);
+    CreateMLValue<float>(allocator, std::vector<int64_t>{2, 2}, std::vector<float>(4, 1.0f), &v2);
+    CreateMLValue<float>(allocator, std::vector<int64_t>{2, 3}, std::vector<float>(6, 1.0f), &v3);
+    NameMLValMap feeds{{"X1", v1}, {"X2", v2}, {"X3", v3}};
+    std::vector<std::string> output_names{"T3"};
+
+    std::vector<MLValue> fetches;
+    status = session_object.Run(RunOptions(), feeds, output_names, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    // the arenas are only shrunk with more than the min free bytes free, and the pooled frame is kept either way
+    AllocatorStats stats;
+    ASSERT_TRUE(session_object.GetCpuArenaStats(&stats).IsOK());
+    if (min_free_bytes == 0) {
+      EXPECT_GT(stats.num_arena_shrinkages, 0);
+    } else {
+      EXPECT_EQ(stats.num_arena_shrinkages, 0);
+    }
+
+    EXPECT_EQ(session_state->GetExecutionFramePoolSize(), 1u);
+  }
+}
+
+TEST(ExecutionFramePoolTest, FramesAreReusedUpToCapacity) {
+  auto cpu_xp = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def1("X1", &tensor_float),
+      input_def2("X2", &tensor_float),
+      input_def3("X3", &tensor_float),
+      gemm1_out_def("T1", &tensor_float),
+      gemm2_out_def("T2", &tensor_float),
+      clip_out_def("T3", &tensor_float);
+
+  using ArgMap = std::vector<onnxruntime::NodeArg*>;
+  graph.AddNode("node1", "MatMul", "gemm1", ArgMap{&input_def1, &input_def2}, ArgMap{&gemm1_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node2", "MatMul", "gemm2", ArgMap{&gemm1_out_def, &input_def3}, ArgMap{&gemm2_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node3", "Clip", "clip1", ArgMap{&gemm2_out_def}, ArgMap{&clip_out_def})
+      .SetExecutionProviderType(xp_type);
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  KernelRegistryManager kernel_registry_manager;
+  kernel_registry_manager.RegisterKernelRegistry(cpu_xp->GetKernelRegistry(), KernelRegistryPriority::LowPriority);
+
+  ExecutionProviders execution_providers;
+  execution_providers.Add(xp_type, std::move(cpu_xp));
+
+  SessionState state{execution_providers};
+  state.SetExecutionFramePoolCapacity(2);
+  state.SetGraphViewer(std::make_unique<GraphViewer>(graph));
+
+  MLValueNameIdxMap& mlvalue_name_idx_map{state.GetMLValueNameIdxMap()};
+  for (const auto& name : {"X1", "X2", "X3", "T1", "T2", "T3"}) {
+    mlvalue_name_idx_map.Add(name);
+  }
+
+  std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan;
+  status = SequentialPlanner::CreatePlan(GraphViewer(graph), {}, execution_providers, kernel_registry_manager,
+                                         mlvalue_name_idx_map, p_seq_exec_plan);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  state.SetExecutionPlan(std::move(p_seq_exec_plan));
+  state.CalculateNodeIndexInfo();
+
+  auto cpu_allocator = execution_providers.Get(xp_type)->GetAllocator(0, OrtMemTypeDefault);
+
+  MLValue v1, v2, v3;
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{1, 2}, std::vector<float>(2, 1.0f), &v1);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 2}, std::vector<float>(4, 1.0f), &v2);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 3}, std::vector<float>(6, 1.0f), &v3);
+
+  std::unordered_map<std::string, MLValue> feeds{{"X1", v1}, {"X2", v2}, {"X3", v3}};
+  std::vector<std::string> output_names{"T3"};
+  std::vector<MLValue> fetches;
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+
+  std::vector<TensorShape> input_shapes;
+  for (const auto& feed : feeds) {
+    input_shapes.push_back(feed.second.Get<Tensor>().Shape());
+  }
+
+  // first run. there's no memory pattern for these input shapes yet so the frame traces the allocations
+  ExecutionFrame* first_frame = nullptr;
+  {
+    auto frame = state.AcquireExecutionFrame(feeds, output_names, fetches, fetch_allocators);
+    first_frame = frame.get();
+    ASSERT_TRUE(frame->HasPlan());
+
+    status = frame->AllocateMLValueTensorSelfOwnBuffer(3, DataTypeImpl::GetType<float>(), cpu_allocator->Info(),
+                                                       TensorShape(std::vector<int64_t>{1, 2}));
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    status = frame->AllocateMLValueTensorSelfOwnBuffer(4, DataTypeImpl::GetType<float>(), cpu_allocator->Info(),
+                                                       TensorShape(std::vector<int64_t>{1, 3}));
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    auto mem_patterns = std::make_unique<MemoryPatternGroup>();
+    status = frame->GeneratePatterns(mem_patterns.get());
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    status = state.UpdateMemoryPatternGroupCache(input_shapes, std::move(mem_patterns));
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  }
+
+  // second run reuses the frame and binds the memory pattern buffer for the input shapes
+  {
+    auto frame = state.AcquireExecutionFrame(feeds, output_names, fetches, fetch_allocators);
+    EXPECT_EQ(frame.get(), first_frame);
+    EXPECT_FALSE(frame->HasPlan());
+  }
+
+  // the frame and the buffer bound by the previous run are reused without allocating from the arena
+  {
+    auto* arena = dynamic_cast<IArenaAllocator*>(cpu_allocator.get());
+    ASSERT_NE(arena, nullptr);
+    AllocatorStats stats;
+    arena->GetStats(&stats);
+    const int64_t allocs_before = stats.num_allocs;
+
+    ExecutionFrame* reused_frame = nullptr;
+    {
+      auto frame = state.AcquireExecutionFrame(feeds, output_names, fetches, fetch_allocators);
+      reused_frame = frame.get();
+    }
+
+    arena->GetStats(&stats);
+    EXPECT_EQ(reused_frame, first_frame);
+    EXPECT_EQ(stats.num_allocs, allocs_before);
+  }
+
+  EXPECT_EQ(state.GetExecutionFramePoolSize(), 1u);
+
+  // concurrent runs each get their own frame. only as many as the capacity are kept for later runs.
+  {
+    auto frame1 = state.AcquireExecutionFrame(feeds, output_names, fetches, fetch_allocators);
+    auto frame2 = state.AcquireExecutionFrame(feeds, output_names, fetches, fetch_allocators);
+    auto frame3 = state.AcquireExecutionFrame(feeds, output_names, fetches, fetch_allocators);
+    EXPECT_NE(frame1.get(), frame2.get());
+    EXPECT_NE(frame2.get(), frame3.get());
+    EXPECT_EQ(state.GetExecutionFramePoolSize(), 0u);
+  }
+
+  EXPECT_EQ(state.GetExecutionFramePoolSize(), 2u);
+
+  state.ReleaseExecutionFramePool();
+  EXPECT_EQ(state.GetExecutionFramePoolSize(), 0u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
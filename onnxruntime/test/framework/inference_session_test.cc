@@ -7,6 +7,7 @@
 #include <cfloat>
 #include <functional>
 #include <iterator>
+#include <sstream>
 #include <thread>
 #include <fstream>
 
@@ -14,19 +15,25 @@
 #include "core/platform/env.h"
 #include "core/common/logging/logging.h"
 #include "core/common/profiler.h"
+#include "core/common/work_stealing_thread_pool.h"
 #include "core/framework/execution_provider.h"
+#include "core/framework/feeds_fetches_info.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shared_initializer_cache.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/compute_capability.h"
 #include "core/graph/model.h"
 #include "core/graph/op.h"
+#include "core/optimizer/graph_transformer.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/session/IOBinding.h"
 #include "test/capturing_sink.h"
+#include "test/model_proto_builder.h"
+#include "test/temp_file_path.h"
 #include "test/test_environment.h"
 #include "test/providers/provider_test_utils.h"
 #include "test_utils.h"
@@ -340,6 +347,432 @@ TEST(InferenceSessionTests, DisableCPUArena) {
   RunModel(session_object, run_options);
 }
 
+// a transformer that counts the graphs it's applied to, without changing them
+class CountingTransformer : public GraphTransformer {
+ public:
+  explicit CountingTransformer(int& num_applied)
+      : GraphTransformer("CountingTransformer", "Count the graphs the transformer is applied to"),
+        num_applied_(num_applied) {}
+
+ private:
+  Status ApplyImpl(Graph& /*graph*/, bool& /*modified*/, int /*graph_level*/) const override {
+    ++num_applied_;
+    return Status::OK();
+  }
+
+  int& num_applied_;
+};
+
+TEST(InferenceSessionTests, SaveAndLoadOptimizedModel) {
+  TempFilePath optimized_model_file("mul_1.optimized.onnx");
+  const std::string& optimized_model_uri = optimized_model_file.Path();
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.SaveAndLoadOptimizedModel";
+  so.graph_optimization_level = TransformerLevel::kExtended;
+  so.optimized_model_filepath = optimized_model_uri;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  // the saved model records where each node runs
+  std::shared_ptr<Model> model;
+  ASSERT_TRUE(Model::Load(optimized_model_uri, model).IsOK());
+  const auto& metadata = model->MetaData();
+  const Node& node = *model->MainGraph().Nodes().begin();
+  ASSERT_EQ(metadata.at("onnxruntime.optimized_model.execution_providers"), kCpuExecutionProvider);
+  ASSERT_EQ(metadata.at("onnxruntime.optimized_model.node_placement"),
+            node.Name() + "\t" + node.OpType() + "\t" + kCpuExecutionProvider + "\n");
+
+  // and a session that loads it skips the transformations, including the ones registered with it
+  int num_applied = 0;
+  SessionOptions so2;
+  so2.session_logid = "InferenceSessionTests.SaveAndLoadOptimizedModel2";
+  so2.graph_optimization_level = TransformerLevel::kExtended;
+  InferenceSession session_object2{so2, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object2.RegisterGraphTransformer(std::make_unique<CountingTransformer>(num_applied)).IsOK());
+  ASSERT_TRUE(session_object2.Load(optimized_model_uri).IsOK());
+  auto status = session_object2.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_EQ(num_applied, 0);
+  RunModel(session_object2, run_options);
+
+  // the same transformer is applied to the original model
+  InferenceSession session_object3{so2, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object3.RegisterGraphTransformer(std::make_unique<CountingTransformer>(num_applied)).IsOK());
+  ASSERT_TRUE(session_object3.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object3.Initialize().IsOK());
+  EXPECT_GT(num_applied, 0);
+}
+
+TEST(InferenceSessionTests, LoadOptimizedModelWithEditedNodes) {
+  TempFilePath optimized_model_file("mul_1.optimized.onnx");
+  TempFilePath edited_model_file("mul_1.optimized.edited.onnx");
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.LoadOptimizedModelWithEditedNodes";
+  so.optimized_model_filepath = optimized_model_file.Path();
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // rename the node, so the saved placement no longer matches it
+  ModelProto model_proto;
+  {
+    std::ifstream model_file(optimized_model_file.Path(), std::ios::binary);
+    ASSERT_TRUE(model_proto.ParseFromIstream(&model_file));
+  }
+  model_proto.mutable_graph()->mutable_node(0)->set_name("renamed");
+  {
+    std::ofstream model_file(edited_model_file.Path(), std::ios::binary);
+    ASSERT_TRUE(model_proto.SerializeToOstream(&model_file));
+  }
+
+  SessionOptions so2;
+  so2.session_logid = "InferenceSessionTests.LoadOptimizedModelWithEditedNodes2";
+  InferenceSession session_object2{so2, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object2.Load(edited_model_file.Path()).IsOK());
+  auto status = session_object2.Initialize();
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_NE(status.ErrorMessage().find("doesn't match node 'renamed'"), std::string::npos) << status.ErrorMessage();
+}
+
+// Y = X * W with W = {1, 2, 3, 4, 5, 6} as an initializer, so RunModel sees the same results as for mul_1.pb
+static void SaveMulInitializerModel(const std::string& model_uri) {
+  GraphProto graph;
+  graph.set_name("mul_initializer");
+  AddValueInfo(graph.add_input(), "X", {3, 2});
+  // raw_data, so a session that maps the file can use the data in place
+  AddInitializer(graph, "W", {3, 2}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, /*use_raw_data*/ true);
+  AddNode(graph, "Mul", {"X", "W"}, {"Y"});
+  AddValueInfo(graph.add_output(), "Y", {3, 2});
+
+  std::ofstream model_file(model_uri, std::ios::out | std::ios::trunc | std::ios::binary);
+  ASSERT_TRUE(CreateModelProto(std::move(graph), 7).SerializeToOstream(&model_file));
+}
+
+// exposes the graph and SessionState of the session
+class InferenceSessionStateWrapper : public InferenceSession {
+ public:
+  using InferenceSession::GetGraphAndSessionState;
+  using InferenceSession::InferenceSession;
+};
+
+TEST(InferenceSessionTests, LoadWithModelFileMapping) {
+  TempFilePath model_file("mul_initializer.mapped.onnx");
+  const std::string& model_uri = model_file.Path();
+  SaveMulInitializerModel(model_uri);
+
+  // the initializer's raw data is found in the mapped file
+  std::shared_ptr<Model> model;
+  ASSERT_TRUE(Model::LoadMapped(model_uri, model).IsOK());
+  size_t length = 0;
+  const auto* data = static_cast<const float*>(model->MainGraph().GetMappedInitializerData("W", length));
+  ASSERT_NE(data, nullptr);
+  ASSERT_EQ(length, 6 * sizeof(float));
+  ASSERT_EQ(std::vector<float>(data, data + 6), std::vector<float>({1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}));
+  model.reset();
+
+  for (bool enable_mem_pattern : {true, false}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.LoadWithModelFileMapping";
+    so.enable_model_file_mapping = true;
+    so.enable_mem_pattern = enable_mem_pattern;
+
+    InferenceSessionStateWrapper session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(model_uri).IsOK());
+    auto status = session_object.Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    // the initialized tensor uses the data in the session's mapping of the file rather than a copy
+    const Graph* graph = nullptr;
+    const SessionState* session_state = nullptr;
+    ASSERT_TRUE(session_object.GetGraphAndSessionState(graph, session_state).IsOK());
+    const char* mapped_data = static_cast<const char*>(graph->GetMappedInitializerData("W", length));
+    ASSERT_NE(mapped_data, nullptr);
+
+    int w_idx = -1;
+    ASSERT_TRUE(session_state->GetMLValueNameIdxMap().GetIdx("W", w_idx).IsOK());
+    const auto& w = session_state->GetInitializedTensors().at(w_idx).Get<Tensor>();
+    const char* w_data = static_cast<const char*>(w.DataRaw());
+    EXPECT_GE(w_data, mapped_data);
+    EXPECT_LE(w_data + w.Size(), mapped_data + length);
+
+    RunOptions run_options;
+    RunModel(session_object, run_options);
+  }
+}
+
+TEST(InferenceSessionTests, SharedInitializers) {
+  TempFilePath model_file("mul_initializer.shared.onnx");
+  const std::string& model_uri = model_file.Path();
+  SaveMulInitializerModel(model_uri);
+
+  auto cache = std::make_shared<SharedInitializerCache>();
+  std::vector<std::unique_ptr<InferenceSession>> sessions;
+  for (bool enable_mem_pattern : {true, false}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.SharedInitializers";
+    so.enable_mem_pattern = enable_mem_pattern;
+    so.shared_initializer_cache = cache;
+
+    sessions.push_back(std::make_unique<InferenceSession>(so, &DefaultLoggingManager()));
+    ASSERT_TRUE(sessions.back()->Load(model_uri).IsOK());
+    auto status = sessions.back()->Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  }
+
+  // both sessions use one copy of W
+  auto stats = cache->GetStats();
+  EXPECT_EQ(stats.num_tensors, 1u);
+  EXPECT_EQ(stats.num_bytes, 6 * sizeof(float));
+  EXPECT_EQ(stats.num_references, 2u);
+
+  RunOptions run_options;
+  for (auto& session : sessions) {
+    RunModel(*session, run_options);
+  }
+
+  sessions.clear();
+  EXPECT_EQ(cache->GetStats().num_tensors, 0u);
+}
+
+// Y = op_type(X, W) where W is an initializer that isn't a graph input, so the kernel can pre-pack it.
+// K spans more than one slice of the packed matrix and N isn't a multiple of the packed block width.
+// W is also listed as a graph input if w_is_input is true.
+static std::string CreateConstantWeightsModel(const std::string& op_type, bool trans_b,
+                                              int64_t M, int64_t K, int64_t N,
+                                              int64_t ir_version = ONNX_NAMESPACE::Version::IR_VERSION,
+                                              bool w_is_input = false) {
+  GraphProto graph;
+  graph.set_name("constant_weights");
+
+  const std::vector<int64_t> w_dims{trans_b ? N : K, trans_b ? K : N};
+  AddValueInfo(graph.add_input(), "X", {M, K});
+  if (w_is_input) {
+    AddValueInfo(graph.add_input(), "W", w_dims);
+  }
+  AddValueInfo(graph.add_output(), "Y", {M, N});
+
+  std::vector<float> weights(K * N);
+  for (int64_t i = 0; i < K * N; ++i) {
+    weights[i] = static_cast<float>(i % 7 - 3);
+  }
+  AddInitializer(graph, "W", w_dims, weights);
+
+  auto* node = AddNode(graph, op_type, {"X", "W"}, {"Y"});
+
+  if (op_type == "Gemm") {
+    std::vector<float> bias(N);
+    for (int64_t n = 0; n < N; ++n) {
+      bias[n] = static_cast<float>(n);
+    }
+    AddInitializer(graph, "C", {N}, bias);
+
+    node->add_input("C");
+    AddAttribute(*node, "transB", int64_t{trans_b ? 1 : 0});
+  }
+
+  auto model = CreateModelProto(std::move(graph));
+  model.set_ir_version(ir_version);
+
+  std::string serialized;
+  model.SerializeToString(&serialized);
+  return serialized;
+}
+
+TEST(InferenceSessionTests, PrePackConstantWeights) {
+  const int64_t M = 3, K = 130, N = 20;
+
+  std::vector<float> x(M * K);
+  for (int64_t i = 0; i < M * K; ++i) {
+    x[i] = static_cast<float>(i % 5 - 2);
+  }
+
+  struct TestCase {
+    std::string op_type;
+    bool trans_b;
+  };
+
+  for (const auto& test_case : {TestCase{"MatMul", false}, TestCase{"Gemm", false}, TestCase{"Gemm", true}}) {
+    const bool is_gemm = test_case.op_type == "Gemm";
+
+    std::vector<float> expected_y(M * N);
+    for (int64_t m = 0; m < M; ++m) {
+      for (int64_t n = 0; n < N; ++n) {
+        float sum = is_gemm ? static_cast<float>(n) : 0.0f;
+        for (int64_t k = 0; k < K; ++k) {
+          const int64_t w_idx = test_case.trans_b ? n * K + k : k * N + n;
+          sum += x[m * K + k] * static_cast<float>(w_idx % 7 - 3);
+        }
+        expected_y[m * N + n] = sum;
+      }
+    }
+
+    const std::string model = CreateConstantWeightsModel(test_case.op_type, test_case.trans_b, M, K, N);
+    for (bool enable_mem_pattern : {true, false}) {
+      SessionOptions so;
+      so.session_logid = "InferenceSessionTests.PrePackConstantWeights";
+      so.enable_mem_pattern = enable_mem_pattern;
+
+      InferenceSession session_object{so, &DefaultLoggingManager()};
+      std::istringstream model_stream(model);
+      ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+      auto status = session_object.Initialize();
+      ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+      MLValue ml_value;
+      CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {M, K}, x, &ml_value);
+      NameMLValMap feeds;
+      feeds.insert(std::make_pair("X", ml_value));
+
+      // run twice as the packed weights are used by every run
+      for (int run = 0; run < 2; ++run) {
+        std::vector<MLValue> fetches;
+        RunOptions run_options;
+        status = session_object.Run(run_options, feeds, std::vector<std::string>{"Y"}, &fetches);
+        ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+        VerifyOutputs(fetches, {M, N}, expected_y);
+      }
+    }
+  }
+}
+
+TEST(InferenceSessionTests, PrePackWeightsListedAsInput) {
+  const int64_t M = 2, K = 3, N = 4;
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+
+  MLValue x_value;
+  CreateMLValue<float>(allocator, {M, K}, std::vector<float>(M * K, 1.f), &x_value);
+  MLValue w_value;
+  CreateMLValue<float>(allocator, {K, N}, std::vector<float>(K * N, 2.f), &w_value);
+
+  // Y = X * W with W[k, n] = (k * N + n) % 7 - 3, for rows of ones
+  std::vector<float> expected_y(M * N);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      float sum = 0.f;
+      for (int64_t k = 0; k < K; ++k) {
+        sum += static_cast<float>((k * N + n) % 7 - 3);
+      }
+      expected_y[m * N + n] = sum;
+    }
+  }
+
+  for (int64_t ir_version : {int64_t{3}, int64_t{ONNX_NAMESPACE::Version::IR_VERSION}}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.PrePackWeightsListedAsInput";
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    std::istringstream model_stream(CreateConstantWeightsModel("MatMul", false, M, K, N, ir_version, true));
+    ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+    auto status = session_object.Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    RunOptions run_options;
+    std::vector<MLValue> fetches;
+    NameMLValMap feeds{{"X", x_value}};
+    status = session_object.Run(run_options, feeds, std::vector<std::string>{"Y"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    VerifyOutputs(fetches, {M, N}, expected_y);
+
+    // before IR version 4 W is constant, so the MatMul pre-packs it and a feed for it is rejected. after that W
+    // is a default value, so it's read at execution time and the feed replaces it.
+    feeds.insert({"W", w_value});
+    fetches.clear();
+    status = session_object.Run(run_options, feeds, std::vector<std::string>{"Y"}, &fetches);
+    if (ir_version < 4) {
+      ASSERT_FALSE(status.IsOK());
+      EXPECT_EQ(status.Code(), common::INVALID_ARGUMENT);
+      EXPECT_NE(status.ErrorMessage().find("is an initializer and can't be fed"), std::string::npos);
+    } else {
+      ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+      VerifyOutputs(fetches, {M, N}, std::vector<float>(M * N, 2.f * K));
+    }
+  }
+}
+
+static std::string CreateZipMapModel(const std::vector<std::string>& classlabels, int64_t batch_size) {
+  GraphProto graph;
+  graph.set_name("zipmap");
+
+  AddValueInfo(graph.add_input(), "X", {batch_size, static_cast<int64_t>(classlabels.size())});
+
+  auto* output = graph.add_output();
+  output->set_name("Z");
+  auto* map_type = output->mutable_type()->mutable_sequence_type()->mutable_elem_type()->mutable_map_type();
+  map_type->set_key_type(TensorProto_DataType_STRING);
+  map_type->mutable_value_type()->mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+  auto* node = AddNode(graph, "ZipMap", {"X"}, {"Z"});
+  node->set_domain(onnxruntime::kMLDomain);
+  AddStrings(*node, "classlabels_strings", classlabels);
+
+  ModelProto model = CreateModelProto(std::move(graph));
+  auto* opset = model.add_opset_import();
+  opset->set_domain(onnxruntime::kMLDomain);
+  opset->set_version(1);
+
+  std::string serialized;
+  model.SerializeToString(&serialized);
+  return serialized;
+}
+
+TEST(InferenceSessionTests, ZipMapSharedKeys) {
+  const std::vector<std::string> classlabels{"class1", "class2", "class3"};
+  const std::vector<float> x{1.f, 0.f, 3.f, 44.f, 23.f, 11.3f};
+  const std::string model = CreateZipMapModel(classlabels, 2);
+
+  for (bool enable_zipmap_shared_keys : {false, true}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.ZipMapSharedKeys";
+    so.enable_zipmap_shared_keys = enable_zipmap_shared_keys;
+
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    std::istringstream model_stream(model);
+    ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+    auto status = session_object.Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    // the type of the output reported by the session is the one it returns
+    auto outputs = session_object.GetModelOutputs();
+    ASSERT_TRUE(outputs.first.IsOK());
+    ASSERT_EQ(outputs.second->size(), 1u);
+    const auto* output_type = DataTypeImpl::TypeFromProto(*outputs.second->at(0)->TypeAsProto());
+
+    MLValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 3}, x, &ml_value);
+    NameMLValMap feeds;
+    feeds.insert(std::make_pair("X", ml_value));
+
+    std::vector<MLValue> fetches;
+    RunOptions run_options;
+    status = session_object.Run(run_options, feeds, std::vector<std::string>{"Z"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    ASSERT_EQ(fetches.size(), 1u);
+    EXPECT_EQ(fetches[0].Type(), output_type);
+
+    if (enable_zipmap_shared_keys) {
+      ASSERT_EQ(fetches[0].Type(), DataTypeImpl::GetType<SharedKeyMapsString>());
+      const auto& maps = fetches[0].Get<SharedKeyMapsString>();
+      EXPECT_EQ(*maps.keys, classlabels);
+      EXPECT_EQ(maps.values, x);
+    } else {
+      ASSERT_EQ(fetches[0].Type(), DataTypeImpl::GetType<VectorMapStringToFloat>());
+      const auto& maps = fetches[0].Get<VectorMapStringToFloat>();
+      ASSERT_EQ(maps.size(), 2u);
+      for (size_t i = 0; i < maps.size(); ++i) {
+        for (size_t j = 0; j < classlabels.size(); ++j) {
+          EXPECT_EQ(maps[i].at(classlabels[j]), x[i * classlabels.size() + j]);
+        }
+      }
+    }
+  }
+}
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 static bool Compare(const InputDefList& f_arg, const InputDefList& s_arg) {
   if (f_arg.size() != s_arg.size()) {
@@ -469,6 +902,8 @@ TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions) {
   so.session_logid = "CheckRunProfiler";
   so.enable_profiling = true;
   so.profile_file_prefix = "onnxprofile_profile_test";
+  // the default graph transformers record events of their own. this test checks the events of loading and running.
+  so.graph_optimization_level = TransformerLevel::kNone;
 
   InferenceSession session_object(so);
   ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
@@ -543,6 +978,47 @@ TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
   }
 }
 
+TEST(InferenceSessionTests, CheckRunProfilerWithParallelExecution) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerWithParallelExecution";
+  so.enable_sequential_execution = false;
+  so.session_thread_pool_size = 2;
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+
+  session_object.StartProfiling("onnxruntime_profile_parallel");
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string line;
+
+  bool has_kernel_event = false;
+  bool has_worker_event = false;
+  while (std::getline(profile, line)) {
+    has_kernel_event |= line.find("mul_1_kernel_time") != string::npos;
+#ifndef USE_EIGEN_THREADPOOL
+    if (line.find("inter_op_worker_") != string::npos) {
+      has_worker_event = true;
+      ASSERT_TRUE(line.find("steals") != string::npos);
+      ASSERT_TRUE(line.find("idle_us") != string::npos);
+    }
+#else
+    has_worker_event = true;
+#endif
+  }
+
+  ASSERT_TRUE(has_kernel_event);
+  ASSERT_TRUE(has_worker_event);
+}
+
 TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   SessionOptions session_options;
 
@@ -567,6 +1043,111 @@ TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   thread2.join();
 }
 
+TEST(InferenceSessionTests, ConcurrentRunsWithParallelExecution) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.ConcurrentRunsWithParallelExecution";
+  so.enable_sequential_execution = false;
+  so.session_thread_pool_size = 2;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // all the runs share the session's thread pool but must not share any per-run state
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&session_object, i]() {
+      RunOptions run_options;
+      run_options.run_tag = "one session/thread " + std::to_string(i);
+      for (int j = 0; j < 10; ++j) {
+        RunModel(session_object, run_options);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(InferenceSessionTests, ConcurrentRunsShareIntraOpThreadPool) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.ConcurrentRunsShareIntraOpThreadPool";
+  so.enable_sequential_execution = false;
+  so.session_thread_pool_size = 2;
+  // more than the machine has, to check the session caps it rather than failing
+  so.intra_op_num_threads = static_cast<int>(std::thread::hardware_concurrency()) + 4;
+
+  InferenceSessionStateWrapper session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  const Graph* graph = nullptr;
+  const SessionState* session_state = nullptr;
+  ASSERT_TRUE(session_object.GetGraphAndSessionState(graph, session_state).IsOK());
+
+  // the threads running kernels and the intra-op pool stay within the hardware threads, unless the inter-op
+  // pool alone doesn't, in which case the kernels run single threaded
+  WorkStealingThreadPool* intra_op_thread_pool = session_state->GetIntraOpThreadPool();
+  const int hardware_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  const int intra_op_pool_threads = intra_op_thread_pool == nullptr
+                                        ? 0
+                                        : static_cast<int>(intra_op_thread_pool->NumThreads());
+  if (so.session_thread_pool_size < hardware_threads) {
+    ASSERT_EQ(hardware_threads, so.session_thread_pool_size + intra_op_pool_threads + 1);
+  } else {
+    ASSERT_EQ(intra_op_thread_pool, nullptr);
+  }
+
+  // every kernel uses the session's pool, so runs on different threads share it
+  for (const auto& node : graph->Nodes()) {
+    const OpKernel* kernel = session_state->GetKernel(node.Index());
+    ASSERT_NE(kernel, nullptr);
+    ASSERT_EQ(kernel->Info().GetIntraOpThreadPool(), intra_op_thread_pool);
+  }
+
+  const std::vector<int64_t> dims_mul_x = {3, 2};
+  const std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  const std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  const int num_threads = 4;
+  const int num_runs = 10;
+  std::vector<std::vector<Status>> statuses(num_threads);
+  std::vector<std::vector<std::vector<MLValue>>> fetches(num_threads);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&, i]() {
+      RunOptions run_options;
+      run_options.run_tag = "intra-op/thread " + std::to_string(i);
+      for (int j = 0; j < num_runs; ++j) {
+        MLValue ml_value;
+        CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x,
+                             values_mul_x, &ml_value);
+        NameMLValMap feeds{{"X", ml_value}};
+        fetches[i].emplace_back();
+        statuses[i].push_back(session_object.Run(run_options, feeds, {"Y"}, &fetches[i].back()));
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < num_threads; ++i) {
+    ASSERT_EQ(static_cast<size_t>(num_runs), statuses[i].size());
+    for (int j = 0; j < num_runs; ++j) {
+      ASSERT_TRUE(statuses[i][j].IsOK()) << "thread " << i << " run " << j << ": " << statuses[i][j].ErrorMessage();
+      VerifyOutputs(fetches[i][j], dims_mul_x, expected_values_mul_y);
+    }
+  }
+
+  ASSERT_EQ(session_state->GetIntraOpThreadPool(), intra_op_thread_pool);
+}
+
 TEST(InferenceSessionTests, PreAllocateOutputVector) {
   SessionOptions so;
 
@@ -582,6 +1163,175 @@ TEST(InferenceSessionTests, PreAllocateOutputVector) {
   RunModel(session_object, run_options, is_preallocate_output_vec);
 }
 
+TEST(InferenceSessionTests, RunWithFeedsFetchesInfo) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.RunWithFeedsFetchesInfo";
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+
+  std::unique_ptr<FeedsFetchesInfo> feeds_fetches_info;
+
+  // the names are resolved to MLValue indices so the session must be initialized first
+  ASSERT_FALSE(session_object.CreateFeedsFetchesInfo({"X"}, {"Y"}, feeds_fetches_info).IsOK());
+
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  ASSERT_FALSE(session_object.CreateFeedsFetchesInfo({"X"}, {"Z"}, feeds_fetches_info).IsOK());
+  ASSERT_FALSE(session_object.CreateFeedsFetchesInfo({}, {"Y"}, feeds_fetches_info).IsOK());
+  ASSERT_FALSE(session_object.CreateFeedsFetchesInfo({"X", "X"}, {"Y"}, feeds_fetches_info).IsOK());
+
+  auto st = session_object.CreateFeedsFetchesInfo({"X"}, {"Y"}, feeds_fetches_info);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<MLValue> feeds(1);
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                       &feeds[0]);
+
+  std::vector<int64_t> expected_dims_mul_y = {3, 2};
+  std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+
+  // run a few times to use the memory pattern generated by the first run
+  for (int i = 0; i < 3; ++i) {
+    std::vector<MLValue> fetches;
+    st = session_object.Run(run_options, *feeds_fetches_info, feeds, &fetches);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    VerifyOutputs(fetches, expected_dims_mul_y, expected_values_mul_y);
+  }
+
+  // the feed types are still checked on each run
+  std::vector<int64_t> int_values_mul_x = {1, 2, 3, 4, 5, 6};
+  std::vector<MLValue> int_feeds(1);
+  CreateMLValue<int64_t>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x,
+                         int_values_mul_x, &int_feeds[0]);
+  std::vector<MLValue> fetches;
+  ASSERT_FALSE(session_object.Run(run_options, *feeds_fetches_info, int_feeds, &fetches).IsOK());
+
+  // and the number of feeds must match
+  ASSERT_FALSE(session_object.Run(run_options, *feeds_fetches_info, {}, &fetches).IsOK());
+
+  // the MLValue indices only apply to the session that resolved them
+  InferenceSession other_session{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(other_session.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(other_session.Initialize().IsOK());
+  st = other_session.Run(run_options, *feeds_fetches_info, feeds, &fetches);
+  ASSERT_FALSE(st.IsOK());
+  EXPECT_EQ(st.Code(), common::INVALID_ARGUMENT);
+
+  // as do ones that don't belong to an input
+  FeedsFetchesInfo unresolved_info({"X"}, {"Y"});
+  unresolved_info.feeds_mlvalue_idxs = {-1};
+  unresolved_info.fetches_mlvalue_idxs = feeds_fetches_info->fetches_mlvalue_idxs;
+  unresolved_info.session_state = feeds_fetches_info->session_state;
+  st = session_object.Run(run_options, unresolved_info, feeds, &fetches);
+  ASSERT_FALSE(st.IsOK());
+  EXPECT_EQ(st.Code(), common::INVALID_ARGUMENT);
+}
+
+TEST(InferenceSessionTests, WarmUp) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.WarmUp";
+  so.mem_pattern_dim_buckets = {4, 8};
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+
+  std::vector<std::unordered_map<std::string, TensorShape>> bucket_shapes{{{"X", TensorShape({4, 2})}},
+                                                                          {{"X", TensorShape({8, 2})}}};
+
+  // the session must be initialized first
+  ASSERT_FALSE(session_object.WarmUp(bucket_shapes).IsOK());
+
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  ASSERT_FALSE(session_object.WarmUp({{{"Z", TensorShape({4, 2})}}}).IsOK());
+
+  MemoryPatternCacheStats stats;
+  ASSERT_TRUE(session_object.GetMemoryPatternCacheStats(&stats).IsOK());
+  EXPECT_EQ(stats.size, 0u);
+
+  auto st = session_object.WarmUp(bucket_shapes);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+  // each bucket got a pattern traced by its warm up run
+  ASSERT_TRUE(session_object.GetMemoryPatternCacheStats(&stats).IsOK());
+  EXPECT_EQ(stats.size, 2u);
+  EXPECT_EQ(stats.num_hits, 0);
+  EXPECT_EQ(stats.num_misses, 2);
+
+  // the 3x2 input uses the pattern warmed up for the 4x2 upper bound of its bucket, so no run traces another
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+
+  ASSERT_TRUE(session_object.GetMemoryPatternCacheStats(&stats).IsOK());
+  EXPECT_EQ(stats.size, 2u);
+  EXPECT_GE(stats.num_hits, 1);
+  EXPECT_EQ(stats.num_misses, 2);
+}
+
+TEST(InferenceSessionTests, CpuArenaShrink) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.CpuArenaShrink";
+  so.cpu_mem_arena_extend_strategy = ArenaExtendStrategy::kSameAsRequested;
+  so.enable_mem_arena_shrink_on_idle = true;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+
+  AllocatorStats stats;
+  ASSERT_FALSE(session_object.GetCpuArenaStats(&stats).IsOK());
+
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+
+  ASSERT_TRUE(session_object.GetCpuArenaStats(&stats).IsOK());
+  EXPECT_GT(stats.num_arena_extensions, 0);
+  const int64_t allocated_bytes = stats.total_allocated_bytes;
+
+  // the region of the output, which was still in use when the run finished, is free now. the memory pattern buffer
+  // of the pooled frame is released too.
+  const size_t released_bytes = session_object.ShrinkMemoryArenas();
+  EXPECT_GT(released_bytes, 0u);
+  ASSERT_TRUE(session_object.GetCpuArenaStats(&stats).IsOK());
+  EXPECT_EQ(stats.total_allocated_bytes, allocated_bytes - static_cast<int64_t>(released_bytes));
+  EXPECT_GT(stats.num_arena_shrinkages, 0);
+
+  // the arena grows again as needed
+  RunModel(session_object, run_options);
+}
+
+TEST(InferenceSessionTests, CpuArenaStatsWithArenaDisabled) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.CpuArenaStatsWithArenaDisabled";
+  so.enable_cpu_mem_arena = false;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+  RunModel(session_object, run_options);
+
+  AllocatorStats stats;
+  stats.num_allocs = 1;
+  ASSERT_TRUE(session_object.GetCpuArenaStats(&stats).IsOK());
+  EXPECT_EQ(stats.num_allocs, 0);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+  EXPECT_EQ(stats.num_arena_extensions, 0);
+}
+
 TEST(InferenceSessionTests, ConfigureVerbosityLevel) {
   SessionOptions so;
 
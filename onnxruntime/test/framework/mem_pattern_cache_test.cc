@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static std::vector<TensorShape> Shapes(std::initializer_list<std::vector<int64_t>> dims) {
+  std::vector<TensorShape> shapes;
+  for (const auto& d : dims) {
+    shapes.emplace_back(d);
+  }
+
+  return shapes;
+}
+
+TEST(MemoryPatternCacheTest, ExactShapes) {
+  MemoryPatternCache cache;
+
+  EXPECT_EQ(cache.Get(Shapes({{2, 3}})), nullptr);
+
+  cache.Add(Shapes({{2, 3}}), std::make_unique<MemoryPatternGroup>());
+  auto patterns = cache.Get(Shapes({{2, 3}}));
+  EXPECT_NE(patterns, nullptr);
+
+  // without buckets other shapes, including ones with the same dims in a different rank or order, need their own
+  EXPECT_EQ(cache.Get(Shapes({{3, 2}})), nullptr);
+  EXPECT_EQ(cache.Get(Shapes({{1, 2, 3}})), nullptr);
+  EXPECT_EQ(cache.Get(Shapes({{2}, {3}})), nullptr);
+  EXPECT_EQ(cache.Get(Shapes({{1, 3}})), nullptr);
+
+  // the first pattern added for a key is kept
+  cache.Add(Shapes({{2, 3}}), std::make_unique<MemoryPatternGroup>());
+  EXPECT_EQ(cache.Get(Shapes({{2, 3}})), patterns);
+  EXPECT_EQ(cache.Size(), 1u);
+}
+
+TEST(MemoryPatternCacheTest, Bounded) {
+  MemoryPatternCache cache;
+  cache.Configure(4, {});
+
+  for (int64_t i = 1; i < 100; ++i) {
+    cache.Add(Shapes({{i}}), std::make_unique<MemoryPatternGroup>());
+    EXPECT_NE(cache.Get(Shapes({{i}})), nullptr);
+    EXPECT_LE(cache.Size(), 4u);
+  }
+}
+
+TEST(MemoryPatternCacheTest, Eviction) {
+  // a capacity of 1 has a single shard so which pattern is evicted is deterministic
+  MemoryPatternCache cache;
+  cache.Configure(1, {});
+
+  cache.Add(Shapes({{1}}), std::make_unique<MemoryPatternGroup>());
+  auto patterns1 = cache.Get(Shapes({{1}}));
+  ASSERT_NE(patterns1, nullptr);
+
+  cache.Add(Shapes({{2}}), std::make_unique<MemoryPatternGroup>());
+  EXPECT_EQ(cache.Get(Shapes({{1}})), nullptr);
+  EXPECT_NE(cache.Get(Shapes({{2}})), nullptr);
+  EXPECT_EQ(cache.Size(), 1u);
+
+  // an evicted pattern stays valid for a frame that's still using it
+  EXPECT_EQ(patterns1.use_count(), 1);
+}
+
+TEST(MemoryPatternCacheTest, Unbounded) {
+  MemoryPatternCache cache;
+  cache.Configure(0, {});
+
+  for (int64_t i = 1; i <= 1000; ++i) {
+    cache.Add(Shapes({{i}}), std::make_unique<MemoryPatternGroup>());
+  }
+
+  EXPECT_EQ(cache.Size(), 1000u);
+}
+
+TEST(MemoryPatternCacheTest, DimBuckets) {
+  MemoryPatternCache cache;
+  cache.Configure(MemoryPatternCache::kDefaultCapacity, {64, 16, 32});
+
+  // traced with a sequence length of 20, so usable for up to 20 in the (16, 32] bucket
+  cache.Add(Shapes({{1, 20}}), std::make_unique<MemoryPatternGroup>());
+  auto patterns20 = cache.Get(Shapes({{1, 20}}));
+  ASSERT_NE(patterns20, nullptr);
+  EXPECT_EQ(cache.Get(Shapes({{1, 17}})), patterns20);
+  EXPECT_EQ(cache.Get(Shapes({{1, 25}})), nullptr);
+  EXPECT_EQ(cache.Get(Shapes({{1, 16}})), nullptr);
+  EXPECT_EQ(cache.Get(Shapes({{2, 20}})), nullptr);
+
+  // a larger input in the bucket replaces the pattern, which then covers the whole bucket
+  cache.Add(Shapes({{1, 32}}), std::make_unique<MemoryPatternGroup>());
+  auto patterns32 = cache.Get(Shapes({{1, 25}}));
+  ASSERT_NE(patterns32, nullptr);
+  EXPECT_NE(patterns32, patterns20);
+  EXPECT_EQ(cache.Get(Shapes({{1, 17}})), patterns32);
+  EXPECT_EQ(cache.Size(), 1u);
+
+  // a smaller one doesn't
+  cache.Add(Shapes({{1, 18}}), std::make_unique<MemoryPatternGroup>());
+  EXPECT_EQ(cache.Get(Shapes({{1, 18}})), patterns32);
+
+  // dims above the largest bucket are used as is
+  cache.Add(Shapes({{1, 100}}), std::make_unique<MemoryPatternGroup>());
+  EXPECT_NE(cache.Get(Shapes({{1, 100}})), nullptr);
+  EXPECT_EQ(cache.Get(Shapes({{1, 99}})), nullptr);
+  EXPECT_EQ(cache.Size(), 2u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
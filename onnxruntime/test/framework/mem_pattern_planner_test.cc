@@ -4,6 +4,8 @@
 #include "core/framework/mem_pattern_planner.h"
 #include "gtest/gtest.h"
 
+#include <random>
+
 namespace onnxruntime {
 namespace test {
 TEST(MemPatternPlannerTest, TraceAllocaitonTest) {
@@ -34,5 +36,90 @@ TEST(MemPatternPlannerTest, TraceAllocaitonTest) {
   EXPECT_EQ(pattern.GetBlock(5)->offset_, 1024 + 256 + 512);
   EXPECT_EQ(pattern.GetBlock(6)->offset_, 1024);
 }
+
+TEST(MemPatternPlannerTest, LowerBound) {
+  MemPatternPlanner planner;
+  planner.TraceAllocation(0, 100);
+  planner.TraceAllocation(1, 100);
+  planner.TraceFree(0);
+  planner.TraceAllocation(2, 200);
+
+  // the freed block is too small for the last allocation, so it goes after the live one
+  auto pattern = planner.GenerateMemPattern();
+  EXPECT_EQ(pattern.GetBlock(2)->offset_, 200);
+  EXPECT_EQ(pattern.PeakSize(), 400);
+  EXPECT_EQ(pattern.LowerBound(), 300);
+}
+
+TEST(MemPatternPlannerTest, OfflinePacking) {
+  MemPatternPlanner planner(true);
+  planner.TraceAllocation(0, 100);
+  planner.TraceAllocation(1, 100);
+  planner.TraceFree(0);
+  planner.TraceAllocation(2, 200);
+
+  // the largest block goes first, and the first block isn't live at the same time so shares its space
+  auto pattern = planner.GenerateMemPattern();
+  EXPECT_EQ(pattern.GetBlock(2)->offset_, 0);
+  EXPECT_EQ(pattern.GetBlock(0)->offset_, 0);
+  EXPECT_EQ(pattern.GetBlock(1)->offset_, 200);
+  EXPECT_EQ(pattern.PeakSize(), 300);
+  EXPECT_EQ(pattern.LowerBound(), 300);
+}
+
+// check that blocks which are live at the same time don't overlap
+static void TraceRandomAllocations(bool offline_packing) {
+  std::default_random_engine engine(42);
+  std::uniform_int_distribution<size_t> size_dist(0, 4096);
+  std::bernoulli_distribution free_dist(0.5);
+
+  MemPatternPlanner planner(offline_packing);
+  std::vector<int> live;
+  // (index, alloc step, free step) for each allocation
+  std::vector<std::tuple<int, int, int>> lifetimes;
+  int step = 0;
+
+  for (int index = 0; index < 1000; ++index) {
+    while (!live.empty() && free_dist(engine)) {
+      size_t victim = std::uniform_int_distribution<size_t>(0, live.size() - 1)(engine);
+      planner.TraceFree(live[victim]);
+      std::get<2>(lifetimes[live[victim]]) = step++;
+      live.erase(live.begin() + victim);
+    }
+
+    planner.TraceAllocation(index, size_dist(engine));
+    lifetimes.emplace_back(index, step++, std::numeric_limits<int>::max());
+    live.push_back(index);
+  }
+
+  auto pattern = planner.GenerateMemPattern();
+  EXPECT_GE(pattern.PeakSize(), pattern.LowerBound());
+
+  for (size_t i = 0; i < lifetimes.size(); ++i) {
+    const auto* a = pattern.GetBlock(static_cast<int>(i));
+    ASSERT_NE(a, nullptr);
+    EXPECT_LE(a->offset_ + a->size_, pattern.PeakSize());
+    if (a->size_ == 0) {
+      continue;
+    }
+
+    for (size_t j = i + 1; j < lifetimes.size(); ++j) {
+      const auto* b = pattern.GetBlock(static_cast<int>(j));
+      bool live_together = std::get<1>(lifetimes[j]) < std::get<2>(lifetimes[i]);
+      if (live_together && b->size_ > 0) {
+        bool disjoint = a->offset_ + a->size_ <= b->offset_ || b->offset_ + b->size_ <= a->offset_;
+        ASSERT_TRUE(disjoint) << "blocks " << i << " and " << j << " overlap";
+      }
+    }
+  }
+}
+
+TEST(MemPatternPlannerTest, RandomAllocations) {
+  TraceRandomAllocations(false);
+}
+
+TEST(MemPatternPlannerTest, RandomAllocationsOfflinePacking) {
+  TraceRandomAllocations(true);
+}
 }  // namespace test
 }  // namespace onnxruntime
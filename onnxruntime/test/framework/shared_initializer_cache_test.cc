@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shared_initializer_cache.h"
+#include "gtest/gtest.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+static TensorProto CreateTensorProto(const std::vector<int64_t>& dims, const std::vector<float>& values) {
+  TensorProto tensor_proto;
+  tensor_proto.set_name("W");
+  tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+  for (auto dim : dims) {
+    tensor_proto.add_dims(dim);
+  }
+
+  tensor_proto.set_raw_data(values.data(), values.size() * sizeof(float));
+  return tensor_proto;
+}
+
+static const OrtAllocatorInfo kCpuLocation(CPU, OrtArenaAllocator);
+
+TEST(SharedInitializerCacheTest, SharesEqualTensors) {
+  SharedInitializerCache cache;
+  const auto tensor_proto = CreateTensorProto({2, 2}, {1.f, 2.f, 3.f, 4.f});
+
+  std::shared_ptr<void> buffer1, buffer2;
+  MLValue mlvalue1, mlvalue2;
+  ASSERT_TRUE(cache.GetOrAdd(tensor_proto, kCpuLocation, buffer1, mlvalue1).IsOK());
+  ASSERT_TRUE(cache.GetOrAdd(tensor_proto, kCpuLocation, buffer2, mlvalue2).IsOK());
+
+  EXPECT_EQ(buffer1, buffer2);
+  const auto& tensor = mlvalue2.Get<Tensor>();
+  EXPECT_EQ(tensor.DataRaw(), buffer1.get());
+  EXPECT_EQ(tensor.Shape(), TensorShape({2, 2}));
+  EXPECT_EQ(std::vector<float>(tensor.Data<float>(), tensor.Data<float>() + 4),
+            std::vector<float>({1.f, 2.f, 3.f, 4.f}));
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.num_tensors, 1u);
+  EXPECT_EQ(stats.num_bytes, 4 * sizeof(float));
+  EXPECT_EQ(stats.num_references, 2u);
+  EXPECT_EQ(stats.num_referenced_bytes, 8 * sizeof(float));
+}
+
+TEST(SharedInitializerCacheTest, KeepsDifferentTensorsApart) {
+  SharedInitializerCache cache;
+  const std::vector<TensorProto> tensor_protos = {
+      CreateTensorProto({2, 2}, {1.f, 2.f, 3.f, 4.f}),
+      // same data in another shape
+      CreateTensorProto({4}, {1.f, 2.f, 3.f, 4.f}),
+      // same shape with other data
+      CreateTensorProto({2, 2}, {1.f, 2.f, 3.f, 5.f})};
+
+  std::vector<std::shared_ptr<void>> buffers(tensor_protos.size());
+  for (size_t i = 0; i < tensor_protos.size(); ++i) {
+    MLValue mlvalue;
+    ASSERT_TRUE(cache.GetOrAdd(tensor_protos[i], kCpuLocation, buffers[i], mlvalue).IsOK());
+  }
+
+  EXPECT_NE(buffers[0], buffers[1]);
+  EXPECT_NE(buffers[0], buffers[2]);
+  EXPECT_NE(buffers[1], buffers[2]);
+  EXPECT_EQ(cache.GetStats().num_tensors, 3u);
+}
+
+TEST(SharedInitializerCacheTest, ReleasesUnusedTensors) {
+  SharedInitializerCache cache;
+  const auto tensor_proto = CreateTensorProto({2}, {1.f, 2.f});
+
+  {
+    std::shared_ptr<void> buffer;
+    MLValue mlvalue;
+    ASSERT_TRUE(cache.GetOrAdd(tensor_proto, kCpuLocation, buffer, mlvalue).IsOK());
+    EXPECT_EQ(cache.GetStats().num_tensors, 1u);
+  }
+
+  // nothing holds the tensor once its users are gone
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.num_tensors, 0u);
+  EXPECT_EQ(stats.num_bytes, 0u);
+
+  std::shared_ptr<void> buffer;
+  MLValue mlvalue;
+  ASSERT_TRUE(cache.GetOrAdd(tensor_proto, kCpuLocation, buffer, mlvalue).IsOK());
+  EXPECT_EQ(cache.GetStats().num_tensors, 1u);
+}
+
+TEST(SharedInitializerCacheTest, CanShare) {
+  EXPECT_TRUE(SharedInitializerCache::CanShare(CreateTensorProto({1}, {1.f}), kCpuLocation));
+
+  // tensors with typed data aren't shared
+  TensorProto float_data;
+  float_data.set_data_type(TensorProto_DataType_FLOAT);
+  float_data.add_dims(1);
+  float_data.add_float_data(1.f);
+  EXPECT_FALSE(SharedInitializerCache::CanShare(float_data, kCpuLocation));
+
+  // nor are tensors that aren't on CPU
+  EXPECT_FALSE(SharedInitializerCache::CanShare(CreateTensorProto({1}, {1.f}),
+                                                OrtAllocatorInfo("Cuda", OrtArenaAllocator)));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/thread_caching_arena.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+
+namespace onnxruntime {
+namespace test {
+
+static std::unique_ptr<BFCArena> CreateBFCArena() {
+  return std::make_unique<BFCArena>(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+}
+
+static AllocatorStats GetStats(ThreadCachingArena& a) {
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  return stats;
+}
+
+TEST(ThreadCachingArenaTest, ReusesFreedBlock) {
+  ThreadCachingArena a(CreateBFCArena());
+
+  void* p = a.Alloc(1000);
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0u);
+  a.Free(p);
+
+  // the same size class is served from the thread's cache
+  void* q = a.Alloc(1010);
+  EXPECT_EQ(q, p);
+  a.Free(q);
+
+  auto stats = GetStats(a);
+  EXPECT_EQ(stats.num_cache_hits, 1);
+  EXPECT_EQ(stats.num_cache_misses, 1);
+  EXPECT_EQ(stats.num_allocs, 1);
+
+  // a different size class isn't
+  void* r = a.Alloc(4000);
+  EXPECT_NE(r, p);
+  a.Free(r);
+
+  stats = GetStats(a);
+  EXPECT_EQ(stats.num_cache_hits, 1);
+  EXPECT_EQ(stats.num_cache_misses, 2);
+}
+
+TEST(ThreadCachingArenaTest, LargeAllocationsBypassCache) {
+  ThreadCachingArena a(CreateBFCArena(), 1024);
+
+  void* p = a.Alloc(1 << 20);
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0u);
+  a.Free(p);
+
+  auto stats = GetStats(a);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.num_cache_hits, 0);
+  EXPECT_EQ(stats.num_cache_misses, 0);
+
+  void* r = a.Reserve(1000);
+  ASSERT_NE(r, nullptr);
+  a.Free(r);
+  EXPECT_EQ(GetStats(a).bytes_in_use, 0);
+}
+
+TEST(ThreadCachingArenaTest, FlushThreadCache) {
+  ThreadCachingArena a(CreateBFCArena());
+
+  std::vector<void*> ptrs;
+  for (size_t size = 1; size < 10000; size += 100) {
+    void* p = a.Alloc(size);
+    ASSERT_NE(p, nullptr);
+    memset(p, 0, size);
+    ptrs.push_back(p);
+  }
+
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  // the cached blocks are still in use as far as the BFCArena is concerned
+  EXPECT_GT(GetStats(a).bytes_in_use, 0);
+
+  a.FlushThreadCache();
+  EXPECT_EQ(GetStats(a).bytes_in_use, 0);
+}
+
+TEST(ThreadCachingArenaTest, Shrink) {
+  ThreadCachingArena a(CreateBFCArena());
+
+  void* p = a.Alloc(1000);
+  a.Free(p);
+
+  // the block cached by this thread is returned first, so the whole arena is free
+  EXPECT_GT(a.Shrink(), 0u);
+  auto stats = GetStats(a);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+  EXPECT_EQ(stats.num_arena_shrinkages, 1);
+}
+
+TEST(ThreadCachingArenaTest, CacheIsBounded) {
+  const size_t max_cached_bytes = 64 * 1024;
+  ThreadCachingArena a(CreateBFCArena(), ThreadCachingArena::kDefaultMaxCachedSize, max_cached_bytes);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 100; ++i) {
+    ptrs.push_back(a.Alloc(4000));
+  }
+
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  EXPECT_LE(static_cast<size_t>(GetStats(a).bytes_in_use), max_cached_bytes);
+}
+
+TEST(ThreadCachingArenaTest, MultipleThreads) {
+  ThreadCachingArena a(CreateBFCArena());
+
+  // blocks allocated on one thread and freed on others end up in the freeing thread's cache
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 64; ++i) {
+    ptrs.push_back(a.Alloc(100 * (i + 1)));
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&a, &ptrs, t]() {
+      for (size_t i = t; i < ptrs.size(); i += 4) {
+        a.Free(ptrs[i]);
+      }
+
+      for (int i = 0; i < 1000; ++i) {
+        void* p = a.Alloc(64 + (i % 50) * 100);
+        memset(p, t, 64);
+        a.Free(p);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // the threads returned their caches when they exited
+  auto stats = GetStats(a);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.num_cache_hits + stats.num_cache_misses, 64 + 4 * 1000);
+  EXPECT_GT(stats.num_cache_hits, 0);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
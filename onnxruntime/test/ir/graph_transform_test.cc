@@ -6,6 +6,8 @@
 #include "core/graph/model.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/graph_transformer_mgr.h"
+#include "core/optimizer/constant_folding.h"
+#include "core/optimizer/initializer.h"
 #include "core/optimizer/identity_elimination.h"
 #include "core/optimizer/slice_elimination.h"
 #include "core/optimizer/unsqueeze_elimination.h"
@@ -15,15 +17,20 @@
 #include "core/optimizer/conv_activation_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
+#include "core/optimizer/nchwc_transformer.h"
 #include "core/framework/data_types.h"
 #include "core/framework/ml_value.h"
 #include "core/util/math.h"
 #include "core/platform/env.h"
 #include "test/framework/test_utils.h"
+#include "test/model_proto_builder.h"
 #include "test/capturing_sink.h"
 #include "test/test_environment.h"
 #include "gtest/gtest.h"
 
+#include <fstream>
+#include <sstream>
+
 using namespace std;
 using namespace ONNX_NAMESPACE;
 
@@ -64,6 +71,202 @@ TEST(GraphTransformationTests, IdentityElimination) {
   ASSERT_TRUE(op_to_count["Identity"] == 0);
 }
 
+TEST(GraphTransformationTests, DefaultTransformersByLevel) {
+  string model_uri = MODEL_FOLDER + "fusion/fuse-conv-bn-mul-add-unsqueeze.onnx";
+
+  std::shared_ptr<Model> model;
+  ASSERT_TRUE(Model::Load(model_uri, model).IsOK());
+  Graph& graph = model->MainGraph();
+
+  onnxruntime::GraphTransformerManager none_mgr{5, TransformerLevel::kNone};
+  ASSERT_TRUE(none_mgr.ApplyAll(graph).IsOK());
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Unsqueeze"], 2);
+  EXPECT_EQ(op_to_count["BatchNormalization"], 1);
+
+  // the BatchNormalization, Mul and Add are folded into the Conv once the Unsqueeze nodes are removed
+  onnxruntime::GraphTransformerManager basic_mgr{5, TransformerLevel::kBasic};
+  ASSERT_TRUE(basic_mgr.ApplyAll(graph).IsOK());
+  op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Unsqueeze"], 0);
+  EXPECT_EQ(op_to_count["BatchNormalization"], 0);
+  EXPECT_EQ(op_to_count["Mul"], 0);
+  EXPECT_EQ(op_to_count["Add"], 0);
+  EXPECT_EQ(op_to_count["Conv"], 1);
+}
+
+TEST(GraphTransformationTests, DefaultTransformersProfiled) {
+  string model_uri = MODEL_FOLDER + "fusion/fuse-conv-bn-mul-add-unsqueeze.onnx";
+
+  SessionOptions so;
+  so.session_logid = "GraphTransformationTests.DefaultTransformersProfiled";
+  so.enable_profiling = true;
+  so.profile_file_prefix = "graph_transform_profile_test";
+  so.graph_optimization_level = TransformerLevel::kExtended;
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(model_uri).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::ifstream profile(session_object.EndProfiling());
+  ASSERT_TRUE(profile);
+  std::string contents((std::istreambuf_iterator<char>(profile)), std::istreambuf_iterator<char>());
+  EXPECT_NE(contents.find("ConvBNFusion_graph_transform"), std::string::npos);
+  EXPECT_NE(contents.find("GemmActivationFusion_graph_transform"), std::string::npos);
+  EXPECT_NE(contents.find("num_nodes_after"), std::string::npos);
+  EXPECT_NE(contents.find("num_rewrites"), std::string::npos);
+}
+
+TEST(GraphTransformationTests, FusionRewritesCounted) {
+  string model_uri = MODEL_FOLDER + "fusion/fuse-conv-bn-mul-add-unsqueeze.onnx";
+
+  std::shared_ptr<Model> p_model;
+  ASSERT_TRUE(Model::Load(model_uri, p_model).IsOK());
+  Graph& graph = p_model->MainGraph();
+
+  UnsqueezeElimination unsqueeze_elimination;
+  ConvBNFusion conv_bn_fusion;
+  for (const GraphTransformer* transformer : {static_cast<const GraphTransformer*>(&unsqueeze_elimination),
+                                              static_cast<const GraphTransformer*>(&conv_bn_fusion)}) {
+    const int num_nodes_before = graph.NumberOfNodes();
+    bool modified = false;
+    ASSERT_TRUE(transformer->Apply(graph, modified).IsOK());
+    ASSERT_TRUE(graph.Resolve().IsOK());
+
+    // each of these rewrites removes exactly one node
+    EXPECT_GT(transformer->NumRewrites(), 0) << transformer->Name();
+    EXPECT_EQ(transformer->NumRewrites(), num_nodes_before - graph.NumberOfNodes()) << transformer->Name();
+    EXPECT_TRUE(modified);
+  }
+}
+
+// Y = (A + B) * X, with A and B initializers. B is also a graph input if b_is_input is true.
+static ModelProto CreateConstantFoldingModel(bool b_is_input) {
+  GraphProto graph;
+  graph.set_name("constant_folding");
+
+  AddValueInfo(graph.add_input(), "X", {3});
+  if (b_is_input) {
+    AddValueInfo(graph.add_input(), "B", {3});
+  }
+
+  AddInitializer(graph, "A", {3}, {1.f, 2.f, 3.f});
+  AddInitializer(graph, "B", {3}, {10.f, 20.f, 30.f});
+
+  AddNode(graph, "Add", {"A", "B"}, {"C"});
+  AddNode(graph, "Mul", {"C", "X"}, {"Y"});
+
+  AddValueInfo(graph.add_output(), "Y", {3});
+
+  return CreateModelProto(std::move(graph));
+}
+
+TEST(GraphTransformationTests, ConstantFolding) {
+  std::shared_ptr<Model> model;
+  ASSERT_TRUE(Model::Load(CreateConstantFoldingModel(false), model).IsOK());
+  Graph& graph = model->MainGraph();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<ConstantFolding>());
+  ASSERT_TRUE(graph_transformation_mgr.ApplyAll(graph).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Add"], 0);
+  ASSERT_EQ(op_to_count["Mul"], 1);
+
+  const TensorProto* folded = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor("C", folded));
+  Initializer c{folded};
+  ASSERT_EQ(c.size(), 3);
+  EXPECT_EQ(c.data<float>()[0], 11.f);
+  EXPECT_EQ(c.data<float>()[1], 22.f);
+  EXPECT_EQ(c.data<float>()[2], 33.f);
+}
+
+TEST(GraphTransformationTests, ConstantFoldingSkipped) {
+  // B can be overridden by a feed so it isn't constant
+  std::shared_ptr<Model> model;
+  ASSERT_TRUE(Model::Load(CreateConstantFoldingModel(true), model).IsOK());
+  Graph& graph = model->MainGraph();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<ConstantFolding>());
+  ASSERT_TRUE(graph_transformation_mgr.ApplyAll(graph).IsOK());
+  ASSERT_EQ(CountOpsInGraph(graph)["Add"], 1);
+
+  // the output is larger than the limit
+  ASSERT_TRUE(Model::Load(CreateConstantFoldingModel(false), model).IsOK());
+  Graph& graph2 = model->MainGraph();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr2{5};
+  graph_transformation_mgr2.Register(std::make_unique<ConstantFolding>(sizeof(float)));
+  ASSERT_TRUE(graph_transformation_mgr2.ApplyAll(graph2).IsOK());
+  ASSERT_EQ(CountOpsInGraph(graph2)["Add"], 1);
+}
+
+TEST(GraphTransformationTests, ConstantFoldingChecksSizeBeforeRunning) {
+  // Y = Gather(A, I) * X. I has an index that is out of range, so the Gather kernel fails if it runs.
+  GraphProto graph_proto;
+  graph_proto.set_name("constant_folding_size");
+  AddValueInfo(graph_proto.add_input(), "X", {2});
+  AddInitializer(graph_proto, "A", {3}, {1.f, 2.f, 3.f});
+  auto* indices = graph_proto.add_initializer();
+  indices->set_name("I");
+  indices->set_data_type(TensorProto_DataType_INT64);
+  indices->add_dims(2);
+  indices->add_int64_data(0);
+  indices->add_int64_data(5);
+  AddNode(graph_proto, "Gather", {"A", "I"}, {"C"});
+  AddNode(graph_proto, "Mul", {"C", "X"}, {"Y"});
+  AddValueInfo(graph_proto.add_output(), "Y", {2});
+
+  std::shared_ptr<Model> model;
+  ASSERT_TRUE(Model::Load(CreateModelProto(std::move(graph_proto)), model).IsOK());
+  Graph& graph = model->MainGraph();
+
+  // the output of Gather is larger than the limit, so the node is skipped without running the kernel
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<ConstantFolding>(sizeof(float)));
+  Status status = graph_transformation_mgr.ApplyAll(graph);
+  ASSERT_TRUE(status.IsOK()) << status;
+  ASSERT_EQ(CountOpsInGraph(graph)["Gather"], 1);
+}
+
+TEST(GraphTransformationTests, ConstantFoldingRejectsFeed) {
+  // before IR version 4 every initializer is constant even though it's listed as a graph input, so B is folded and
+  // a feed for it is rejected rather than ignored
+  auto model_proto = CreateConstantFoldingModel(true);
+  model_proto.set_ir_version(3);
+  std::string serialized_model;
+  ASSERT_TRUE(model_proto.SerializeToString(&serialized_model));
+
+  SessionOptions so;
+  so.session_logid = "GraphTransformationTests.ConstantFoldingRejectsFeed";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  std::istringstream model_stream(serialized_model);
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  MLValue ml_value_x;
+  CreateMLValue<float>(allocator, {3}, {1.f, 2.f, 3.f}, &ml_value_x);
+  MLValue ml_value_b;
+  CreateMLValue<float>(allocator, {3}, {0.f, 0.f, 0.f}, &ml_value_b);
+
+  std::vector<MLValue> fetches;
+  Status status = session_object.Run({{"X", ml_value_x}, {"B", ml_value_b}}, {"Y"}, &fetches);
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_EQ(status.Code(), common::INVALID_ARGUMENT);
+  EXPECT_NE(status.ErrorMessage().find("is an initializer and can't be fed"), std::string::npos);
+
+  fetches.clear();
+  status = session_object.Run({{"X", ml_value_x}}, {"Y"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  const auto& y = fetches[0].Get<Tensor>();
+  EXPECT_EQ(y.Data<float>()[0], 11.f);
+  EXPECT_EQ(y.Data<float>()[1], 44.f);
+  EXPECT_EQ(y.Data<float>()[2], 99.f);
+}
+
 TEST(GraphTransformationTests, SliceElimination) {
   string model_uri = MODEL_FOLDER + "slice-elim.onnx";
   std::shared_ptr<Model> model;
@@ -231,6 +434,94 @@ TEST(GraphTransformationTests, FuseConvAddMul3D) {
   ASSERT_TRUE(st.IsOK()) << st;
 }
 
+// X -> Conv(W, B) -> Mul(S) -> Y, and X -> Conv(W2, B2) -> Z. the second Conv uses the same W and B as the first
+// if share_initializers is true. W is also a graph input if w_is_input is true.
+static ModelProto CreateConvMulModel(bool share_initializers, bool w_is_input) {
+  GraphProto graph;
+  graph.set_name("conv_mul");
+
+  AddValueInfo(graph.add_input(), "X", {1, 1, 3, 3});
+  if (w_is_input) {
+    AddValueInfo(graph.add_input(), "W", {2, 1, 1, 1});
+  }
+
+  AddInitializer(graph, "W", {2, 1, 1, 1}, {1.f, 1.f});
+  AddInitializer(graph, "B", {2}, {1.f, 1.f});
+  AddInitializer(graph, "S", {2, 1, 1}, {3.f, 3.f});
+  if (!share_initializers) {
+    AddInitializer(graph, "W2", {2, 1, 1, 1}, {1.f, 1.f});
+    AddInitializer(graph, "B2", {2}, {1.f, 1.f});
+  }
+
+  AddNode(graph, "Conv", {"X", "W", "B"}, {"C"});
+  AddNode(graph, "Mul", {"C", "S"}, {"Y"});
+  AddNode(graph, "Conv", {"X", share_initializers ? "W" : "W2", share_initializers ? "B" : "B2"}, {"Z"});
+
+  AddValueInfo(graph.add_output(), "Y", {1, 2, 3, 3});
+  AddValueInfo(graph.add_output(), "Z", {1, 2, 3, 3});
+
+  return CreateModelProto(std::move(graph));
+}
+
+TEST(GraphTransformationTests, FuseConvMulSharedInitializers) {
+  auto apply = [](bool share_initializers, bool w_is_input, std::shared_ptr<Model>& model) {
+    ASSERT_TRUE(Model::Load(CreateConvMulModel(share_initializers, w_is_input), model).IsOK());
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    graph_transformation_mgr.Register(std::make_unique<ConvMulFusion>());
+    ASSERT_TRUE(graph_transformation_mgr.ApplyAll(model->MainGraph()).IsOK());
+  };
+
+  // the Mul is fused when the first Conv is the only user of W and B
+  std::shared_ptr<Model> model;
+  apply(false, false, model);
+  EXPECT_EQ(CountOpsInGraph(model->MainGraph())["Mul"], 0);
+
+  const TensorProto* w = nullptr;
+  ASSERT_TRUE(model->MainGraph().GetInitializedTensor("W", w));
+  EXPECT_EQ(Initializer{w}.data<float>()[0], 3.f);
+
+  // the second Conv would see the scaled W and B if they were shared
+  apply(true, false, model);
+  EXPECT_EQ(CountOpsInGraph(model->MainGraph())["Mul"], 1);
+
+  ASSERT_TRUE(model->MainGraph().GetInitializedTensor("W", w));
+  EXPECT_EQ(Initializer{w}.data<float>()[0], 1.f);
+
+  // a value fed for W would replace the scaled W
+  apply(false, true, model);
+  EXPECT_EQ(CountOpsInGraph(model->MainGraph())["Mul"], 1);
+}
+
+TEST(GraphTransformationTests, FuseConvMulSharedInitializersOutputs) {
+  // both Convs read the unscaled W and B when a session runs the default transformers
+  std::string serialized_model;
+  ASSERT_TRUE(CreateConvMulModel(true, false).SerializeToString(&serialized_model));
+
+  SessionOptions so;
+  so.session_logid = "GraphTransformationTests.FuseConvMulSharedInitializersOutputs";
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  std::istringstream model_stream(serialized_model);
+  ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  MLValue ml_value_x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1, 1, 3, 3},
+                       std::vector<float>(9, 2.f), &ml_value_x);
+  NameMLValMap feeds{{"X", ml_value_x}};
+
+  std::vector<MLValue> fetches;
+  ASSERT_TRUE(session_object.Run(feeds, {"Y", "Z"}, &fetches).IsOK());
+  ASSERT_EQ(fetches.size(), 2u);
+
+  // Y = (2 * 1 + 1) * 3, Z = 2 * 1 + 1
+  const auto& y = fetches[0].Get<Tensor>();
+  const auto& z = fetches[1].Get<Tensor>();
+  for (int64_t i = 0; i < y.Shape().Size(); ++i) {
+    EXPECT_EQ(y.Data<float>()[i], 9.f);
+    EXPECT_EQ(z.Data<float>()[i], 3.f);
+  }
+}
+
 TEST(GraphTransformationTests, MatMulAddFusion_two_input) {
   string model_uri = MODEL_FOLDER + "matmul_add_fusion/2Input/model.onnx";
 
@@ -340,5 +631,111 @@ TEST(GraphTransformationTests, FuseConvBnAddMulFloat16) {
   ASSERT_EQ(expected_values_prod, found);
 }
 
+// X (1x3x9x9) -> Conv -> Relu -> MaxPool -> depthwise Conv -> 1x1 Conv -+-> Add -> Y (1x24x4x4)
+//                                                    \-> 1x1 Conv ------/      \-> GlobalAveragePool -> Z
+static ModelProto CreateNchwcModel() {
+  GraphProto graph;
+  graph.set_name("nchwc");
+
+  // small integer values so the results don't depend on the order of the summations
+  auto add_initializer = [&graph](const std::string& name, const std::vector<int64_t>& dims) {
+    std::vector<float> values(NumElements(dims));
+    for (size_t i = 0; i < values.size(); i++) {
+      values[i] = static_cast<float>(static_cast<int64_t>(i % 5) - 2);
+    }
+    AddInitializer(graph, name, dims, values);
+  };
+
+  AddValueInfo(graph.add_input(), "X", {1, 3, 9, 9});
+
+  add_initializer("W1", {16, 3, 3, 3});
+  add_initializer("B1", {16});
+  add_initializer("W2", {16, 1, 3, 3});
+  add_initializer("W3", {24, 16, 1, 1});
+  add_initializer("W4", {24, 16, 1, 1});
+
+  AddInts(*AddNode(graph, "Conv", {"X", "W1", "B1"}, {"C1"}), "pads", {1, 1, 1, 1});
+  AddNode(graph, "Relu", {"C1"}, {"R1"});
+  auto* pool = AddNode(graph, "MaxPool", {"R1"}, {"P1"});
+  AddInts(*pool, "kernel_shape", {2, 2});
+  AddInts(*pool, "strides", {2, 2});
+  auto* depthwise = AddNode(graph, "Conv", {"P1", "W2"}, {"C2"});
+  AddInts(*depthwise, "pads", {1, 1, 1, 1});
+  AddAttribute(*depthwise, "group", int64_t{16});
+  AddNode(graph, "Conv", {"C2", "W3"}, {"C3"});
+  AddNode(graph, "Conv", {"P1", "W4"}, {"C4"});
+  AddNode(graph, "Add", {"C3", "C4"}, {"Y"});
+  AddNode(graph, "GlobalAveragePool", {"Y"}, {"Z"});
+
+  AddValueInfo(graph.add_output(), "Y", {1, 24, 4, 4});
+  AddValueInfo(graph.add_output(), "Z", {1, 24, 1, 1});
+
+  return CreateModelProto(std::move(graph));
+}
+
+TEST(GraphTransformationTests, NchwcTransformer) {
+  std::shared_ptr<Model> model;
+  ASSERT_TRUE(Model::Load(CreateNchwcModel(), model).IsOK());
+  Graph& graph = model->MainGraph();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<NchwcTransformer>());
+  ASSERT_TRUE(graph_transformation_mgr.ApplyAll(graph).IsOK());
+
+  // the first Conv reads the NCHW input directly as it has fewer channels than the block size, so the only
+  // reorders are for the graph outputs
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Conv"], 0);
+  EXPECT_EQ(op_to_count["NchwcConv"], 4);
+  EXPECT_EQ(op_to_count["NchwcMaxPool"], 1);
+  EXPECT_EQ(op_to_count["NchwcGlobalAveragePool"], 1);
+  EXPECT_EQ(op_to_count["Relu"], 1);
+  EXPECT_EQ(op_to_count["Add"], 1);
+  EXPECT_EQ(op_to_count["ReorderInput"], 0);
+  EXPECT_EQ(op_to_count["ReorderOutput"], 2);
+}
+
+TEST(GraphTransformationTests, NchwcTransformerOutputs) {
+  std::string serialized_model;
+  ASSERT_TRUE(CreateNchwcModel().SerializeToString(&serialized_model));
+
+  std::vector<int64_t> dims_x = {1, 3, 9, 9};
+  std::vector<float> values_x;
+  for (int i = 0; i < 3 * 9 * 9; ++i) {
+    values_x.push_back(static_cast<float>(i % 7 - 3));
+  }
+
+  // run the model with and without the layout transformation and compare the outputs
+  std::vector<std::vector<MLValue>> results;
+  for (auto level : {TransformerLevel::kNone, TransformerLevel::kLayout}) {
+    SessionOptions so;
+    so.session_logid = "GraphTransformationTests.NchwcTransformerOutputs";
+    so.graph_optimization_level = level;
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    std::istringstream model_stream(serialized_model);
+    ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    NameMLValMap feeds;
+    MLValue ml_value_x;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_x, values_x, &ml_value_x);
+    feeds.insert(std::make_pair("X", ml_value_x));
+
+    RunOptions run_options;
+    std::vector<MLValue> fetches;
+    ASSERT_TRUE(session_object.Run(run_options, feeds, std::vector<std::string>{"Y", "Z"}, &fetches).IsOK());
+    results.push_back(fetches);
+  }
+
+  for (size_t i = 0; i < 2; i++) {
+    auto& expected = results[0][i].Get<Tensor>();
+    auto& actual = results[1][i].Get<Tensor>();
+    ASSERT_EQ(expected.Shape(), actual.Shape());
+    for (int64_t j = 0; j < expected.Shape().Size(); j++) {
+      EXPECT_NEAR(expected.Data<float>()[j], actual.Data<float>()[j], 1e-3f) << "output " << i << " index " << j;
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -16,8 +16,11 @@ Abstract:
 
 #include <stdio.h>
 #include <memory.h>
+#include <math.h>
 #include <algorithm>
+#include <chrono>
 #include <limits>
+#include <vector>
 #include <mlas.h>
 
 #if defined(_WIN32)
@@ -367,6 +370,311 @@ ExecuteSgemmTests(
     }
 }
 
+void
+TrialSgemmPackedB(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    float beta,
+    MatrixGuardBuffer& BufferA,
+    MatrixGuardBuffer& BufferB,
+    MatrixGuardBuffer& BufferC,
+    MatrixGuardBuffer& BufferCReference
+    )
+{
+    const float* A = BufferA.GetBuffer(K * M);
+    const float* B = BufferB.GetBuffer(N * K);
+    float* C = BufferC.GetBuffer(N * M);
+    float* CReference = BufferCReference.GetBuffer(N * M);
+
+    const size_t lda = (TransA == CblasNoTrans) ? K : M;
+    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+    //
+    // The packed buffer must be aligned to 64 bytes.
+    //
+
+    std::vector<float> PackedBStorage(MlasSgemmPackBSize(N, K) / sizeof(float) + 16);
+    void* PackedB = (void*)(((uintptr_t)PackedBStorage.data() + 63) & ~uintptr_t(63));
+
+    MlasSgemmPackB(TransB, N, K, B, ldb, PackedB);
+
+    for (size_t f = 0; f < M * N; f++) {
+        C[f] = -0.5f;
+        CReference[f] = -0.5f;
+    }
+
+    MlasSgemm(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, N);
+    ReferenceSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, CReference, N);
+
+    for (size_t f = 0; f < M * N; f++) {
+        // Sensitive to comparing positive/negative zero.
+        if (C[f] != CReference[f]) {
+            printf("mismatch packed B TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
+            break;
+        }
+    }
+}
+
+void
+ExecuteSgemmPackedBTests(
+    void
+    )
+{
+    constexpr size_t MaximumDimension = 320;
+
+    MatrixGuardBuffer BufferA(MaximumDimension * MaximumDimension, true);
+    MatrixGuardBuffer BufferB(MaximumDimension * MaximumDimension, true);
+    MatrixGuardBuffer BufferC(MaximumDimension * MaximumDimension, false);
+    MatrixGuardBuffer BufferCReference(MaximumDimension * MaximumDimension, false);
+
+    static const CBLAS_TRANSPOSE transposes[] = { CblasNoTrans, CblasTrans };
+    static const float multipliers[] = { 0.0f, 0.25f, 1.0f, -1.0f };
+    static const size_t ms[] = { 1, 2, 5, 16, 33, 160 };
+    static const size_t ns[] = { 1, 7, 16, 17, 64, 129, 300 };
+    static const size_t ks[] = { 1, 3, 16, 64, 127, 128, 129, 260, 320 };
+
+    for (size_t ta = 0; ta < _countof(transposes); ta++) {
+        for (size_t tb = 0; tb < _countof(transposes); tb++) {
+            for (size_t m = 0; m < _countof(ms); m++) {
+                for (size_t n = 0; n < _countof(ns); n++) {
+                    for (size_t k = 0; k < _countof(ks); k++) {
+                        for (size_t b = 0; b < _countof(multipliers); b++) {
+                            TrialSgemmPackedB(transposes[ta], transposes[tb], ms[m], ns[n], ks[k], 1.0f,
+                                multipliers[b], BufferA, BufferB, BufferC, BufferCReference);
+                        }
+                        TrialSgemmPackedB(transposes[ta], transposes[tb], ms[m], ns[n], ks[k], -0.5f, 0.0f,
+                            BufferA, BufferB, BufferC, BufferCReference);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+EvaluateSgemmPackedBPerformance(
+    void
+    )
+{
+    //
+    // Shapes of the fully connected layers of batch 1 inference, as {M, N, K}.
+    //
+
+    static const struct {
+        size_t M;
+        size_t N;
+        size_t K;
+    } shapes[] = {
+        { 1, 1000, 2048 },
+        { 1, 4096, 4096 },
+        { 1, 768, 768 },
+        { 1, 3072, 768 },
+        { 8, 768, 768 },
+        { 128, 768, 768 },
+    };
+
+    for (size_t s = 0; s < _countof(shapes); s++) {
+
+        const size_t M = shapes[s].M;
+        const size_t N = shapes[s].N;
+        const size_t K = shapes[s].K;
+
+        MatrixGuardBuffer BufferA(M * K, true);
+        MatrixGuardBuffer BufferB(K * N, true);
+        MatrixGuardBuffer BufferC(M * N, false);
+
+        const float* A = BufferA.GetBuffer(M * K);
+        const float* B = BufferB.GetBuffer(K * N);
+        float* C = BufferC.GetBuffer(M * N);
+
+        std::vector<float> PackedBStorage(MlasSgemmPackBSize(N, K) / sizeof(float) + 16);
+        void* PackedB = (void*)(((uintptr_t)PackedBStorage.data() + 63) & ~uintptr_t(63));
+        MlasSgemmPackB(CblasTrans, N, K, B, K, PackedB);
+
+        constexpr int Iterations = 50;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < Iterations; i++) {
+            MlasSgemm(CblasNoTrans, CblasTrans, M, N, K, 1.0f, A, K, B, K, 0.0f, C, N);
+        }
+        auto unpacked = std::chrono::high_resolution_clock::now() - start;
+
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < Iterations; i++) {
+            MlasSgemm(CblasNoTrans, M, N, K, 1.0f, A, K, PackedB, 0.0f, C, N);
+        }
+        auto packed = std::chrono::high_resolution_clock::now() - start;
+
+        printf("M=%zd N=%zd K=%zd transB: unpacked %.1fus, packed %.1fus\n", M, N, K,
+            std::chrono::duration<double, std::micro>(unpacked).count() / Iterations,
+            std::chrono::duration<double, std::micro>(packed).count() / Iterations);
+    }
+}
+
+void
+TrialSgemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BatchCount,
+    bool BroadcastA,
+    bool BroadcastB,
+    MatrixGuardBuffer& BufferA,
+    MatrixGuardBuffer& BufferB,
+    MatrixGuardBuffer& BufferC,
+    MatrixGuardBuffer& BufferCReference
+    )
+{
+    const size_t StrideA = BroadcastA ? 0 : M * K;
+    const size_t StrideB = BroadcastB ? 0 : K * N;
+    const size_t StrideC = M * N;
+
+    const float* A = BufferA.GetBuffer(BroadcastA ? M * K : M * K * BatchCount);
+    const float* B = BufferB.GetBuffer(BroadcastB ? K * N : K * N * BatchCount);
+    float* C = BufferC.GetBuffer(M * N * BatchCount);
+    float* CReference = BufferCReference.GetBuffer(M * N * BatchCount);
+
+    const size_t lda = (TransA == CblasNoTrans) ? K : M;
+    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+    for (size_t f = 0; f < M * N * BatchCount; f++) {
+        C[f] = -0.5f;
+        CReference[f] = -0.5f;
+    }
+
+    MlasSgemmBatch(TransA, TransB, M, N, K, 1.0f, A, lda, StrideA, B, ldb, StrideB, 0.25f, C, N, StrideC, BatchCount);
+
+    for (size_t batch = 0; batch < BatchCount; batch++) {
+        ReferenceSgemm(TransA, TransB, M, N, K, 1.0f, A + batch * StrideA, lda, B + batch * StrideB, ldb, 0.25f,
+            CReference + batch * StrideC, N);
+    }
+
+    for (size_t f = 0; f < M * N * BatchCount; f++) {
+        if (C[f] != CReference[f]) {
+            printf("mismatch TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, BatchCount=%zd, BroadcastA=%d, BroadcastB=%d!\n",
+                TransA, TransB, M, N, K, BatchCount, int(BroadcastA), int(BroadcastB));
+            break;
+        }
+    }
+}
+
+void
+ExecuteSgemmBatchTests(
+    void
+    )
+{
+    constexpr size_t MaximumElements = 64 * 64 * 64;
+
+    MatrixGuardBuffer BufferA(MaximumElements, true);
+    MatrixGuardBuffer BufferB(MaximumElements, true);
+    MatrixGuardBuffer BufferC(MaximumElements, false);
+    MatrixGuardBuffer BufferCReference(MaximumElements, false);
+
+    static const CBLAS_TRANSPOSE transposes[] = { CblasNoTrans, CblasTrans };
+    static const size_t dims[] = { 1, 3, 16, 33, 64 };
+    static const size_t batches[] = { 1, 2, 7, 16, 64 };
+
+    for (size_t ta = 0; ta < _countof(transposes); ta++) {
+        for (size_t tb = 0; tb < _countof(transposes); tb++) {
+            for (size_t m = 0; m < _countof(dims); m++) {
+                for (size_t n = 0; n < _countof(dims); n++) {
+                    for (size_t k = 0; k < _countof(dims); k++) {
+                        for (size_t b = 0; b < _countof(batches); b++) {
+
+                            if (dims[m] * dims[n] * batches[b] > MaximumElements ||
+                                dims[m] * dims[k] * batches[b] > MaximumElements ||
+                                dims[k] * dims[n] * batches[b] > MaximumElements) {
+                                continue;
+                            }
+
+                            for (int broadcast = 0; broadcast < 3; broadcast++) {
+                                TrialSgemmBatch(transposes[ta], transposes[tb], dims[m], dims[n], dims[k], batches[b],
+                                    broadcast == 1, broadcast == 2, BufferA, BufferB, BufferC, BufferCReference);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+EvaluateSgemmBatchPerformance(
+    void
+    )
+{
+    //
+    // Shapes of the batched matrix multiplies of a transformer layer, as
+    // {BatchCount, M, N, K, BroadcastB}: the attention scores and context of
+    // each head, and the projections of all sequence positions by a shared
+    // weight.
+    //
+
+    static const struct {
+        size_t BatchCount;
+        size_t M;
+        size_t N;
+        size_t K;
+        bool BroadcastB;
+    } shapes[] = {
+        { 12, 128, 128, 64, false },
+        { 12, 128, 64, 128, false },
+        { 96, 128, 128, 64, false },
+        { 96, 128, 64, 128, false },
+        { 12, 1, 128, 64, false },
+        { 8, 128, 768, 768, true },
+        { 8, 128, 3072, 768, true },
+        { 64, 1, 768, 768, true },
+    };
+
+    for (size_t s = 0; s < _countof(shapes); s++) {
+
+        const size_t BatchCount = shapes[s].BatchCount;
+        const size_t M = shapes[s].M;
+        const size_t N = shapes[s].N;
+        const size_t K = shapes[s].K;
+        const size_t StrideB = shapes[s].BroadcastB ? 0 : K * N;
+
+        MatrixGuardBuffer BufferA(M * K * BatchCount, true);
+        MatrixGuardBuffer BufferB(shapes[s].BroadcastB ? K * N : K * N * BatchCount, true);
+        MatrixGuardBuffer BufferC(M * N * BatchCount, false);
+
+        const float* A = BufferA.GetBuffer(M * K * BatchCount);
+        const float* B = BufferB.GetBuffer(shapes[s].BroadcastB ? K * N : K * N * BatchCount);
+        float* C = BufferC.GetBuffer(M * N * BatchCount);
+
+        constexpr int Iterations = 20;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < Iterations; i++) {
+            for (size_t batch = 0; batch < BatchCount; batch++) {
+                MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A + batch * M * K, K, B + batch * StrideB, N,
+                    0.0f, C + batch * M * N, N);
+            }
+        }
+        auto loop = std::chrono::high_resolution_clock::now() - start;
+
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < Iterations; i++) {
+            MlasSgemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, M * K, B, N, StrideB, 0.0f, C, N, M * N,
+                BatchCount);
+        }
+        auto batched = std::chrono::high_resolution_clock::now() - start;
+
+        printf("batch=%zd M=%zd N=%zd K=%zd broadcastB=%d: loop %.1fus, batched %.1fus\n", BatchCount, M, N, K,
+            int(shapes[s].BroadcastB),
+            std::chrono::duration<double, std::micro>(loop).count() / Iterations,
+            std::chrono::duration<double, std::micro>(batched).count() / Iterations);
+    }
+}
+
 void
 ReferenceConv2D(
     size_t BatchCount,
@@ -601,6 +909,21 @@ ExecuteConvTests(
         TrialConv2D(b, 1, 64, 11, 11, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
     }
 
+    //
+    // Depthwise convolutions.
+    //
+
+    for (unsigned i = 1; i <= 32; i++) {
+        for (unsigned k = 3; k <= 5; k += 2) {
+            for (unsigned p = 0; p <= k / 2; p++) {
+                for (unsigned s = 1; s <= 2; s++) {
+                    TrialConv2D(1, 32, 1, i, i, 1, k, k, p, p, p, p, 1, 1, s, s);
+                    TrialConv2D(2, 24, 1, i, i + 3, 2, k, k, p, p, 0, p, 1, 1, s, s);
+                }
+            }
+        }
+    }
+
     for (unsigned ic = 0; ic < _countof(cs); ic++) {
         for (unsigned ih = 0; ih < _countof(is); ih++) {
             for (unsigned iw = 0; iw < _countof(is); iw++) {
@@ -1152,6 +1475,387 @@ ExecutePool3DTests(
     }
 }
 
+void
+TrialNchwcConv2D(
+    size_t BatchCount,
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t InputHeight,
+    size_t InputWidth,
+    size_t FilterCount,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t PaddingLeftHeight,
+    size_t PaddingLeftWidth,
+    size_t PaddingRightHeight,
+    size_t PaddingRightWidth,
+    size_t DilationHeight,
+    size_t DilationWidth,
+    size_t StrideHeight,
+    size_t StrideWidth
+    )
+{
+    //
+    // The NCHWc convolution supports a single group or a depthwise
+    // convolution.
+    //
+
+    if (GroupCount > 1 && (InputChannels != 1 || FilterCount != 1)) {
+        return;
+    }
+
+    int64_t OutputHeight64 =
+        ((int64_t(InputHeight) + int64_t(PaddingLeftHeight) + int64_t(PaddingRightHeight)) -
+        (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
+    int64_t OutputWidth64 =
+        ((int64_t(InputWidth) + int64_t(PaddingLeftWidth) + int64_t(PaddingRightWidth)) -
+        (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
+
+    if (OutputHeight64 <= 0 || OutputWidth64 <= 0) {
+        return;
+    }
+
+    size_t BlockSize = MlasNchwcGetBlockSize();
+
+    size_t Channels = GroupCount * InputChannels;
+    size_t OutputChannels = GroupCount * FilterCount;
+    size_t ChannelsPadded = (Channels + BlockSize - 1) & ~(BlockSize - 1);
+    size_t OutputChannelsPadded = (OutputChannels + BlockSize - 1) & ~(BlockSize - 1);
+
+    //
+    // A single group convolution with fewer channels than the block size
+    // reads the NCHW input directly.
+    //
+
+    bool ReorderInput = (GroupCount > 1 || Channels >= BlockSize);
+
+    int64_t InputShape[] = { int64_t(BatchCount), int64_t(Channels), int64_t(InputHeight), int64_t(InputWidth) };
+    int64_t NchwcInputShape[] = { int64_t(BatchCount), int64_t(ReorderInput ? ChannelsPadded : Channels), int64_t(InputHeight), int64_t(InputWidth) };
+    int64_t FilterShape[] = { int64_t(OutputChannels), int64_t(InputChannels), int64_t(KernelHeight), int64_t(KernelWidth) };
+    int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+    int64_t DilationShape[] = { int64_t(DilationHeight), int64_t(DilationWidth) };
+    int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+    int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+    int64_t OutputShape[] = { int64_t(BatchCount), int64_t(OutputChannels), OutputHeight64, OutputWidth64 };
+    int64_t NchwcOutputShape[] = { int64_t(BatchCount), int64_t(OutputChannelsPadded), OutputHeight64, OutputWidth64 };
+
+    size_t OutputHeight = size_t(OutputHeight64);
+    size_t OutputWidth = size_t(OutputWidth64);
+
+    size_t InputSize = InputHeight * InputWidth;
+    size_t KernelSize = KernelHeight * KernelWidth;
+    size_t OutputSize = OutputHeight * OutputWidth;
+
+    size_t InputBufferElements = BatchCount * Channels * InputSize;
+    size_t NchwcInputBufferElements = BatchCount * ChannelsPadded * InputSize;
+    size_t FilterBufferElements = OutputChannels * InputChannels * KernelSize;
+    size_t NchwcFilterBufferElements = OutputChannelsPadded * ((GroupCount > 1) ? 1 : ChannelsPadded) * KernelSize;
+    size_t BiasBufferElements = OutputChannels;
+    size_t OutputBufferElements = BatchCount * OutputChannels * OutputSize;
+    size_t NchwcOutputBufferElements = BatchCount * OutputChannelsPadded * OutputSize;
+
+    MatrixGuardBuffer BufferInput(InputBufferElements, true);
+    MatrixGuardBuffer BufferNchwcInput(NchwcInputBufferElements, false);
+    MatrixGuardBuffer BufferFilter(FilterBufferElements, true);
+    MatrixGuardBuffer BufferNchwcFilter(NchwcFilterBufferElements, false);
+    MatrixGuardBuffer BufferBias(BiasBufferElements, true);
+    MatrixGuardBuffer BufferNchwcBias(OutputChannelsPadded, false);
+    MatrixGuardBuffer BufferOutput(OutputBufferElements, false);
+    MatrixGuardBuffer BufferNchwcOutput(NchwcOutputBufferElements, false);
+    MatrixGuardBuffer BufferOutputReference(OutputBufferElements, false);
+
+    const float* Input = BufferInput.GetBuffer(InputBufferElements);
+    float* NchwcInput = BufferNchwcInput.GetBuffer(NchwcInputBufferElements);
+    const float* Filter = BufferFilter.GetBuffer(FilterBufferElements);
+    float* NchwcFilter = BufferNchwcFilter.GetBuffer(NchwcFilterBufferElements);
+    const float* Bias = BufferBias.GetBuffer(BiasBufferElements);
+    float* NchwcBias = BufferNchwcBias.GetBuffer(OutputChannelsPadded);
+    float* Output = BufferOutput.GetBuffer(OutputBufferElements);
+    float* NchwcOutput = BufferNchwcOutput.GetBuffer(NchwcOutputBufferElements);
+    float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
+
+    if (ReorderInput) {
+        MlasReorderInput(InputShape, Input, NchwcInput);
+    }
+
+    if (GroupCount == 1 && ReorderInput) {
+        MlasReorderFilterOIHWBiBo(FilterShape, Filter, NchwcFilter);
+    } else {
+        MlasReorderFilterOIHWBo(FilterShape, Filter, NchwcFilter);
+    }
+
+    std::fill_n(NchwcBias, OutputChannelsPadded, 0.0f);
+    std::copy_n(Bias, OutputChannels, NchwcBias);
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasIdentityActivation;
+
+    MlasNchwcConv(NchwcInputShape,
+                  KernelShape,
+                  DilationShape,
+                  Padding,
+                  StrideShape,
+                  NchwcOutputShape,
+                  GroupCount,
+                  ReorderInput ? NchwcInput : Input,
+                  NchwcFilter,
+                  NchwcBias,
+                  NchwcOutput,
+                  &Activation);
+
+    MlasReorderOutput(OutputShape, NchwcOutput, Output);
+
+    ReferenceConv2D(BatchCount,
+                    GroupCount,
+                    InputChannels,
+                    InputHeight, InputWidth,
+                    FilterCount,
+                    KernelHeight, KernelWidth,
+                    PaddingLeftHeight, PaddingLeftWidth,
+                    DilationHeight, DilationWidth,
+                    StrideHeight, StrideWidth,
+                    OutputHeight, OutputWidth,
+                    Input,
+                    Filter,
+                    Bias,
+                    OutputReference);
+
+    if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+        printf("mismatch: nchwc batch=%zd,group=%zd,input(%zd,%zd,%zd),filter=%zd,kernel(%zd,%zd)!!!\n",
+            BatchCount, GroupCount, InputChannels, InputHeight, InputWidth, FilterCount,
+            KernelHeight, KernelWidth);
+    }
+}
+
+void
+TrialNchwcPool2D(
+    size_t BatchCount,
+    size_t InputChannels,
+    size_t InputHeight,
+    size_t InputWidth,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    size_t PaddingLeftHeight,
+    size_t PaddingLeftWidth,
+    size_t PaddingRightHeight,
+    size_t PaddingRightWidth,
+    size_t StrideHeight,
+    size_t StrideWidth
+    )
+{
+    size_t BlockSize = MlasNchwcGetBlockSize();
+
+    size_t ChannelsPadded = (InputChannels + BlockSize - 1) & ~(BlockSize - 1);
+
+    int64_t InputShape[] = { int64_t(BatchCount), int64_t(InputChannels), int64_t(InputHeight), int64_t(InputWidth) };
+    int64_t NchwcInputShape[] = { int64_t(BatchCount), int64_t(ChannelsPadded), int64_t(InputHeight), int64_t(InputWidth) };
+    int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+    int64_t Padding[] = { int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth) };
+    int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+    int64_t OutputShape[] = { int64_t(BatchCount), int64_t(InputChannels), 0, 0 };
+
+    OutputShape[2] = (InputShape[2] + Padding[0] + Padding[2] - KernelShape[0]) / StrideShape[0] + 1;
+    OutputShape[3] = (InputShape[3] + Padding[1] + Padding[3] - KernelShape[1]) / StrideShape[1] + 1;
+
+    int64_t NchwcOutputShape[] = { int64_t(BatchCount), int64_t(ChannelsPadded), OutputShape[2], OutputShape[3] };
+
+    size_t InputBufferElements = size_t(InputShape[0] * InputShape[1] * InputShape[2] * InputShape[3]);
+    size_t NchwcInputBufferElements = size_t(NchwcInputShape[0] * NchwcInputShape[1] * NchwcInputShape[2] * NchwcInputShape[3]);
+    size_t OutputBufferElements = size_t(OutputShape[0] * OutputShape[1] * OutputShape[2] * OutputShape[3]);
+    size_t NchwcOutputBufferElements = size_t(NchwcOutputShape[0] * NchwcOutputShape[1] * NchwcOutputShape[2] * NchwcOutputShape[3]);
+
+    MatrixGuardBuffer BufferInput(InputBufferElements, true);
+    MatrixGuardBuffer BufferNchwcInput(NchwcInputBufferElements, false);
+    MatrixGuardBuffer BufferOutput(OutputBufferElements, false);
+    MatrixGuardBuffer BufferNchwcOutput(NchwcOutputBufferElements, false);
+    MatrixGuardBuffer BufferOutputReference(OutputBufferElements, false);
+
+    const float* Input = BufferInput.GetBuffer(InputBufferElements);
+    float* NchwcInput = BufferNchwcInput.GetBuffer(NchwcInputBufferElements);
+    float* Output = BufferOutput.GetBuffer(OutputBufferElements);
+    float* NchwcOutput = BufferNchwcOutput.GetBuffer(NchwcOutputBufferElements);
+    float* OutputReference = BufferOutputReference.GetBuffer(OutputBufferElements);
+
+    MlasReorderInput(InputShape, Input, NchwcInput);
+
+    MlasNchwcPool(MlasMaximumPooling, NchwcInputShape, KernelShape, Padding, StrideShape, NchwcOutputShape, NchwcInput, NchwcOutput);
+    MlasReorderOutput(OutputShape, NchwcOutput, Output);
+    ReferenceMaximumPool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference);
+
+    if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+        printf("mismatch: nchwc maximum input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
+            InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+    }
+
+    MlasNchwcPool(MlasAveragePoolingExcludePad, NchwcInputShape, KernelShape, Padding, StrideShape, NchwcOutputShape, NchwcInput, NchwcOutput);
+    MlasReorderOutput(OutputShape, NchwcOutput, Output);
+    ReferenceAveragePool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, false);
+
+    if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+        printf("mismatch: nchwc averageexcpad input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
+            InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+    }
+
+    MlasNchwcPool(MlasAveragePoolingIncludePad, NchwcInputShape, KernelShape, Padding, StrideShape, NchwcOutputShape, NchwcInput, NchwcOutput);
+    MlasReorderOutput(OutputShape, NchwcOutput, Output);
+    ReferenceAveragePool2D(InputShape, KernelShape, Padding, StrideShape, Input, OutputReference, true);
+
+    if (memcmp(Output, OutputReference, OutputBufferElements * sizeof(float)) != 0) {
+        printf("mismatch: nchwc averageincpad input(%zd,%zd,%zd),kernel(%zd,%zd)!!!\n",
+            InputChannels, InputHeight, InputWidth, KernelHeight, KernelWidth);
+    }
+}
+
+void
+ExecuteNchwcTests(
+    void
+    )
+{
+    static const unsigned cs[] = { 32, 20, 3 };
+    static const unsigned is[] = { 53, 11, 5, 1 };
+
+    for (unsigned i = 1; i < 256; i <<= 1) {
+        TrialNchwcConv2D(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+        TrialNchwcConv2D(1, 1, 16, i, i, 32, 3, 3, 1, 1, 1, 1, 1, 1, 2, 2);
+        TrialNchwcConv2D(1, 1, 3, i, i, 24, 3, 3, 1, 1, 1, 1, 1, 1, 2, 2);
+        TrialNchwcConv2D(1, 40, 1, i, i, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+        TrialNchwcConv2D(1, 1, 16, i, i, 32, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+    }
+
+    for (unsigned b = 1; b < 5; b++) {
+        TrialNchwcConv2D(b, 1, 64, 11, 11, 40, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
+        TrialNchwcConv2D(b, 24, 1, 11, 11, 1, 5, 5, 2, 2, 2, 2, 1, 1, 1, 1);
+    }
+
+    for (unsigned ic = 0; ic < _countof(cs); ic++) {
+        for (unsigned ih = 0; ih < _countof(is); ih++) {
+            for (unsigned iw = 0; iw < _countof(is); iw++) {
+                fprintf(stderr, "Handling %dx%dx%d\n", cs[ic], is[ih], is[iw]);
+                for (unsigned kh = 1; kh <= 5; kh += 2) {
+                    for (unsigned kw = 1; kw <= 5; kw += 2) {
+                        for (unsigned p0 = 0; p0 < 2; p0++) {
+                            for (unsigned p1 = 0; p1 < 2; p1++) {
+                                for (unsigned d = 1; d <= 2; d++) {
+                                    for (unsigned s = 1; s <= 2; s++) {
+                                        TrialNchwcConv2D(1, 1, cs[ic], is[ih], is[iw], 24, kh, kw, p0, p1, p1, p0, d, d, s, s);
+                                        TrialNchwcConv2D(1, cs[ic], 1, is[ih], is[iw], 1, kh, kw, p0, p1, p1, p0, d, d, s, s);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+                for (unsigned kh = 1; kh <= 3; kh++) {
+                    if (kh > is[ih]) break;
+                    for (unsigned kw = 1; kw <= 3; kw++) {
+                        if (kw > is[iw]) break;
+                        for (unsigned s = 1; s <= 2; s++) {
+                            for (unsigned p = 0; p < kh && p < kw; p++) {
+                                TrialNchwcPool2D(2, cs[ic], is[ih], is[iw], kh, kw, p, p, p, p, s, s);
+                                TrialNchwcPool2D(2, cs[ic], is[ih], is[iw], kh, kw, 0, p, p, 0, s, s);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+ReferenceSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    )
+{
+    for (size_t n = 0; n < N; n++) {
+
+        double Maximum = Input[0];
+
+        for (size_t d = 1; d < D; d++) {
+            Maximum = (std::max)(Maximum, double(Input[d]));
+        }
+
+        double Sum = 0.0;
+
+        for (size_t d = 0; d < D; d++) {
+            Sum += exp(double(Input[d]) - Maximum);
+        }
+
+        for (size_t d = 0; d < D; d++) {
+            if (LogSoftmax) {
+                Output[d] = float(double(Input[d]) - Maximum - log(Sum));
+            } else {
+                Output[d] = float(exp(double(Input[d]) - Maximum) / Sum);
+            }
+        }
+
+        Input += D;
+        Output += D;
+    }
+}
+
+void
+TrialSoftmax(
+    size_t N,
+    size_t D,
+    bool LogSoftmax
+    )
+{
+    const float AbsoluteTolerance = 1e-6f;
+    const float RelativeTolerance = 1e-5f;
+
+    MatrixGuardBuffer BufferInput(N * D, false);
+    MatrixGuardBuffer BufferOutput(N * D, false);
+    MatrixGuardBuffer BufferOutputReference(N * D, false);
+
+    float* Input = BufferInput.GetBuffer(N * D);
+    float* Output = BufferOutput.GetBuffer(N * D);
+    float* OutputReference = BufferOutputReference.GetBuffer(N * D);
+
+    //
+    // Use a range of values that includes inputs that underflow the
+    // exponential function after the maximum is subtracted.
+    //
+
+    for (size_t i = 0; i < N * D; i++) {
+        Input[i] = float(int((i * 7919) % 2011) - 1005) / 8.0f;
+    }
+
+    MlasComputeSoftmax(Input, Output, N, D, LogSoftmax);
+    ReferenceSoftmax(Input, OutputReference, N, D, LogSoftmax);
+
+    for (size_t i = 0; i < N * D; i++) {
+        float diff = float(fabs(Output[i] - OutputReference[i]));
+        if (diff > AbsoluteTolerance && diff > fabs(OutputReference[i]) * RelativeTolerance) {
+            printf("mismatch: %s(%zd,%zd) [%zd] %f %f!!!\n", LogSoftmax ? "logsoftmax" : "softmax",
+                N, D, i, Output[i], OutputReference[i]);
+            break;
+        }
+    }
+}
+
+void
+ExecuteSoftmaxTests(
+    void
+    )
+{
+    for (unsigned n = 1; n < 128; n++) {
+        for (unsigned d = 1; d < 128; d++) {
+            TrialSoftmax(n, d, false);
+            TrialSoftmax(n, d, true);
+        }
+    }
+
+    TrialSoftmax(1, 100000, false);
+    TrialSoftmax(1, 100000, true);
+    TrialSoftmax(4096, 1000, false);
+    TrialSoftmax(4096, 1000, true);
+}
+
 #if 0
 #if defined(_WIN32)
 
@@ -1239,10 +1943,16 @@ main(
     )
 {
 //    ExecuteSgemmTests();
+    ExecuteSgemmBatchTests();
+    ExecuteSgemmPackedBTests();
     ExecuteConvTests();
+    ExecuteNchwcTests();
+    ExecuteSoftmaxTests();
 //    ExecutePool2DTests();
 //    ExecutePool3DTests();
 //    EvaluateThreadingPerformance();
+//    EvaluateSgemmBatchPerformance();
+//    EvaluateSgemmPackedBPerformance();
 
     return 0;
 }
@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/graph/onnx_protobuf.h>
+#include <core/framework/allocator.h>
+#include <core/framework/ml_value.h>
+#include <core/framework/tensor.h>
+#include <core/session/inference_session.h>
+#include <test/model_proto_builder.h>
+
+#include <sstream>
+
+using namespace onnxruntime;
+using namespace onnxruntime::test;
+using namespace ONNX_NAMESPACE;
+
+// the per-iteration work in the subgraphs is small so the time is mostly the cost of running the subgraph
+static const int64_t kHiddenSize = 32;
+
+// Scan with one loop state variable and one scan input of sequence_len steps. Each step adds the input to the state.
+static ModelProto CreateScanModel(int64_t sequence_len) {
+  GraphProto body;
+  body.set_name("scan_body");
+  AddValueInfo(body.add_input(), "state_in", {kHiddenSize});
+  AddValueInfo(body.add_input(), "x", {kHiddenSize});
+  AddNode(body, "Add", {"state_in", "x"}, {"state_out"});
+  AddNode(body, "Relu", {"state_out"}, {"y"});
+  AddValueInfo(body.add_output(), "state_out", {kHiddenSize});
+  AddValueInfo(body.add_output(), "y", {kHiddenSize});
+
+  GraphProto graph;
+  graph.set_name("scan");
+  AddValueInfo(graph.add_input(), "initial_state", {kHiddenSize});
+  AddValueInfo(graph.add_input(), "sequence", {sequence_len, kHiddenSize});
+
+  auto* scan = AddNode(graph, "Scan", {"initial_state", "sequence"}, {"final_state", "scan_output"});
+  AddAttribute(*scan, "num_scan_inputs", int64_t{1});
+  AddAttribute(*scan, "body", body);
+
+  AddValueInfo(graph.add_output(), "final_state", {kHiddenSize});
+  AddValueInfo(graph.add_output(), "scan_output", {sequence_len, kHiddenSize});
+
+  return CreateModelProto(std::move(graph));
+}
+
+// Loop that runs for the trip count with one loop carried variable that is negated on each iteration.
+static ModelProto CreateLoopModel() {
+  GraphProto body;
+  body.set_name("loop_body");
+  AddValueInfo(body.add_input(), "iter_num", {1}, TensorProto_DataType_INT64);
+  AddValueInfo(body.add_input(), "cond_in", {1}, TensorProto_DataType_BOOL);
+  AddValueInfo(body.add_input(), "v_in", {kHiddenSize});
+  AddNode(body, "Identity", {"cond_in"}, {"cond_out"});
+  AddNode(body, "Neg", {"v_in"}, {"v_out"});
+  AddValueInfo(body.add_output(), "cond_out", {1}, TensorProto_DataType_BOOL);
+  AddValueInfo(body.add_output(), "v_out", {kHiddenSize});
+
+  GraphProto graph;
+  graph.set_name("loop");
+  AddValueInfo(graph.add_input(), "M", {1}, TensorProto_DataType_INT64);
+  AddValueInfo(graph.add_input(), "cond", {1}, TensorProto_DataType_BOOL);
+  AddValueInfo(graph.add_input(), "v_initial", {kHiddenSize});
+
+  auto* loop = AddNode(graph, "Loop", {"M", "cond", "v_initial"}, {"v_final"});
+  AddAttribute(*loop, "body", body);
+
+  AddValueInfo(graph.add_output(), "v_final", {kHiddenSize});
+
+  return CreateModelProto(std::move(graph));
+}
+
+template <typename T>
+static MLValue CreateTensorValue(const std::vector<int64_t>& dims, T value) {
+  static AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  TensorShape shape(dims);
+  auto tensor = std::make_unique<Tensor>(DataTypeImpl::GetType<T>(), shape,
+                                         allocator->Alloc(shape.Size() * sizeof(T)), allocator->Info(), allocator);
+  std::fill_n(tensor->template MutableData<T>(), shape.Size(), value);
+  return MLValue{tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()};
+}
+
+static void RunModel(benchmark::State& state, const ModelProto& model, const NameMLValMap& feeds,
+                     const std::vector<std::string>& output_names) {
+  SessionOptions so;
+  so.session_logid = "controlflow";
+  InferenceSession session{so};
+
+  std::stringstream model_stream;
+  model.SerializeToOstream(&model_stream);
+  auto status = session.Load(model_stream);
+  if (status.IsOK()) {
+    status = session.Initialize();
+  }
+
+  if (!status.IsOK()) {
+    state.SkipWithError(status.ErrorMessage().c_str());
+    return;
+  }
+
+  for (auto _ : state) {
+    std::vector<MLValue> fetches;
+    status = session.Run(feeds, output_names, &fetches);
+    if (!status.IsOK()) {
+      state.SkipWithError(status.ErrorMessage().c_str());
+      break;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ScanLongSequence(benchmark::State& state) {
+  const int64_t sequence_len = state.range(0);
+  NameMLValMap feeds{{"initial_state", CreateTensorValue<float>({kHiddenSize}, 0.f)},
+                     {"sequence", CreateTensorValue<float>({sequence_len, kHiddenSize}, 1.f)}};
+
+  RunModel(state, CreateScanModel(sequence_len), feeds, {"final_state", "scan_output"});
+}
+
+BENCHMARK(BM_ScanLongSequence)->Arg(500)->Arg(2000)->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_LoopLongSequence(benchmark::State& state) {
+  NameMLValMap feeds{{"M", CreateTensorValue<int64_t>({1}, state.range(0))},
+                     {"cond", CreateTensorValue<bool>({1}, true)},
+                     {"v_initial", CreateTensorValue<float>({kHiddenSize}, 1.f)}};
+
+  RunModel(state, CreateLoopModel(), feeds, {"v_final"});
+}
+
+BENCHMARK(BM_LoopLongSequence)->Arg(500)->Arg(2000)->Unit(benchmark::TimeUnit::kMicrosecond);
@@ -0,0 +1,238 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/graph/onnx_protobuf.h>
+#include <core/framework/allocator.h>
+#include <core/framework/ml_value.h>
+#include <core/framework/tensor.h>
+#include <core/session/inference_session.h>
+#include <test/model_proto_builder.h>
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+
+using namespace onnxruntime;
+using namespace onnxruntime::test;
+using namespace ONNX_NAMESPACE;
+
+static const int64_t kNumFeatures = 100;
+static const int64_t kNumClasses = 3;
+
+// the size of a typical gradient boosted model
+static const int64_t kNumTrees = 500;
+static const int64_t kTreeDepth = 6;
+
+// the size of a typical kernel SVM
+static const int64_t kNumSupportVectors = 100;
+
+// completes a graph of one ML op node, which reads X and writes Y, and Z if it's a classifier, and serializes it
+static std::string SerializeModel(GraphProto& graph, bool classifier) {
+  graph.set_name("ml_op");
+  AddValueInfo(graph.add_input(), "X", {-1, kNumFeatures});
+
+  auto* node = graph.mutable_node(0);
+  node->set_domain("ai.onnx.ml");
+  node->add_input("X");
+  node->add_output("Y");
+  if (classifier) {
+    node->add_output("Z");
+    AddValueInfo(graph.add_output(), "Y", {-1}, TensorProto_DataType_INT64);
+    AddValueInfo(graph.add_output(), "Z", {-1, kNumClasses});
+  } else {
+    AddValueInfo(graph.add_output(), "Y", {-1, 1});
+  }
+
+  ModelProto model = CreateModelProto(std::move(graph));
+  auto* opset = model.add_opset_import();
+  opset->set_domain("ai.onnx.ml");
+  opset->set_version(1);
+
+  std::string serialized;
+  model.SerializeToString(&serialized);
+  return serialized;
+}
+
+// kNumTrees complete trees of kTreeDepth levels of random splits. the leaves of a classifier have a weight for
+// each class, the leaves of a regressor have a single weight.
+static std::string CreateTreeEnsembleModel(bool classifier) {
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int64_t> feature(0, kNumFeatures - 1);
+  std::uniform_real_distribution<float> value(-1.f, 1.f);
+
+  std::vector<int64_t> treeids, nodeids, featureids, truenodeids, falsenodeids;
+  std::vector<float> values;
+  std::vector<std::string> modes;
+  std::vector<int64_t> weight_treeids, weight_nodeids, weight_ids;
+  std::vector<float> weights;
+
+  const int64_t num_nodes = (int64_t{1} << (kTreeDepth + 1)) - 1;
+  const int64_t num_branches = (int64_t{1} << kTreeDepth) - 1;
+  const int64_t num_weight_ids = classifier ? kNumClasses : 1;
+  for (int64_t tree = 0; tree < kNumTrees; ++tree) {
+    for (int64_t node = 0; node < num_nodes; ++node) {
+      treeids.push_back(tree);
+      nodeids.push_back(node);
+      if (node < num_branches) {
+        featureids.push_back(feature(generator));
+        values.push_back(value(generator));
+        modes.push_back("BRANCH_LEQ");
+        truenodeids.push_back(2 * node + 1);
+        falsenodeids.push_back(2 * node + 2);
+      } else {
+        featureids.push_back(0);
+        values.push_back(0.f);
+        modes.push_back("LEAF");
+        truenodeids.push_back(0);
+        falsenodeids.push_back(0);
+        for (int64_t id = 0; id < num_weight_ids; ++id) {
+          weight_treeids.push_back(tree);
+          weight_nodeids.push_back(node);
+          weight_ids.push_back(id);
+          weights.push_back(value(generator));
+        }
+      }
+    }
+  }
+
+  GraphProto graph;
+  auto* node = graph.add_node();
+  AddInts(*node, "nodes_treeids", treeids);
+  AddInts(*node, "nodes_nodeids", nodeids);
+  AddInts(*node, "nodes_featureids", featureids);
+  AddFloats(*node, "nodes_values", values);
+  AddStrings(*node, "nodes_modes", modes);
+  AddInts(*node, "nodes_truenodeids", truenodeids);
+  AddInts(*node, "nodes_falsenodeids", falsenodeids);
+
+  if (classifier) {
+    node->set_op_type("TreeEnsembleClassifier");
+    AddInts(*node, "class_treeids", weight_treeids);
+    AddInts(*node, "class_nodeids", weight_nodeids);
+    AddInts(*node, "class_ids", weight_ids);
+    AddFloats(*node, "class_weights", weights);
+    AddInts(*node, "classlabels_int64s", {0, 1, 2});
+  } else {
+    node->set_op_type("TreeEnsembleRegressor");
+    AddInts(*node, "target_treeids", weight_treeids);
+    AddInts(*node, "target_nodeids", weight_nodeids);
+    AddInts(*node, "target_ids", weight_ids);
+    AddFloats(*node, "target_weights", weights);
+    AddAttribute(*node, "n_targets", int64_t{1});
+  }
+
+  return SerializeModel(graph, classifier);
+}
+
+// a classifier with kNumClasses linear functions of the features
+static std::string CreateLinearClassifierModel() {
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<float> value(-1.f, 1.f);
+  std::vector<float> coefficients(kNumClasses * kNumFeatures);
+  std::vector<float> intercepts(kNumClasses);
+  std::generate(coefficients.begin(), coefficients.end(), [&]() { return value(generator); });
+  std::generate(intercepts.begin(), intercepts.end(), [&]() { return value(generator); });
+
+  GraphProto graph;
+  auto* node = graph.add_node();
+  node->set_op_type("LinearClassifier");
+  AddFloats(*node, "coefficients", coefficients);
+  AddFloats(*node, "intercepts", intercepts);
+  AddInts(*node, "classlabels_ints", {0, 1, 2});
+  return SerializeModel(graph, true);
+}
+
+// a classifier with kNumSupportVectors support vectors for each of kNumClasses classes and an RBF kernel
+static std::string CreateSVMClassifierModel() {
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<float> value(-1.f, 1.f);
+  const int64_t num_vectors = kNumClasses * kNumSupportVectors;
+  std::vector<float> support_vectors(num_vectors * kNumFeatures);
+  std::vector<float> coefficients((kNumClasses - 1) * num_vectors);
+  std::vector<float> rho(kNumClasses * (kNumClasses - 1) / 2);
+  std::generate(support_vectors.begin(), support_vectors.end(), [&]() { return value(generator); });
+  std::generate(coefficients.begin(), coefficients.end(), [&]() { return value(generator); });
+  std::generate(rho.begin(), rho.end(), [&]() { return value(generator); });
+
+  GraphProto graph;
+  auto* node = graph.add_node();
+  node->set_op_type("SVMClassifier");
+  AddAttribute(*node, "kernel_type", "RBF");
+  AddFloats(*node, "kernel_params", {1.f / kNumFeatures, 0.f, 3.f});
+  AddFloats(*node, "support_vectors", support_vectors);
+  AddInts(*node, "vectors_per_class", std::vector<int64_t>(kNumClasses, kNumSupportVectors));
+  AddFloats(*node, "coefficients", coefficients);
+  AddFloats(*node, "rho", rho);
+  AddInts(*node, "classlabels_ints", {0, 1, 2});
+  return SerializeModel(graph, true);
+}
+
+static void RunModel(benchmark::State& state, const std::string& model, bool classifier) {
+  const int64_t num_rows = state.range(0);
+
+  SessionOptions so;
+  so.session_logid = "ml_ops";
+  InferenceSession session{so};
+
+  std::istringstream model_stream(model);
+  auto status = session.Load(model_stream);
+  if (status.IsOK()) {
+    status = session.Initialize();
+  }
+
+  if (!status.IsOK()) {
+    state.SkipWithError(status.ErrorMessage().c_str());
+    return;
+  }
+
+  static AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  TensorShape shape({num_rows, kNumFeatures});
+  auto tensor = std::make_unique<Tensor>(DataTypeImpl::GetType<float>(), shape,
+                                         allocator->Alloc(shape.Size() * sizeof(float)), allocator->Info(), allocator);
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<float> value(-1.f, 1.f);
+  std::generate_n(tensor->MutableData<float>(), shape.Size(), [&]() { return value(generator); });
+  NameMLValMap feeds{{"X", MLValue{tensor.release(), DataTypeImpl::GetType<Tensor>(),
+                                   DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()}}};
+
+  std::vector<std::string> output_names{"Y"};
+  if (classifier) {
+    output_names.push_back("Z");
+  }
+
+  for (auto _ : state) {
+    std::vector<MLValue> fetches;
+    status = session.Run(feeds, output_names, &fetches);
+    if (!status.IsOK()) {
+      state.SkipWithError(status.ErrorMessage().c_str());
+      break;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_rows);
+}
+
+static void BM_TreeEnsembleRegressor(benchmark::State& state) {
+  RunModel(state, CreateTreeEnsembleModel(false), false);
+}
+
+BENCHMARK(BM_TreeEnsembleRegressor)->Arg(1)->Arg(100)->Arg(10000)->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_TreeEnsembleClassifier(benchmark::State& state) {
+  RunModel(state, CreateTreeEnsembleModel(true), true);
+}
+
+BENCHMARK(BM_TreeEnsembleClassifier)->Arg(1)->Arg(100)->Arg(10000)->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_LinearClassifier(benchmark::State& state) {
+  RunModel(state, CreateLinearClassifierModel(), true);
+}
+
+BENCHMARK(BM_LinearClassifier)->RangeMultiplier(8)->Range(1, 4096)->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_SVMClassifier(benchmark::State& state) {
+  RunModel(state, CreateSVMClassifierModel(), true);
+}
+
+BENCHMARK(BM_SVMClassifier)->RangeMultiplier(8)->Range(1, 4096)->Unit(benchmark::TimeUnit::kMicrosecond);
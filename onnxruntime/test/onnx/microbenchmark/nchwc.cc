@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/graph/onnx_protobuf.h>
+#include <core/framework/allocator.h>
+#include <core/framework/ml_value.h>
+#include <core/framework/tensor.h>
+#include <core/session/inference_session.h>
+#include <test/model_proto_builder.h>
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+
+using namespace onnxruntime;
+using namespace onnxruntime::test;
+using namespace ONNX_NAMESPACE;
+
+static const int64_t kNumBlocks = 4;
+static const int64_t kImageSize = 56;
+
+// kNumBlocks of a 3x3 Conv -> Relu, which the layout transformers run in the NCHWc format, with channels in
+// every layer and a MaxPool at the end
+static std::string CreateConvModel(int64_t channels) {
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<float> value(-0.1f, 0.1f);
+
+  GraphProto graph;
+  graph.set_name("nchwc");
+
+  AddValueInfo(graph.add_input(), "X", {1, channels, kImageSize, kImageSize});
+
+  std::string x = "X";
+  for (int64_t i = 0; i < kNumBlocks; ++i) {
+    const std::string id = std::to_string(i);
+    const std::vector<int64_t> weight_dims{channels, channels, 3, 3};
+    std::vector<float> weights(NumElements(weight_dims));
+    std::generate(weights.begin(), weights.end(), [&]() { return value(generator); });
+    AddInitializer(graph, "W" + id, weight_dims, weights);
+    AddInitializer(graph, "B" + id, {channels}, std::vector<float>(channels, 0.f));
+
+    AddInts(*AddNode(graph, "Conv", {x, "W" + id, "B" + id}, {"conv" + id}), "pads", {1, 1, 1, 1});
+    x = "relu" + id;
+    AddNode(graph, "Relu", {"conv" + id}, {x});
+  }
+
+  auto* pool = AddNode(graph, "MaxPool", {x}, {"Y"});
+  AddInts(*pool, "kernel_shape", {2, 2});
+  AddInts(*pool, "strides", {2, 2});
+  AddValueInfo(graph.add_output(), "Y", {1, channels, kImageSize / 2, kImageSize / 2});
+
+  std::string serialized;
+  CreateModelProto(std::move(graph)).SerializeToString(&serialized);
+  return serialized;
+}
+
+static void RunConvModel(benchmark::State& state, TransformerLevel level) {
+  const int64_t channels = state.range(0);
+
+  SessionOptions so;
+  so.session_logid = "nchwc";
+  so.graph_optimization_level = level;
+  InferenceSession session{so};
+
+  std::istringstream model_stream(CreateConvModel(channels));
+  auto status = session.Load(model_stream);
+  if (status.IsOK()) {
+    status = session.Initialize();
+  }
+
+  if (!status.IsOK()) {
+    state.SkipWithError(status.ErrorMessage().c_str());
+    return;
+  }
+
+  static AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  TensorShape shape({1, channels, kImageSize, kImageSize});
+  auto tensor = std::make_unique<Tensor>(DataTypeImpl::GetType<float>(), shape,
+                                         allocator->Alloc(shape.Size() * sizeof(float)), allocator->Info(), allocator);
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<float> value(-1.f, 1.f);
+  std::generate_n(tensor->MutableData<float>(), shape.Size(), [&]() { return value(generator); });
+  NameMLValMap feeds{{"X", MLValue{tensor.release(), DataTypeImpl::GetType<Tensor>(),
+                                   DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()}}};
+
+  for (auto _ : state) {
+    std::vector<MLValue> fetches;
+    status = session.Run(feeds, {"Y"}, &fetches);
+    if (!status.IsOK()) {
+      state.SkipWithError(status.ErrorMessage().c_str());
+      break;
+    }
+  }
+}
+
+// the baseline: Conv runs in the NCHW format through im2col and sgemm
+static void BM_ConvNchw(benchmark::State& state) {
+  RunConvModel(state, TransformerLevel::kExtended);
+}
+
+BENCHMARK(BM_ConvNchw)->Arg(16)->Arg(64)->Arg(128)->Unit(benchmark::TimeUnit::kMillisecond);
+
+// the same model with NchwcTransformer, which runs Conv and MaxPool with the MLAS NCHWc kernels
+static void BM_ConvNchwc(benchmark::State& state) {
+  RunConvModel(state, TransformerLevel::kLayout);
+}
+
+BENCHMARK(BM_ConvNchwc)->Arg(16)->Arg(64)->Arg(128)->Unit(benchmark::TimeUnit::kMillisecond);
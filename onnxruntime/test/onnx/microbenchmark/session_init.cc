@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/graph/onnx_protobuf.h>
+#include <core/session/inference_session.h>
+#include <test/model_proto_builder.h>
+#include <test/temp_file_path.h>
+
+#include <fstream>
+#include <sstream>
+
+using namespace onnxruntime;
+using namespace onnxruntime::test;
+using namespace ONNX_NAMESPACE;
+
+static const int64_t kChannels = 16;
+
+// num_blocks of Conv -> BatchNormalization -> Relu, which the default transformers fuse into one FusedConv each
+static std::string CreateConvBNModel(int64_t num_blocks) {
+  GraphProto graph;
+  graph.set_name("conv_bn");
+
+  AddValueInfo(graph.add_input(), "X", {1, kChannels, 8, 8});
+
+  std::string x = "X";
+  for (int64_t i = 0; i < num_blocks; ++i) {
+    const std::string id = std::to_string(i);
+    const std::vector<int64_t> weight_dims{kChannels, kChannels, 3, 3};
+    AddInitializer(graph, "W" + id, weight_dims, std::vector<float>(NumElements(weight_dims), 0.01f));
+    AddInitializer(graph, "B" + id, {kChannels}, std::vector<float>(kChannels, 0.f));
+    for (const auto* param : {"scale", "bias", "mean", "var"}) {
+      AddInitializer(graph, param + id, {kChannels}, std::vector<float>(kChannels, 1.f));
+    }
+
+    AddInts(*AddNode(graph, "Conv", {x, "W" + id, "B" + id}, {"conv" + id}), "pads", {1, 1, 1, 1});
+    AddNode(graph, "BatchNormalization", {"conv" + id, "scale" + id, "bias" + id, "mean" + id, "var" + id},
+            {"bn" + id});
+    x = "relu" + id;
+    AddNode(graph, "Relu", {"bn" + id}, {x});
+  }
+
+  AddValueInfo(graph.add_output(), x, {1, kChannels, 8, 8});
+
+  std::string serialized;
+  CreateModelProto(std::move(graph)).SerializeToString(&serialized);
+  return serialized;
+}
+
+static Status InitializeSession(const std::string& model, const SessionOptions& so) {
+  InferenceSession session{so};
+  std::istringstream model_stream(model);
+  ORT_RETURN_IF_ERROR(session.Load(model_stream));
+  return session.Initialize();
+}
+
+static SessionOptions GetSessionOptions() {
+  SessionOptions so;
+  so.session_logid = "session_init";
+  so.graph_optimization_level = TransformerLevel::kExtended;
+  return so;
+}
+
+static void BM_InitializeOriginalModel(benchmark::State& state) {
+  const std::string model = CreateConvBNModel(state.range(0));
+  const SessionOptions so = GetSessionOptions();
+
+  for (auto _ : state) {
+    auto status = InitializeSession(model, so);
+    if (!status.IsOK()) {
+      state.SkipWithError(status.ErrorMessage().c_str());
+      break;
+    }
+  }
+}
+
+BENCHMARK(BM_InitializeOriginalModel)->Arg(10)->Arg(100)->Unit(benchmark::TimeUnit::kMillisecond);
+
+// the same model saved by a session with optimized_model_filepath set
+static void BM_InitializeOptimizedModel(benchmark::State& state) {
+  TempFilePath optimized_model_file("session_init_optimized.onnx");
+  SessionOptions so = GetSessionOptions();
+  so.optimized_model_filepath = optimized_model_file.Path();
+  auto status = InitializeSession(CreateConvBNModel(state.range(0)), so);
+  if (!status.IsOK()) {
+    state.SkipWithError(status.ErrorMessage().c_str());
+    return;
+  }
+
+  std::ifstream optimized_model_stream(optimized_model_file.Path(), std::ios::binary);
+  const std::string optimized_model((std::istreambuf_iterator<char>(optimized_model_stream)),
+                                    std::istreambuf_iterator<char>());
+  so.optimized_model_filepath.clear();
+
+  for (auto _ : state) {
+    status = InitializeSession(optimized_model, so);
+    if (!status.IsOK()) {
+      state.SkipWithError(status.ErrorMessage().c_str());
+      break;
+    }
+  }
+}
+
+BENCHMARK(BM_InitializeOptimizedModel)->Arg(10)->Arg(100)->Unit(benchmark::TimeUnit::kMillisecond);
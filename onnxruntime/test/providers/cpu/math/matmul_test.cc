@@ -59,6 +59,11 @@ TEST(MathOpTest, MatMul) {
        {1, 3, 4},
        {2, 2, 4},
        {20, 23, 26, 29, 56, 68, 80, 92, 92, 113, 134, 155, 128, 158, 188, 218}},
+      {"test batched",
+       {2, 2, 3},
+       {2, 3, 1},
+       {2, 2, 1},
+       {5, 14, 86, 122}},
   };
 
   for (auto t : testcases) {
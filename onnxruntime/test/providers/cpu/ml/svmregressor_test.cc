@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -57,6 +59,49 @@ TEST(MLOpTest, SVMRegressorNuSVC) {
   test.Run();
 }
 
+TEST(MLOpTest, SVMRegressorRBFLargeFeatures) {
+  OpTester test("SVMRegressor", 1, onnxruntime::kMLDomain);
+
+  // nearby points far from the origin, where |x|^2 - 2 x.s + |s|^2 loses all the digits of the distance in float.
+  // there are more rows than a block of them to cover the last partial block.
+  const int64_t N = 21, F = 3, S = 2;
+  std::vector<float> dual_coefficients = {1.f, -0.5f};
+  std::vector<float> support_vectors = {10000.f, 20000.f, -30000.f, 10001.f, 20000.5f, -30000.5f};
+  std::vector<float> rho = {0.25f};
+  std::vector<float> kernel_params = {0.5f, 0.f, 3.f};  //gamma, coef0, degree
+
+  std::vector<float> X(N * F);
+  std::vector<float> predictions(N);
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t f = 0; f < F; f++) {
+      X[n * F + f] = support_vectors[f] + static_cast<float>((n + f) % 5) * 0.25f;
+    }
+
+    double sum = rho[0];
+    for (int64_t s = 0; s < S; s++) {
+      double distance = 0.;
+      for (int64_t f = 0; f < F; f++) {
+        const double diff = static_cast<double>(X[n * F + f]) - support_vectors[s * F + f];
+        distance += diff * diff;
+      }
+      sum += dual_coefficients[s] * std::exp(-kernel_params[0] * distance);
+    }
+    predictions[n] = static_cast<float>(sum);
+  }
+
+  test.AddAttribute("kernel_type", std::string("RBF"));
+  test.AddAttribute("coefficients", dual_coefficients);
+  test.AddAttribute("support_vectors", support_vectors);
+  test.AddAttribute("rho", rho);
+  test.AddAttribute("kernel_params", kernel_params);
+  test.AddAttribute("n_supports", S);
+
+  test.AddInput<float>("X", {N, F}, X);
+  test.AddOutput<float>("Y", {N, 1}, predictions);
+
+  test.Run();
+}
+
 TEST(MLOpTest, SVMRegressorNuSVCPolyKernel) {
   OpTester test("SVMRegressor", 1, onnxruntime::kMLDomain);
 
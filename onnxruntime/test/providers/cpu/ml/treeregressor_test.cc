@@ -2,8 +2,12 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/providers/cpu/ml/tree_ensemble_common.h"
 #include "test/providers/provider_test_utils.h"
 
+#include <algorithm>
+#include <random>
+
 namespace onnxruntime {
 namespace test {
 
@@ -50,5 +54,225 @@ TEST(MLOpTest, TreeRegressorMultiTarget) {
   test.Run();
 }
 
+TEST(MLOpTest, TreeRegressorMissingValueTracksTrue) {
+  OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+
+  // two trees with the same split, only the first sends a missing value down the true branch
+  std::vector<int64_t> lefts = {1, -1, -1, 1, -1, -1};
+  std::vector<int64_t> rights = {2, -1, -1, 2, -1, -1};
+  std::vector<int64_t> treeids = {0, 0, 0, 1, 1, 1};
+  std::vector<int64_t> nodeids = {0, 1, 2, 0, 1, 2};
+  std::vector<int64_t> featureids = {0, -2, -2, 0, -2, -2};
+  std::vector<float> thresholds = {0.f, -2.f, -2.f, 0.f, -2.f, -2.f};
+  std::vector<std::string> modes = {"BRANCH_LEQ", "LEAF", "LEAF", "BRANCH_LEQ", "LEAF", "LEAF"};
+  std::vector<int64_t> missing_tracks_true = {1, 0, 0, 0, 0, 0};
+
+  std::vector<int64_t> target_treeids = {0, 0, 1, 1};
+  std::vector<int64_t> target_nodeids = {1, 2, 1, 2};
+  std::vector<int64_t> target_ids = {0, 0, 0, 0};
+  std::vector<float> target_weights = {1.f, 2.f, 10.f, 20.f};
+
+  std::vector<float> X = {-1.f, 1.f, std::numeric_limits<float>::quiet_NaN()};
+  std::vector<float> results = {11.f, 22.f, 21.f};
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("nodes_missing_value_tracks_true", missing_tracks_true);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_ids);
+  test.AddAttribute("target_weights", target_weights);
+
+  test.AddAttribute("n_targets", (int64_t)1);
+  test.AddAttribute("aggregate_function", "SUM");
+  test.AddInput<float>("X", {3, 1}, X);
+  test.AddOutput<float>("Y", {3, 1}, results);
+  test.Run();
+}
+
+TEST(MLOpTest, TreeRegressorMixedModes) {
+  OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+
+  // the trees split the same way with different modes, and only the first sends a missing value down the true branch
+  std::vector<int64_t> lefts = {1, -1, -1, 1, -1, -1};
+  std::vector<int64_t> rights = {2, -1, -1, 2, -1, -1};
+  std::vector<int64_t> treeids = {0, 0, 0, 1, 1, 1};
+  std::vector<int64_t> nodeids = {0, 1, 2, 0, 1, 2};
+  std::vector<int64_t> featureids = {0, -2, -2, 0, -2, -2};
+  std::vector<float> thresholds = {0.f, -2.f, -2.f, 0.f, -2.f, -2.f};
+  std::vector<std::string> modes = {"BRANCH_GT", "LEAF", "LEAF", "BRANCH_LEQ", "LEAF", "LEAF"};
+  std::vector<int64_t> missing_tracks_true = {1, 0, 0, 0, 0, 0};
+
+  std::vector<int64_t> target_treeids = {0, 0, 1, 1};
+  std::vector<int64_t> target_nodeids = {1, 2, 1, 2};
+  std::vector<int64_t> target_ids = {0, 0, 0, 0};
+  std::vector<float> target_weights = {1.f, 2.f, 10.f, 20.f};
+
+  std::vector<float> X = {-1.f, 1.f, std::numeric_limits<float>::quiet_NaN()};
+  std::vector<float> results = {12.f, 21.f, 21.f};
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("nodes_missing_value_tracks_true", missing_tracks_true);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_ids);
+  test.AddAttribute("target_weights", target_weights);
+
+  test.AddAttribute("n_targets", (int64_t)1);
+  test.AddAttribute("aggregate_function", "SUM");
+  test.AddInput<float>("X", {3, 1}, X);
+  test.AddOutput<float>("Y", {3, 1}, results);
+  test.Run();
+}
+
+// The nodes and weights of random trees, in the form the TreeEnsemble constructor takes them.
+struct RandomTrees {
+  std::vector<int64_t> treeids, nodeids, featureids, truenodeids, falsenodeids, missing_tracks_true;
+  std::vector<float> values;
+  std::vector<ml::NODE_MODE> modes;
+  std::vector<int64_t> weight_treeids, weight_nodeids, weight_ids;
+  std::vector<float> weights;
+
+  // Adds a node of tree and returns its id. Below max_depth a node becomes a branch with mode at random, so the
+  // trees have leaves at different depths.
+  int64_t AddNode(std::mt19937& generator, int64_t tree, int64_t depth, int64_t max_depth, ml::NODE_MODE mode,
+                  int64_t num_features, int64_t num_scores) {
+    const int64_t node = static_cast<int64_t>(std::count(treeids.begin(), treeids.end(), tree));
+    const size_t index = treeids.size();
+    treeids.push_back(tree);
+    nodeids.push_back(node);
+    featureids.push_back(std::uniform_int_distribution<int64_t>(0, num_features - 1)(generator));
+    // thresholds and inputs are small integers, so EQ and NEQ branches go both ways
+    values.push_back(static_cast<float>(std::uniform_int_distribution<int>(-2, 2)(generator)));
+    missing_tracks_true.push_back(std::uniform_int_distribution<int>(0, 1)(generator));
+    truenodeids.push_back(0);
+    falsenodeids.push_back(0);
+    modes.push_back(ml::NODE_MODE::LEAF);
+
+    if (depth < max_depth && std::uniform_int_distribution<int>(0, 3)(generator) != 0) {
+      // the children grow the arrays, so add them before taking references into them
+      const int64_t true_node = AddNode(generator, tree, depth + 1, max_depth, mode, num_features, num_scores);
+      const int64_t false_node = AddNode(generator, tree, depth + 1, max_depth, mode, num_features, num_scores);
+      modes[index] = mode;
+      truenodeids[index] = true_node;
+      falsenodeids[index] = false_node;
+    } else {
+      // no weight, or one or more weights for random ids
+      const int num_weights = std::uniform_int_distribution<int>(0, 2)(generator);
+      for (int i = 0; i < num_weights; ++i) {
+        weight_treeids.push_back(tree);
+        weight_nodeids.push_back(node);
+        weight_ids.push_back(std::uniform_int_distribution<int64_t>(0, num_scores - 1)(generator));
+        weights.push_back(static_cast<float>(std::uniform_int_distribution<int>(-8, 8)(generator)));
+      }
+    }
+
+    return node;
+  }
+
+  // Adds a tree of one branch with mode and two leaves without weights.
+  void AddStump(int64_t tree, ml::NODE_MODE mode) {
+    treeids.insert(treeids.end(), {tree, tree, tree});
+    nodeids.insert(nodeids.end(), {0, 1, 2});
+    featureids.insert(featureids.end(), {0, 0, 0});
+    values.insert(values.end(), {0.f, 0.f, 0.f});
+    missing_tracks_true.insert(missing_tracks_true.end(), {0, 0, 0});
+    truenodeids.insert(truenodeids.end(), {1, 0, 0});
+    falsenodeids.insert(falsenodeids.end(), {2, 0, 0});
+    modes.insert(modes.end(), {mode, ml::NODE_MODE::LEAF, ml::NODE_MODE::LEAF});
+  }
+
+  ml::TreeEnsemble Create() const {
+    return ml::TreeEnsemble(treeids, nodeids, featureids, values, modes, truenodeids, falsenodeids,
+                            missing_tracks_true, weight_treeids, weight_nodeids, weight_ids, weights);
+  }
+};
+
+// Shallow trees that all branch the same way are walked a block of rows at a time. Adding a tree with another mode
+// and no weights switches the same ensemble to the per-row walk, which must give the same scores.
+TEST(MLOpTest, TreeEnsembleRowsTogetherMatchesPerRowWalk) {
+  const ml::NODE_MODE branch_modes[] = {ml::NODE_MODE::BRANCH_LEQ, ml::NODE_MODE::BRANCH_LT,
+                                        ml::NODE_MODE::BRANCH_GTE, ml::NODE_MODE::BRANCH_GT,
+                                        ml::NODE_MODE::BRANCH_EQ, ml::NODE_MODE::BRANCH_NEQ};
+  const int64_t num_features = 5;
+  const int64_t num_scores = 3;
+  const int64_t num_rows = 37;
+
+  std::mt19937 generator(42);
+  for (int ensemble = 0; ensemble < 100; ++ensemble) {
+    const ml::NODE_MODE mode = branch_modes[ensemble % 6];
+    const int64_t num_trees = std::uniform_int_distribution<int64_t>(1, 20)(generator);
+    const int64_t max_depth = std::uniform_int_distribution<int64_t>(1, 8)(generator);
+
+    RandomTrees trees;
+    for (int64_t tree = 0; tree < num_trees; ++tree) {
+      trees.AddNode(generator, tree, 0, max_depth, mode, num_features, num_scores);
+    }
+
+    RandomTrees mixed_trees = trees;
+    mixed_trees.AddStump(num_trees, branch_modes[(ensemble + 1) % 6]);
+
+    std::vector<float> x(num_rows * num_features);
+    for (auto& value : x) {
+      const int v = std::uniform_int_distribution<int>(-3, 3)(generator);
+      value = v == 3 ? std::numeric_limits<float>::quiet_NaN() : static_cast<float>(v);
+    }
+
+    std::vector<float> scores(num_rows * num_scores, 0.f), expected_scores(num_rows * num_scores, 0.f);
+    std::vector<uint8_t> has_score(num_rows * num_scores, 0), expected_has_score(num_rows * num_scores, 0);
+    ASSERT_TRUE(trees.Create()
+                    .ComputeScores(x.data(), num_rows, num_features, num_scores, scores.data(), has_score.data(),
+                                   nullptr)
+                    .IsOK());
+    ASSERT_TRUE(mixed_trees.Create()
+                    .ComputeScores(x.data(), num_rows, num_features, num_scores, expected_scores.data(),
+                                   expected_has_score.data(), nullptr)
+                    .IsOK());
+    ASSERT_EQ(expected_scores, scores) << "ensemble " << ensemble;
+    ASSERT_EQ(expected_has_score, has_score) << "ensemble " << ensemble;
+  }
+}
+
+TEST(MLOpTest, TreeEnsembleSharedSubtrees) {
+  // every branch sends both ways to the next node, so the tree has 2^200 paths through only 201 nodes. creating
+  // the ensemble must not walk all of them.
+  const int64_t num_branches = 200;
+  RandomTrees trees;
+  for (int64_t node = 0; node <= num_branches; ++node) {
+    const bool leaf = node == num_branches;
+    trees.treeids.push_back(0);
+    trees.nodeids.push_back(node);
+    trees.featureids.push_back(0);
+    trees.values.push_back(0.f);
+    trees.missing_tracks_true.push_back(0);
+    trees.truenodeids.push_back(leaf ? 0 : node + 1);
+    trees.falsenodeids.push_back(leaf ? 0 : node + 1);
+    trees.modes.push_back(leaf ? ml::NODE_MODE::LEAF : ml::NODE_MODE::BRANCH_LEQ);
+  }
+
+  trees.weight_treeids.push_back(0);
+  trees.weight_nodeids.push_back(num_branches);
+  trees.weight_ids.push_back(0);
+  trees.weights.push_back(2.5f);
+
+  std::vector<float> x{-1.f, 1.f};
+  std::vector<float> scores(2, 0.f);
+  std::vector<uint8_t> has_score(2, 0);
+  ASSERT_TRUE(trees.Create().ComputeScores(x.data(), 2, 1, 1, scores.data(), has_score.data(), nullptr).IsOK());
+  EXPECT_EQ(std::vector<float>({2.5f, 2.5f}), scores);
+  EXPECT_EQ(std::vector<uint8_t>({1, 1}), has_score);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
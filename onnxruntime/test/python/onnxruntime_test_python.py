@@ -296,6 +296,22 @@ class TestInferenceSession(unittest.TestCase):
         res = sess.run([output_name], {x_name: x})
         self.assertEqual(output_expected, res[0])
 
+    def testZipMapSharedKeys(self):
+        so = onnxrt.SessionOptions()
+        so.enable_zipmap_shared_keys = True
+        x = np.array([1.0, 0.0, 3.0, 44.0, 23.0, 11.0], dtype=np.float32).reshape((2,3))
+
+        # the maps come back as the list of keys and a row of values for each map
+        sess = onnxrt.InferenceSession(self.get_name("zipmap_stringfloat.pb"), sess_options=so)
+        keys, values = sess.run(["Z"], {"X": x})[0]
+        self.assertEqual(['class1', 'class2', 'class3'], keys)
+        np.testing.assert_array_equal(x, values)
+
+        sess = onnxrt.InferenceSession(self.get_name("zipmap_int64float.pb"), sess_options=so)
+        keys, values = sess.run(["Z"], {"X": x})[0]
+        self.assertEqual([10, 20, 30], keys)
+        np.testing.assert_array_equal(x, values)
+
     def testRaiseWrongNumInputs(self):
         with self.assertRaises(ValueError) as context:
             sess = onnxrt.InferenceSession(self.get_name("logicaland.pb"))
@@ -131,6 +131,7 @@ void TestInference(OrtEnv* env, T model_uri,
 
 static constexpr PATH_TYPE MODEL_URI = TSTR("testdata/mul_1.pb");
 static constexpr PATH_TYPE CUSTOM_OP_MODEL_URI = TSTR("testdata/foo_1.pb");
+static constexpr PATH_TYPE ZIPMAP_MODEL_URI = TSTR("testdata/zipmap_stringfloat.pb");
 
 class CApiTestWithProvider : public CApiTest,
                              public ::testing::WithParamInterface<int> {
@@ -154,6 +155,125 @@ INSTANTIATE_TEST_CASE_P(CApiTestWithProviders,
                         CApiTestWithProvider,
                         ::testing::Values(0, 1, 2, 3, 4));
 
+TEST_F(CApiTest, run_with_plan) {
+  SessionOptionsWrapper sf(env);
+  std::unique_ptr<OrtSession, decltype(&OrtReleaseSession)>
+      inference_session(sf.OrtCreateSession(MODEL_URI), OrtReleaseSession);
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  OrtRunPlan* run_plan_ptr;
+  ORT_THROW_ON_ERROR(OrtCreateRunPlan(inference_session.get(), input_names, 1, output_names, 1, &run_plan_ptr));
+  std::unique_ptr<OrtRunPlan, decltype(&OrtReleaseRunPlan)> run_plan(run_plan_ptr, OrtReleaseRunPlan);
+
+  // unknown names are rejected when the plan is created rather than on each run
+  const char* invalid_output_names[] = {"Z"};
+  OrtStatus* status = OrtCreateRunPlan(inference_session.get(), input_names, 1, invalid_output_names, 1,
+                                       &run_plan_ptr);
+  ASSERT_NE(status, nullptr);
+  OrtReleaseStatus(status);
+
+  std::unique_ptr<MockedOrtAllocator> default_allocator(std::make_unique<MockedOrtAllocator>());
+  std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> value_x(
+      OrtCreateTensorAsOrtValue(default_allocator.get(), {3, 2}, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT),
+      OrtReleaseValue);
+  void* raw_data;
+  ORT_THROW_ON_ERROR(OrtGetTensorMutableData(value_x.get(), &raw_data));
+  memcpy(raw_data, values_x.data(), values_x.size() * sizeof(values_x[0]));
+
+  std::vector<float> expected_values_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+  const OrtValue* inputs[] = {value_x.get()};
+  for (int i = 0; i != 2; ++i) {
+    OrtValue* output_tensor = nullptr;
+    ORT_THROW_ON_ERROR(OrtRunWithPlan(inference_session.get(), nullptr, run_plan.get(), inputs, &output_tensor));
+    ASSERT_NE(output_tensor, nullptr);
+    std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> value_y(output_tensor, OrtReleaseValue);
+
+    float* f;
+    ORT_THROW_ON_ERROR(OrtGetTensorMutableData(value_y.get(), (void**)&f));
+    for (size_t j = 0; j != expected_values_y.size(); ++j) {
+      ASSERT_EQ(expected_values_y[j], f[j]);
+    }
+  }
+
+  // a plan only runs with the session that created it
+  std::unique_ptr<OrtSession, decltype(&OrtReleaseSession)>
+      other_session(sf.OrtCreateSession(MODEL_URI), OrtReleaseSession);
+  OrtValue* output_tensor = nullptr;
+  status = OrtRunWithPlan(other_session.get(), nullptr, run_plan.get(), inputs, &output_tensor);
+  ASSERT_NE(status, nullptr);
+  ASSERT_EQ(OrtGetErrorCode(status), ORT_INVALID_ARGUMENT);
+  OrtReleaseStatus(status);
+  ASSERT_EQ(output_tensor, nullptr);
+}
+
+TEST_F(CApiTest, zipmap_shared_keys) {
+  SessionOptionsWrapper sf(env);
+  sf.EnableZipMapSharedKeys();
+  std::unique_ptr<OrtSession, decltype(&OrtReleaseSession)>
+      inference_session(sf.OrtCreateSession(ZIPMAP_MODEL_URI), OrtReleaseSession);
+
+  std::unique_ptr<MockedOrtAllocator> default_allocator(std::make_unique<MockedOrtAllocator>());
+  std::vector<float> values_x = {1.0f, 0.0f, 3.0f, 44.0f, 23.0f, 11.0f};
+  std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> value_x(
+      OrtCreateTensorAsOrtValue(default_allocator.get(), {2, 3}, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT),
+      OrtReleaseValue);
+  void* raw_data;
+  ORT_THROW_ON_ERROR(OrtGetTensorMutableData(value_x.get(), &raw_data));
+  memcpy(raw_data, values_x.data(), values_x.size() * sizeof(values_x[0]));
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Z"};
+  const OrtValue* inputs[] = {value_x.get()};
+  OrtValue* output_ptr = nullptr;
+  ORT_THROW_ON_ERROR(OrtRun(inference_session.get(), nullptr, input_names, inputs, 1, output_names, 1, &output_ptr));
+  ASSERT_NE(output_ptr, nullptr);
+  std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> output(output_ptr, OrtReleaseValue);
+  ASSERT_EQ(OrtGetValueType(output.get()), ONNX_TYPE_OPAQUE);
+
+  OrtValue* keys_ptr = nullptr;
+  OrtValue* values_ptr = nullptr;
+  ORT_THROW_ON_ERROR(OrtGetSharedKeyMaps(output.get(), &keys_ptr, &values_ptr));
+  std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> keys(keys_ptr, OrtReleaseValue);
+  std::unique_ptr<OrtValue, decltype(&OrtReleaseValue)> values(values_ptr, OrtReleaseValue);
+
+  // the keys are the class labels of the ZipMap, in order
+  const std::vector<std::string> expected_keys = {"class1", "class2", "class3"};
+  size_t data_len;
+  ORT_THROW_ON_ERROR(OrtGetStringTensorDataLength(keys.get(), &data_len));
+  std::string keys_data(data_len, '\0');
+  std::vector<size_t> offsets(expected_keys.size());
+  ORT_THROW_ON_ERROR(OrtGetStringTensorContent(keys.get(), (void*)keys_data.data(), data_len, offsets.data(),
+                                               offsets.size()));
+  for (size_t i = 0; i != expected_keys.size(); ++i) {
+    const size_t end = i + 1 < offsets.size() ? offsets[i + 1] : data_len;
+    ASSERT_EQ(keys_data.substr(offsets[i], end - offsets[i]), expected_keys[i]);
+  }
+
+  // a row of values for each map, in the order of the keys
+  std::unique_ptr<OrtTensorTypeAndShapeInfo> shape_info;
+  {
+    OrtTensorTypeAndShapeInfo* shape_info_ptr;
+    ORT_THROW_ON_ERROR(OrtGetTensorShapeAndType(values.get(), &shape_info_ptr));
+    shape_info.reset(shape_info_ptr);
+  }
+  std::vector<int64_t> shape_array(OrtGetNumOfDimensions(shape_info.get()));
+  OrtGetDimensions(shape_info.get(), shape_array.data(), shape_array.size());
+  ASSERT_EQ(shape_array, (std::vector<int64_t>{2, 3}));
+
+  float* f;
+  ORT_THROW_ON_ERROR(OrtGetTensorMutableData(values.get(), (void**)&f));
+  for (size_t i = 0; i != values_x.size(); ++i) {
+    ASSERT_EQ(values_x[i], f[i]);
+  }
+
+  // a value that isn't a batch of maps is rejected
+  OrtStatus* status = OrtGetSharedKeyMaps(value_x.get(), &keys_ptr, &values_ptr);
+  ASSERT_NE(status, nullptr);
+  OrtReleaseStatus(status);
+}
+
 #ifndef _WIN32
 //doesn't work, failed in type comparison
 TEST_F(CApiTest, DISABLED_custom_op) {
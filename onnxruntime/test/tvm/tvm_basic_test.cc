@@ -15,6 +15,9 @@
 #include "core/framework/op_kernel.h"
 #include "core/framework/kernel_registry.h"
 
+#include <fstream>
+#include <sstream>
+
 namespace onnxruntime {
 
 tvm::Schedule DefaultTVMScheduleGenerator(const TVMGraph& tvm_graph) {
@@ -83,16 +86,25 @@ static DLDataType GetDataType(DType type) {
 
 namespace test {
 
+// the output buffer the fused function last wrote to, to check the runtime uses it without a copy
+struct FusedOutput {
+  void* data = nullptr;
+  // the runtime didn't provide a buffer, so the function allocated it
+  bool allocated_by_function = false;
+};
+
 struct TVMFuncState {
   AllocateFunc test_allocate_func = nullptr;
   DestroyFunc test_release_func = nullptr;
   AllocatorHandle allocator = nullptr;
   tvm::runtime::Module* module = nullptr;
+  FusedOutput* last_output = nullptr;
 };
 
 class FuseExecutionProviderX : public CPUExecutionProvider {
  public:
-  explicit FuseExecutionProviderX(const CPUExecutionProviderInfo& info) : CPUExecutionProvider(info) {
+  FuseExecutionProviderX(const CPUExecutionProviderInfo& info, FusedOutput* last_output)
+      : CPUExecutionProvider(info), last_output_(last_output) {
   }
 
   std::vector<std::unique_ptr<ComputeCapability>>
@@ -198,7 +210,8 @@ class FuseExecutionProviderX : public CPUExecutionProvider {
 
       compute_info.create_state_func = [=](ComputeContext* context, FunctionState* state) {
         auto* p = new TVMFuncState();
-        *p = {context->allocate_func, context->release_func, context->allocator_handle, modules_[context->node_name].get()};
+        *p = {context->allocate_func, context->release_func, context->allocator_handle, modules_[context->node_name].get(),
+              last_output_};
         *state = p;
         return 0;
       };
@@ -231,17 +244,19 @@ class FuseExecutionProviderX : public CPUExecutionProvider {
         }
 
         for (auto i = 0; i < num_outputs; i++) {
-          //setup output tensor property
-          //todo: type should be set by framework.
-          output_tensors[i].dtype = input_tensors[0].dtype;
-          //todo: shape inference
-          output_tensors[i].ndim = input_tensors[0].ndim;
-          output_tensors[i].shape = new int64_t[output_tensors[i].ndim];
-          memcpy(output_tensors[i].shape, input_tensors[0].shape, sizeof(int64_t) * output_tensors[i].ndim);
-          int64_t size = 1;
-          for (auto j = 0; j < output_tensors[i].ndim; j++)
-            size *= output_tensors[i].shape[j];
-          output_tensors[i].data = (*(tvm_state->test_allocate_func))(tvm_state->allocator, sizeof(double) * size, 64);
+          // if the runtime didn't allocate the output from its inferred shape, allocate it here
+          tvm_state->last_output->allocated_by_function = output_tensors[i].data == nullptr;
+          if (output_tensors[i].data == nullptr) {
+            output_tensors[i].dtype = input_tensors[0].dtype;
+            output_tensors[i].ndim = input_tensors[0].ndim;
+            output_tensors[i].shape = new int64_t[output_tensors[i].ndim];
+            memcpy(output_tensors[i].shape, input_tensors[0].shape, sizeof(int64_t) * output_tensors[i].ndim);
+            int64_t size = 1;
+            for (auto j = 0; j < output_tensors[i].ndim; j++)
+              size *= output_tensors[i].shape[j];
+            output_tensors[i].data = (*(tvm_state->test_allocate_func))(tvm_state->allocator, sizeof(double) * size, 64);
+          }
+          tvm_state->last_output->data = output_tensors[i].data;
 
           tvm_type_codes[num_inputs + i] = kNDArrayContainer;
           dl_tensors[num_inputs + i].ctx = cpu_context;
@@ -276,6 +291,7 @@ class FuseExecutionProviderX : public CPUExecutionProvider {
 
  private:
   std::unordered_map<std::string, std::shared_ptr<tvm::runtime::Module>> modules_;
+  FusedOutput* last_output_;
 };
 
 static void RunSession(InferenceSession& session_object,
@@ -283,7 +299,8 @@ static void RunSession(InferenceSession& session_object,
                        std::vector<int64_t>& dims_x,
                        std::vector<double>& values_x,
                        std::vector<int64_t>& dims_y,
-                       std::vector<double>& values_y) {
+                       std::vector<double>& values_y,
+                       const void** output_data = nullptr) {
   // prepare inputs
   MLValue ml_value;
   CreateMLValue<double>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_x, values_x, &ml_value);
@@ -307,21 +324,44 @@ static void RunSession(InferenceSession& session_object,
   ASSERT_EQ(found.size(), values_y.size());
   for (size_t i = 0; i < found.size(); i++)
     ASSERT_EQ(found[i], values_y[i]);
+
+  if (output_data)
+    *output_data = rtensor.DataRaw();
 }
 
 static const std::string MODEL_URI = "testdata/fuse_add_1.pb";
 
-TEST(TVMTest, Fuse_Add_Test) {
+class TVMFuseTest : public ::testing::Test {
+ protected:
+  // load the model into session_object with the fusing provider registered
+  void LoadModel(InferenceSession& session_object, const ONNX_NAMESPACE::ModelProto& model_proto) {
+    CPUExecutionProviderInfo info;
+    auto tvm_xp = std::make_unique<FuseExecutionProviderX>(info, &last_output_);
+    ASSERT_TRUE(session_object.RegisterExecutionProvider(std::move(tvm_xp)).IsOK());
+
+    std::stringstream model_stream;
+    ASSERT_TRUE(model_proto.SerializeToOstream(&model_stream));
+    ASSERT_TRUE(session_object.Load(model_stream).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+  }
+
+  static ONNX_NAMESPACE::ModelProto LoadModelProto() {
+    ONNX_NAMESPACE::ModelProto model_proto;
+    std::ifstream model_file(MODEL_URI, std::ios::binary);
+    EXPECT_TRUE(model_proto.ParseFromIstream(&model_file));
+    return model_proto;
+  }
+
+  FusedOutput last_output_;
+};
+
+TEST_F(TVMFuseTest, Fuse_Add_Test) {
   SessionOptions so;
 
   so.session_logid = "InferenceSessionTests.NoTimeout";
 
   InferenceSession session_object{so, &DefaultLoggingManager()};
-  CPUExecutionProviderInfo info;
-  auto tvm_xp = std::make_unique<FuseExecutionProviderX>(info);
-  EXPECT_TRUE(session_object.RegisterExecutionProvider(std::move(tvm_xp)).IsOK());
-  EXPECT_TRUE(session_object.Load(MODEL_URI).IsOK());
-  EXPECT_TRUE(session_object.Initialize().IsOK());
+  LoadModel(session_object, LoadModelProto());
 
   RunOptions run_options;
   run_options.run_tag = "one session/one tag";
@@ -340,7 +380,48 @@ TEST(TVMTest, Fuse_Add_Test) {
   std::vector<double> expected_values_y = {5.0, 10.0, 15.0, 20.0, 25.0, 30.0};
 
   // Now run
-  RunSession(session_object, run_options, dims_x, values_x, expected_dims_y, expected_values_y);
+  const void* output_data = nullptr;
+  RunSession(session_object, run_options, dims_x, values_x, expected_dims_y, expected_values_y, &output_data);
+
+  // the output shape is known, so the runtime allocated the fetch and the fused function wrote to it
+  EXPECT_FALSE(last_output_.allocated_by_function);
+  EXPECT_EQ(last_output_.data, output_data);
+}
+
+TEST_F(TVMFuseTest, FuseAddAdoptsFunctionOutput) {
+  // with a symbolic dim the output shape isn't known before the run, so the fused function allocates the output
+  // and the runtime adopts its buffer as the fetch. the weights are declared as inputs of the same shape so shape
+  // inference doesn't resolve the dim from them.
+  auto model_proto = LoadModelProto();
+  auto* graph_proto = model_proto.mutable_graph();
+  for (auto* value_info : {graph_proto->mutable_input(0), graph_proto->mutable_output(0)}) {
+    value_info->mutable_type()->mutable_tensor_type()->mutable_shape()->mutable_dim(0)->set_dim_param("N");
+  }
+
+  for (const auto* weights : {"W1", "W2", "W3", "W4"}) {
+    auto* input = graph_proto->add_input();
+    *input = graph_proto->input(0);
+    input->set_name(weights);
+  }
+
+  SessionOptions so;
+  so.session_logid = "TVMFuseTest.FuseAddAdoptsFunctionOutput";
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  LoadModel(session_object, model_proto);
+
+  RunOptions run_options;
+  std::vector<int64_t> dims_x = {6};
+  std::vector<double> values_x = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  std::vector<int64_t> expected_dims_y = {6};
+  std::vector<double> expected_values_y = {5.0, 10.0, 15.0, 20.0, 25.0, 30.0};
+
+  const void* output_data = nullptr;
+  RunSession(session_object, run_options, dims_x, values_x, expected_dims_y, expected_values_y, &output_data);
+
+  // the fetch is the buffer the function allocated, so no copy was made
+  EXPECT_TRUE(last_output_.allocated_by_function);
+  EXPECT_EQ(last_output_.data, output_data);
 }
 }  // namespace test
 
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/graph/onnx_protobuf.h"
+
+namespace onnxruntime {
+namespace test {
+
+/**
+Helpers to build a ModelProto by hand in tests and benchmarks, for models that are easier to describe in code than
+to check in as a file.
+*/
+
+// Set value_info to a tensor of elem_type. A negative dim is a symbolic dim named "N".
+void AddValueInfo(ONNX_NAMESPACE::ValueInfoProto* value_info, const std::string& name, const std::vector<int64_t>& dims,
+                  ONNX_NAMESPACE::TensorProto_DataType elem_type = ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+
+// Add a float initializer. values holds one value for each element. The values are written to raw_data if
+// use_raw_data is true, and to float_data otherwise.
+ONNX_NAMESPACE::TensorProto* AddInitializer(ONNX_NAMESPACE::GraphProto& graph, const std::string& name,
+                                            const std::vector<int64_t>& dims, const std::vector<float>& values,
+                                            bool use_raw_data = false);
+
+ONNX_NAMESPACE::NodeProto* AddNode(ONNX_NAMESPACE::GraphProto& graph, const std::string& op_type,
+                                   const std::vector<std::string>& inputs, const std::vector<std::string>& outputs);
+
+void AddAttribute(ONNX_NAMESPACE::NodeProto& node, const std::string& name, int64_t value);
+void AddAttribute(ONNX_NAMESPACE::NodeProto& node, const std::string& name, const std::string& value);
+void AddAttribute(ONNX_NAMESPACE::NodeProto& node, const std::string& name, const ONNX_NAMESPACE::GraphProto& value);
+void AddInts(ONNX_NAMESPACE::NodeProto& node, const std::string& name, const std::vector<int64_t>& values);
+void AddFloats(ONNX_NAMESPACE::NodeProto& node, const std::string& name, const std::vector<float>& values);
+void AddStrings(ONNX_NAMESPACE::NodeProto& node, const std::string& name, const std::vector<std::string>& values);
+
+// Create a model of the current IR version with graph, which imports opset_version of the ONNX domain.
+ONNX_NAMESPACE::ModelProto CreateModelProto(ONNX_NAMESPACE::GraphProto graph, int64_t opset_version = 9);
+
+// Number of elements of a tensor with dims.
+int64_t NumElements(const std::vector<int64_t>& dims);
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+namespace onnxruntime {
+namespace test {
+
+// A path in the temporary directory for a file a test writes, e.g. a model it saves. The path is unique to the
+// process and the instance, so tests running in parallel don't share it, and the file is removed on destruction.
+class TempFilePath {
+ public:
+  explicit TempFilePath(const std::string& file_name);
+  ~TempFilePath();
+
+  TempFilePath(const TempFilePath&) = delete;
+  TempFilePath& operator=(const TempFilePath&) = delete;
+
+  const std::string& Path() const {
+    return path_;
+  }
+
+ private:
+  const std::string path_;
+};
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test/model_proto_builder.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+void AddValueInfo(ValueInfoProto* value_info, const std::string& name, const std::vector<int64_t>& dims,
+                  TensorProto_DataType elem_type) {
+  value_info->set_name(name);
+  auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+  tensor_type->set_elem_type(elem_type);
+  auto* shape = tensor_type->mutable_shape();
+  for (auto dim : dims) {
+    if (dim >= 0) {
+      shape->add_dim()->set_dim_value(dim);
+    } else {
+      shape->add_dim()->set_dim_param("N");
+    }
+  }
+}
+
+TensorProto* AddInitializer(GraphProto& graph, const std::string& name, const std::vector<int64_t>& dims,
+                            const std::vector<float>& values, bool use_raw_data) {
+  auto* initializer = graph.add_initializer();
+  initializer->set_name(name);
+  initializer->set_data_type(TensorProto_DataType_FLOAT);
+  for (auto dim : dims) {
+    initializer->add_dims(dim);
+  }
+
+  if (use_raw_data) {
+    initializer->set_raw_data(values.data(), values.size() * sizeof(float));
+  } else {
+    for (auto value : values) {
+      initializer->add_float_data(value);
+    }
+  }
+
+  return initializer;
+}
+
+NodeProto* AddNode(GraphProto& graph, const std::string& op_type,
+                   const std::vector<std::string>& inputs, const std::vector<std::string>& outputs) {
+  auto* node = graph.add_node();
+  node->set_op_type(op_type);
+  for (const auto& input : inputs) {
+    node->add_input(input);
+  }
+
+  for (const auto& output : outputs) {
+    node->add_output(output);
+  }
+
+  return node;
+}
+
+static AttributeProto* NewAttribute(NodeProto& node, const std::string& name, AttributeProto_AttributeType type) {
+  auto* attribute = node.add_attribute();
+  attribute->set_name(name);
+  attribute->set_type(type);
+  return attribute;
+}
+
+void AddAttribute(NodeProto& node, const std::string& name, int64_t value) {
+  NewAttribute(node, name, AttributeProto_AttributeType_INT)->set_i(value);
+}
+
+void AddAttribute(NodeProto& node, const std::string& name, const std::string& value) {
+  NewAttribute(node, name, AttributeProto_AttributeType_STRING)->set_s(value);
+}
+
+void AddAttribute(NodeProto& node, const std::string& name, const GraphProto& value) {
+  *NewAttribute(node, name, AttributeProto_AttributeType_GRAPH)->mutable_g() = value;
+}
+
+void AddInts(NodeProto& node, const std::string& name, const std::vector<int64_t>& values) {
+  auto* attribute = NewAttribute(node, name, AttributeProto_AttributeType_INTS);
+  for (auto value : values) {
+    attribute->add_ints(value);
+  }
+}
+
+void AddFloats(NodeProto& node, const std::string& name, const std::vector<float>& values) {
+  auto* attribute = NewAttribute(node, name, AttributeProto_AttributeType_FLOATS);
+  for (auto value : values) {
+    attribute->add_floats(value);
+  }
+}
+
+void AddStrings(NodeProto& node, const std::string& name, const std::vector<std::string>& values) {
+  auto* attribute = NewAttribute(node, name, AttributeProto_AttributeType_STRINGS);
+  for (const auto& value : values) {
+    attribute->add_strings(value);
+  }
+}
+
+ModelProto CreateModelProto(GraphProto graph, int64_t opset_version) {
+  ModelProto model;
+  model.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
+  auto* opset = model.add_opset_import();
+  opset->set_domain("");
+  opset->set_version(opset_version);
+  *model.mutable_graph() = std::move(graph);
+  return model;
+}
+
+int64_t NumElements(const std::vector<int64_t>& dims) {
+  int64_t size = 1;
+  for (auto dim : dims) {
+    size *= dim;
+  }
+
+  return size;
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test/temp_file_path.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+namespace test {
+
+static std::string GetTempDirectory() {
+#ifdef _WIN32
+  const char* dir = std::getenv("TEMP");
+#else
+  const char* dir = std::getenv("TMPDIR");
+#endif
+  if (dir != nullptr && *dir != '\0') {
+    return dir;
+  }
+
+#ifdef _WIN32
+  return ".";
+#else
+  return "/tmp";
+#endif
+}
+
+static std::string CreateTempFilePath(const std::string& file_name) {
+  static std::atomic<int> next_id{0};
+
+  std::ostringstream path;
+  path << GetTempDirectory() << "/onnxruntime_test_" << Env::Default().GetSelfPid() << "_" << next_id++ << "_"
+       << file_name;
+  return path.str();
+}
+
+TempFilePath::TempFilePath(const std::string& file_name) : path_(CreateTempFilePath(file_name)) {
+}
+
+TempFilePath::~TempFilePath() {
+  // the file may not have been written
+  std::remove(path_.c_str());
+}
+
+}  // namespace test
+}  // namespace onnxruntime